@@ -4,6 +4,8 @@
 
 namespace InternalAssembler
 {
+	//The routines below are also done natively in 8085_emu/src/BootloaderHle.cpp (CPU::SetBootloaderHle()).
+	//Change both together; the HLE turns itself off if a routine doesn't start like it expects.
 	std::string Bootloader = R"(
 
 RST0 EQU 0000H
@@ -187,8 +189,9 @@ _WAIT_BEEP:
 	RET
 
 
-; NOT VERY ACCURATE DUE TO THE WAY THE SIMULATOR WORKS
-; Could fix this by changing how the clock cycles are handled in C++
+; CALL DCD is 67 more t-states per loop, so CALL DELA takes 2939 t-states in all (0.92 ms at 3.2 MHz).
+; That's what the simulator counts with exact cycles (Options -> "Exact T-states").
+; Without them it counts 3301, one more per instruction.
 
 DELA:
 	PUSH PSW ; 12 t-states
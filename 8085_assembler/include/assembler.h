@@ -31,21 +31,45 @@ namespace Assembler
 
 	std::shared_ptr<uint8_t> GetAssembledMemory(std::shared_ptr<InternalAssembler::SourceFile> source, Assembler::Assembly& result); // Assembled memory from SourceFile*
 	std::shared_ptr<uint8_t> GetAssembledMemory(std::string code, Assembler::Assembly& result); // Assembled memory from std::string
+
+	//Assembles every one of codes on its own, on threads at once (0 for one per core). Each result is what GetAssembledMemory() gives for its code.
+	std::vector<Assembly> AssembleMany(const std::vector<std::string>& codes, unsigned int threads = 0);
 }
 
 namespace InternalAssembler
 {
 
-	extern Assembler::Assembly* currentAssembler;
+	//Everything one assembly works on, so more of them can run at once on different threads.
+	//Passed to parsing, the instructions and the MACROs. Errors go to the Assembly.
+	struct AssemblerContext
+	{
+		Assembler::Assembly& Result;
+
+		uint16_t StartingAddr = 0x0800;
+		uint16_t CurrentAddr = 0x0800;
+
+		SymbolScope<uint16_t> ProgramLabels; // Every label in Assembler::Assembly::Labels, the first one if there are more with the same name.
+		SymbolScope<uint16_t>* CurrentLabels = &ProgramLabels; // The labels instructions see: the program's, or a MACRO's over them while it's assembled.
+		SymbolScope<Macro*> Macros; // Assembler::Assembly::Macros by name.
+
+		AssemblerContext(Assembler::Assembly& result)
+			: Result(result)
+		{
+
+		}
+
+		AssemblerContext(const AssemblerContext&) = delete; // CurrentLabels points into it.
+		AssemblerContext& operator=(const AssemblerContext&) = delete;
+	};
 
-	void Error(std::string err, std::shared_ptr<SourceFile> source); // Add error to error list. 
-	void Error(std::string err, int line); // Add error to error list. 
+	void Error(AssemblerContext& context, std::string err, std::shared_ptr<SourceFile> source); // Add error to error list. 
+	void Error(AssemblerContext& context, std::string err, int line); // Add error to error list. 
 
-	void ParseIfDirective(std::shared_ptr<SourceFile> source, std::vector<IfExpr>& _IfBuffer);
+	void ParseIfDirective(AssemblerContext& context, std::shared_ptr<SourceFile> source, std::vector<IfExpr>& _IfBuffer);
 
 	bool isNumber(std::string str);
-	uint8_t StringToUInt8(std::string str, std::shared_ptr<SourceFile> source); // Converts string to uint8. Could be hex(ending in 'h'), binary(ending in 'b') or dec. 
-	uint16_t StringToUInt16(std::string str, std::shared_ptr<SourceFile> source, bool noerrors = false, bool* NaN = nullptr); // Same but for uint16_t
+	uint8_t StringToUInt8(AssemblerContext& context, std::string str, std::shared_ptr<SourceFile> source); // Converts string to uint8. Could be hex(ending in 'h'), binary(ending in 'b') or dec. 
+	uint16_t StringToUInt16(AssemblerContext& context, std::string str, std::shared_ptr<SourceFile> source, bool noerrors = false, bool* NaN = nullptr); // Same but for uint16_t
 
-	std::shared_ptr<uint8_t> parse(std::shared_ptr<SourceFile> source, Assembler::Assembly& result, bool scanning = false, bool bootloader = false); // Parses the file, returing a dump of the assembled memory or simply scans the file, parsing but only saving labels/EQU/MACRO
+	std::shared_ptr<uint8_t> parse(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool scanning = false, bool bootloader = false); // Parses the file, returing a dump of the assembled memory or simply scans the file, parsing but only saving labels/EQU/MACRO
 }
\ No newline at end of file
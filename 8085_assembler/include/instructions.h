@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "source_file.h"
 #include "assembler.h"
@@ -12,108 +13,122 @@ namespace InternalAssembler
 
     //The entire instruction set, used in assembling the binary from text.
 
+    //What a word does when a statement starts with it, if it's not an instruction.
+    enum class Directives : uint8_t
+    {
+        None, // An instruction.
+        ORG,
+        END,
+        DB,
+        DW,
+        IF,
+        ELSE,
+        ENDIF
+    };
+
+    //Each mnemonic once, with what encodes its operands. Directives too, without an ACTION.
     struct Instruction
     {
-        uint8_t OPCODE;
-        char OPERAND[16];
+        char MNEMONIC[8];
         uint8_t bytes;
-        bool (*ACTION)(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-        char ARGS[16];
+        bool (*ACTION)(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+        Directives DIRECTIVE;
     } typedef Instruction;
 
-    uint16_t FindLabel(const std::string& label, std::shared_ptr<SourceFile> source);
+    //The instruction or directive word is, nullptr if it's neither.
+    const Instruction* FindInstruction(std::string_view word);
 
-    uint8_t GetNextRegister(std::shared_ptr<SourceFile> source, bool a = true, bool m = true);
+    uint16_t FindLabel(AssemblerContext& context, const std::string& label, std::shared_ptr<SourceFile> source);
 
-    uint8_t GetNextDoubleRegister(std::shared_ptr<SourceFile> source, bool h = true, bool sp = false, bool psw = false);
+    uint8_t GetNextRegister(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool a = true, bool m = true);
 
-    uint8_t GetImmediate8(std::shared_ptr<SourceFile> source);
+    uint8_t GetNextDoubleRegister(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool h = true, bool sp = false, bool psw = false);
 
-    uint16_t GetImmediate16(std::shared_ptr<SourceFile> source);
+    uint8_t GetImmediate8(AssemblerContext& context, std::shared_ptr<SourceFile> source);
 
+    uint16_t GetImmediate16(AssemblerContext& context, std::shared_ptr<SourceFile> source);
 
-    bool ACI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ADC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ADD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ADI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ANA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ANI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CALL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CMA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CMC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CMP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CPI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool CZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DAA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DAD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DCR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DCX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool EI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool HLT(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool IN(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool INR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool INX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JMP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool JZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool LDA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool LDAX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool LHLD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool LXI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool MOV(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool MVI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool NOP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ORA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool ORI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool OUT(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool PCHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool POP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool PUSH(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RAL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RAR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RET(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RIM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RLC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool DSUB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RRC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RST(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool RZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SBB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SBI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SHLD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SIM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SPHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool STA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool STAX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool STC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SUB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool SUI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool XCHG(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool XRA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool XRI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
-    bool XTHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
 
-    extern Instruction Instructions[256];
+    bool ACI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ADC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ADD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ADI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ANA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ANI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CALL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CMA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CMC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CMP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CPI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool CZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DAA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DAD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DCR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DCX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool EI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool HLT(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool IN(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool INR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool INX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JMP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool JZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool LDA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool LDAX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool LHLD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool LXI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool MOV(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool MVI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool NOP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ORA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool ORI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool OUT(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool PCHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool POP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool PUSH(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RAL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RAR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RET(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RIM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RLC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool DSUB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RRC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RST(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool RZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SBB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SBI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SHLD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SIM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SPHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool STA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool STAX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool STC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SUB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool SUI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool XCHG(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool XRA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool XRI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
+    bool XTHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory);
 
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace InternalAssembler
+{
+
+	//Splitting the program into words, once, before it's parsed.
+
+	enum class TokenKinds
+	{
+		Word, // An instruction, a register, a number, a label...
+		String, // Starts with ", for DB. Has the quotes, and may have spaces and commas in it.
+		Newline
+	};
+
+	struct Token
+	{
+		std::string_view Text; // Part of the text that was lexed, which has to outlive the token.
+		int Line = 1;
+		int Column = 1;
+		TokenKinds Kind = TokenKinds::Word;
+	};
+
+	//Words end with a space, a tab, a comma, a ; or a newline. Spaces, tabs, commas and \r between them are skipped,
+	//a ; starts a comment up to the end of the line. Newlines are tokens, an instruction's operands have to be on its line.
+	std::vector<Token> Lex(std::string_view text);
+}
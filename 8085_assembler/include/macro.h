@@ -18,7 +18,7 @@ namespace InternalAssembler
 		std::shared_ptr<SourceFile> _Source;
 		std::vector<std::string> _Arguments;
 
-		std::vector < std::pair<std::string, uint16_t> > labels;
+		SymbolScope<uint16_t> _Labels; // Ours, over the ones where we're used. See AssemblerContext::CurrentLabels.
 		std::vector<std::pair<uint16_t, int>> Symbols;
 		std::vector<IfExpr> _IfBuffer;
 
@@ -29,14 +29,14 @@ namespace InternalAssembler
 		std::string Name;
 
 
-		Macro(std::string name, std::shared_ptr<SourceFile> source);
+		Macro(AssemblerContext& context, std::string name, std::shared_ptr<SourceFile> source);
 
-		uint16_t Parse(std::shared_ptr<SourceFile> source, uint16_t currentAddr, Assembler::Assembly& result, bool scanning = false);
+		uint16_t Parse(AssemblerContext& context, std::shared_ptr<SourceFile> source, uint16_t currentAddr, bool scanning = false);
 
-		inline std::vector<std::pair<uint16_t, int>> GetSymbols() { return Symbols; }
+		inline const std::vector<std::pair<uint16_t, int>>& GetSymbols() { return Symbols; }
 
 	private:
-		uint16_t Assemble(std::shared_ptr<SourceFile> source, Assembler::Assembly& result, uint16_t currentAddr, std::shared_ptr<SourceFile> ogSource, bool scanning = false);
+		uint16_t Assemble(AssemblerContext& context, std::shared_ptr<SourceFile> source, uint16_t currentAddr, std::shared_ptr<SourceFile> ogSource, bool scanning = false);
 	};
 
 }
\ No newline at end of file
@@ -1,104 +1,113 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <memory>
+
+#include "lexer.h"
+#include "symbol_table.h"
 
 namespace InternalAssembler
 {
 
 	//Parsing of text / file.
+	//The text is split into tokens once (see Lex()), reading a word only moves the cursor to the next token.
 
 	class SourceFile
 	{
 	private:
-		std::string _Source; // Our program
-		std::string _LastWord; // Last word we read.
-		int _Cursor = 0; // Current cursor in the text.
+		std::shared_ptr<const std::string> _Text; // Our program, in upper case. The tokens point into it.
+		std::shared_ptr<const std::vector<Token>> _Tokens;
 
-		bool _HasMore = true; // Is there more text?
+		//The tokens this file reads, _Begin to _End. Part of another file's for a MACRO.
+		size_t _Begin = 0;
+		size_t _End = 0;
+		size_t _Cursor = 0; // Current token.
 
-		int _LineCount = 1;
-		int _CharCount = 1;
+		std::string _LastWord; // Last word we read.
+		std::string_view _LastText; // The same, before the EQUs replaced it.
 
-		int _PrevLineCount = 1;
-		int _PrevCharCount = 1;
+		int _Line = 1; // Of the last word we read.
+		int _Column = 1;
 
 	public:
-		std::vector < std::pair<std::string, std::string> > _Equ; // A list of all "EQU" defines of our program.
+		SymbolScope<std::string> _Equ; // All "EQU" defines of our program.
 
 	public:
 		SourceFile(std::string source)
-			: _Source(source), _LastWord("")
 		{
+			std::transform(source.begin(), source.end(), source.begin(), ::toupper); //Convert all letters to upper
 
+			_Text = std::make_shared<const std::string>(std::move(source));
+			_Tokens = std::make_shared<const std::vector<Token>>(Lex(*_Text));
+
+			_End = _Tokens->size();
 		}
 
-		inline bool HasMore()
+		//The tokens begin to end of file, without its EQUs.
+		SourceFile(const SourceFile& file, size_t begin, size_t end)
+			: _Text(file._Text), _Tokens(file._Tokens), _Begin(begin), _End(end), _Cursor(begin)
 		{
-			return _HasMore;
+
 		}
 
-		inline int GetLine()
+		inline bool HasMore()
 		{
-			return _PrevLineCount;
+			return _Cursor < _End;
 		}
 
-		inline void SetLine(int line)
+		inline int GetLine()
 		{
-			_LineCount = line + 1;
-			_PrevLineCount = line;
+			return _Line;
 		}
 
 		inline int GetCharCount()
 		{
-			return _PrevCharCount;
+			return _Column;
 		}
 
 		inline void ResetFile()
 		{
-			_Cursor = 0;
+			_Cursor = _Begin;
 
-			_HasMore = true;
-
-			_LineCount = 1;
-			_CharCount = 1;
-
-			_PrevLineCount = 1;
-			_PrevCharCount = 1;
+			_Line = 1;
+			_Column = 1;
 		}
 
-		inline void SetFileCursor(int cursor)
+		//The token the next word is read from.
+		inline size_t GetFileCursor()
 		{
-			_Cursor = cursor;
+			return _Cursor;
 		}
 
+		//The next word, without moving on to it.
 		inline std::string NextNoCursor(bool ignore_newline_at_start = false)
 		{
-			return NextInternal(_Source, ignore_newline_at_start, true);
+			return NextInternal(ignore_newline_at_start, true);
 		}
 
-
+		//The next word, "" at the end of the line (unless ignore_newline_at_start) or of the file.
 		inline std::string Next(bool ignore_newline_at_start = false)
 		{
-
-			return NextInternal(_Source, ignore_newline_at_start);
+			return NextInternal(ignore_newline_at_start);
 		}
 
-		inline std::string ReadRawUntil(std::string until, std::string until2 = "-_-=+=!2")
+		//Skip everything up to the word until and read it. Where it is, or the end of the file if it isn't there.
+		inline size_t SkipUntil(const std::string& until)
 		{
-			std::string ret = "";
-
-			while ((NextInternal(_Source, true, true) != until && NextInternal(_Source, true, true) != until2) && _HasMore)
+			while (_Cursor < _End && ((*_Tokens)[_Cursor].Kind == TokenKinds::Newline || Replace((*_Tokens)[_Cursor].Text) != until))
 			{
-				std::string str = NextInternal(_Source, true, false, true);
-				ret += str;
+				_Cursor++;
 			}
 
-			NextInternal(_Source, true);
+			size_t at = _Cursor;
+
+			Next(true);
 
-			return ret;
+			return at;
 		}
 
 		inline std::string GetLastWord()
@@ -106,173 +115,73 @@ namespace InternalAssembler
 			return _LastWord;
 		}
 
-	private:
-
-		inline std::string NextInternal(std::string str, bool ignore_newline_at_start, bool no_cursor = false, bool raw = false)
+		inline std::string GetLastText()
 		{
-			std::string word = "";
-
-			int cc = _CharCount; //Buffers
-			int lc = _LineCount;
-			int c = _Cursor;
-			bool hm = _HasMore;
+			return std::string(_LastText);
+		}
 
-			int i = _Cursor;
+	private:
 
-			bool done = false;
+		//If word is found in defines, replace it. Also -word.
+		inline std::string Replace(std::string_view word)
+		{
+			if (const std::string* value = _Equ.Find(word))
+			{
+				return *value;
+			}
 
-			while (i < str.length() && !done)
+			if (word.size() > 1 && word[0] == '-')
 			{
-				if (word.length() == 0)
+				if (const std::string* value = _Equ.Find(word.substr(1)))
 				{
-					if (str[i] == ';') // Means it's a comment. Ignore until we find \n
-					{
-						while (i < str.length() && str[i] != '\n') //Ignore all until \n but increase counter i.
-						{
-							i++;
-						}
-					}
-
-					if (str[i] == ' ' || str[i] == '\r' || str[i] == '\t' || str[i] == ',') // ignore these characters
-												//\r needed because CRLF
-					{
-						_CharCount++;
-					}
-					else if (str[i] == '\"') // Means it's a string. Mostly used with "DB"
-					{
-						word += '\"';
-
-						i++;
+					return "-" + *value;
+				}
+			}
 
-						//We get ALL characters until \n or \".
-						//That means a string may contain spaces, commas and everything else, 
-						//But it may only be one line.
+			return std::string(word);
+		}
 
-						//TODO: Probably should implement escape character
-						while (i < str.length() && str[i] != '\n' && str[i] != '\"')
-						{
-							word += str[i];
-							i++;
-							_CharCount++;
-						}
+		inline std::string NextInternal(bool ignore_newline_at_start, bool no_cursor = false)
+		{
+			const std::vector<Token>& tokens = *_Tokens;
+			size_t i = _Cursor;
 
-						if (str[i] == '\n')
-						{
-							i--;
-						}
+			while (i < _End && tokens[i].Kind == TokenKinds::Newline)
+			{
+				i++;
 
-						if (str[i] == '\"')
-							word += '\"';
-					}
-					else if (str[i] == '\n')
-					{
-						_LineCount++;
-						_CharCount = 0;
-
-						if (!ignore_newline_at_start) // Ignore empty lines when it's at the beginning of a word
-						{
-							done = true;
-						}
-
-						if (raw)
-						{
-							word += '\n';
-						}
-					}
-					else
-					{
-						_CharCount++;
-						word += str[i];
-					}
-				}
-				else
+				if (!ignore_newline_at_start) // Empty word at the end of the line, unless it's ignored at the beginning of a word.
 				{
-					//Ending delimeters.
-					//A word ends with a space, a tab, a comma, or a newline.
-					if (str[i] == ' ' || str[i] == '\t' || str[i] == ',' || str[i] == ';')
+					if (!no_cursor)
 					{
-						_PrevLineCount = _LineCount;
-						_PrevCharCount = _CharCount;
-
-						_CharCount++;
-
-						if (raw)
-						{
-							word += str[i];
-						}
-
-						done = true;
+						_Cursor = i;
+						_LastWord = "";
+						_LastText = "";
 					}
-					else if (str[i] == '\r') {}
-					else if (str[i] == '\n')
-					{
-						_PrevLineCount = _LineCount;
-						_PrevCharCount = _CharCount;
-
-						//_LineCount++;
-						//_CharCount = 0;
-						i--;
 
-						done = true;
-					}
-					else // if none of the above, just add the letter to the word.
-					{
-						_CharCount++;
-						word += str[i];
-					}
+					return "";
 				}
-
-				i++;
-			}
-
-			_Cursor = i;
-			if (_Cursor == str.length()) // Cursor at the end.
-			{
-				_HasMore = false;
 			}
 
-			std::transform(word.begin(), word.end(), word.begin(), ::toupper); //Convert all letters to upper
+			std::string word = i < _End ? Replace(tokens[i].Text) : "";
 
-			bool found = false;
-
-			for (int i = _Equ.size() - 1; i >= 0; i--) //If word is found in defines, replace it.
+			if (!no_cursor)
 			{
-				if (_Equ.at(i).first == word)
-				{
-					word = _Equ.at(i).second;
-					found = true;
-					break;
-				}
-			}
+				_LastText = "";
 
-			if (!found)
-			{
-				if (word[0] == '-')
+				if (i < _End)
 				{
-					for (int i = _Equ.size() - 1; i >= 0; i--) //If word is found in defines, replace it.
-					{
-						if (_Equ.at(i).first == word.substr(1, word.size() - 1))
-						{
-							word = "-" + _Equ.at(i).second;
-							found = true;
-							break;
-						}
-					}
+					_Line = tokens[i].Line;
+					_Column = tokens[i].Column;
+					_LastText = tokens[i].Text;
+					i++;
 				}
-			}
 
-			if (!no_cursor)
+				_Cursor = i;
 				_LastWord = word;
-
-			if (no_cursor) //If no_cursor, bring back the valeus from the buffers.
-			{
-				_CharCount = cc;
-				_LineCount = lc;
-				_Cursor = c;
-				_HasMore = hm;
 			}
 
 			return word;
 		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace InternalAssembler
+{
+
+	//Names to small ids: the same name always gets the same id, the first one is 0.
+	//Open addressing: a power of two slots, each -1 or the id of a name. A name is in the slot of its hash or in one of the next ones.
+	class SymbolTable
+	{
+	private:
+		std::vector<std::string> _Names; // By id.
+		std::vector<uint32_t> _Hashes; // The same, so growing doesn't hash them again.
+		std::vector<int> _Slots;
+
+		static uint32_t Hash(std::string_view name);
+
+		void Grow();
+
+	public:
+		//The id of name, added if it's not in here yet.
+		int Intern(std::string_view name);
+
+		//-1 if it's not in here.
+		int Find(std::string_view name) const;
+
+		inline const std::string& GetName(int id) const
+		{
+			return _Names[id];
+		}
+
+		inline int GetCount() const
+		{
+			return (int)_Names.size();
+		}
+
+		void Clear();
+	};
+
+	//Values by name, over an outer scope: what isn't defined in here is looked up there.
+	//The program's EQUs, labels and MACROs. A MACRO's arguments, EQUs and labels are a scope over the ones of the file it's used in.
+	template <typename T>
+	class SymbolScope
+	{
+	private:
+		const SymbolScope* _Parent = nullptr;
+
+		SymbolTable _Names;
+		std::vector<T> _Values; // By id.
+
+	public:
+		inline void SetParent(const SymbolScope* parent)
+		{
+			_Parent = parent;
+		}
+
+		//Only what's defined in this one, the outer scope stays.
+		inline void Clear()
+		{
+			_Names.Clear();
+			_Values.clear();
+		}
+
+		//Defines name in this scope, or defines it again.
+		inline void Set(std::string_view name, const T& value)
+		{
+			int id = _Names.Intern(name);
+
+			if (id == (int)_Values.size())
+				_Values.push_back(value);
+			else
+				_Values[id] = value;
+		}
+
+		//Defines name in this scope if it's not defined yet, here or outside. False if it is, the first one stays.
+		inline bool Add(std::string_view name, const T& value)
+		{
+			if (Find(name) != nullptr)
+				return false;
+
+			Set(name, value);
+			return true;
+		}
+
+		//Everything that's defined in other, not in its outer scopes.
+		inline void Merge(const SymbolScope& other)
+		{
+			for (int id = 0; id < other._Names.GetCount(); id++)
+			{
+				Set(other._Names.GetName(id), other._Values[id]);
+			}
+		}
+
+		//nullptr if it's not defined, here or outside.
+		inline const T* Find(std::string_view name) const
+		{
+			for (const SymbolScope* scope = this; scope != nullptr; scope = scope->_Parent)
+			{
+				int id = scope->_Names.Find(name);
+
+				if (id >= 0)
+					return &scope->_Values[id];
+			}
+
+			return nullptr;
+		}
+	};
+}
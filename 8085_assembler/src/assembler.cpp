@@ -1,10 +1,14 @@
 #include "assembler.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "instructions.h"
 #include "Bootloader.h"
@@ -13,28 +17,25 @@
 namespace InternalAssembler
 {
 
-	uint16_t startingAddr = 0x0800;
-	uint16_t currentAddr = 0x0800;
-
-	Assembler::Assembly* currentAssembler;
-
-	void Error(std::string err, std::shared_ptr<SourceFile> source)
+	void Error(AssemblerContext& context, std::string err, std::shared_ptr<SourceFile> source)
 	{
-		//Print and add each error to a list
+		//Add each error to the list of the assembly, only print it in debug: other assemblies may be printing at the same time.
+#ifdef _DEBUG
 		printf("Error: Line %d, Character %d\n%s\n", source->GetLine(), source->GetCharCount(), err.c_str());
-		currentAssembler->Errors.push_back({ source->GetLine(), err });
+#endif
+		context.Result.Errors.push_back({ source->GetLine(), err });
 	}
 
-	void Error(std::string err, int line)
+	void Error(AssemblerContext& context, std::string err, int line)
 	{
 		//Print and add each error to a list
 #ifdef _DEBUG
 		printf("Error: Line %d, Character %d\n%s\n", line, 0, err.c_str());
 #endif
-		currentAssembler->Errors.push_back({ line, err });
+		context.Result.Errors.push_back({ line, err });
 	}
 
-	void ParseIfDirective(std::shared_ptr<SourceFile> source, std::vector<IfExpr>& IfBuffer)
+	void ParseIfDirective(AssemblerContext& context, std::shared_ptr<SourceFile> source, std::vector<IfExpr>& IfBuffer)
 	{
 		std::string word = source->GetLastWord();
 		int ifLine = source->GetLine();
@@ -44,26 +45,26 @@ namespace InternalAssembler
 			std::string first = source->Next();
 			if (first == "")
 			{
-				Error("Expected expression after IF", ifLine);
+				Error(context, "Expected expression after IF", ifLine);
 				return;
 			}
 			std::string _operator = source->Next();
 			if (_operator == "")
 			{
-				Error("Expected expression after IF", ifLine);
+				Error(context, "Expected expression after IF", ifLine);
 				return;
 			}
 			std::string other = source->Next();
 			if (other == "")
 			{
-				Error("Expected expression after IF", ifLine);
+				Error(context, "Expected expression after IF", ifLine);
 				return;
 			}
 
 			if (isNumber(first) && isNumber(other))
 			{
-				uint16_t first_numeric = StringToUInt16(first, source);
-				uint16_t other_numeric = StringToUInt16(other, source);
+				uint16_t first_numeric = StringToUInt16(context, first, source);
+				uint16_t other_numeric = StringToUInt16(context, other, source);
 				if (_operator == "EQ")
 				{
 					IfBuffer.push_back({ first_numeric == other_numeric, false });
@@ -90,7 +91,7 @@ namespace InternalAssembler
 				}
 				else
 				{
-					Error("Unknown operator " + _operator + " between numbers", source);
+					Error(context, "Unknown operator " + _operator + " between numbers", source);
 				}
 			}
 			else if (!isNumber(first) && !isNumber(other))
@@ -105,7 +106,7 @@ namespace InternalAssembler
 				}
 				else
 				{
-					Error("Unknown operator " + _operator + " between literals", source);
+					Error(context, "Unknown operator " + _operator + " between literals", source);
 				}
 			}
 			else
@@ -118,18 +119,18 @@ namespace InternalAssembler
 				{
 					IfBuffer.push_back({ true, false });
 				}
-				//Error("Unable to compare literal and number.", source);
+				//Error(context, "Unable to compare literal and number.", source);
 			}
 		}
 		else if (word == "ELSE")
 		{
 			if (IfBuffer.size() == 0)
 			{
-				Error("Unexpected ELSE; Expecting IF before ELSE", source);
+				Error(context, "Unexpected ELSE; Expecting IF before ELSE", source);
 			}
 			else if (IfBuffer.at(IfBuffer.size() - 1).isElse)
 			{
-				Error("Unexpected ELSE; Expecting IF before ELSE", source);
+				Error(context, "Unexpected ELSE; Expecting IF before ELSE", source);
 			}
 			else
 			{
@@ -151,7 +152,7 @@ namespace InternalAssembler
 		{
 			if (IfBuffer.size() == 0)
 			{
-				Error("Unexpected ENDIF; Expecting IF before ENDIF", source);
+				Error(context, "Unexpected ENDIF; Expecting IF before ENDIF", source);
 			}
 			else
 			{
@@ -205,7 +206,7 @@ namespace InternalAssembler
 		return true;
 	}
 
-	uint8_t StringToUInt8(std::string str, std::shared_ptr<SourceFile> source)
+	uint8_t StringToUInt8(AssemblerContext& context, std::string str, std::shared_ptr<SourceFile> source)
 	{
 		if (str.length() == 0)
 		{
@@ -224,7 +225,7 @@ namespace InternalAssembler
 			}
 			catch (...)
 			{
-				Error("Expected hex number, got: " + str, source);
+				Error(context, "Expected hex number, got: " + str, source);
 				return 0;
 			}
 
@@ -243,7 +244,7 @@ namespace InternalAssembler
 			}
 			catch (...)
 			{
-				Error("Expected binary number, got: " + str, source);
+				Error(context, "Expected binary number, got: " + str, source);
 				return 0;
 			}
 
@@ -266,7 +267,7 @@ namespace InternalAssembler
 		}
 		catch (...)
 		{
-			Error("Expected dec number, got: " + str, source);
+			Error(context, "Expected dec number, got: " + str, source);
 			return 0;
 		}
 
@@ -277,7 +278,7 @@ namespace InternalAssembler
 	}
 
 	//Same exact thing, but with uint16_t number.
-	uint16_t StringToUInt16(std::string str, std::shared_ptr<SourceFile> source, bool noerrors, bool* NaN)
+	uint16_t StringToUInt16(AssemblerContext& context, std::string str, std::shared_ptr<SourceFile> source, bool noerrors, bool* NaN)
 	{
 		if (str.length() == 0)
 		{
@@ -296,7 +297,7 @@ namespace InternalAssembler
 			catch (...)
 			{
 				if (!noerrors)
-					Error("Expected hex number, got: " + str, source);
+					Error(context, "Expected hex number, got: " + str, source);
 				else if (NaN != nullptr)
 					*NaN = true;
 				return 0;
@@ -322,7 +323,7 @@ namespace InternalAssembler
 			catch (...)
 			{
 				if (!noerrors)
-					Error("Expected binary number, got: " + str, source);
+					Error(context, "Expected binary number, got: " + str, source);
 				else if (NaN != nullptr)
 					*NaN = true;
 				return 0;
@@ -345,7 +346,7 @@ namespace InternalAssembler
 		catch (...)
 		{
 			if (!noerrors)
-				Error("Expected dec number, got: " + str, source);
+				Error(context, "Expected dec number, got: " + str, source);
 			else if (NaN != nullptr)
 				*NaN = true;
 			return 0;
@@ -359,17 +360,61 @@ namespace InternalAssembler
 		return result;
 	}
 
+	//The bootloader, assembled. It's the same for every program, so it's assembled once and every program starts from a copy of it.
+	struct BootloaderImage
+	{
+		Assembler::Assembly Program; // Its memory and labels.
+
+		SymbolScope<uint16_t> Labels;
+		SymbolScope<std::string> Equ;
+
+		uint16_t EndAddr = 0; // Where a program starts if it doesn't ORG.
+	};
+
+	static const BootloaderImage& GetBootloaderImage()
+	{
+		//Assembled by the first assembly that needs it, the others wait for it. Never changed after.
+		static const BootloaderImage image = []()
+		{
+			BootloaderImage image;
+			AssemblerContext context(image.Program);
+
+			image.Program.Memory = std::shared_ptr<uint8_t>((uint8_t*)calloc(0xffff + 1, sizeof(uint8_t)), free);
+
+			if (image.Program.Memory == nullptr)
+			{
+				perror("Unable to allocate memory");
+				exit(1);
+			}
+
+			std::shared_ptr<SourceFile> bl = std::make_shared<SourceFile>(Bootloader);
+			parse(context, bl, false, true);
+
+			image.Labels = context.ProgramLabels;
+			image.Equ = bl->_Equ;
+			image.EndAddr = context.CurrentAddr;
+
+			return image;
+		}();
+
+		return image;
+	}
+
 	//Parse the file first, looking for labels and calculating their location in memory. This is my "scanning" mode.
 	//We do this so we can use a label before we declare it.
 	//Otherwise, we wouldn't be able to use a label that's BELOW the code we're currently writing in a file.
 	// Same for EQU and MACROs
 	//And then actually parse the file.
-	std::shared_ptr<uint8_t> parse(std::shared_ptr<SourceFile> source, Assembler::Assembly& result, bool scanning, bool bootloader)
+	std::shared_ptr<uint8_t> parse(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool scanning, bool bootloader)
 	{
+		Assembler::Assembly& result = context.Result;
+
 		if (!scanning && !bootloader)
 		{
+			const BootloaderImage& bl = GetBootloaderImage();
 
-			result.Memory = std::shared_ptr<uint8_t>((uint8_t*)calloc(0xffff + 1, sizeof(uint8_t)), free);
+			//No need to clear it, all of it is copied over.
+			result.Memory = std::shared_ptr<uint8_t>((uint8_t*)malloc(0xffff + 1), free);
 
 			//If we failed to allocate memory.
 			//TODO Probably should throw error instead of crashing...
@@ -379,35 +424,36 @@ namespace InternalAssembler
 				exit(1);
 			}
 
-			currentAddr = startingAddr;
+			memcpy(result.Memory.get(), bl.Program.Memory.get(), 0xffff + 1);
 
-			std::shared_ptr<SourceFile> bl = std::make_shared<SourceFile>(Bootloader);
-			parse(bl, result, false, true);
+			context.CurrentAddr = bl.EndAddr;
 
-			for (int i = 0; i < bl->_Equ.size(); i++)
-			{
-				source->_Equ.push_back(bl->_Equ.at(i));
-			}
+			//The bootloader's labels and EQUs are shared by every program. Ours are defined over them.
+			context.ProgramLabels.Clear();
+			context.ProgramLabels.SetParent(&bl.Labels);
+			context.CurrentLabels = &context.ProgramLabels;
+			context.Macros.Clear();
 
+			source->_Equ.SetParent(&bl.Equ);
+
+			result.Labels = bl.Program.Labels;
 			result.Symbols.clear();
 		}
 
-		currentAssembler = &result;
-
-		//currentAddr = startingAddr;
-		uint16_t addr = currentAddr;
+		//context.CurrentAddr = context.StartingAddr;
+		uint16_t addr = context.CurrentAddr;
 
 		//Scan for labels
 		if (!scanning)
 		{
-			parse(source, result, true, bootloader);
+			parse(context, source, true, bootloader);
 		}
 
 		source->ResetFile();
 
 
-		//Reset currentAddr after scanning for labels.
-		currentAddr = addr;
+		//Reset the current address after scanning for labels.
+		context.CurrentAddr = addr;
 
 		bool ended = false;
 
@@ -419,9 +465,12 @@ namespace InternalAssembler
 
 			if (word == "") { continue; }
 
-			else if (word == "IF" || word == "ELSE" || word == "ENDIF")
+			const Instruction* instruction = FindInstruction(word);
+			Directives directive = instruction != nullptr ? instruction->DIRECTIVE : Directives::None;
+
+			if (directive == Directives::IF || directive == Directives::ELSE || directive == Directives::ENDIF)
 			{
-				ParseIfDirective(source, result.IfBuffer);
+				ParseIfDirective(context, source, result.IfBuffer);
 				continue;
 			}
 
@@ -436,50 +485,42 @@ namespace InternalAssembler
 
 			//-----------------------------------------------------------
 
-			bool found = false;
-			int i = 0;
-			while (i < 0xff && !found)
+			bool found = instruction != nullptr && instruction->ACTION != nullptr;
+
+			if (found)
 			{
-				if (Instructions[i].OPERAND == word)
+				if (!scanning)
 				{
-					found = true;
-					if (!scanning)
-					{
-						result.Symbols.push_back({ currentAddr, source->GetLine() }); //So we know which instruction corresponds to which line
-						bool ret = Instructions[i].ACTION(Instructions[i].bytes, source, result.Memory.get() + currentAddr); // Not really using ret. . .
-					}
-					currentAddr += Instructions[i].bytes;
+					result.Symbols.push_back({ context.CurrentAddr, source->GetLine() }); //So we know which instruction corresponds to which line
+					bool ret = instruction->ACTION(context, instruction->bytes, source, result.Memory.get() + context.CurrentAddr); // Not really using ret. . .
 				}
-
-				i++;
+				context.CurrentAddr += instruction->bytes;
 			}
-
-			if (found) {}
-			else if (word == "ORG")
+			else if (directive == Directives::ORG)
 			{
 				//Read address
 				std::string addrStr = source->Next();
 
 				//Convert to uint16_t
-				uint16_t addr = StringToUInt16(addrStr, source);
+				uint16_t addr = StringToUInt16(context, addrStr, source);
 
-				//Make it the currentAddr
-				currentAddr = addr;
+				//Make it the current address
+				context.CurrentAddr = addr;
 			}
 			else if (source->NextNoCursor() == "EQU")  //If the NEXT word is "EQU", but don't increment the cursor on SourceFile.
 			{
 				if (scanning)
 				{
-					std::string label = word; //Label of EQU is our current word.
+					std::string label = source->GetLastText(); //Label of EQU is our current word, as it is written: an EQU can be defined again, e.g. in a MACRO.
 					source->Next(); // We ignore next word, we know it's "EQU"
 					std::string val = source->Next(); //Value of EQU is the 3rd word.
 
 					if (val.empty())
 					{
-						Error("Expected a value after EQU", source);
+						Error(context, "Expected a value after EQU", source);
 					}
 
-					source->_Equ.push_back({ label, val });
+					source->_Equ.Set(label, val);
 				}
 				else
 				{
@@ -491,12 +532,13 @@ namespace InternalAssembler
 			{
 				if (scanning)
 				{
-					Macro* macro = new Macro(word, source);
+					Macro* macro = new Macro(context, word, source);
 					result.Macros.push_back(macro);
+					context.Macros.Add(word, macro);
 				}
 				else
 				{
-					source->ReadRawUntil("ENDM");
+					source->SkipUntil("ENDM");
 				}
 			}
 			else if (word[word.length() - 1] == ':')
@@ -507,27 +549,24 @@ namespace InternalAssembler
 					{
 						std::string label = word.substr(0, word.length() - 1);
 
-						for (int i = 0; i < result.Labels.size(); i++)
+						if (!context.ProgramLabels.Add(label, context.CurrentAddr - 1))
 						{
-							if (result.Labels.at(i).first == label)
-							{
-								Error("Label " + label + " already exists", source);
-							}
+							Error(context, "Label " + label + " already exists", source);
 						}
 
-						result.Labels.push_back({ label, currentAddr - 1 });
+						result.Labels.push_back({ label, context.CurrentAddr - 1 });
 					}
 					else
 					{
-						Error("Expected a name for the label", source);
+						Error(context, "Expected a name for the label", source);
 					}
 				}
 			}
-			else if (word == "END") // Not needed, but want to be fully compatible with microlab.
+			else if (directive == Directives::END) // Not needed, but want to be fully compatible with microlab.
 			{
 				ended = true;
 			}
-			else if (word == "DB") //DB saves one or more bytes in current memory address and forward
+			else if (directive == Directives::DB) //DB saves one or more bytes in current memory address and forward
 			{
 				if (scanning) continue; // Potential problems if someone has DB/DW randomly inside their code.
 
@@ -537,84 +576,81 @@ namespace InternalAssembler
 				{
 					if (nextWord.length() != 3)
 					{
-						Error("Expected ONE character and closing apostrophe", source);
+						Error(context, "Expected ONE character and closing apostrophe", source);
 					}
 
 					if (nextWord[nextWord.length() - 1] != '\'') //And it also ends with '
 					{
-						Error("Expected closing apostrophe", source);
+						Error(context, "Expected closing apostrophe", source);
 					}
 
 					std::string numStr = nextWord.substr(1, nextWord.length() - 2);
 
-					result.Memory.get()[currentAddr++] = numStr[0];
+					result.Memory.get()[context.CurrentAddr++] = numStr[0];
 				}
 				else if (nextWord[0] == '\"') // If it starts with ", it is a string and has to also end with "
 				{
 					if (nextWord.length() < 2) //Length could be anything
 					{
-						Error("Expected at least one character and closing double apostrophe", source);
+						Error(context, "Expected at least one character and closing double apostrophe", source);
 					}
 
 					if (nextWord[nextWord.length() - 1] != '\"')
 					{
-						Error("Expected closing double apostrophe", source);
+						Error(context, "Expected closing double apostrophe", source);
 					}
 
 					std::string numStr = nextWord.substr(1, nextWord.length() - 2); //Whatever the DB contained, without the "
 
 					for (int i = 0; i < numStr.length(); i++) //Add it all to memory.
 					{
-						result.Memory.get()[currentAddr++] = numStr[i];
+						result.Memory.get()[context.CurrentAddr++] = numStr[i];
 					}
 				}
 				else //Otherwise, we expect an 8bit number.
 				{
-					result.Memory.get()[currentAddr++] = StringToUInt8(nextWord, source);
+					result.Memory.get()[context.CurrentAddr++] = StringToUInt8(context, nextWord, source);
 				}
 			}
-			else if (word == "DW") //DW get's a 16 bit number.
+			else if (directive == Directives::DW) //DW get's a 16 bit number.
 			{
 				if (scanning) continue;
 
-				uint16_t addr = GetImmediate16(source);
+				uint16_t addr = GetImmediate16(context, source);
 
 				uint8_t HIGH = (addr >> 8) & 0xff;
 				uint8_t LOW = addr & 0xff;
 
 				//TODO: LITTLE/BIG endian??
 
-				result.Memory.get()[currentAddr++] = LOW;
-				result.Memory.get()[currentAddr++] = HIGH;
+				result.Memory.get()[context.CurrentAddr++] = LOW;
+				result.Memory.get()[context.CurrentAddr++] = HIGH;
 			}
 			else
 			{
-				found = false;
+				Macro* const* macro = context.Macros.Find(word);
+				found = macro != nullptr;
 
-				for (int i = 0; i < result.Macros.size(); i++)
+				if (found)
 				{
-					if (result.Macros.at(i)->Name == word)
+					if (scanning)
 					{
-						found = true;
-						if (scanning)
-						{
-							currentAddr = result.Macros.at(i)->Parse(source, currentAddr, result, true);
-						}
-						else
-						{
-							currentAddr = result.Macros.at(i)->Parse(source, currentAddr, result);
+						context.CurrentAddr = (*macro)->Parse(context, source, context.CurrentAddr, true);
+					}
+					else
+					{
+						context.CurrentAddr = (*macro)->Parse(context, source, context.CurrentAddr);
 
-							for (int j = 0; j < result.Macros.at(i)->GetSymbols().size(); j++)
-							{
-								result.Symbols.push_back(result.Macros.at(i)->GetSymbols().at(j)); // Get the Symbols from inside the MACRO.
-							}
+						for (int j = 0; j < (*macro)->GetSymbols().size(); j++)
+						{
+							result.Symbols.push_back((*macro)->GetSymbols().at(j)); // Get the Symbols from inside the MACRO.
 						}
 					}
 				}
 
 				if (!found && !scanning)
 				{
-					Error("Unexpected " + word, source);
+					Error(context, "Unexpected " + word, source);
 				}
 			}
 		}
@@ -626,6 +662,8 @@ namespace InternalAssembler
 				delete result.Macros.at(0);
 				result.Macros.erase(result.Macros.begin());
 			}
+
+			context.Macros.Clear();
 		}
 
 		return nullptr;
@@ -659,12 +697,49 @@ std::shared_ptr<InternalAssembler::SourceFile> Assembler::ReadSourceFile(std::st
 
 std::shared_ptr<uint8_t> Assembler::GetAssembledMemory(std::shared_ptr<InternalAssembler::SourceFile> source, Assembler::Assembly& result) //Helper function to convert SourceFile* to assembled memory
 {
-	return parse(source, result);
+	InternalAssembler::AssemblerContext context(result);
+
+	return parse(context, source);
 }
 
 std::shared_ptr<uint8_t> Assembler::GetAssembledMemory(std::string code, Assembler::Assembly& result) //Helper function to convert the code to assembled memory
 {
 	std::shared_ptr<InternalAssembler::SourceFile> source = std::make_shared<InternalAssembler::SourceFile>(code);
 
-	return InternalAssembler::parse(source, result);
+	InternalAssembler::AssemblerContext context(result);
+
+	return InternalAssembler::parse(context, source);
+}
+
+std::vector<Assembler::Assembly> Assembler::AssembleMany(const std::vector<std::string>& codes, unsigned int threads)
+{
+	std::vector<Assembler::Assembly> results(codes.size());
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	threads = (unsigned int)std::min<size_t>(threads, codes.size());
+
+	//Each thread takes the next code nobody took yet, until there are none left.
+	std::atomic<size_t> next = 0;
+
+	auto work = [&]()
+	{
+		for (size_t i = next++; i < codes.size(); i = next++)
+		{
+			GetAssembledMemory(codes[i], results[i]);
+		}
+	};
+
+	std::vector<std::thread> workers;
+
+	for (unsigned int i = 1; i < threads; i++)
+		workers.emplace_back(work);
+
+	work(); // This thread is one of them too.
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	return results;
 }
\ No newline at end of file
@@ -13,27 +13,22 @@ namespace InternalAssembler
 
     //The entire instruction set, used in assembling the binary from text.
 
-    uint16_t FindLabel(const std::string& label, std::shared_ptr<SourceFile> source)
+    uint16_t FindLabel(AssemblerContext& context, const std::string& label, std::shared_ptr<SourceFile> source)
     {
-        //Loop all labels to find the address associated with it.
+        //Find the address associated with the label.
         //If not found, show an error.
 
-        auto labels = currentAssembler->Labels;
-
-        for (int i = 0; i < labels.size(); i++)
+        if (const uint16_t* addr = context.CurrentLabels->Find(label))
         {
-            if (labels.at(i).first == label)
-            {
-                return labels.at(i).second;
-            }
+            return *addr;
         }
 
-        Error("Label: " + label + " not found!", source);
+        Error(context, "Label: " + label + " not found!", source);
 
         return 0;
     }
 
-    uint8_t GetNextRegister(std::shared_ptr<SourceFile> source, bool a, bool m)
+    uint8_t GetNextRegister(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool a, bool m)
     {
         //Read the next word in the source code.
         //Return a number 0-7 depending on the register (B=0, . . . , A=7)
@@ -45,7 +40,7 @@ namespace InternalAssembler
         std::string str = source->Next();
         if (str.length() != 1)
         {
-            Error("Expected Register: " + str, source);
+            Error(context, "Expected Register: " + str, source);
             return false;
         }
     
@@ -55,7 +50,7 @@ namespace InternalAssembler
             if (a)
                 return 7;
             else
-                Error("Can't use register A for this operation", source);
+                Error(context, "Can't use register A for this operation", source);
             break;
         case 'B':
             return 0;
@@ -73,16 +68,16 @@ namespace InternalAssembler
             if (m)
                 return 6;
             else
-                Error("Can't use register M for this operation", source);
+                Error(context, "Can't use register M for this operation", source);
             return 0;
         default:
-            Error("Unknown Register: " + str.substr(0,1), source);
+            Error(context, "Unknown Register: " + str.substr(0,1), source);
             return 0;
         }
         return 0;
     }
 
-    uint8_t GetNextDoubleRegister(std::shared_ptr<SourceFile> source, bool h, bool sp, bool psw)
+    uint8_t GetNextDoubleRegister(AssemblerContext& context, std::shared_ptr<SourceFile> source, bool h, bool sp, bool psw)
     {
         //Read the next word in the source code.
         //Return a number corresponding to double register 
@@ -105,7 +100,7 @@ namespace InternalAssembler
 
         if (str.length() != 1)
         {
-            Error("Expected Double Register: " + str, source);
+            Error(context, "Expected Double Register: " + str, source);
             return false;
         }
     
@@ -119,14 +114,14 @@ namespace InternalAssembler
             if (h)
                 return 0x20;
             else
-                Error("Can't use double register H in this operation", source);
+                Error(context, "Can't use double register H in this operation", source);
         default:
-            Error("Unknown Double Register: " + str.substr(0,1), source);
+            Error(context, "Unknown Double Register: " + str.substr(0,1), source);
             return 0;
         }
     }
 
-    uint8_t GetImmediate8(std::shared_ptr<SourceFile> source)
+    uint8_t GetImmediate8(AssemblerContext& context, std::shared_ptr<SourceFile> source)
     {
         //Get the next word in the source file. 
         //If it doesn't exist, error.
@@ -136,13 +131,13 @@ namespace InternalAssembler
 
         if (nextWord.length() == 0)
         {
-            Error("Expected a number", source);
+            Error(context, "Expected a number", source);
         }
 
-        return StringToUInt8(nextWord, source);
+        return StringToUInt8(context, nextWord, source);
     }
 
-    uint16_t GetImmediate16(std::shared_ptr<SourceFile> source)
+    uint16_t GetImmediate16(AssemblerContext& context, std::shared_ptr<SourceFile> source)
     {
         //Get the next word in the source file. 
         //If it doesn't exist, error.
@@ -152,10 +147,10 @@ namespace InternalAssembler
 
         if (nextWord.length() == 0)
         {
-            Error("Expected a number", source);
+            Error(context, "Expected a number", source);
         }
 
-        return StringToUInt16(nextWord, source);
+        return StringToUInt16(context, nextWord, source);
     }
 
     //_Memory[0] ALWAYS points to CURRENT MEMORY ADDRESS.
@@ -163,15 +158,15 @@ namespace InternalAssembler
     //So _Memory[0] should ALWAYS be the OPCODE
     //And subsequent addresses should be the data needed by the operand
 
-    bool ACI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ACI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xCE;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool ADC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ADC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         //Opcodes have an offset of 1.
         //For example:
@@ -179,42 +174,42 @@ namespace InternalAssembler
         //ADC C = 0x89
         //....
 
-        uint8_t opcode = 0x88 + GetNextRegister(source);
+        uint8_t opcode = 0x88 + GetNextRegister(context, source);
         _Memory[0] = opcode;
 
         return true;
     }
 
-    bool ADD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ADD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        uint8_t opcode = 0x80 + GetNextRegister(source);
+        uint8_t opcode = 0x80 + GetNextRegister(context, source);
         _Memory[0] = opcode;
         return true;
     }
 
-    bool ADI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ADI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xc6;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool ANA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ANA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        uint8_t opcode = 0xA0 + GetNextRegister(source);
+        uint8_t opcode = 0xA0 + GetNextRegister(context, source);
         _Memory[0] = opcode;
         return true;
     }
 
-    bool ANI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ANI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xe6;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
         return true;
     }
 
-    bool CALL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CALL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xcd;
 
@@ -222,7 +217,7 @@ namespace InternalAssembler
         std::string label = source->Next();
 
         //Find label will do the error checking for us.
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -235,13 +230,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xdc;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -252,13 +247,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xfc;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -268,32 +263,32 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CMA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CMA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x2f;
         return true;
     }
 
-    bool CMC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CMC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x3f;
         return true;
     }
 
-    bool CMP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CMP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        uint8_t opcode = 0xB8 + GetNextRegister(source);
+        uint8_t opcode = 0xB8 + GetNextRegister(context, source);
         _Memory[0] = opcode;
         return true;
     }
 
-    bool CNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xd4;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -303,13 +298,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xc4;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -319,13 +314,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xf4;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -335,13 +330,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xec;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -351,21 +346,21 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CPI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CPI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xfe;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool CPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xe4;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -375,13 +370,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool CZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool CZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = (uint8_t)0xcc;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -391,85 +386,85 @@ namespace InternalAssembler
         return true;
     }
 
-    bool DAA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DAA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x27;
 
         return true;
     }
 
-    bool DAD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DAD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         //Offset for double registers is always 0x10, so it returns a value based on that.
-        _Memory[0] = 0x09 + GetNextDoubleRegister(source);
+        _Memory[0] = 0x09 + GetNextDoubleRegister(context, source);
         return true;
     }
 
-    bool DCR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DCR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         //Offset between registers here is 0x08.
         //GetNextRegister return a number assuming an offset of 1
         //So we multiply by 0x08.
-        _Memory[0] = 0x05 + (GetNextRegister(source) * 0x08);
+        _Memory[0] = 0x05 + (GetNextRegister(context, source) * 0x08);
 
         return true;
     }
 
-    bool DCX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DCX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x0b + GetNextDoubleRegister(source);
+        _Memory[0] = 0x0b + GetNextDoubleRegister(context, source);
 
         return true;
     }
 
-    bool DI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf3;
         return true;
     }
 
-    bool EI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool EI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xfb;
         return true;
     }
 
-    bool HLT(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool HLT(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x76;
 
         return true;
     }
 
-    bool IN(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool IN(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xdb;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool INR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool INR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x04 + (GetNextRegister(source) * 0x08);
+        _Memory[0] = 0x04 + (GetNextRegister(context, source) * 0x08);
 
         return true;
     }
 
-    bool INX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool INX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x03 + GetNextDoubleRegister(source);
+        _Memory[0] = 0x03 + GetNextDoubleRegister(context, source);
 
         return true;
     }
 
-    bool JC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xda;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -480,13 +475,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xfa;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -498,7 +493,7 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JMP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JMP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xc3;
 
@@ -507,9 +502,9 @@ namespace InternalAssembler
         //Ability to JMP to an address hacked in.
         bool NaN;
 
-        uint16_t addr = StringToUInt16(label, source, true, &NaN);
+        uint16_t addr = StringToUInt16(context, label, source, true, &NaN);
         if (NaN)
-            addr = FindLabel(label, source);
+            addr = FindLabel(context, label, source);
         else
             addr = addr - 1;
 
@@ -522,13 +517,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xd2;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -539,13 +534,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xc2;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -556,13 +551,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf2;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -573,13 +568,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xea;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -590,13 +585,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xe2;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -607,13 +602,13 @@ namespace InternalAssembler
         return true;
     }
 
-    bool JZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool JZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xca;
 
         std::string label = source->Next();
 
-        uint16_t addr = FindLabel(label, source);
+        uint16_t addr = FindLabel(context, label, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -624,11 +619,11 @@ namespace InternalAssembler
         return true;
     }
 
-    bool LDA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool LDA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x3a;
 
-        uint16_t addr = GetImmediate16(source);
+        uint16_t addr = GetImmediate16(context, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -639,20 +634,20 @@ namespace InternalAssembler
         return true;
     }
 
-    bool LDAX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool LDAX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x0a + GetNextDoubleRegister(source, false);
+        _Memory[0] = 0x0a + GetNextDoubleRegister(context, source, false);
 
         return true;
     }
 
-    bool LHLD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool LHLD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x2a;
 
         //std::string label = source->Next();
-        //uint16_t addr = FindLabel(label, source);
-        uint16_t addr = GetImmediate16(source);
+        //uint16_t addr = FindLabel(context, label, source);
+        uint16_t addr = GetImmediate16(context, source);
 
 
         uint8_t HIGH = (addr >> 8) & 0xff;
@@ -663,21 +658,21 @@ namespace InternalAssembler
         return true;
     }
 
-    bool LXI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool LXI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x01 + GetNextDoubleRegister(source, true, true);
+        _Memory[0] = 0x01 + GetNextDoubleRegister(context, source, true, true);
 
-        //uint16_t addr = GetImmediate16(source);
+        //uint16_t addr = GetImmediate16(context, source);
         std::string val = source->NextNoCursor();
         uint16_t addr;
         if (!isNumber(val))
         {
             source->Next();
-            addr = FindLabel(val, source);
+            addr = FindLabel(context, val, source);
         }
         else
         {
-            addr = GetImmediate16(source);
+            addr = GetImmediate16(context, source);
         }
 
         uint8_t HIGH = (addr >> 8) & 0xff;
@@ -689,18 +684,18 @@ namespace InternalAssembler
         return true;
     }
 
-    bool MOV(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool MOV(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         //It has weird offsets, and the operand is vastly different depending on First Register and Second Register
         //Does not allow M,M.
 
-        uint8_t firstR = GetNextRegister(source);
-        uint8_t secondR = GetNextRegister(source);
+        uint8_t firstR = GetNextRegister(context, source);
+        uint8_t secondR = GetNextRegister(context, source);
         if (firstR == 6)
         {
             if (secondR == 6)
             {
-                Error("MOV M,M is invalid", source);
+                Error(context, "MOV M,M is invalid", source);
             }
             _Memory[0] = 0x70 + secondR;
         }
@@ -715,169 +710,169 @@ namespace InternalAssembler
         return true;
     }
 
-    bool MVI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool MVI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x06 + (GetNextRegister(source) * 0x08);
-        _Memory[1] = GetImmediate8(source);
+        _Memory[0] = 0x06 + (GetNextRegister(context, source) * 0x08);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool NOP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool NOP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x00;
         return true;
     }
 
-    bool ORA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ORA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0xb0 + GetNextRegister(source);
+        _Memory[0] = 0xb0 + GetNextRegister(context, source);
         return true;
     }
 
-    bool ORI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool ORI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf6;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool OUT(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool OUT(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xd3;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool PCHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool PCHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xe9;
 
         return true;
     }
 
-    bool POP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool POP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0xc1 + GetNextDoubleRegister(source, true, false, true);
+        _Memory[0] = 0xc1 + GetNextDoubleRegister(context, source, true, false, true);
 
         return true;
     }
 
-    bool PUSH(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool PUSH(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0xc5 + GetNextDoubleRegister(source, true, false, true);
+        _Memory[0] = 0xc5 + GetNextDoubleRegister(context, source, true, false, true);
 
         return true;
     }
 
-    bool RAL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RAL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x17;
 
         return true;
     }
 
-    bool RAR(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RAR(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf1;
 
         return true;
     }
 
-    bool RC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xd8;
 
         return true;
     }
 
-    bool RET(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RET(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xc9;
 
         return true;
     }
 
-    bool RIM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RIM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x20;
 
         return true;
     }
 
-    bool RLC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RLC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x07;
 
         return true;
     }
 
-    bool DSUB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool DSUB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x08;
 
         return true;
     }
 
-    bool RM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf8;
 
         return true;
     }
 
-    bool RNC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RNC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xd0;
 
         return true;
     }
 
-    bool RNZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RNZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xc0;
 
         return true;
     }
 
-    bool RP(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RP(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf0;
 
         return true;
     }
 
-    bool RPE(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RPE(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xe8;
 
         return true;
     }
 
-    bool RPO(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RPO(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xe0;
 
         return true;
     }
 
-    bool RRC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RRC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x0f;
 
         return true;
     }
 
-    bool RST(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RST(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         //Just check next number.
 
         std::string str = source->Next();
         if (str.length() != 1)
         {
-            Error("Expected number between 0-7: " + str, source);
+            Error(context, "Expected number between 0-7: " + str, source);
             return false;
         }
     
@@ -908,39 +903,39 @@ namespace InternalAssembler
             _Memory[0] = 0xff;
             return true;
         default:
-            Error("Expected number (0-7): " + str.substr(0,1), source);
+            Error(context, "Expected number (0-7): " + str.substr(0,1), source);
             return 0;
         }
 
         return true;
     }
 
-    bool RZ(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool RZ(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xc8;
 
         return true;
     }
 
-    bool SBB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SBB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x98 + GetNextRegister(source);
+        _Memory[0] = 0x98 + GetNextRegister(context, source);
 
         return true;
     }
 
-    bool SBI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SBI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xde;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool SHLD(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SHLD(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x22;
-        uint16_t addr = GetImmediate16(source);
+        uint16_t addr = GetImmediate16(context, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -951,25 +946,25 @@ namespace InternalAssembler
         return true;
     }
 
-    bool SIM(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SIM(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x30;
 
         return true;
     }
 
-    bool SPHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SPHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xf9;
 
         return true;
     }
 
-    bool STA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool STA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x32;
 
-        uint16_t addr = GetImmediate16(source);
+        uint16_t addr = GetImmediate16(context, source);
 
         uint8_t HIGH = (addr >> 8) & 0xff;
         uint8_t LOW = addr & 0xff;
@@ -980,322 +975,258 @@ namespace InternalAssembler
         return true;
     }
 
-    bool STAX(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool STAX(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x02 + GetNextDoubleRegister(source, false);
+        _Memory[0] = 0x02 + GetNextDoubleRegister(context, source, false);
         return true;
     }
 
-    bool STC(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool STC(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0x37;
 
         return true;
     }
 
-    bool SUB(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SUB(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0x90 + GetNextRegister(source);
+        _Memory[0] = 0x90 + GetNextRegister(context, source);
 
         return true;
     }
 
-    bool SUI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool SUI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xd6;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool XCHG(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool XCHG(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xeb;
 
         return true;
     }
 
-    bool XRA(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool XRA(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
-        _Memory[0] = 0xa8 + GetNextRegister(source);
+        _Memory[0] = 0xa8 + GetNextRegister(context, source);
 
         return true;
     }
 
-    bool XRI(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool XRI(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xee;
-        _Memory[1] = GetImmediate8(source);
+        _Memory[1] = GetImmediate8(context, source);
 
         return true;
     }
 
-    bool XTHL(int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
+    bool XTHL(AssemblerContext& context, int bytes, std::shared_ptr<SourceFile> source, uint8_t* _Memory)
     {
         _Memory[0] = 0xe3;
 
         return true;
     }
 
-    //Made using a python script and a list of all instructions
-
-    Instruction Instructions[] = {
-        {0x0, "NOP", 1, NOP, ""},
-        {0x1, "LXI", 3, LXI, "B"},
-        {0x2, "STAX", 1, STAX, "B"},
-        {0x3, "INX", 1, INX, "B"},
-        {0x4, "INR", 1, INR, "B"},
-        {0x5, "DCR", 1, DCR, "B"},
-        {0x6, "MVI", 2, MVI, "B N"},
-        {0x7, "RLC", 1, RLC, ""},
-        {0x8, "DSUB", 1, DSUB, ""},
-        {0x9, "DAD", 1, DAD, "B"},
-        {0xa, "LDAX", 1, LDAX, "B"},
-        {0xb, "DCX", 1, DCX, "B"},
-        {0xc, "INR", 1, INR, "C"},
-        {0xd, "DCR", 1, DCR, "C"},
-        {0xe, "MVI", 2, MVI, "C N"},
-        {0xf, "RRC", 1, RRC, ""},
-        {},
-        {0x11, "LXI", 3, LXI, "D"},
-        {0x12, "STAX", 1, STAX, "D"},
-        {0x13, "INX", 1, INX, "D"},
-        {0x14, "INR", 1, INR, "D"},
-        {0x15, "DCR", 1, DCR, "D"},
-        {0x16, "MVI", 2, MVI, "D N"},
-        {0x17, "RAL", 1, RAL, ""},
-        {},
-        {0x19, "DAD", 1, DAD, "D"},
-        {0x1a, "LDAX", 1, LDAX, "D"},
-        {0x1b, "DCX", 1, DCX, "D"},
-        {0x1c, "INR", 1, INR, "E"},
-        {0x1d, "DCR", 1, DCR, "E"},
-        {0x1e, "MVI", 2, MVI, "E N"},
-        {0x1f, "RAR", 1, RAR, ""},
-        {0x20, "RIM", 1, RIM, ""},
-        {0x21, "LXI", 3, LXI, "H"},
-        {0x22, "SHLD", 3, SHLD, "Ad"},
-        {0x23, "INX", 1, INX, "H"},
-        {0x24, "INR", 1, INR, "H"},
-        {0x25, "DCR", 1, DCR, "H"},
-        {0x26, "MVI", 2, MVI, "H N"},
-        {0x27, "DAA", 1, DAA, ""},
-        {},
-        {0x29, "DAD", 1, DAD, "H"},
-        {0x2a, "LHLD", 3, LHLD, "Ad"},
-        {0x2b, "DCX", 1, DCX, "H"},
-        {0x2c, "INR", 1, INR, "L"},
-        {0x2d, "DCR", 1, DCR, "L"},
-        {0x2e, "MVI", 2, MVI, "L N"},
-        {0x2f, "CMA", 1, CMA, ""},
-        {0x30, "SIM", 1, SIM, ""},
-        {0x31, "LXI", 3, LXI, "SP"},
-        {0x32, "STA", 3, STA, "Ad"},
-        {0x33, "INX", 1, INX, "SP"},
-        {0x34, "INR", 1, INR, "M"},
-        {0x35, "DCR", 1, DCR, "M"},
-        {0x36, "MVI", 2, MVI, "M N"},
-        {0x37, "STC", 1, STC, ""},
-        {},
-        {0x39, "DAD", 1, DAD, "SP"},
-        {0x3a, "LDA", 3, LDA, "Ad"},
-        {0x3b, "DCX", 1, DCX, "SP"},
-        {0x3c, "INR", 1, INR, "A"},
-        {0x3d, "DCR", 1, DCR, "A"},
-        {0x3e, "MVI", 2, MVI, "A N"},
-        {0x3f, "CMC", 1, CMC, ""},
-        {0x40, "MOV", 1, MOV, "B B"},
-        {0x41, "MOV", 1, MOV, "B C"},
-        {0x42, "MOV", 1, MOV, "B D"},
-        {0x43, "MOV", 1, MOV, "B E"},
-        {0x44, "MOV", 1, MOV, "B H"},
-        {0x45, "MOV", 1, MOV, "B L"},
-        {0x46, "MOV", 1, MOV, "B M"},
-        {0x47, "MOV", 1, MOV, "B A"},
-        {0x48, "MOV", 1, MOV, "C B"},
-        {0x49, "MOV", 1, MOV, "C C"},
-        {0x4a, "MOV", 1, MOV, "C D"},
-        {0x4b, "MOV", 1, MOV, "C E"},
-        {0x4c, "MOV", 1, MOV, "C H"},
-        {0x4d, "MOV", 1, MOV, "C L"},
-        {0x4e, "MOV", 1, MOV, "C M"},
-        {0x4f, "MOV", 1, MOV, "C A"},
-        {0x50, "MOV", 1, MOV, "D B"},
-        {0x51, "MOV", 1, MOV, "D C"},
-        {0x52, "MOV", 1, MOV, "D D"},
-        {0x53, "MOV", 1, MOV, "D E"},
-        {0x54, "MOV", 1, MOV, "D H"},
-        {0x55, "MOV", 1, MOV, "D L"},
-        {0x56, "MOV", 1, MOV, "D M"},
-        {0x57, "MOV", 1, MOV, "D A"},
-        {0x58, "MOV", 1, MOV, "E B"},
-        {0x59, "MOV", 1, MOV, "E C"},
-        {0x5a, "MOV", 1, MOV, "E D"},
-        {0x5b, "MOV", 1, MOV, "E E"},
-        {0x5c, "MOV", 1, MOV, "E H"},
-        {0x5d, "MOV", 1, MOV, "E L"},
-        {0x5e, "MOV", 1, MOV, "E M"},
-        {0x5f, "MOV", 1, MOV, "E A"},
-        {0x60, "MOV", 1, MOV, "H B"},
-        {0x61, "MOV", 1, MOV, "H C"},
-        {0x62, "MOV", 1, MOV, "H D"},
-        {0x63, "MOV", 1, MOV, "H E"},
-        {0x64, "MOV", 1, MOV, "H H"},
-        {0x65, "MOV", 1, MOV, "H L"},
-        {0x66, "MOV", 1, MOV, "H M"},
-        {0x67, "MOV", 1, MOV, "H A"},
-        {0x68, "MOV", 1, MOV, "L B"},
-        {0x69, "MOV", 1, MOV, "L C"},
-        {0x6a, "MOV", 1, MOV, "L D"},
-        {0x6b, "MOV", 1, MOV, "L E"},
-        {0x6c, "MOV", 1, MOV, "L H"},
-        {0x6d, "MOV", 1, MOV, "L L"},
-        {0x6e, "MOV", 1, MOV, "L M"},
-        {0x6f, "MOV", 1, MOV, "L A"},
-        {0x70, "MOV", 1, MOV, "M B"},
-        {0x71, "MOV", 1, MOV, "M C"},
-        {0x72, "MOV", 1, MOV, "M D"},
-        {0x73, "MOV", 1, MOV, "M E"},
-        {0x74, "MOV", 1, MOV, "M H"},
-        {0x75, "MOV", 1, MOV, "M L"},
-        {0x76, "HLT", 1, HLT, ""},
-        {0x77, "MOV", 1, MOV, "M A"},
-        {0x78, "MOV", 1, MOV, "A B"},
-        {0x79, "MOV", 1, MOV, "A C"},
-        {0x7a, "MOV", 1, MOV, "A D"},
-        {0x7b, "MOV", 1, MOV, "A E"},
-        {0x7c, "MOV", 1, MOV, "A H"},
-        {0x7d, "MOV", 1, MOV, "A L"},
-        {0x7e, "MOV", 1, MOV, "A M"},
-        {0x7f, "MOV", 1, MOV, "A A"},
-        {0x80, "ADD", 1, ADD, "B"},
-        {0x81, "ADD", 1, ADD, "C"},
-        {0x82, "ADD", 1, ADD, "D"},
-        {0x83, "ADD", 1, ADD, "E"},
-        {0x84, "ADD", 1, ADD, "H"},
-        {0x85, "ADD", 1, ADD, "L"},
-        {0x86, "ADD", 1, ADD, "M"},
-        {0x87, "ADD", 1, ADD, "A"},
-        {0x88, "ADC", 1, ADC, "B"},
-        {0x89, "ADC", 1, ADC, "C"},
-        {0x8a, "ADC", 1, ADC, "D"},
-        {0x8b, "ADC", 1, ADC, "E"},
-        {0x8c, "ADC", 1, ADC, "H"},
-        {0x8d, "ADC", 1, ADC, "L"},
-        {0x8e, "ADC", 1, ADC, "M"},
-        {0x8f, "ADC", 1, ADC, "A"},
-        {0x90, "SUB", 1, SUB, "B"},
-        {0x91, "SUB", 1, SUB, "C"},
-        {0x92, "SUB", 1, SUB, "D"},
-        {0x93, "SUB", 1, SUB, "E"},
-        {0x94, "SUB", 1, SUB, "H"},
-        {0x95, "SUB", 1, SUB, "L"},
-        {0x96, "SUB", 1, SUB, "M"},
-        {0x97, "SUB", 1, SUB, "A"},
-        {0x98, "SBB", 1, SBB, "B"},
-        {0x99, "SBB", 1, SBB, "C"},
-        {0x9a, "SBB", 1, SBB, "D"},
-        {0x9b, "SBB", 1, SBB, "E"},
-        {0x9c, "SBB", 1, SBB, "H"},
-        {0x9d, "SBB", 1, SBB, "L"},
-        {0x9e, "SBB", 1, SBB, "M"},
-        {0x9f, "SBB", 1, SBB, "A"},
-        {0xa0, "ANA", 1, ANA, "B"},
-        {0xa1, "ANA", 1, ANA, "C"},
-        {0xa2, "ANA", 1, ANA, "D"},
-        {0xa3, "ANA", 1, ANA, "E"},
-        {0xa4, "ANA", 1, ANA, "H"},
-        {0xa5, "ANA", 1, ANA, "L"},
-        {0xa6, "ANA", 1, ANA, "M"},
-        {0xa7, "ANA", 1, ANA, "A"},
-        {0xa8, "XRA", 1, XRA, "B"},
-        {0xa9, "XRA", 1, XRA, "C"},
-        {0xaa, "XRA", 1, XRA, "D"},
-        {0xab, "XRA", 1, XRA, "E"},
-        {0xac, "XRA", 1, XRA, "H"},
-        {0xad, "XRA", 1, XRA, "L"},
-        {0xae, "XRA", 1, XRA, "M"},
-        {0xaf, "XRA", 1, XRA, "A"},
-        {0xb0, "ORA", 1, ORA, "B"},
-        {0xb1, "ORA", 1, ORA, "C"},
-        {0xb2, "ORA", 1, ORA, "D"},
-        {0xb3, "ORA", 1, ORA, "E"},
-        {0xb4, "ORA", 1, ORA, "H"},
-        {0xb5, "ORA", 1, ORA, "L"},
-        {0xb6, "ORA", 1, ORA, "M"},
-        {0xb7, "ORA", 1, ORA, "A"},
-        {0xb8, "CMP", 1, CMP, "B"},
-        {0xb9, "CMP", 1, CMP, "C"},
-        {0xba, "CMP", 1, CMP, "D"},
-        {0xbb, "CMP", 1, CMP, "E"},
-        {0xbc, "CMP", 1, CMP, "H"},
-        {0xbd, "CMP", 1, CMP, "M"},
-        {},
-        {0xbf, "CMP", 1, CMP, "A"},
-        {0xc0, "RNZ", 1, RNZ, ""},
-        {0xc1, "POP", 1, POP, "B"},
-        {0xc2, "JNZ", 3, JNZ, "La"},
-        {0xc3, "JMP", 3, JMP, "La"},
-        {0xc4, "CNZ", 3, CNZ, "La"},
-        {0xc5, "PUSH", 1, PUSH, "B"},
-        {0xc6, "ADI", 2, ADI, "N"},
-        {0xc7, "RST", 1, RST, "0"},
-        {0xc8, "RZ", 1, RZ, ""},
-        {0xc9, "RET", 1, RET, ""},
-        {0xca, "JZ", 3, JZ, "La"},
-        {},
-        {0xcc, "CZ", 3, CZ, "La"},
-        {0xcd, "CALL", 3, CALL, "La"},
-        {0xce, "ACI", 2, ACI, "N"},
-        {0xcf, "RST", 1, RST, "1"},
-        {0xd0, "RNC", 1, RNC, ""},
-        {0xd1, "POP", 1, POP, "D"},
-        {0xd2, "JNC", 3, JNC, "La"},
-        {0xd3, "OUT", 2, OUT, "P"},
-        {0xd4, "CNC", 3, CNC, "La"},
-        {0xd5, "PUSH", 1, PUSH, "D"},
-        {0xd6, "SUI", 2, SUI, "N"},
-        {0xd7, "RST", 1, RST, "2"},
-        {0xd8, "RC", 1, RC, ""},
-        {},
-        {0xda, "JC", 3, JC, "La"},
-        {0xdb, "IN", 2, IN, "P"},
-        {0xdc, "CC", 3, CC, "La"},
-        {},
-        {0xde, "SBI", 2, SBI, "N"},
-        {0xdf, "RST", 1, RST, "3"},
-        {0xe0, "RPO", 1, RPO, ""},
-        {0xe1, "POP", 1, POP, "H"},
-        {0xe2, "JPO", 3, JPO, "La"},
-        {0xe3, "XTHL", 1, XTHL, ""},
-        {0xe4, "CPO", 3, CPO, "La"},
-        {0xe5, "PUSH", 1, PUSH, "H"},
-        {0xe6, "ANI", 2, ANI, "N"},
-        {0xe7, "RST", 1, RST, "4"},
-        {0xe8, "RPE", 1, RPE, ""},
-        {0xe9, "PCHL", 1, PCHL, ""},
-        {0xea, "JPE", 3, JPE, "La"},
-        {0xeb, "XCHG", 1, XCHG, ""},
-        {0xec, "CPE", 3, CPE, "La"},
-        {},
-        {0xee, "XRI", 2, XRI, "N"},
-        {0xef, "RST", 1, RST, "5"},
-        {0xf0, "RP", 1, RP, ""},
-        {0xf1, "POP", 1, POP, "PSW"},
-        {0xf2, "JP", 3, JP, "La"},
-        {0xf3, "DI", 1, DI, ""},
-        {0xf4, "CP", 3, CP, "La"},
-        {0xf5, "PUSH", 1, PUSH, "PSW"},
-        {0xf6, "ORI", 2, ORI, "N"},
-        {0xf7, "RST", 1, RST, "6"},
-        {0xf8, "RM", 1, RM, ""},
-        {0xf9, "SPHL", 1, SPHL, ""},
-        {0xfa, "JM", 3, JM, "La"},
-        {0xfb, "EI", 1, EI, ""},
-        {0xfc, "CM", 3, CM, "La"},
-        {},
-        {0xfe, "CPI", 2, CPI, "N"},
-        {0xff, "RST", 1, RST, "7"}
+    constexpr Instruction Instructions[] = {
+        {"ACI", 2, ACI, Directives::None},
+        {"ADC", 1, ADC, Directives::None},
+        {"ADD", 1, ADD, Directives::None},
+        {"ADI", 2, ADI, Directives::None},
+        {"ANA", 1, ANA, Directives::None},
+        {"ANI", 2, ANI, Directives::None},
+        {"CALL", 3, CALL, Directives::None},
+        {"CC", 3, CC, Directives::None},
+        {"CM", 3, CM, Directives::None},
+        {"CMA", 1, CMA, Directives::None},
+        {"CMC", 1, CMC, Directives::None},
+        {"CMP", 1, CMP, Directives::None},
+        {"CNC", 3, CNC, Directives::None},
+        {"CNZ", 3, CNZ, Directives::None},
+        {"CP", 3, CP, Directives::None},
+        {"CPE", 3, CPE, Directives::None},
+        {"CPI", 2, CPI, Directives::None},
+        {"CPO", 3, CPO, Directives::None},
+        {"CZ", 3, CZ, Directives::None},
+        {"DAA", 1, DAA, Directives::None},
+        {"DAD", 1, DAD, Directives::None},
+        {"DCR", 1, DCR, Directives::None},
+        {"DCX", 1, DCX, Directives::None},
+        {"DI", 1, DI, Directives::None},
+        {"DSUB", 1, DSUB, Directives::None},
+        {"EI", 1, EI, Directives::None},
+        {"HLT", 1, HLT, Directives::None},
+        {"IN", 2, IN, Directives::None},
+        {"INR", 1, INR, Directives::None},
+        {"INX", 1, INX, Directives::None},
+        {"JC", 3, JC, Directives::None},
+        {"JM", 3, JM, Directives::None},
+        {"JMP", 3, JMP, Directives::None},
+        {"JNC", 3, JNC, Directives::None},
+        {"JNZ", 3, JNZ, Directives::None},
+        {"JP", 3, JP, Directives::None},
+        {"JPE", 3, JPE, Directives::None},
+        {"JPO", 3, JPO, Directives::None},
+        {"JZ", 3, JZ, Directives::None},
+        {"LDA", 3, LDA, Directives::None},
+        {"LDAX", 1, LDAX, Directives::None},
+        {"LHLD", 3, LHLD, Directives::None},
+        {"LXI", 3, LXI, Directives::None},
+        {"MOV", 1, MOV, Directives::None},
+        {"MVI", 2, MVI, Directives::None},
+        {"NOP", 1, NOP, Directives::None},
+        {"ORA", 1, ORA, Directives::None},
+        {"ORI", 2, ORI, Directives::None},
+        {"OUT", 2, OUT, Directives::None},
+        {"PCHL", 1, PCHL, Directives::None},
+        {"POP", 1, POP, Directives::None},
+        {"PUSH", 1, PUSH, Directives::None},
+        {"RAL", 1, RAL, Directives::None},
+        {"RAR", 1, RAR, Directives::None},
+        {"RC", 1, RC, Directives::None},
+        {"RET", 1, RET, Directives::None},
+        {"RIM", 1, RIM, Directives::None},
+        {"RLC", 1, RLC, Directives::None},
+        {"RM", 1, RM, Directives::None},
+        {"RNC", 1, RNC, Directives::None},
+        {"RNZ", 1, RNZ, Directives::None},
+        {"RP", 1, RP, Directives::None},
+        {"RPE", 1, RPE, Directives::None},
+        {"RPO", 1, RPO, Directives::None},
+        {"RRC", 1, RRC, Directives::None},
+        {"RST", 1, RST, Directives::None},
+        {"RZ", 1, RZ, Directives::None},
+        {"SBB", 1, SBB, Directives::None},
+        {"SBI", 2, SBI, Directives::None},
+        {"SHLD", 3, SHLD, Directives::None},
+        {"SIM", 1, SIM, Directives::None},
+        {"SPHL", 1, SPHL, Directives::None},
+        {"STA", 3, STA, Directives::None},
+        {"STAX", 1, STAX, Directives::None},
+        {"STC", 1, STC, Directives::None},
+        {"SUB", 1, SUB, Directives::None},
+        {"SUI", 2, SUI, Directives::None},
+        {"XCHG", 1, XCHG, Directives::None},
+        {"XRA", 1, XRA, Directives::None},
+        {"XRI", 2, XRI, Directives::None},
+        {"XTHL", 1, XTHL, Directives::None},
+        {"ORG", 0, nullptr, Directives::ORG},
+        {"END", 0, nullptr, Directives::END},
+        {"DB", 0, nullptr, Directives::DB},
+        {"DW", 0, nullptr, Directives::DW},
+        {"IF", 0, nullptr, Directives::IF},
+        {"ELSE", 0, nullptr, Directives::ELSE},
+        {"ENDIF", 0, nullptr, Directives::ENDIF}
     };
 
+    //Looking up a word: it's packed into a number, one letter per byte, and multiplied by Seed. The top bits of that are its slot.
+    //Seed is searched for while compiling, so that no two words in Instructions share a slot. One comparison then tells if a word is one of them.
+
+    constexpr size_t InstructionCount = sizeof(Instructions) / sizeof(Instructions[0]);
+    constexpr int SlotBits = 10;
+    constexpr uint8_t EmptySlot = 0xff;
+
+    constexpr size_t MnemonicLength(const char* mnemonic)
+    {
+        size_t length = 0;
+
+        while (mnemonic[length] != '\0')
+            length++;
+
+        return length;
+    }
+
+    constexpr size_t MaxMnemonicLength()
+    {
+        size_t max = 0;
+
+        for (size_t i = 0; i < InstructionCount; i++)
+        {
+            if (MnemonicLength(Instructions[i].MNEMONIC) > max)
+                max = MnemonicLength(Instructions[i].MNEMONIC);
+        }
+
+        return max;
+    }
+
+    static_assert(MaxMnemonicLength() <= sizeof(uint64_t), "A mnemonic has to fit in the packed number");
+    static_assert(InstructionCount < EmptySlot, "Too many mnemonics for a slot");
+
+    constexpr uint64_t PackMnemonic(const char* word, size_t length)
+    {
+        uint64_t packed = 0;
+
+        for (size_t i = 0; i < length; i++)
+            packed = (packed << 8) | (uint8_t)word[i];
+
+        return packed;
+    }
+
+    constexpr size_t MnemonicSlot(uint64_t packed, uint64_t seed)
+    {
+        return (size_t)((packed * seed) >> (64 - SlotBits));
+    }
+
+    struct MnemonicSlots
+    {
+        uint64_t Seed = 0; // 0 if none was found.
+        uint8_t Index[1 << SlotBits] = {}; // Into Instructions, EmptySlot if no word has this slot.
+    };
+
+    constexpr MnemonicSlots MakeMnemonicSlots()
+    {
+        MnemonicSlots slots;
+        uint64_t seed = 0x9e3779b97f4a7c15;
+
+        for (int attempt = 0; attempt < 100000; attempt++)
+        {
+            bool collision = false;
+
+            for (size_t slot = 0; slot < (1 << SlotBits); slot++)
+                slots.Index[slot] = EmptySlot;
+
+            for (size_t i = 0; i < InstructionCount && !collision; i++)
+            {
+                const char* mnemonic = Instructions[i].MNEMONIC;
+                size_t slot = MnemonicSlot(PackMnemonic(mnemonic, MnemonicLength(mnemonic)), seed);
+
+                if (slots.Index[slot] != EmptySlot)
+                    collision = true;
+                else
+                    slots.Index[slot] = (uint8_t)i;
+            }
+
+            if (!collision)
+            {
+                slots.Seed = seed;
+                return slots;
+            }
+
+            seed = (seed * 6364136223846793005 + 1442695040888963407) | 1; // Next odd seed, odd multipliers keep all bits of the word.
+        }
+
+        return slots;
+    }
+
+    constexpr MnemonicSlots Slots = MakeMnemonicSlots();
+
+    static_assert(Slots.Seed != 0, "No seed without collisions was found, more SlotBits are needed");
+
+    const Instruction* FindInstruction(std::string_view word)
+    {
+        if (word.empty() || word.size() > MaxMnemonicLength()) // Labels, numbers, . . .
+            return nullptr;
+
+        uint8_t index = Slots.Index[MnemonicSlot(PackMnemonic(word.data(), word.size()), Slots.Seed)];
+
+        if (index == EmptySlot || word != Instructions[index].MNEMONIC)
+            return nullptr;
+
+        return &Instructions[index];
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "lexer.h"
+
+namespace InternalAssembler
+{
+
+	static inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == ',';
+	}
+
+	static inline bool EndsWord(char c)
+	{
+		return IsSpace(c) || c == ';' || c == '\n';
+	}
+
+	std::vector<Token> Lex(std::string_view text)
+	{
+		std::vector<Token> tokens;
+		tokens.reserve(text.size() / 4); // Roughly, so it doesn't grow many times.
+
+		size_t i = 0;
+		int line = 1;
+		size_t lineStart = 0;
+
+		while (i < text.size())
+		{
+			char c = text[i];
+
+			if (c == '\n')
+			{
+				tokens.push_back({ text.substr(i, 1), line, (int)(i - lineStart) + 1, TokenKinds::Newline });
+
+				line++;
+				lineStart = i + 1;
+				i++;
+			}
+			else if (IsSpace(c))
+			{
+				i++;
+			}
+			else if (c == ';') // Comment, ignore until the newline.
+			{
+				while (i < text.size() && text[i] != '\n')
+					i++;
+			}
+			else
+			{
+				size_t start = i;
+				TokenKinds kind = TokenKinds::Word;
+
+				//A string may contain spaces, commas and everything else, but it may only be one line.
+				//TODO: Probably should implement escape character
+				if (c == '\"')
+				{
+					kind = TokenKinds::String;
+
+					i++;
+					while (i < text.size() && text[i] != '\n' && text[i] != '\"')
+						i++;
+
+					if (i < text.size() && text[i] == '\"')
+						i++;
+				}
+
+				while (i < text.size() && !EndsWord(text[i]))
+					i++;
+
+				tokens.push_back({ text.substr(start, i - start), line, (int)(start - lineStart) + 1, kind });
+			}
+		}
+
+		return tokens;
+	}
+}
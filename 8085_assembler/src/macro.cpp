@@ -6,7 +6,7 @@
 
 namespace InternalAssembler
 {
-	Macro::Macro(std::string name, std::shared_ptr<SourceFile> source)
+	Macro::Macro(AssemblerContext& context, std::string name, std::shared_ptr<SourceFile> source)
 		: Name(name)
 	{
 		std::string word = source->Next(); // Should be "MACRO"
@@ -19,45 +19,38 @@ namespace InternalAssembler
 			word = source->Next();
 		}
 
-		std::string r = source->GetLastWord();
-		if (r == "ENDM")
+		if (source->GetLastWord() == "ENDM")
 		{
 			_Source = std::make_shared<SourceFile>("");
 			return;
 		}
 
-		r += source->ReadRawUntil("ENDM");
-		r += "\n";
+		//The MACRO's own file is its tokens in ours.
+		size_t begin = source->GetFileCursor();
+		size_t end = source->SkipUntil("ENDM");
 
 		if (source->GetLastWord() != "ENDM")
 		{
 			_Source = std::make_shared<SourceFile>("");
 
-			Error("Expected ENDM to end the MACRO.", source);
+			Error(context, "Expected ENDM to end the MACRO.", source);
 			return;
 		}
 
-		_Source = std::make_shared<SourceFile>(r);
+		_Source = std::make_shared<SourceFile>(*source, begin, end);
 	}
 
-	uint16_t Macro::Parse(std::shared_ptr<SourceFile> source, uint16_t currentAddr, Assembler::Assembly& result, bool scanning)
+	uint16_t Macro::Parse(AssemblerContext& context, std::shared_ptr<SourceFile> source, uint16_t currentAddr, bool scanning)
 	{
 		_Source->ResetFile();
-		_Source->_Equ.clear();
 		Symbols.clear();
-		labels.clear();
 
-		for (int i = 0; i < source->_Equ.size(); i++)
-		{
-			_Source->_Equ.push_back(source->_Equ.at(i));
-		}
-
-		for (int i = 0; i < result.Labels.size(); i++)
-		{
-			labels.push_back(result.Labels.at(i));
-		}
+		//Our arguments, EQUs and labels, over the ones where we're used.
+		_Source->_Equ.Clear();
+		_Source->_Equ.SetParent(&source->_Equ);
 
-		_Source->SetLine(_StartLine);
+		_Labels.Clear();
+		_Labels.SetParent(context.CurrentLabels);
 
 		std::vector<std::string> passedArguments;
 
@@ -74,44 +67,44 @@ namespace InternalAssembler
 		{
 			if (!scanning)
 			{
-				//Error("Expected more arguments", _Source);
-				Error("Expected more arguments", source);
+				//Error(context, "Expected more arguments", _Source);
+				Error(context, "Expected more arguments", source);
 			}
 			return currentAddr;
 		}
 		else if (_Arguments.size() < passedArguments.size())
 		{
 			if (!scanning)
-				//Error("Expected fewer arguments", _Source);
-				Error("Expected fewer arguments", source);
+				//Error(context, "Expected fewer arguments", _Source);
+				Error(context, "Expected fewer arguments", source);
 			return currentAddr;
 		}
 		else
 		{
 			for (int i = 0; i < _Arguments.size(); i++)
 			{
-				_Source->_Equ.push_back({ _Arguments.at(i), passedArguments.at(i) });
+				_Source->_Equ.Set(_Arguments.at(i), passedArguments.at(i));
 			}
 		}
 
-		return Assemble(_Source, result, currentAddr, source, scanning);
+		return Assemble(context, _Source, currentAddr, source, scanning);
 	}
 
-	uint16_t Macro::Assemble(std::shared_ptr<SourceFile> source, Assembler::Assembly& result, uint16_t currentAddr, std::shared_ptr<SourceFile> ogSource, bool scanning)
+	uint16_t Macro::Assemble(AssemblerContext& context, std::shared_ptr<SourceFile> source, uint16_t currentAddr, std::shared_ptr<SourceFile> ogSource, bool scanning)
 	{
+		Assembler::Assembly& result = context.Result;
+
 		//Scan for labels
 		source->ResetFile();
 		if (!scanning)
-			Assemble(source, result, currentAddr, ogSource, true);
+			Assemble(context, source, currentAddr, ogSource, true);
 		source->ResetFile();
 
-		source->SetLine(_StartLine);
-
-		//swap our assembler's labels temporarily.
-		auto tempLabels = result.Labels;
+		//Instructions see our labels while we're assembled.
+		SymbolScope<uint16_t>* outerLabels = context.CurrentLabels;
 		if (!scanning)
 		{
-			result.Labels = labels;
+			context.CurrentLabels = &_Labels;
 		}
 
 		_IfBuffer.clear();
@@ -122,9 +115,12 @@ namespace InternalAssembler
 
 			if (word == "") { continue; }
 
-			else if (word == "IF" || word == "ELSE" || word == "ENDIF")
+			const Instruction* instruction = FindInstruction(word);
+			Directives directive = instruction != nullptr ? instruction->DIRECTIVE : Directives::None;
+
+			if (directive == Directives::IF || directive == Directives::ELSE || directive == Directives::ENDIF)
 			{
-				ParseIfDirective(source, _IfBuffer);
+				ParseIfDirective(context, source, _IfBuffer);
 				continue;
 			}
 
@@ -137,34 +133,26 @@ namespace InternalAssembler
 				continue;
 			}
 
-			bool found = false;
-			int i = 0;
-			while (i < 0xff && !found)
+			bool found = instruction != nullptr && instruction->ACTION != nullptr;
+
+			if (found)
 			{
-				if (Instructions[i].OPERAND == word)
+				if (!scanning)
 				{
-					found = true;
-					if (!scanning)
-					{
-						Symbols.push_back({ currentAddr, source->GetLine() }); //So we know which instruction corresponds to which line
+					Symbols.push_back({ currentAddr, source->GetLine() }); //So we know which instruction corresponds to which line
 
-						if (result.Memory != nullptr)
-							bool ret = Instructions[i].ACTION(Instructions[i].bytes, source, result.Memory.get() + currentAddr); // Not really using ret. . .
-					}
-					currentAddr += Instructions[i].bytes;
+					if (result.Memory != nullptr)
+						bool ret = instruction->ACTION(context, instruction->bytes, source, result.Memory.get() + currentAddr); // Not really using ret. . .
 				}
-
-				i++;
+				currentAddr += instruction->bytes;
 			}
-
-			if (found) {}
-			else if (word == "ORG") //Could have it as a 0 byte "instruction" instead
+			else if (directive == Directives::ORG)
 			{
 				//Read address
 				std::string addrStr = source->Next();
 
 				//Convert to uint16_t
-				uint16_t addr = StringToUInt16(addrStr, source);
+				uint16_t addr = StringToUInt16(context, addrStr, source);
 
 				//Make it the currentAddr
 				currentAddr = addr;
@@ -173,11 +161,11 @@ namespace InternalAssembler
 			{
 				if (scanning)
 				{
-					std::string label = word; //Label of EQU is our current word.
+					std::string label = source->GetLastText(); //Label of EQU is our current word, as it is written: an EQU can be defined again, e.g. in a MACRO.
 					source->Next(); // We ignore next word, we know it's "EQU"
 					std::string val = source->Next(); //Value of EQU is the 3rd word.
 
-					source->_Equ.push_back({ label, val });
+					source->_Equ.Set(label, val);
 				}
 				else
 				{
@@ -194,25 +182,20 @@ namespace InternalAssembler
 					{
 						std::string label = word.substr(0, word.length() - 1);
 
-						for (int i = 0; i < labels.size(); i++)
+						if (!_Labels.Add(label, currentAddr - 1))
 						{
-							if (labels.at(i).first == label)
-							{
-								Error("Label " + label + " already exists", source);
-								Error("Error in MACRO", ogSource);
-							}
+							Error(context, "Label " + label + " already exists", source);
+							Error(context, "Error in MACRO", ogSource);
 						}
-
-						labels.push_back({ label, currentAddr - 1 });
 					}
 					else
 					{
-						Error("Expected a name for the label", source);
-						Error("Error in MACRO", ogSource);
+						Error(context, "Expected a name for the label", source);
+						Error(context, "Error in MACRO", ogSource);
 					}
 				}
 			}
-			else if (word == "DB") //DB saves one or more bytes in current memory address and forward
+			else if (directive == Directives::DB) //DB saves one or more bytes in current memory address and forward
 			{
 				if (scanning) continue;
 
@@ -222,14 +205,14 @@ namespace InternalAssembler
 				{
 					if (nextWord.length() != 3)
 					{
-						Error("Expected ONE character and closing apostrophe", source);
-						Error("Error in MACRO", ogSource);
+						Error(context, "Expected ONE character and closing apostrophe", source);
+						Error(context, "Error in MACRO", ogSource);
 					}
 
 					if (nextWord[nextWord.length() - 1] != '\'') //And it also ends with '
 					{
-						Error("Expected closing apostrophe", source);
-						Error("Error in MACRO", ogSource);
+						Error(context, "Expected closing apostrophe", source);
+						Error(context, "Error in MACRO", ogSource);
 					}
 
 					std::string numStr = nextWord.substr(1, nextWord.length() - 2);
@@ -240,14 +223,14 @@ namespace InternalAssembler
 				{
 					if (nextWord.length() < 2) //Length could be anything
 					{
-						Error("Expected at least one character and closing double apostrophe", source);
-						Error("Error in MACRO", ogSource);
+						Error(context, "Expected at least one character and closing double apostrophe", source);
+						Error(context, "Error in MACRO", ogSource);
 					}
 
 					if (nextWord[nextWord.length() - 1] != '\"')
 					{
-						Error("Expected closing double apostrophe", source);
-						Error("Error in MACRO", ogSource);
+						Error(context, "Expected closing double apostrophe", source);
+						Error(context, "Error in MACRO", ogSource);
 					}
 
 					std::string numStr = nextWord.substr(1, nextWord.length() - 2); //Whatever the DB contained, without the "
@@ -259,14 +242,14 @@ namespace InternalAssembler
 				}
 				else //Otherwise, we expect an 8bit number.
 				{
-					result.Memory.get()[currentAddr++] = StringToUInt8(nextWord, source);
+					result.Memory.get()[currentAddr++] = StringToUInt8(context, nextWord, source);
 				}
 			}
-			else if (word == "DW") //DW get's a 16 bit number.
+			else if (directive == Directives::DW) //DW get's a 16 bit number.
 			{
 				if (scanning) continue;
 
-				uint16_t addr = GetImmediate16(source);
+				uint16_t addr = GetImmediate16(context, source);
 
 				uint8_t HIGH = (addr >> 8) & 0xff;
 				uint8_t LOW = addr & 0xff;
@@ -278,39 +261,35 @@ namespace InternalAssembler
 			}
 			else
 			{
-				found = false;
+				Macro* const* macro = context.Macros.Find(word);
+				found = macro != nullptr;
 
-				for (int i = 0; i < result.Macros.size(); i++)
+				if (found)
 				{
-					if (result.Macros.at(i)->Name == word)
+					if (scanning)
 					{
-						found = true;
-						if (scanning)
-						{
-							currentAddr = result.Macros.at(i)->Parse(source, currentAddr, result, true);
-						}
-						else
-						{
-							currentAddr = result.Macros.at(i)->Parse(source, currentAddr, result);
+						currentAddr = (*macro)->Parse(context, source, currentAddr, true);
+					}
+					else
+					{
+						currentAddr = (*macro)->Parse(context, source, currentAddr);
 
-							for (int j = 0; j < result.Macros.at(i)->GetSymbols().size(); j++)
-							{
-								Symbols.push_back(result.Macros.at(i)->GetSymbols().at(j)); // Get the Symbols from inside the MACRO.
-							}
+						for (int j = 0; j < (*macro)->GetSymbols().size(); j++)
+						{
+							Symbols.push_back((*macro)->GetSymbols().at(j)); // Get the Symbols from inside the MACRO.
 						}
 					}
 				}
 
 				if (!found && !scanning)
 				{
-					Error("Unexpected " + word, source);
-					Error("Error in MACRO", ogSource);
+					Error(context, "Unexpected " + word, source);
+					Error(context, "Error in MACRO", ogSource);
 				}
 			}
 		}
 
-		if (!scanning)
-			result.Labels = tempLabels;
+		context.CurrentLabels = outerLabels;
 
 		return currentAddr;
 	}
@@ -0,0 +1,98 @@
+#include "symbol_table.h"
+
+#include <algorithm>
+
+namespace InternalAssembler
+{
+
+	uint32_t SymbolTable::Hash(std::string_view name)
+	{
+		//FNV-1a
+		uint32_t hash = 2166136261u;
+
+		for (char c : name)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+	void SymbolTable::Grow()
+	{
+		_Slots.assign(_Slots.empty() ? 64 : _Slots.size() * 2, -1);
+
+		size_t mask = _Slots.size() - 1;
+
+		for (int id = 0; id < (int)_Names.size(); id++)
+		{
+			size_t slot = _Hashes[id] & mask;
+
+			while (_Slots[slot] != -1)
+				slot = (slot + 1) & mask;
+
+			_Slots[slot] = id;
+		}
+	}
+
+	int SymbolTable::Intern(std::string_view name)
+	{
+		//At most half full, so there's always an empty slot close by.
+		if ((_Names.size() + 1) * 2 > _Slots.size())
+			Grow();
+
+		uint32_t hash = Hash(name);
+		size_t mask = _Slots.size() - 1;
+		size_t slot = hash & mask;
+
+		while (_Slots[slot] != -1)
+		{
+			int id = _Slots[slot];
+
+			if (_Hashes[id] == hash && _Names[id] == name)
+				return id;
+
+			slot = (slot + 1) & mask;
+		}
+
+		int id = (int)_Names.size();
+
+		_Names.emplace_back(name);
+		_Hashes.push_back(hash);
+		_Slots[slot] = id;
+
+		return id;
+	}
+
+	int SymbolTable::Find(std::string_view name) const
+	{
+		if (_Names.empty())
+			return -1;
+
+		uint32_t hash = Hash(name);
+		size_t mask = _Slots.size() - 1;
+		size_t slot = hash & mask;
+
+		while (_Slots[slot] != -1)
+		{
+			int id = _Slots[slot];
+
+			if (_Hashes[id] == hash && _Names[id] == name)
+				return id;
+
+			slot = (slot + 1) & mask;
+		}
+
+		return -1;
+	}
+
+	void SymbolTable::Clear()
+	{
+		_Names.clear();
+		_Hashes.clear();
+
+		//The slots stay allocated, a MACRO's scope is cleared every time it's used.
+		std::fill(_Slots.begin(), _Slots.end(), -1);
+	}
+}
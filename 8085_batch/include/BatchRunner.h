@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "cpu.h"
+
+namespace Batch
+{
+	enum JobStatus
+	{
+		NotRun = 0,
+		Halted = 1, // Reached HLT (or a runtime error, see ErrorCode).
+		OutOfCycles = 2, // Still running when the cycle budget ran out.
+		ReadFailed = 3, // Couldn't open the file.
+		AssemblyFailed = 4,
+		Crashed = 5,
+		Mismatch = 6 // --check: the core and the reference core didn't agree, or a --check-snapshots snapshot or --check-rewind seek didn't come back the same. See Errors.
+	};
+
+	const char* GetStatusName(JobStatus status);
+
+	//Every CPU runs at 3.2mhz, 500 Loop()s per second.
+	constexpr int ClockSpeed = 3200000;
+	constexpr int ClockAccuracy = 500;
+
+	struct PortOutput
+	{
+		uint8_t Port;
+		uint8_t Value;
+	};
+
+	struct BatchOptions
+	{
+		uint64_t CycleBudget = 100000000; // ~31 seconds at 3.2mhz
+		size_t Threads = 0; // 0 = all cores
+		size_t MaxOutputs = 100000; // Per program. Programs that loop forever would fill the memory otherwise.
+
+		uint8_t Switches = 0; // What IN 20H reads.
+
+		Emulator::CPUCores Core = Emulator::SwitchCore;
+		bool LazyFlags = false; // Switch core only. See CPU::SetLazyFlags().
+		bool Check = false; // Also run the table core and compare the two after every Loop().
+		bool SnapshotCheck = false; // After every Loop(), take a snapshot, change everything and load it again. It has to come back the same.
+		bool RewindCheck = false; // Record the run (Emulator::Rewind), then seek back to points of it. The CPU has to be as it was there.
+		bool IdleSkip = false; // See CPU::SetIdleSkip(). The reference core of Check runs without it.
+		bool BootloaderHle = false; // See CPU::SetBootloaderHle(). Same as IdleSkip for Check.
+		bool CycleExact = false; // See CPU::SetCycleExact(). The reference core of Check counts the same way.
+		bool Perf = false; // Count opcodes too (CPU::SetOpcodeCounting()) and put the counters in the report.
+
+		//If set, every program's execution trace goes to <TraceDir>/<file name>.trace (CPU::SetTracer()). Not the reference core's.
+		std::string TraceDir;
+
+		//Profile every program (CPU::SetProfiler()) and put it in the JSON report. Like the GUI, no idle loop skipping or HLE then.
+		bool Profile = false;
+
+		//Raised at these cycles (CPU::ScheduleInterrupt()), on the reference core of Check too.
+		//A program in HLT waits for the next one, the cycles in between are counted like in the GUI.
+		std::vector<std::pair<Emulator::InterruptLines, uint64_t>> Interrupts;
+	};
+
+	struct JobResult
+	{
+		std::string File;
+		JobStatus Status = NotRun;
+
+		std::vector<std::pair<int, std::string>> Errors; // Assembly errors. Line, message. For Mismatch, line 0 and what differed.
+		Emulator::ErrorCodes ErrorCode = Emulator::None; // Runtime error.
+
+		Emulator::CpuState State; // Final registers.
+		uint64_t Cycles = 0;
+		double WallMs = 0; // Assembling + running.
+		Emulator::PerfCounts Perf; // CPU::GetPerfCounts() at the end.
+		Emulator::ProfileReport Profile; // Only with BatchOptions::Profile.
+
+		std::vector<PortOutput> Outputs; // Every OUT, in order.
+		bool OutputsTruncated = false;
+	};
+
+	//path can be a directory (every .8085 file in it, recursively), a manifest (one path per line, relative to the manifest)
+	//or a single .8085 file. Returned sorted, so reports are in the same order every night.
+	std::vector<std::string> CollectPrograms(const std::string& path);
+
+	//Assemble and run one program. Thread safe.
+	void RunJob(JobResult& job, const BatchOptions& options);
+
+	//Run everything on a work-stealing pool. Results are in the same order as files.
+	std::vector<JobResult> RunAll(const std::vector<std::string>& files, const BatchOptions& options);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "BatchRunner.h"
+
+namespace Batch
+{
+	//One object per program, in a "jobs" array.
+	void WriteJSON(std::ostream& out, const std::vector<JobResult>& results, const BatchOptions& options);
+
+	//One row per program. Outputs are written as "port:value" pairs (hex) separated by ';'.
+	void WriteCSV(std::ostream& out, const std::vector<JobResult>& results);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Batch
+{
+	//Work-stealing thread pool.
+	//Every worker has its own queue. Submit() spreads the tasks round-robin over the queues.
+	//A worker takes tasks from the back of its own queue, and when that's empty it steals from the front of the others.
+	//Programs can take very different amounts of time to run, so this keeps every core busy until the end.
+
+	class ThreadPool
+	{
+	private:
+		struct WorkerQueue
+		{
+			std::mutex Mutex;
+			std::deque<std::function<void()>> Tasks;
+		};
+
+		std::vector<std::unique_ptr<WorkerQueue>> _Queues;
+		std::vector<std::thread> _Threads;
+
+		std::atomic<size_t> _NextQueue{ 0 };
+		std::atomic<size_t> _Queued{ 0 }; // Sitting in a queue.
+		std::atomic<size_t> _Pending{ 0 }; // Submitted but not finished yet.
+		bool _Stop = false;
+
+		//Sleeping workers wait on _WorkAvailable, Wait() waits on _AllDone.
+		std::mutex _Mutex;
+		std::condition_variable _WorkAvailable;
+		std::condition_variable _AllDone;
+
+		bool PopLocal(size_t worker, std::function<void()>& task);
+		bool Steal(size_t worker, std::function<void()>& task);
+
+		void WorkerLoop(size_t worker);
+
+	public:
+		//threads = 0 uses all cores.
+		ThreadPool(size_t threads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Submit(std::function<void()> task);
+
+		//Block until every submitted task has finished.
+		void Wait();
+
+		inline size_t GetThreadCount() { return _Threads.size(); }
+	};
+}
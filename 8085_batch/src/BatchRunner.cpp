@@ -0,0 +1,539 @@
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "assembler.h"
+#include "rewind.h"
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace Batch
+{
+	namespace
+	{
+		//Everything a port handler needs. Passed to the handlers as their context.
+		struct JobContext
+		{
+			JobResult* Job;
+			const BatchOptions* Options;
+		};
+
+		template <uint8_t Port>
+		void LogOutput(void* ctx, uint8_t value)
+		{
+			JobContext* context = (JobContext*)ctx;
+
+			if (context->Job->Outputs.size() >= context->Options->MaxOutputs)
+			{
+				context->Job->OutputsTruncated = true;
+				return;
+			}
+
+			context->Job->Outputs.push_back({ Port, value });
+		}
+
+		//What the GUI's peripherals read when nobody touches them.
+		uint8_t ReadKeyboard(void* ctx) { return 0xff; } // No key pressed.
+		uint8_t ReadSwitches(void* ctx) { return ((JobContext*)ctx)->Options->Switches; }
+		uint8_t ReadBeep(void* ctx) { return 0; } // Countdown is always done.
+
+		template <size_t... Ports>
+		void AddOutputLoggers(Emulator::CPU& cpu, JobContext* context, std::index_sequence<Ports...>)
+		{
+			(cpu.AddIOInterface(Ports, { LogOutput<Ports>, context }, {}), ...);
+		}
+
+		bool ReadFile(const std::string& fileName, std::string& text)
+		{
+			std::ifstream file(fileName);
+
+			if (!file.is_open())
+				return false;
+
+			std::stringstream ss;
+			ss << file.rdbuf();
+			text = ss.str();
+
+			//The assembler doesn't stop on a last line without a newline.
+			if (text.empty() || text.back() != '\n')
+				text += '\n';
+
+			return true;
+		}
+
+		//INTR_ROUTINE and the peripherals.
+		void SetUp(Emulator::CPU& cpu, Assembler::Assembly& program, JobContext* context)
+		{
+			cpu.SetClock(ClockSpeed, ClockAccuracy);
+			cpu.SetCycleExact(context->Options->CycleExact);
+
+			for (auto& label : program.Labels)
+			{
+				if (label.first == "INTR_ROUTINE")
+				{
+					cpu.State.INTR_ADDR = label.second;
+				}
+			}
+
+			for (auto& interrupt : context->Options->Interrupts)
+			{
+				cpu.ScheduleInterrupt(interrupt.second, interrupt.first);
+			}
+
+			AddOutputLoggers(cpu, context, std::make_index_sequence<256>());
+			cpu.AddIOInterface(0x18, {}, { ReadKeyboard, context });
+			cpu.AddIOInterface(0x20, {}, { ReadSwitches, context });
+			cpu.AddIOInterface(0x60, {}, { ReadBeep, context });
+			cpu.AddIOInterface(0x61, {}, { ReadBeep, context });
+
+			cpu.SetRunning(true);
+			cpu.SetHalted(false);
+		}
+
+		//In HLT, with an interrupt still to come before the end of the budget: the clock runs up to it and the interrupt is taken.
+		//False if the CPU stays halted.
+		bool WakeFromHalt(Emulator::CPU& cpu, uint64_t budget)
+		{
+			while (cpu.GetRunning() && cpu.GetWaitingForInterrupt())
+			{
+				uint64_t next = cpu.GetNextEvent();
+				if (next >= budget)
+					return false;
+
+				if (next > cpu.State.TotalCycles)
+					cpu.AddHaltedCycles(next - cpu.State.TotalCycles);
+
+				cpu.RunEvents();
+
+				if (cpu.Interrupts())
+				{
+					cpu.SetHalted(false);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		//The first register that isn't what's expected goes to ss. against says where the expected ones come from.
+		void CompareRegisters(std::stringstream& ss, const Emulator::CpuState& s, const Emulator::CpuState& r, const char* against)
+		{
+			auto differs = [&](const char* name, long long value, long long expected)
+			{
+				if (value != expected && ss.tellp() == 0)
+					ss << name << " is " << value << ", " << against << " has " << expected;
+			};
+
+			differs("A", s.A, r.A);
+			differs("B", s.B, r.B);
+			differs("C", s.C, r.C);
+			differs("D", s.D, r.D);
+			differs("E", s.E, r.E);
+			differs("H", s.H, r.H);
+			differs("L", s.L, r.L);
+			differs("Flags", s.Flags, r.Flags);
+			differs("PC", s.PC, r.PC);
+			differs("SP", s.SP, r.SP);
+			differs("InterruptsEnabled", s.InterruptsEnabled, r.InterruptsEnabled);
+			differs("TotalCycles", s.TotalCycles, r.TotalCycles);
+			differs("TotalInstructions", s.TotalInstructions, r.TotalInstructions);
+		}
+
+		//Same for the first byte of memory, all 64 KB.
+		void CompareMemory(std::stringstream& ss, const uint8_t* mem, const uint8_t* expected, const char* against)
+		{
+			if (ss.tellp() != 0)
+				return;
+
+			for (size_t addr = 0; addr <= 0xffff; addr++)
+			{
+				if (mem[addr] != expected[addr])
+				{
+					ss << "Memory at " << addr << " is " << (int)mem[addr] << ", " << against << " has " << (int)expected[addr];
+					return;
+				}
+			}
+		}
+
+		//--check. What differs between the two CPUs, empty if nothing.
+		std::string Compare(Emulator::CPU& cpu, JobResult& job, Emulator::CPU& reference, JobResult& referenceJob)
+		{
+			std::stringstream ss;
+			CompareRegisters(ss, cpu.State, reference.State, "the reference core");
+
+			auto differs = [&](const char* name, long long value, long long expected)
+			{
+				if (value != expected && ss.tellp() == 0)
+					ss << name << " is " << value << ", the reference core has " << expected;
+			};
+
+			differs("Halted", cpu.GetHalted(), reference.GetHalted());
+			differs("Outputs", job.Outputs.size(), referenceJob.Outputs.size());
+
+			CompareMemory(ss, cpu.GetMemory()->GetData().get(), reference.GetMemory()->GetData().get(), "the reference core");
+
+			return ss.str();
+		}
+
+		//--check-snapshots. CPU::LoadState() has to put back everything CPU::SaveState() took: empty if it did, what it didn't otherwise.
+		std::string CheckSnapshot(Emulator::CPU& cpu)
+		{
+			uint8_t* mem = cpu.GetMemory()->GetData().get();
+
+			Emulator::CpuState state = cpu.State;
+			std::vector<uint8_t> memory(mem, mem + 0xffff + 1);
+
+			Emulator::Snapshot snapshot = cpu.SaveState();
+
+			//Change all of it, the first and the last byte too: the stack starts at FFFFH.
+			for (size_t addr = 0; addr <= 0xffff; addr++)
+				mem[addr] = ~mem[addr];
+
+			cpu.State.A++;
+			cpu.State.PC++;
+			cpu.State.SP--;
+			cpu.State.TotalCycles++;
+			cpu.State.TotalInstructions++;
+
+			cpu.LoadState(snapshot);
+
+			std::stringstream ss;
+			CompareRegisters(ss, cpu.State, state, "the snapshot");
+			CompareMemory(ss, mem, memory.data(), "the snapshot");
+
+			return ss.str();
+		}
+
+		//--check-rewind. Where the CPU was after some of the Loop()s, to go back to at the end.
+		struct RewindPoint
+		{
+			Emulator::CpuState State;
+			std::vector<uint8_t> Memory;
+		};
+
+		//A point every this many Loop()s, 0.1 s at 3.2mhz.
+		constexpr uint64_t RewindPointInterval = 50;
+
+		//Enough to keep everything a program does in the default cycle budget.
+		constexpr size_t RewindCheckBudget = 256 * 1024 * 1024;
+
+		//Seeks to every point, from the last one back and then forward again. The CPU has to be exactly as it was there.
+		//Empty if it always was, what differed otherwise.
+		std::string CheckRewind(Emulator::CPU& cpu, Emulator::Rewind& rewind, const std::vector<RewindPoint>& points)
+		{
+			std::vector<size_t> order;
+
+			for (size_t i = points.size(); i-- > 0;)
+				order.push_back(i);
+
+			for (size_t i = 0; i < points.size(); i++)
+				order.push_back(i);
+
+			for (size_t i : order)
+			{
+				const RewindPoint& point = points[i];
+
+				if (point.State.TotalInstructions < rewind.GetFirst()) // Dropped to stay within the budget.
+					continue;
+
+				rewind.Seek(&cpu, point.State.TotalInstructions);
+
+				std::stringstream ss;
+				CompareRegisters(ss, cpu.State, point.State, "the recording");
+				CompareMemory(ss, cpu.GetMemory()->GetData().get(), point.Memory.data(), "the recording");
+
+				if (ss.tellp() != 0)
+					return "After seeking to instruction " + std::to_string(point.State.TotalInstructions) + ": " + ss.str();
+			}
+
+			return "";
+		}
+
+		void Execute(JobResult& job, const BatchOptions& options, Assembler::Assembly& program)
+		{
+			std::vector<int> breakpoints;
+			Emulator::CPU cpu(program.Memory, 0xffff + 1, breakpoints, program.Symbols, options.Core);
+
+			cpu.SetLazyFlags(options.LazyFlags);
+			cpu.SetIdleSkip(options.IdleSkip);
+			cpu.SetBootloaderLabels(program.Labels);
+			cpu.SetBootloaderHle(options.BootloaderHle);
+			cpu.SetOpcodeCounting(options.Perf);
+
+			JobContext context = { &job, &options };
+			SetUp(cpu, program, &context);
+
+			//Big, it has a count for every address.
+			std::unique_ptr<Emulator::Profiler> profiler;
+
+			if (options.Profile)
+			{
+				profiler = std::make_unique<Emulator::Profiler>();
+				cpu.SetProfiler(profiler.get());
+			}
+
+			Emulator::TraceWriter tracer;
+
+			if (!options.TraceDir.empty())
+			{
+				fs::path traceFile = fs::path(options.TraceDir) / fs::path(job.File).filename();
+				traceFile += ".trace";
+
+				if (tracer.Open(traceFile.string()))
+					cpu.SetTracer(&tracer);
+				else
+					fprintf(stderr, "Can't open %s for writing.\n", traceFile.string().c_str());
+			}
+
+			//--check: the table core runs the same program on its own copy of the memory, with its own outputs.
+			std::unique_ptr<Emulator::CPU> reference;
+			JobResult referenceJob;
+			JobContext referenceContext = { &referenceJob, &options };
+
+			if (options.Check)
+			{
+				std::shared_ptr<uint8_t> copy((uint8_t*)calloc(0xffff + 1, sizeof(uint8_t)), free);
+				memcpy(copy.get(), program.Memory.get(), 0xffff + 1);
+
+				reference = std::make_unique<Emulator::CPU>(copy, 0xffff + 1, breakpoints, program.Symbols, Emulator::TableCore);
+				SetUp(*reference, program, &referenceContext);
+			}
+
+			//--check-rewind: recorded like the GUI does, see CheckRewind().
+			std::unique_ptr<Emulator::Rewind> rewind;
+			std::vector<RewindPoint> rewindPoints;
+			uint64_t loops = 0;
+
+			if (options.RewindCheck)
+			{
+				rewind = std::make_unique<Emulator::Rewind>(RewindCheckBudget);
+				rewind->Start(&cpu);
+			}
+
+			job.Status = OutOfCycles;
+
+			try
+			{
+				//Only --interrupt raises interrupts here. Without one coming, a halted CPU stays halted.
+				while (cpu.State.TotalCycles < options.CycleBudget)
+				{
+					cpu.Loop();
+
+					if (rewind != nullptr)
+					{
+						rewind->Record(&cpu);
+
+						//Not in HLT, there the same instruction goes on for many Loop()s.
+						bool point = ++loops % RewindPointInterval == 0 && !cpu.GetHalted() &&
+							(rewindPoints.empty() || rewindPoints.back().State.TotalInstructions != cpu.State.TotalInstructions);
+
+						if (point)
+						{
+							uint8_t* mem = cpu.GetMemory()->GetData().get();
+							rewindPoints.push_back({ cpu.State, std::vector<uint8_t>(mem, mem + 0xffff + 1) });
+						}
+					}
+
+					if (reference != nullptr)
+					{
+						reference->Loop();
+
+						std::string difference = Compare(cpu, job, *reference, referenceJob);
+						if (!difference.empty())
+						{
+							job.Status = Mismatch;
+							job.Errors.push_back({ 0, difference });
+							break;
+						}
+					}
+
+					if (options.SnapshotCheck)
+					{
+						std::string difference = CheckSnapshot(cpu);
+						if (!difference.empty())
+						{
+							job.Status = Mismatch;
+							job.Errors.push_back({ 0, difference });
+							break;
+						}
+					}
+
+					if (cpu.GetHalted() || !cpu.GetRunning())
+					{
+						bool woken = WakeFromHalt(cpu, options.CycleBudget);
+
+						if (reference != nullptr)
+							WakeFromHalt(*reference, options.CycleBudget);
+
+						if (woken)
+							continue;
+
+						job.Status = Halted;
+						break;
+					}
+				}
+			}
+			catch (...)
+			{
+				job.Status = Crashed;
+			}
+
+			job.State = cpu.State;
+			job.Cycles = cpu.State.TotalCycles;
+			job.ErrorCode = cpu.ErrorCode;
+			cpu.PublishPerfCounts();
+			job.Perf = cpu.GetPerfCounts();
+
+			cpu.SetTracer(nullptr);
+			tracer.Close();
+
+			if (profiler != nullptr)
+				job.Profile = profiler->GetReport(program.Labels, program.Symbols);
+
+			if (rewind != nullptr && job.Status != Mismatch && job.Status != Crashed)
+			{
+				//Going back runs the OUTs again, they aren't the program's.
+				std::vector<PortOutput> outputs = job.Outputs;
+				bool truncated = job.OutputsTruncated;
+
+				std::string difference;
+
+				try
+				{
+					difference = CheckRewind(cpu, *rewind, rewindPoints);
+				}
+				catch (...)
+				{
+					difference = "Crashed while seeking";
+				}
+
+				job.Outputs = outputs;
+				job.OutputsTruncated = truncated;
+
+				if (!difference.empty())
+				{
+					job.Status = Mismatch;
+					job.Errors.push_back({ 0, difference });
+				}
+			}
+		}
+	}
+
+	const char* GetStatusName(JobStatus status)
+	{
+		switch (status)
+		{
+		case NotRun: return "not_run";
+		case Halted: return "halted";
+		case OutOfCycles: return "out_of_cycles";
+		case ReadFailed: return "read_failed";
+		case AssemblyFailed: return "assembly_failed";
+		case Crashed: return "crashed";
+		case Mismatch: return "mismatch";
+		}
+
+		return "unknown";
+	}
+
+	std::vector<std::string> CollectPrograms(const std::string& path)
+	{
+		std::vector<std::string> files;
+
+		if (fs::is_directory(path))
+		{
+			for (auto& entry : fs::recursive_directory_iterator(path))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == ".8085")
+				{
+					files.push_back(entry.path().string());
+				}
+			}
+		}
+		else if (fs::path(path).extension() == ".8085")
+		{
+			files.push_back(path);
+		}
+		else
+		{
+			//Manifest. Empty lines and lines starting with # are skipped.
+			std::ifstream manifest(path);
+			fs::path base = fs::path(path).parent_path();
+
+			std::string line;
+			while (std::getline(manifest, line))
+			{
+				line.erase(0, line.find_first_not_of(" \t"));
+				line.erase(line.find_last_not_of(" \t\r") + 1);
+
+				if (line.empty() || line[0] == '#')
+					continue;
+
+				fs::path file(line);
+				if (file.is_relative())
+					file = base / file;
+
+				files.push_back(file.string());
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+
+		return files;
+	}
+
+	void RunJob(JobResult& job, const BatchOptions& options)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		std::string text;
+		if (!ReadFile(job.File, text))
+		{
+			job.Status = ReadFailed;
+		}
+		else
+		{
+			Assembler::Assembly program;
+			Assembler::GetAssembledMemory(text, program); // Each assembly has its own context, the jobs assemble at once.
+
+			if (program.Errors.size() > 0)
+			{
+				job.Status = AssemblyFailed;
+				job.Errors = program.Errors;
+			}
+			else
+			{
+				Execute(job, options, program);
+			}
+		}
+
+		job.WallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::vector<JobResult> RunAll(const std::vector<std::string>& files, const BatchOptions& options)
+	{
+		std::vector<JobResult> results(files.size());
+
+		ThreadPool pool(std::min(options.Threads == 0 ? (size_t)std::thread::hardware_concurrency() : options.Threads, std::max<size_t>(files.size(), 1)));
+
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			results[i].File = files[i];
+
+			JobResult* job = &results[i];
+			pool.Submit([job, &options] { RunJob(*job, options); });
+		}
+
+		pool.Wait();
+
+		return results;
+	}
+}
@@ -0,0 +1,232 @@
+#include "Report.h"
+
+#include <cstdio>
+#include <string>
+
+namespace Batch
+{
+	namespace
+	{
+		std::string Hex(unsigned value, int digits)
+		{
+			char buf[8];
+			snprintf(buf, sizeof(buf), "%0*X", digits, value);
+			return buf;
+		}
+
+		std::string EscapeJSON(const std::string& str)
+		{
+			std::string ret;
+
+			for (char c : str)
+			{
+				switch (c)
+				{
+				case '"': ret += "\\\""; break;
+				case '\\': ret += "\\\\"; break;
+				case '\n': ret += "\\n"; break;
+				case '\r': ret += "\\r"; break;
+				case '\t': ret += "\\t"; break;
+				default:
+					if ((unsigned char)c < 0x20)
+						ret += "\\u00" + Hex((unsigned char)c, 2);
+					else
+						ret += c;
+				}
+			}
+
+			return ret;
+		}
+
+		std::string EscapeCSV(const std::string& str)
+		{
+			if (str.find_first_of(",\"\n\r") == std::string::npos)
+				return str;
+
+			std::string ret = "\"";
+			for (char c : str)
+			{
+				if (c == '"')
+					ret += '"';
+				ret += c;
+			}
+
+			return ret + "\"";
+		}
+
+		//{ "3E": 12, ... }, only what isn't 0.
+		void WriteCounts(std::ostream& out, const uint64_t* counts, size_t size)
+		{
+			out << "{";
+
+			bool first = true;
+			for (size_t i = 0; i < size; i++)
+			{
+				if (counts[i] == 0)
+					continue;
+
+				out << (first ? " " : ", ") << "\"" << Hex((unsigned)i, 2) << "\": " << counts[i];
+				first = false;
+			}
+
+			out << (first ? "}" : " }");
+		}
+
+		void WritePerf(std::ostream& out, const Emulator::PerfCounts& perf)
+		{
+			out << "      \"perf\": {\n";
+			out << "        \"instructions\": " << perf.Instructions << ",\n";
+			out << "        \"loops\": " << perf.Loops << ",\n";
+			out << "        \"loop_ns\": " << perf.LoopNs << ",\n";
+			out << "        \"host_ns_per_emulated_ms\": " << perf.HostNsPerEmulatedMs(ClockSpeed) << ",\n";
+			out << "        \"interrupts\": { "
+				<< "\"5.5\": " << perf.Interrupts[Emulator::Interrupt55] << ", "
+				<< "\"6.5\": " << perf.Interrupts[Emulator::Interrupt65] << ", "
+				<< "\"7.5\": " << perf.Interrupts[Emulator::Interrupt75] << ", "
+				<< "\"intr\": " << perf.Interrupts[Emulator::InterruptINTR] << " },\n";
+
+			out << "        \"in\": ";
+			WriteCounts(out, perf.In, 256);
+			out << ",\n        \"out\": ";
+			WriteCounts(out, perf.Out, 256);
+			out << ",\n        \"opcodes\": ";
+			WriteCounts(out, perf.Opcodes, 256);
+			out << "\n      },\n";
+		}
+
+		//The labels and routines that took the most cycles, and who called them.
+		void WriteProfile(std::ostream& out, const Emulator::ProfileReport& profile)
+		{
+			constexpr size_t MaxRows = 32;
+
+			out << "      \"profile\": {\n";
+			out << "        \"instructions\": " << profile.Total.Instructions << ",\n";
+			out << "        \"cycles\": " << profile.Total.Cycles << ",\n";
+
+			out << "        \"labels\": [";
+			for (size_t i = 0; i < profile.Labels.size() && i < MaxRows; i++)
+			{
+				const Emulator::ProfileLabel& label = profile.Labels[i];
+				out << (i == 0 ? "" : ", ") << "{ \"label\": \"" << EscapeJSON(label.Name) << "\", \"address\": \"" << Hex(label.Address, 4)
+					<< "\", \"instructions\": " << label.Count.Instructions << ", \"cycles\": " << label.Count.Cycles << " }";
+			}
+
+			out << "],\n        \"routines\": [";
+			for (size_t i = 0; i < profile.Routines.size() && i < MaxRows; i++)
+			{
+				const Emulator::ProfileRoutine& routine = profile.Routines[i];
+				out << (i == 0 ? "" : ", ") << "{ \"routine\": \"" << EscapeJSON(routine.Name) << "\", \"address\": \"" << Hex(routine.Address, 4)
+					<< "\", \"calls\": " << routine.Calls << ", \"cycles\": " << routine.Cycles << " }";
+			}
+
+			out << "],\n        \"calls\": [";
+			for (size_t i = 0; i < profile.Calls.size() && i < MaxRows; i++)
+			{
+				const Emulator::ProfileCall& call = profile.Calls[i];
+				out << (i == 0 ? "" : ", ") << "{ \"caller\": \"" << EscapeJSON(call.Caller) << "\", \"callee\": \"" << EscapeJSON(call.Callee)
+					<< "\", \"calls\": " << call.Calls << ", \"cycles\": " << call.Cycles << " }";
+			}
+
+			out << "]\n      },\n";
+		}
+	}
+
+	void WriteJSON(std::ostream& out, const std::vector<JobResult>& results, const BatchOptions& options)
+	{
+		out << "{\n";
+		out << "  \"cycle_budget\": " << options.CycleBudget << ",\n";
+		out << "  \"exact_cycles\": " << (options.CycleExact ? "true" : "false") << ",\n";
+		out << "  \"jobs\": [";
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const JobResult& job = results[i];
+			const Emulator::CpuState& s = job.State;
+
+			out << (i == 0 ? "\n" : ",\n");
+			out << "    {\n";
+			out << "      \"file\": \"" << EscapeJSON(job.File) << "\",\n";
+			out << "      \"status\": \"" << GetStatusName(job.Status) << "\",\n";
+			out << "      \"error_code\": " << (int)job.ErrorCode << ",\n";
+
+			out << "      \"errors\": [";
+			for (size_t e = 0; e < job.Errors.size(); e++)
+			{
+				out << (e == 0 ? "" : ", ") << "{ \"line\": " << job.Errors[e].first << ", \"message\": \"" << EscapeJSON(job.Errors[e].second) << "\" }";
+			}
+			out << "],\n";
+
+			out << "      \"cycles\": " << job.Cycles << ",\n";
+			out << "      \"wall_ms\": " << job.WallMs << ",\n";
+
+			if (options.Perf)
+			{
+				WritePerf(out, job.Perf);
+			}
+
+			if (options.Profile)
+			{
+				WriteProfile(out, job.Profile);
+			}
+
+			out << "      \"registers\": { "
+				<< "\"A\": \"" << Hex(s.A, 2) << "\", "
+				<< "\"B\": \"" << Hex(s.B, 2) << "\", "
+				<< "\"C\": \"" << Hex(s.C, 2) << "\", "
+				<< "\"D\": \"" << Hex(s.D, 2) << "\", "
+				<< "\"E\": \"" << Hex(s.E, 2) << "\", "
+				<< "\"H\": \"" << Hex(s.H, 2) << "\", "
+				<< "\"L\": \"" << Hex(s.L, 2) << "\", "
+				<< "\"F\": \"" << Hex(s.Flags, 2) << "\", "
+				<< "\"PC\": \"" << Hex(s.PC, 4) << "\", "
+				<< "\"SP\": \"" << Hex(s.SP, 4) << "\" },\n";
+
+			out << "      \"outputs_truncated\": " << (job.OutputsTruncated ? "true" : "false") << ",\n";
+			out << "      \"outputs\": [";
+			for (size_t o = 0; o < job.Outputs.size(); o++)
+			{
+				out << (o == 0 ? "" : ", ") << "[\"" << Hex(job.Outputs[o].Port, 2) << "\", \"" << Hex(job.Outputs[o].Value, 2) << "\"]";
+			}
+			out << "]\n";
+
+			out << "    }";
+		}
+
+		out << (results.empty() ? "]\n" : "\n  ]\n");
+		out << "}\n";
+	}
+
+	void WriteCSV(std::ostream& out, const std::vector<JobResult>& results)
+	{
+		out << "file,status,error_code,errors,cycles,wall_ms,A,B,C,D,E,H,L,F,PC,SP,outputs_truncated,outputs\n";
+
+		for (auto& job : results)
+		{
+			const Emulator::CpuState& s = job.State;
+
+			std::string errors;
+			for (auto& e : job.Errors)
+			{
+				errors += (errors.empty() ? "" : "; ") + std::to_string(e.first) + ": " + e.second;
+			}
+
+			std::string outputs;
+			for (auto& o : job.Outputs)
+			{
+				outputs += (outputs.empty() ? "" : ";") + Hex(o.Port, 2) + ":" + Hex(o.Value, 2);
+			}
+
+			out << EscapeCSV(job.File) << ","
+				<< GetStatusName(job.Status) << ","
+				<< (int)job.ErrorCode << ","
+				<< EscapeCSV(errors) << ","
+				<< job.Cycles << ","
+				<< job.WallMs << ","
+				<< Hex(s.A, 2) << "," << Hex(s.B, 2) << "," << Hex(s.C, 2) << "," << Hex(s.D, 2) << ","
+				<< Hex(s.E, 2) << "," << Hex(s.H, 2) << "," << Hex(s.L, 2) << "," << Hex(s.Flags, 2) << ","
+				<< Hex(s.PC, 4) << "," << Hex(s.SP, 4) << ","
+				<< (job.OutputsTruncated ? "1" : "0") << ","
+				<< outputs << "\n";
+		}
+	}
+}
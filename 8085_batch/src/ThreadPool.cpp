@@ -0,0 +1,129 @@
+#include "ThreadPool.h"
+
+namespace Batch
+{
+	ThreadPool::ThreadPool(size_t threads)
+	{
+		if (threads == 0)
+		{
+			threads = std::thread::hardware_concurrency();
+
+			if (threads == 0) // hardware_concurrency() is allowed to not know.
+				threads = 1;
+		}
+
+		for (size_t i = 0; i < threads; i++)
+		{
+			_Queues.push_back(std::make_unique<WorkerQueue>());
+		}
+
+		for (size_t i = 0; i < threads; i++)
+		{
+			_Threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			_Stop = true;
+		}
+		_WorkAvailable.notify_all();
+
+		for (auto& t : _Threads)
+		{
+			t.join();
+		}
+	}
+
+	void ThreadPool::Submit(std::function<void()> task)
+	{
+		//Count it first, a worker can pick it up (and finish it) as soon as it's in a queue.
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			_Pending++;
+			_Queued++;
+		}
+
+		size_t queue = _NextQueue++ % _Queues.size();
+
+		{
+			std::lock_guard<std::mutex> lock(_Queues[queue]->Mutex);
+			_Queues[queue]->Tasks.push_back(std::move(task));
+		}
+
+		_WorkAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(_Mutex);
+		_AllDone.wait(lock, [this] { return _Pending == 0; });
+	}
+
+	bool ThreadPool::PopLocal(size_t worker, std::function<void()>& task)
+	{
+		WorkerQueue& q = *_Queues[worker];
+		std::lock_guard<std::mutex> lock(q.Mutex);
+
+		if (q.Tasks.empty())
+			return false;
+
+		task = std::move(q.Tasks.back());
+		q.Tasks.pop_back();
+		_Queued--;
+		return true;
+	}
+
+	bool ThreadPool::Steal(size_t worker, std::function<void()>& task)
+	{
+		//Start at the next worker, so not everyone steals from worker 0.
+		for (size_t i = 1; i < _Queues.size(); i++)
+		{
+			WorkerQueue& q = *_Queues[(worker + i) % _Queues.size()];
+			std::lock_guard<std::mutex> lock(q.Mutex);
+
+			if (!q.Tasks.empty())
+			{
+				task = std::move(q.Tasks.front());
+				q.Tasks.pop_front();
+				_Queued--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ThreadPool::WorkerLoop(size_t worker)
+	{
+		while (true)
+		{
+			std::function<void()> task;
+
+			if (PopLocal(worker, task) || Steal(worker, task))
+			{
+				task();
+
+				std::lock_guard<std::mutex> lock(_Mutex);
+				if (--_Pending == 0)
+				{
+					_AllDone.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(_Mutex);
+
+			if (_Stop)
+				return;
+
+			//Someone else can grab the task before we get to it. That's fine, we just look again.
+			_WorkAvailable.wait(lock, [this] { return _Stop || _Queued > 0; });
+
+			if (_Stop)
+				return;
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <stdexcept>
+#include <filesystem>
+
+#include "BatchRunner.h"
+#include "Report.h"
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: 8085_batch <directory | manifest | file.8085> [options]\n"
+		"\n"
+		"  --cycles N        Cycle budget per program (default 100000000).\n"
+		"  --threads N       Worker threads (default: all cores).\n"
+		"  --json FILE       Write the report as JSON.\n"
+		"  --csv FILE        Write the report as CSV.\n"
+		"  --switches N      Value read from the switches (IN 20H). Default 0.\n"
+		"  --max-outputs N   Port outputs kept per program (default 100000).\n"
+		"  --reference       Use the reference CPU core (slower).\n"
+		"  --blocks          Use the block cache core.\n"
+		"  --jit             Use the block cache core with hot blocks compiled to\n"
+		"                    x86-64. The same as --blocks on other machines.\n"
+		"  --check           Also run every program on the reference core and stop\n"
+		"                    with \"mismatch\" at the first difference. Slow.\n"
+		"  --check-snapshots After every Loop(), save the machine, change all of it\n"
+		"                    and load it back. \"mismatch\" if it isn't the same.\n"
+		"  --check-rewind    Record every program for Step Back, then go back to\n"
+		"                    points of the run. \"mismatch\" if the CPU or the\n"
+		"                    memory isn't what it was there.\n"
+		"  --lazy-flags      Compute flags only when they're read. Faster for long\n"
+		"                    runs of arithmetic, slower for tight loops.\n"
+		"  --skip-idle       Skip delay loops and busy waits in one step, with the\n"
+		"                    same result. Works with any core.\n"
+		"  --hle             Run the bootloader routines (STDM, DELA, KIND...) in\n"
+		"                    C++, with the same result. Works with any core.\n"
+		"  --exact-cycles    Count the documented T-states of every instruction.\n"
+		"  --interrupt L@N   Raise interrupt L (5.5, 6.5, 7.5 or intr) at cycle N.\n"
+		"                    Can be given more than once.\n"
+		"  --perf            Add the performance counters of every program to the\n"
+		"                    JSON report: opcodes, ports, interrupts, host time.\n"
+		"                    Opcode counting makes --jit run as --blocks.\n"
+		"  --profile         Add the cycles spent under every label and in every\n"
+		"                    routine (CALL to RET) to the JSON report. Runs every\n"
+		"                    instruction, without --skip-idle or --hle.\n"
+		"  --trace DIR       Write the execution trace of every program to\n"
+		"                    DIR/<name>.trace, see 8085_trace. Runs one instruction\n"
+		"                    at a time, without --skip-idle or --hle.\n"
+		"\n"
+		"Without --json or --csv, the JSON report is written to batch_report.json.\n"
+		"(Not stdout, debug builds of the assembler print their errors there.)\n");
+}
+
+//"5.5@100000". Throws on anything else.
+static std::pair<Emulator::InterruptLines, uint64_t> ParseInterrupt(const std::string& value)
+{
+	size_t at = value.find('@');
+	if (at == std::string::npos)
+		throw std::invalid_argument(value);
+
+	std::string line = value.substr(0, at);
+	uint64_t cycle = std::stoull(value.substr(at + 1), nullptr, 0);
+
+	if (line == "5.5")
+		return { Emulator::Interrupt55, cycle };
+	if (line == "6.5")
+		return { Emulator::Interrupt65, cycle };
+	if (line == "7.5")
+		return { Emulator::Interrupt75, cycle };
+	if (line == "intr" || line == "INTR")
+		return { Emulator::InterruptINTR, cycle };
+
+	throw std::invalid_argument(value);
+}
+
+static bool WriteReport(const std::string& fileName, const std::vector<Batch::JobResult>& results, const Batch::BatchOptions& options, bool csv)
+{
+	std::ofstream file(fileName);
+	if (!file.is_open())
+	{
+		fprintf(stderr, "Can't open %s for writing.\n", fileName.c_str());
+		return false;
+	}
+
+	csv ? Batch::WriteCSV(file, results) : Batch::WriteJSON(file, results, options);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Batch::BatchOptions options;
+	std::string input, jsonFile, csvFile;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		try
+		{
+			if (arg == "--cycles" && hasValue)
+				options.CycleBudget = std::stoull(argv[++i], nullptr, 0);
+			else if (arg == "--threads" && hasValue)
+				options.Threads = std::stoul(argv[++i], nullptr, 0);
+			else if (arg == "--json" && hasValue)
+				jsonFile = argv[++i];
+			else if (arg == "--csv" && hasValue)
+				csvFile = argv[++i];
+			else if (arg == "--switches" && hasValue)
+				options.Switches = (uint8_t)std::stoul(argv[++i], nullptr, 0);
+			else if (arg == "--max-outputs" && hasValue)
+				options.MaxOutputs = std::stoul(argv[++i], nullptr, 0);
+			else if (arg == "--reference")
+				options.Core = Emulator::TableCore;
+			else if (arg == "--blocks")
+				options.Core = Emulator::BlockCore;
+			else if (arg == "--jit")
+				options.Core = Emulator::JitCore;
+			else if (arg == "--check")
+				options.Check = true;
+			else if (arg == "--check-snapshots")
+				options.SnapshotCheck = true;
+			else if (arg == "--check-rewind")
+				options.RewindCheck = true;
+			else if (arg == "--lazy-flags")
+				options.LazyFlags = true;
+			else if (arg == "--skip-idle")
+				options.IdleSkip = true;
+			else if (arg == "--hle")
+				options.BootloaderHle = true;
+			else if (arg == "--exact-cycles")
+				options.CycleExact = true;
+			else if (arg == "--perf")
+				options.Perf = true;
+			else if (arg == "--profile")
+				options.Profile = true;
+			else if (arg == "--trace" && hasValue)
+				options.TraceDir = argv[++i];
+			else if (arg == "--interrupt" && hasValue)
+				options.Interrupts.push_back(ParseInterrupt(argv[++i]));
+			else if (arg == "-h" || arg == "--help")
+			{
+				PrintUsage();
+				return 0;
+			}
+			else if (arg[0] != '-' && input.empty())
+				input = arg;
+			else
+			{
+				fprintf(stderr, "Unknown argument: %s\n\n", arg.c_str());
+				PrintUsage();
+				return 2;
+			}
+		}
+		catch (...)
+		{
+			fprintf(stderr, "Bad value for %s\n", arg.c_str());
+			return 2;
+		}
+	}
+
+	if (input.empty())
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	if (!options.TraceDir.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(options.TraceDir, error);
+	}
+
+	std::vector<std::string> files = Batch::CollectPrograms(input);
+
+	if (files.empty())
+	{
+		fprintf(stderr, "No programs found in %s\n", input.c_str());
+		return 2;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<Batch::JobResult> results = Batch::RunAll(files, options);
+
+	double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (jsonFile.empty() && csvFile.empty())
+		jsonFile = "batch_report.json";
+
+	bool ok = true;
+
+	if (!jsonFile.empty())
+		ok &= WriteReport(jsonFile, results, options, false);
+	if (!csvFile.empty())
+		ok &= WriteReport(csvFile, results, options, true);
+
+	int failed = 0;
+	for (auto& job : results)
+	{
+		if (job.Status != Batch::Halted && job.Status != Batch::OutOfCycles)
+		{
+			printf("%s: %s\n", job.File.c_str(), Batch::GetStatusName(job.Status));
+			failed++;
+		}
+	}
+
+	printf("%zu programs, %d failed, %.1f ms\n", results.size(), failed, wallMs);
+
+	return (failed > 0 || !ok) ? 1 : 0;
+}
@@ -2,267 +2,273 @@
 
 #include <cstdint>
 
+namespace Emulator
+{
+    class CPU;
+}
+
 namespace InternalEmulator
 {
 
     //CPUInstruction has OPCODE, OPERAND, bytes, and an ACTION.
+    //ACTION gets the CPU it runs on, so any number of CPUs can run at the same time.
     struct CPUInstruction
     {
         uint8_t OPCODE;
         char OPERAND[16];
         uint8_t bytes;
-        int(*ACTION)(int bytes);
+        int(*ACTION)(Emulator::CPU* cpu, int bytes);
     };
 
     //All 246 instructions.
 
-    int ACIData(int bytes);
-    int ADCA(int bytes);
-    int ADCB(int bytes);
-    int ADCC(int bytes);
-    int ADCD(int bytes);
-    int ADCE(int bytes);
-    int ADCH(int bytes);
-    int ADCL(int bytes);
-    int ADCM(int bytes);
-    int ADDA(int bytes);
-    int ADDB(int bytes);
-    int ADDC(int bytes);
-    int ADDD(int bytes);
-    int ADDE(int bytes);
-    int ADDH(int bytes);
-    int ADDL(int bytes);
-    int ADDM(int bytes);
-    int ADIData(int bytes);
-    int ANAA(int bytes);
-    int ANAB(int bytes);
-    int ANAC(int bytes);
-    int ANAD(int bytes);
-    int ANAE(int bytes);
-    int ANAH(int bytes);
-    int ANAL(int bytes);
-    int ANAM(int bytes);
-    int ANIData(int bytes);
-    int CALLLabel(int bytes);
-    int CCLabel(int bytes);
-    int CMLabel(int bytes);
-    int CMA(int bytes);
-    int CMC(int bytes);
-    int CMPA(int bytes);
-    int CMPB(int bytes);
-    int CMPC(int bytes);
-    int CMPD(int bytes);
-    int CMPE(int bytes);
-    int CMPH(int bytes);
-    int CMPL(int bytes);
-    int CMPM(int bytes);
-    int CNCLabel(int bytes);
-    int CNZLabel(int bytes);
-    int CPLabel(int bytes);
-    int CPELabel(int bytes);
-    int CPIData(int bytes);
-    int CPOLabel(int bytes);
-    int CZLabel(int bytes);
-    int DAA(int bytes);
-    int DADB(int bytes);
-    int DADD(int bytes);
-    int DADH(int bytes);
-    int DADSP(int bytes);
-    int DCRA(int bytes);
-    int DCRB(int bytes);
-    int DCRC(int bytes);
-    int DCRD(int bytes);
-    int DCRE(int bytes);
-    int DCRH(int bytes);
-    int DCRL(int bytes);
-    int DCRM(int bytes);
-    int DCXB(int bytes);
-    int DCXD(int bytes);
-    int DCXH(int bytes);
-    int DCXSP(int bytes);
-    int DI(int bytes);
-    int EI(int bytes);
-    int HLT(int bytes);
-    int INPortAddress(int bytes);
-    int INRA(int bytes);
-    int INRB(int bytes);
-    int INRC(int bytes);
-    int INRD(int bytes);
-    int INRE(int bytes);
-    int INRH(int bytes);
-    int INRL(int bytes);
-    int INRM(int bytes);
-    int INXB(int bytes);
-    int INXD(int bytes);
-    int INXH(int bytes);
-    int INXSP(int bytes);
-    int JCLabel(int bytes);
-    int JMLabel(int bytes);
-    int JMPLabel(int bytes);
-    int JNCLabel(int bytes);
-    int JNZLabel(int bytes);
-    int JPLabel(int bytes);
-    int JPELabel(int bytes);
-    int JPOLabel(int bytes);
-    int JZLabel(int bytes);
-    int LDAAddress(int bytes);
-    int LDAXB(int bytes);
-    int LDAXD(int bytes);
-    int LHLDAddress(int bytes);
-    int LXIB(int bytes);
-    int LXID(int bytes);
-    int LXIH(int bytes);
-    int LXISP(int bytes);
-    int MOVAA(int bytes);
-    int MOVAB(int bytes);
-    int MOVAC(int bytes);
-    int MOVAD(int bytes);
-    int MOVAE(int bytes);
-    int MOVAH(int bytes);
-    int MOVAL(int bytes);
-    int MOVAM(int bytes);
-    int MOVBA(int bytes);
-    int MOVBB(int bytes);
-    int MOVBC(int bytes);
-    int MOVBD(int bytes);
-    int MOVBE(int bytes);
-    int MOVBH(int bytes);
-    int MOVBL(int bytes);
-    int MOVBM(int bytes);
-    int MOVCA(int bytes);
-    int MOVCB(int bytes);
-    int MOVCC(int bytes);
-    int MOVCD(int bytes);
-    int MOVCE(int bytes);
-    int MOVCH(int bytes);
-    int MOVCL(int bytes);
-    int MOVCM(int bytes);
-    int MOVDA(int bytes);
-    int MOVDB(int bytes);
-    int MOVDC(int bytes);
-    int MOVDD(int bytes);
-    int MOVDE(int bytes);
-    int MOVDH(int bytes);
-    int MOVDL(int bytes);
-    int MOVDM(int bytes);
-    int MOVEA(int bytes);
-    int MOVEB(int bytes);
-    int MOVEC(int bytes);
-    int MOVED(int bytes);
-    int MOVEE(int bytes);
-    int MOVEH(int bytes);
-    int MOVEL(int bytes);
-    int MOVEM(int bytes);
-    int MOVHA(int bytes);
-    int MOVHB(int bytes);
-    int MOVHC(int bytes);
-    int MOVHD(int bytes);
-    int MOVHE(int bytes);
-    int MOVHH(int bytes);
-    int MOVHL(int bytes);
-    int MOVHM(int bytes);
-    int MOVLA(int bytes);
-    int MOVLB(int bytes);
-    int MOVLC(int bytes);
-    int MOVLD(int bytes);
-    int MOVLE(int bytes);
-    int MOVLH(int bytes);
-    int MOVLL(int bytes);
-    int MOVLM(int bytes);
-    int MOVMA(int bytes);
-    int MOVMB(int bytes);
-    int MOVMC(int bytes);
-    int MOVMD(int bytes);
-    int MOVME(int bytes);
-    int MOVMH(int bytes);
-    int MOVML(int bytes);
-    int MVIAData(int bytes);
-    int MVIBData(int bytes);
-    int MVICData(int bytes);
-    int MVIDData(int bytes);
-    int MVIEData(int bytes);
-    int MVIHData(int bytes);
-    int MVILData(int bytes);
-    int MVIMData(int bytes);
-    int NOP(int bytes);
-    int ORAA(int bytes);
-    int ORAB(int bytes);
-    int ORAC(int bytes);
-    int ORAD(int bytes);
-    int ORAE(int bytes);
-    int ORAH(int bytes);
-    int ORAL(int bytes);
-    int ORAM(int bytes);
-    int ORIData(int bytes);
-    int OUTPortAddress(int bytes);
-    int PCHL(int bytes);
-    int POPB(int bytes);
-    int POPD(int bytes);
-    int POPH(int bytes);
-    int POPPSW(int bytes);
-    int PUSHB(int bytes);
-    int PUSHD(int bytes);
-    int PUSHH(int bytes);
-    int PUSHPSW(int bytes);
-    int RAL(int bytes);
-    int RAR(int bytes);
-    int RC(int bytes);
-    int RET(int bytes);
-    int RIM(int bytes);
-    int RLC(int bytes);
-    int DSUB(int bytes);
-    int RM(int bytes);
-    int RNC(int bytes);
-    int RNZ(int bytes);
-    int RP(int bytes);
-    int RPE(int bytes);
-    int RPO(int bytes);
-    int RRC(int bytes);
-    int RST0(int bytes);
-    int RST1(int bytes);
-    int RST2(int bytes);
-    int RST3(int bytes);
-    int RST4(int bytes);
-    int RST5(int bytes);
-    int RST6(int bytes);
-    int RST7(int bytes);
-    int RZ(int bytes);
-    int SBBA(int bytes);
-    int SBBB(int bytes);
-    int SBBC(int bytes);
-    int SBBD(int bytes);
-    int SBBE(int bytes);
-    int SBBH(int bytes);
-    int SBBL(int bytes);
-    int SBBM(int bytes);
-    int SBIData(int bytes);
-    int SHLDAddress(int bytes);
-    int SIM(int bytes);
-    int SPHL(int bytes);
-    int STAAddress(int bytes);
-    int STAXB(int bytes);
-    int STAXD(int bytes);
-    int STC(int bytes);
-    int SUBA(int bytes);
-    int SUBB(int bytes);
-    int SUBC(int bytes);
-    int SUBD(int bytes);
-    int SUBE(int bytes);
-    int SUBH(int bytes);
-    int SUBL(int bytes);
-    int SUBM(int bytes);
-    int SUIData(int bytes);
-    int XCHG(int bytes);
-    int XRAA(int bytes);
-    int XRAB(int bytes);
-    int XRAC(int bytes);
-    int XRAD(int bytes);
-    int XRAE(int bytes);
-    int XRAH(int bytes);
-    int XRAL(int bytes);
-    int XRAM(int bytes);
-    int XRIData(int bytes);
-    int XTHL(int bytes);
+    int ACIData(Emulator::CPU* cpu, int bytes);
+    int ADCA(Emulator::CPU* cpu, int bytes);
+    int ADCB(Emulator::CPU* cpu, int bytes);
+    int ADCC(Emulator::CPU* cpu, int bytes);
+    int ADCD(Emulator::CPU* cpu, int bytes);
+    int ADCE(Emulator::CPU* cpu, int bytes);
+    int ADCH(Emulator::CPU* cpu, int bytes);
+    int ADCL(Emulator::CPU* cpu, int bytes);
+    int ADCM(Emulator::CPU* cpu, int bytes);
+    int ADDA(Emulator::CPU* cpu, int bytes);
+    int ADDB(Emulator::CPU* cpu, int bytes);
+    int ADDC(Emulator::CPU* cpu, int bytes);
+    int ADDD(Emulator::CPU* cpu, int bytes);
+    int ADDE(Emulator::CPU* cpu, int bytes);
+    int ADDH(Emulator::CPU* cpu, int bytes);
+    int ADDL(Emulator::CPU* cpu, int bytes);
+    int ADDM(Emulator::CPU* cpu, int bytes);
+    int ADIData(Emulator::CPU* cpu, int bytes);
+    int ANAA(Emulator::CPU* cpu, int bytes);
+    int ANAB(Emulator::CPU* cpu, int bytes);
+    int ANAC(Emulator::CPU* cpu, int bytes);
+    int ANAD(Emulator::CPU* cpu, int bytes);
+    int ANAE(Emulator::CPU* cpu, int bytes);
+    int ANAH(Emulator::CPU* cpu, int bytes);
+    int ANAL(Emulator::CPU* cpu, int bytes);
+    int ANAM(Emulator::CPU* cpu, int bytes);
+    int ANIData(Emulator::CPU* cpu, int bytes);
+    int CALLLabel(Emulator::CPU* cpu, int bytes);
+    int CCLabel(Emulator::CPU* cpu, int bytes);
+    int CMLabel(Emulator::CPU* cpu, int bytes);
+    int CMA(Emulator::CPU* cpu, int bytes);
+    int CMC(Emulator::CPU* cpu, int bytes);
+    int CMPA(Emulator::CPU* cpu, int bytes);
+    int CMPB(Emulator::CPU* cpu, int bytes);
+    int CMPC(Emulator::CPU* cpu, int bytes);
+    int CMPD(Emulator::CPU* cpu, int bytes);
+    int CMPE(Emulator::CPU* cpu, int bytes);
+    int CMPH(Emulator::CPU* cpu, int bytes);
+    int CMPL(Emulator::CPU* cpu, int bytes);
+    int CMPM(Emulator::CPU* cpu, int bytes);
+    int CNCLabel(Emulator::CPU* cpu, int bytes);
+    int CNZLabel(Emulator::CPU* cpu, int bytes);
+    int CPLabel(Emulator::CPU* cpu, int bytes);
+    int CPELabel(Emulator::CPU* cpu, int bytes);
+    int CPIData(Emulator::CPU* cpu, int bytes);
+    int CPOLabel(Emulator::CPU* cpu, int bytes);
+    int CZLabel(Emulator::CPU* cpu, int bytes);
+    int DAA(Emulator::CPU* cpu, int bytes);
+    int DADB(Emulator::CPU* cpu, int bytes);
+    int DADD(Emulator::CPU* cpu, int bytes);
+    int DADH(Emulator::CPU* cpu, int bytes);
+    int DADSP(Emulator::CPU* cpu, int bytes);
+    int DCRA(Emulator::CPU* cpu, int bytes);
+    int DCRB(Emulator::CPU* cpu, int bytes);
+    int DCRC(Emulator::CPU* cpu, int bytes);
+    int DCRD(Emulator::CPU* cpu, int bytes);
+    int DCRE(Emulator::CPU* cpu, int bytes);
+    int DCRH(Emulator::CPU* cpu, int bytes);
+    int DCRL(Emulator::CPU* cpu, int bytes);
+    int DCRM(Emulator::CPU* cpu, int bytes);
+    int DCXB(Emulator::CPU* cpu, int bytes);
+    int DCXD(Emulator::CPU* cpu, int bytes);
+    int DCXH(Emulator::CPU* cpu, int bytes);
+    int DCXSP(Emulator::CPU* cpu, int bytes);
+    int DI(Emulator::CPU* cpu, int bytes);
+    int EI(Emulator::CPU* cpu, int bytes);
+    int HLT(Emulator::CPU* cpu, int bytes);
+    int INPortAddress(Emulator::CPU* cpu, int bytes);
+    int INRA(Emulator::CPU* cpu, int bytes);
+    int INRB(Emulator::CPU* cpu, int bytes);
+    int INRC(Emulator::CPU* cpu, int bytes);
+    int INRD(Emulator::CPU* cpu, int bytes);
+    int INRE(Emulator::CPU* cpu, int bytes);
+    int INRH(Emulator::CPU* cpu, int bytes);
+    int INRL(Emulator::CPU* cpu, int bytes);
+    int INRM(Emulator::CPU* cpu, int bytes);
+    int INXB(Emulator::CPU* cpu, int bytes);
+    int INXD(Emulator::CPU* cpu, int bytes);
+    int INXH(Emulator::CPU* cpu, int bytes);
+    int INXSP(Emulator::CPU* cpu, int bytes);
+    int JCLabel(Emulator::CPU* cpu, int bytes);
+    int JMLabel(Emulator::CPU* cpu, int bytes);
+    int JMPLabel(Emulator::CPU* cpu, int bytes);
+    int JNCLabel(Emulator::CPU* cpu, int bytes);
+    int JNZLabel(Emulator::CPU* cpu, int bytes);
+    int JPLabel(Emulator::CPU* cpu, int bytes);
+    int JPELabel(Emulator::CPU* cpu, int bytes);
+    int JPOLabel(Emulator::CPU* cpu, int bytes);
+    int JZLabel(Emulator::CPU* cpu, int bytes);
+    int LDAAddress(Emulator::CPU* cpu, int bytes);
+    int LDAXB(Emulator::CPU* cpu, int bytes);
+    int LDAXD(Emulator::CPU* cpu, int bytes);
+    int LHLDAddress(Emulator::CPU* cpu, int bytes);
+    int LXIB(Emulator::CPU* cpu, int bytes);
+    int LXID(Emulator::CPU* cpu, int bytes);
+    int LXIH(Emulator::CPU* cpu, int bytes);
+    int LXISP(Emulator::CPU* cpu, int bytes);
+    int MOVAA(Emulator::CPU* cpu, int bytes);
+    int MOVAB(Emulator::CPU* cpu, int bytes);
+    int MOVAC(Emulator::CPU* cpu, int bytes);
+    int MOVAD(Emulator::CPU* cpu, int bytes);
+    int MOVAE(Emulator::CPU* cpu, int bytes);
+    int MOVAH(Emulator::CPU* cpu, int bytes);
+    int MOVAL(Emulator::CPU* cpu, int bytes);
+    int MOVAM(Emulator::CPU* cpu, int bytes);
+    int MOVBA(Emulator::CPU* cpu, int bytes);
+    int MOVBB(Emulator::CPU* cpu, int bytes);
+    int MOVBC(Emulator::CPU* cpu, int bytes);
+    int MOVBD(Emulator::CPU* cpu, int bytes);
+    int MOVBE(Emulator::CPU* cpu, int bytes);
+    int MOVBH(Emulator::CPU* cpu, int bytes);
+    int MOVBL(Emulator::CPU* cpu, int bytes);
+    int MOVBM(Emulator::CPU* cpu, int bytes);
+    int MOVCA(Emulator::CPU* cpu, int bytes);
+    int MOVCB(Emulator::CPU* cpu, int bytes);
+    int MOVCC(Emulator::CPU* cpu, int bytes);
+    int MOVCD(Emulator::CPU* cpu, int bytes);
+    int MOVCE(Emulator::CPU* cpu, int bytes);
+    int MOVCH(Emulator::CPU* cpu, int bytes);
+    int MOVCL(Emulator::CPU* cpu, int bytes);
+    int MOVCM(Emulator::CPU* cpu, int bytes);
+    int MOVDA(Emulator::CPU* cpu, int bytes);
+    int MOVDB(Emulator::CPU* cpu, int bytes);
+    int MOVDC(Emulator::CPU* cpu, int bytes);
+    int MOVDD(Emulator::CPU* cpu, int bytes);
+    int MOVDE(Emulator::CPU* cpu, int bytes);
+    int MOVDH(Emulator::CPU* cpu, int bytes);
+    int MOVDL(Emulator::CPU* cpu, int bytes);
+    int MOVDM(Emulator::CPU* cpu, int bytes);
+    int MOVEA(Emulator::CPU* cpu, int bytes);
+    int MOVEB(Emulator::CPU* cpu, int bytes);
+    int MOVEC(Emulator::CPU* cpu, int bytes);
+    int MOVED(Emulator::CPU* cpu, int bytes);
+    int MOVEE(Emulator::CPU* cpu, int bytes);
+    int MOVEH(Emulator::CPU* cpu, int bytes);
+    int MOVEL(Emulator::CPU* cpu, int bytes);
+    int MOVEM(Emulator::CPU* cpu, int bytes);
+    int MOVHA(Emulator::CPU* cpu, int bytes);
+    int MOVHB(Emulator::CPU* cpu, int bytes);
+    int MOVHC(Emulator::CPU* cpu, int bytes);
+    int MOVHD(Emulator::CPU* cpu, int bytes);
+    int MOVHE(Emulator::CPU* cpu, int bytes);
+    int MOVHH(Emulator::CPU* cpu, int bytes);
+    int MOVHL(Emulator::CPU* cpu, int bytes);
+    int MOVHM(Emulator::CPU* cpu, int bytes);
+    int MOVLA(Emulator::CPU* cpu, int bytes);
+    int MOVLB(Emulator::CPU* cpu, int bytes);
+    int MOVLC(Emulator::CPU* cpu, int bytes);
+    int MOVLD(Emulator::CPU* cpu, int bytes);
+    int MOVLE(Emulator::CPU* cpu, int bytes);
+    int MOVLH(Emulator::CPU* cpu, int bytes);
+    int MOVLL(Emulator::CPU* cpu, int bytes);
+    int MOVLM(Emulator::CPU* cpu, int bytes);
+    int MOVMA(Emulator::CPU* cpu, int bytes);
+    int MOVMB(Emulator::CPU* cpu, int bytes);
+    int MOVMC(Emulator::CPU* cpu, int bytes);
+    int MOVMD(Emulator::CPU* cpu, int bytes);
+    int MOVME(Emulator::CPU* cpu, int bytes);
+    int MOVMH(Emulator::CPU* cpu, int bytes);
+    int MOVML(Emulator::CPU* cpu, int bytes);
+    int MVIAData(Emulator::CPU* cpu, int bytes);
+    int MVIBData(Emulator::CPU* cpu, int bytes);
+    int MVICData(Emulator::CPU* cpu, int bytes);
+    int MVIDData(Emulator::CPU* cpu, int bytes);
+    int MVIEData(Emulator::CPU* cpu, int bytes);
+    int MVIHData(Emulator::CPU* cpu, int bytes);
+    int MVILData(Emulator::CPU* cpu, int bytes);
+    int MVIMData(Emulator::CPU* cpu, int bytes);
+    int NOP(Emulator::CPU* cpu, int bytes);
+    int ORAA(Emulator::CPU* cpu, int bytes);
+    int ORAB(Emulator::CPU* cpu, int bytes);
+    int ORAC(Emulator::CPU* cpu, int bytes);
+    int ORAD(Emulator::CPU* cpu, int bytes);
+    int ORAE(Emulator::CPU* cpu, int bytes);
+    int ORAH(Emulator::CPU* cpu, int bytes);
+    int ORAL(Emulator::CPU* cpu, int bytes);
+    int ORAM(Emulator::CPU* cpu, int bytes);
+    int ORIData(Emulator::CPU* cpu, int bytes);
+    int OUTPortAddress(Emulator::CPU* cpu, int bytes);
+    int PCHL(Emulator::CPU* cpu, int bytes);
+    int POPB(Emulator::CPU* cpu, int bytes);
+    int POPD(Emulator::CPU* cpu, int bytes);
+    int POPH(Emulator::CPU* cpu, int bytes);
+    int POPPSW(Emulator::CPU* cpu, int bytes);
+    int PUSHB(Emulator::CPU* cpu, int bytes);
+    int PUSHD(Emulator::CPU* cpu, int bytes);
+    int PUSHH(Emulator::CPU* cpu, int bytes);
+    int PUSHPSW(Emulator::CPU* cpu, int bytes);
+    int RAL(Emulator::CPU* cpu, int bytes);
+    int RAR(Emulator::CPU* cpu, int bytes);
+    int RC(Emulator::CPU* cpu, int bytes);
+    int RET(Emulator::CPU* cpu, int bytes);
+    int RIM(Emulator::CPU* cpu, int bytes);
+    int RLC(Emulator::CPU* cpu, int bytes);
+    int DSUB(Emulator::CPU* cpu, int bytes);
+    int RM(Emulator::CPU* cpu, int bytes);
+    int RNC(Emulator::CPU* cpu, int bytes);
+    int RNZ(Emulator::CPU* cpu, int bytes);
+    int RP(Emulator::CPU* cpu, int bytes);
+    int RPE(Emulator::CPU* cpu, int bytes);
+    int RPO(Emulator::CPU* cpu, int bytes);
+    int RRC(Emulator::CPU* cpu, int bytes);
+    int RST0(Emulator::CPU* cpu, int bytes);
+    int RST1(Emulator::CPU* cpu, int bytes);
+    int RST2(Emulator::CPU* cpu, int bytes);
+    int RST3(Emulator::CPU* cpu, int bytes);
+    int RST4(Emulator::CPU* cpu, int bytes);
+    int RST5(Emulator::CPU* cpu, int bytes);
+    int RST6(Emulator::CPU* cpu, int bytes);
+    int RST7(Emulator::CPU* cpu, int bytes);
+    int RZ(Emulator::CPU* cpu, int bytes);
+    int SBBA(Emulator::CPU* cpu, int bytes);
+    int SBBB(Emulator::CPU* cpu, int bytes);
+    int SBBC(Emulator::CPU* cpu, int bytes);
+    int SBBD(Emulator::CPU* cpu, int bytes);
+    int SBBE(Emulator::CPU* cpu, int bytes);
+    int SBBH(Emulator::CPU* cpu, int bytes);
+    int SBBL(Emulator::CPU* cpu, int bytes);
+    int SBBM(Emulator::CPU* cpu, int bytes);
+    int SBIData(Emulator::CPU* cpu, int bytes);
+    int SHLDAddress(Emulator::CPU* cpu, int bytes);
+    int SIM(Emulator::CPU* cpu, int bytes);
+    int SPHL(Emulator::CPU* cpu, int bytes);
+    int STAAddress(Emulator::CPU* cpu, int bytes);
+    int STAXB(Emulator::CPU* cpu, int bytes);
+    int STAXD(Emulator::CPU* cpu, int bytes);
+    int STC(Emulator::CPU* cpu, int bytes);
+    int SUBA(Emulator::CPU* cpu, int bytes);
+    int SUBB(Emulator::CPU* cpu, int bytes);
+    int SUBC(Emulator::CPU* cpu, int bytes);
+    int SUBD(Emulator::CPU* cpu, int bytes);
+    int SUBE(Emulator::CPU* cpu, int bytes);
+    int SUBH(Emulator::CPU* cpu, int bytes);
+    int SUBL(Emulator::CPU* cpu, int bytes);
+    int SUBM(Emulator::CPU* cpu, int bytes);
+    int SUIData(Emulator::CPU* cpu, int bytes);
+    int XCHG(Emulator::CPU* cpu, int bytes);
+    int XRAA(Emulator::CPU* cpu, int bytes);
+    int XRAB(Emulator::CPU* cpu, int bytes);
+    int XRAC(Emulator::CPU* cpu, int bytes);
+    int XRAD(Emulator::CPU* cpu, int bytes);
+    int XRAE(Emulator::CPU* cpu, int bytes);
+    int XRAH(Emulator::CPU* cpu, int bytes);
+    int XRAL(Emulator::CPU* cpu, int bytes);
+    int XRAM(Emulator::CPU* cpu, int bytes);
+    int XRIData(Emulator::CPU* cpu, int bytes);
+    int XTHL(Emulator::CPU* cpu, int bytes);
 
     //List of instructions declared in .cpp file.
     extern CPUInstruction CPUInstructions[256];
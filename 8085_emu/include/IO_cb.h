@@ -1,14 +1,73 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 namespace Emulator
 {
-	struct IOCallback
+	//Handlers for IN/OUT.
+	//Context is passed back to Function, so the same function can serve different peripherals (or different CPUs).
+
+	struct OutputHandler
+	{
+		void(*Function)(void* ctx, uint8_t out) = nullptr;
+		void* Context = nullptr;
+
+		inline void operator()(uint8_t out) const
+		{
+			Function(Context, out);
+		}
+
+		inline explicit operator bool() const
+		{
+			return Function != nullptr;
+		}
+	};
+
+	struct InputHandler
+	{
+		uint8_t(*Function)(void* ctx) = nullptr;
+		void* Context = nullptr;
+
+		inline uint8_t operator()() const
+		{
+			return Function(Context);
+		}
+
+		inline explicit operator bool() const
+		{
+			return Function != nullptr;
+		}
+	};
+
+	struct IOPort
+	{
+		OutputHandler OUTPUT;
+		InputHandler INPUT;
+	};
+
+	//Peripherals with state of their own (CPU::AddStateHandler()). Save() appends it to state, Load() gets back what Save() wrote.
+	struct StateHandler
 	{
-		uint16_t addr;
+		void(*Save)(void* ctx, std::vector<uint8_t>& state) = nullptr;
+		void(*Load)(void* ctx, const std::vector<uint8_t>& state) = nullptr;
+		void* Context = nullptr;
+	};
+
+	//Scheduled events (CPU::Schedule()). Called on the CPU's thread between instructions, with the cycle the event was due at.
+	struct EventHandler
+	{
+		void(*Function)(void* ctx, uint64_t cycle) = nullptr;
+		void* Context = nullptr;
+
+		inline void operator()(uint64_t cycle) const
+		{
+			Function(Context, cycle);
+		}
 
-		void(*OUTPUT)(uint8_t out) = nullptr;
-		uint8_t(*INPUT)() = nullptr;
+		inline explicit operator bool() const
+		{
+			return Function != nullptr;
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "memory.h"
+
+namespace InternalEmulator
+{
+	//Predecoded basic blocks, for the block core (see CPUswitch.cpp).
+	//A block is straight-line code starting at some address: it ends after the first instruction that can change PC,
+	//halt or change the interrupt state, or after MaxInstructions.
+	//Blocks are kept per start address and checked against the page generations in Memory, so self-modifying code
+	//(or the hex editor) invalidates them.
+
+	struct DecodedInstruction
+	{
+		uint8_t Opcode;
+		uint8_t Low; // First operand byte
+		uint8_t High; // Second operand byte
+	};
+
+	struct JitFrame;
+	typedef void(*JitFunction)(JitFrame* frame);
+
+	struct Block
+	{
+		static constexpr int MaxInstructions = 32; // At most 96 bytes, so a block is on 2 pages at most.
+
+		uint8_t Count = 0;
+
+		uint8_t Pages[2] = { 0, 0 };
+		uint32_t Generations[2] = { 0, 0 };
+
+		DecodedInstruction Instructions[MaxInstructions];
+
+		//JIT core only, see jit.h. Reset every time the block is decoded again.
+		uint32_t Hits = 0;
+		bool Translated = false; // Native can still be null after this, if the first instruction can't be translated.
+		JitFunction Native = nullptr;
+		long long NativeCost = 0; // Cycles the native code needs to be left in the loop, see Jit::Translate().
+	};
+
+	class BlockCache
+	{
+	private:
+		std::shared_ptr<Emulator::Memory> _Memory;
+
+		//One slot per start address, allocated the first time a block starts there.
+		std::vector<std::unique_ptr<Block>> _Blocks;
+
+		Block* Decode(uint16_t addr);
+
+	public:
+		BlockCache(std::shared_ptr<Emulator::Memory> memory);
+
+		inline Block* Get(uint16_t addr)
+		{
+			Block* block = _Blocks[addr].get();
+
+			if (block != nullptr &&
+				block->Generations[0] == _Memory->GetPageGeneration(block->Pages[0]) &&
+				block->Generations[1] == _Memory->GetPageGeneration(block->Pages[1]))
+			{
+				return block;
+			}
+
+			return Decode(addr);
+		}
+
+		//Forget all native code. Blocks are translated again when they get hot.
+		void DropNative();
+
+		//Instruction length, 1 for the empty opcodes (the switch core runs them as NOP).
+		static uint8_t GetLength(uint8_t opcode);
+
+		//True for the instructions that end a block.
+		static bool EndsBlock(uint8_t opcode);
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Emulator
+{
+	class CPU;
+}
+
+namespace InternalEmulator
+{
+	//High-level emulation of the bootloader routines (Bootloader.h in the assembler), see CPU::SetBootloaderHle().
+	//When the PC gets to one of them, the routine is done here in C++ instead of instruction by instruction:
+	//the same OUTs and INs in the same order, the same registers, flags and stack memory, the same cycles and instruction count.
+	//A routine only runs here if all of it would have run in this Loop() anyway. Otherwise the core runs it, like without HLE.
+	//The loops in DELA, DELB, KIND and the wait at the end of BEEP go on as far as the cycles allow, and stop at the top of the loop.
+	//Those loop labels are entry points too, so the core (or the next Loop()) hands them back to us there.
+	//Interrupts are taken between routines, or between iterations of those loops.
+
+	class BootloaderHle
+	{
+	public:
+		//Every label we need: the routines, then the loops in them.
+		enum Label : uint8_t
+		{
+			NoLabel = 0,
+			LabelDCD, LabelSTDM, LabelSTDC, LabelCLEARDISPLAY, LabelBEEP, LabelBEEPFD, LabelDELA, LabelDELB, LabelKIND,
+			LabelWAIT_BEEP, LabelDELA1, LabelDELB1, LabelKIND0, LabelKIND1, LabelKIND2, LabelKIND3,
+			LabelKINDDONE, // Not an entry point. The end of the code we check.
+			LabelCount
+		};
+
+	private:
+		//The bootloader is below CODE (0800H).
+		static constexpr int Size = 0x0800;
+
+		uint8_t _Labels[Size] = {}; // The entry point at every address.
+		uint16_t _Addresses[LabelCount] = {};
+
+		//The routines as they were in SetLabels(). A program that writes over one has its own code there, so no HLE for that one.
+		uint16_t _CodeStart = 0;
+		std::vector<uint8_t> _Code;
+
+		//The code that label runs (its routine and the ones it calls) is still the same.
+		bool IsIntact(uint8_t* mem, uint8_t label);
+
+	public:
+		//labels is Assembly::Labels. If a routine is missing, or doesn't start like the one in Bootloader.h, nothing is emulated.
+		void SetLabels(Emulator::CPU* cpu, const std::vector<std::pair<std::string, uint16_t>>& labels);
+
+		//A routine, or a loop in one, starts at pc.
+		inline bool Has(uint16_t pc)
+		{
+			return pc < Size && _Labels[pc] != NoLabel;
+		}
+
+		//State has to be written back, at the top of the loop: before the cycle check, with the hanging cycles not added yet.
+		//Returns true if it ran anything.
+		bool Arrive(Emulator::CPU* cpu);
+	};
+}
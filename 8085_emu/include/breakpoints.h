@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+namespace InternalEmulator
+{
+	//One bit for every address (8 KB), so checking PC costs the same no matter how many breakpoints there are.
+	//Add/Remove are called from the GUI thread while the CPU thread is checking, so the words are atomic.
+	//Relaxed is enough: a breakpoint that shows up one instruction late doesn't matter.
+
+	class BreakpointMap
+	{
+	private:
+		std::atomic<uint64_t> _Bits[0x10000 / 64];
+
+		//How many addresses have a breakpoint. 0 = skip the bitmap completely.
+		std::atomic<int> _Count;
+
+		//More than one line can end up on the same address. Only used by Add/Remove.
+		std::unordered_map<uint16_t, int> _References;
+
+	public:
+		BreakpointMap()
+		{
+			Clear();
+		}
+
+		BreakpointMap(const BreakpointMap&) = delete;
+		BreakpointMap& operator=(const BreakpointMap&) = delete;
+
+		void Add(uint16_t addr)
+		{
+			if (_References[addr]++ == 0)
+			{
+				_Bits[addr >> 6].fetch_or(1ull << (addr & 63), std::memory_order_relaxed);
+				_Count.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		void Remove(uint16_t addr)
+		{
+			auto it = _References.find(addr);
+			if (it == _References.end())
+				return;
+
+			if (--it->second == 0)
+			{
+				_References.erase(it);
+				_Bits[addr >> 6].fetch_and(~(1ull << (addr & 63)), std::memory_order_relaxed);
+				_Count.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		void Clear()
+		{
+			for (auto& word : _Bits)
+			{
+				word.store(0, std::memory_order_relaxed);
+			}
+
+			_Count.store(0, std::memory_order_relaxed);
+			_References.clear();
+		}
+
+		inline bool Any() const
+		{
+			return _Count.load(std::memory_order_relaxed) != 0;
+		}
+
+		inline bool Has(uint16_t addr) const
+		{
+			return (_Bits[addr >> 6].load(std::memory_order_relaxed) >> (addr & 63)) & 1;
+		}
+
+		//What the CPU calls for every instruction.
+		inline bool Check(uint16_t addr) const
+		{
+			return Any() && Has(addr);
+		}
+	};
+}
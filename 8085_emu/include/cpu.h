@@ -1,12 +1,30 @@
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "memory.h"
 #include "stack.h"
+#include "breakpoints.h"
+#include "block_cache.h"
+#include "jit.h"
+#include "idle_loop.h"
+#include "bootloader_hle.h"
+#include "scheduler.h"
+#include "timing.h"
+#include "perf_counters.h"
+#include "snapshot.h"
+#include "rewind.h"
+#include "trace.h"
+#include "profiler.h"
+#include "cpu_state.h"
 #include "register.h"
 #include "IO_cb.h"
 
@@ -26,72 +44,140 @@ namespace Emulator
 		EmptyStackPop = 1
 	};
 
+	//Which implementation executes the instructions.
+	enum CPUCores
+	{
+		TableCore = 0, //CPUInstructions function pointer table. This is the reference implementation.
+		SwitchCore = 1, //One big switch over local copies of the registers. Much faster, same behaviour.
+		BlockCore = 2, //The switch core, running predecoded basic blocks. Interrupts are taken between blocks.
+		JitCore = 3 //The block core, with hot blocks translated to x86-64. The same as BlockCore on other hosts.
+	};
+
+	//For RaiseInterrupt() and ScheduleInterrupt().
+	enum InterruptLines
+	{
+		Interrupt55 = 0, //RST 5.5
+		Interrupt65 = 1, //RST 6.5
+		Interrupt75 = 2, //RST 7.5
+		InterruptINTR = 3 //INTR, goes to INTR_ROUTINE.
+	};
+
 	//Clock speed it 3.2mhz
 	//We divide that in CLOCK_ACCURACY steps.
 	//More explanation in .cpp file.
 
 	class CPU
 	{
+		friend class Rewind;
+
 	private:
-		//Each instruction takes multiple cycles in the real 8085.
-		//Here, we execute them all in one or in a few lines of code.
-		//So, for us it's only "one cycle". So we will do absolutely nothing for the next few cycles.
-		//how many, depending on the instruction.
-		int _HangingCycles;
 		bool _Running;
 		bool _Halted;
+		bool _AlreadyHalted = false;
+		bool _WaitingForInterrupt = false; // Halted by HLT, not by a breakpoint or a pause.
 
-		std::vector<IOCallback> IOInterface;
-	public:
-		static CPU* cpu;
+		//See Schedule().
+		InternalEmulator::Scheduler _Scheduler;
 
-		std::vector<int>& _Breakpoints;
-		std::shared_ptr<uint16_t> _BreakpointsArr;
-		size_t _BreakpointsArrSize;
-		std::shared_ptr<uint16_t> _Symbols;
-		size_t _SymbolSize;
+		void SetPending(InterruptLines line);
+		void UpdateLoopLimit();
 
-		ErrorCodes ErrorCode = None;
+		//Interrupts() once it knows which one. Pushes PC and jumps to the vector.
+		void TakeInterrupt(InterruptLines line);
 
+		//RunEvents() without picking up what was posted.
+		void RunDueEvents(uint64_t now);
 
-		std::shared_ptr<Memory> _Memory;
-		std::shared_ptr<InternalEmulator::Stack> _Stack;
+		//Loop() and Step() with a tracer, see SetTracer() and Trace.cpp.
+		void RunTraced();
+		void TracedInstruction(uint8_t* mem);
+		void TraceInterrupt(InterruptLines line);
+
+		//See WaitForWake().
+		std::mutex _WakeMutex;
+		std::condition_variable _WakeCondition;
+		uint64_t _Wakes = 0;
+
+		CPUCores _Core;
+
+		//One slot for every port. Ports nobody registered have empty handlers: IN leaves A as it is, OUT does nothing.
+		std::array<IOPort, 256> _IOPorts;
+
+		//Not for the table core. See SetLazyFlags().
+		bool _LazyFlags = false;
+
+		//See SetCycleExact().
+		bool _CycleExact = false;
+
+		//See SaveState(). The pages memory had at the last SaveState() or LoadState(), the next snapshot shares the ones that didn't change.
+		std::array<SnapshotPage, SnapshotPageCount> _SnapshotPages;
+		std::vector<StateHandler> _StateHandlers;
+
+		//Block and JIT core only.
+		std::unique_ptr<InternalEmulator::BlockCache> _BlockCache;
 
-		std::shared_ptr <Register8> A;
-		std::shared_ptr <Register8> B;
-		std::shared_ptr <Register8> C;
-		std::shared_ptr <Register8> D;
-		std::shared_ptr <Register8> E;
-		std::shared_ptr <Register8> H;
-		std::shared_ptr <Register8> L;
+		//JIT core on x86-64 only.
+		std::unique_ptr<InternalEmulator::Jit> _Jit;
 
-		std::shared_ptr <Register8> Flags;
+		//See SetIdleSkip().
+		bool _IdleSkip = false;
+		InternalEmulator::IdleLoops _IdleLoops;
 
-		std::shared_ptr <Register> PC;
-		std::shared_ptr <Register> SP;
+		//See SetBootloaderHle().
+		bool _BootloaderHle = false;
+		InternalEmulator::BootloaderHle _Bootloader;
 
+		//Switch, block and JIT core, see CPUswitch.cpp.
+		//SingleStep = true runs exactly one instruction, like Clock(). Otherwise it runs like Loop().
+		template <bool SingleStep, bool LazyFlags, bool Blocks>
+		void RunSwitch();
 	public:
+		std::vector<int>& _Breakpoints; // Lines, owned by the editor.
+		std::vector<int> _BreakpointLines; // Lines that are currently in _BreakpointMap.
+		InternalEmulator::BreakpointMap _BreakpointMap; // Addresses.
+		std::shared_ptr<uint16_t> _Symbols;
+		size_t _SymbolSize = 0;
+
+		ErrorCodes ErrorCode = None;
 
-		bool _InterruptsEnabled = false;
 
-		bool _M55 = true;
-		bool _M65 = true;
-		bool _M75 = true;
+		std::shared_ptr<Memory> _Memory;
+		std::shared_ptr<InternalEmulator::Stack> _Stack;
 
-		bool _IP55 = false;
-		bool _IP65 = false;
-		bool _IP75 = false;
+		//Registers, flags, interrupts and cycle counters. The instructions work directly on this.
+		CpuState State;
 
-		bool _IPINTR = false;
-		uint16_t INTR_ADDR = 0;
+		//Views into State. For everything outside of the emulator, e.g. Registers Window.
+		Register8 A{ &State.A };
+		Register8 B{ &State.B };
+		Register8 C{ &State.C };
+		Register8 D{ &State.D };
+		Register8 E{ &State.E };
+		Register8 H{ &State.H };
+		Register8 L{ &State.L };
+
+		Register8 Flags{ &State.Flags };
+
+		Register PC{ &State.PC };
+		Register SP{ &State.SP };
+
+	public:
 
 		double _ClockCyclesPerLoop = 0;
-		long long _CurrentCycles = 0;
+
+		//What CurrentCycles can run to in this Loop(): _ClockCyclesPerLoop, or less if an event is due before that.
+		//The cores (and idle loop skipping, the bootloader HLE) stop there and RunEvents().
+		double _LoopLimit = 0;
 
 	public:
 
-		CPU(std::shared_ptr<Memory> memory, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>>& symbols);
-		CPU(std::shared_ptr<uint8_t> memory, size_t size, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>> symbols);
+		//memory is all 64 KB, 0x10000 bytes.
+		CPU(std::shared_ptr<Memory> memory, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>>& symbols, CPUCores core = TableCore);
+		CPU(std::shared_ptr<uint8_t> memory, size_t size, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>> symbols, CPUCores core = TableCore);
+
+		//The register views point into this object.
+		CPU(const CPU&) = delete;
+		CPU& operator=(const CPU&) = delete;
 		
 		void SetClock(int clock_speed, int accuracy);
 
@@ -122,6 +208,58 @@ namespace Emulator
 		inline void SetHalted(bool halted)
 		{
 			_Halted = halted;
+
+			if (!halted)
+				_WaitingForInterrupt = false;
+		}
+
+		//HLT: halted until an interrupt.
+		inline void Hlt()
+		{
+			_Halted = true;
+			_WaitingForInterrupt = true;
+		}
+
+		inline bool GetWaitingForInterrupt()
+		{
+			return _WaitingForInterrupt;
+		}
+
+		//For peripherals, from any thread. The interrupt is pending from the start of the next Loop() (or RunEvents()).
+		//Also wakes up WaitForWake().
+		void RaiseInterrupt(InterruptLines line);
+
+		//From the CPU's thread only: before running, or in an event handler. cycle is a State.TotalCycles value.
+		//The event happens between instructions, before the first one that starts at cycle or later.
+		//Handlers get the cycle they were due at, so a timer can schedule its next tick from there without drifting.
+		void Schedule(uint64_t cycle, EventHandler handler);
+		void ScheduleInterrupt(uint64_t cycle, InterruptLines line);
+
+		//When the next event is due, UINT64_MAX if there's none.
+		inline uint64_t GetNextEvent()
+		{
+			return _Scheduler.Next();
+		}
+
+		//Runs the events that are due and sets _LoopLimit. Loop() does this itself, call it when you take interrupts without Loop().
+		void RunEvents();
+
+		//Anything else a thread in WaitForWake() should look at (run, step, stop...).
+		void Wake();
+
+		//How many times Wake() was called. Read it before looking at the state, then pass it to WaitForWake(), so no wake up is lost.
+		uint64_t GetWakes();
+
+		//Blocks until Wake() was called since GetWakes() returned wakes, or until the deadline. Returns true if it was woken up.
+		bool WaitForWake(uint64_t wakes, std::chrono::steady_clock::time_point deadline);
+
+		//The clock keeps running in HLT. The cycles that passed while nobody ran Loop().
+		inline void AddHaltedCycles(uint64_t cycles)
+		{
+			State.TotalCycles += cycles;
+
+			if (_Rewind != nullptr)
+				_Rewind->RecordEntry({ State.TotalInstructions, cycles, Rewind::Entry::HaltedCycles, 0 });
 		}
 
 		inline bool GetHalted()
@@ -129,20 +267,153 @@ namespace Emulator
 			return _Halted;
 		}
 
+		inline CPUCores GetCore()
+		{
+			return _Core;
+		}
+
+		//Not for the table core: compute the flags only when something reads them, instead of after every ALU instruction.
+		//State.Flags is always up to date after Loop()/Clock().
+		inline void SetLazyFlags(bool lazy)
+		{
+			_LazyFlags = lazy;
+		}
+
+		inline bool GetLazyFlags()
+		{
+			return _LazyFlags;
+		}
+
+		//Any core: count the documented 8085 T-states of every instruction (timing.h), including the cheaper branches not taken.
+		//Otherwise an instruction counts one cycle more than its T-states and a branch not taken counts 2, as it always has.
+		//The JIT core runs as the block core, and there's no bootloader HLE: both have the other counts built in.
+		inline void SetCycleExact(bool exact)
+		{
+			_CycleExact = exact;
+		}
+
+		inline bool GetCycleExact()
+		{
+			return _CycleExact;
+		}
+
+		//What the CPU did so far, from any thread. Published by Loop(), Step() and AddSleep(), at most PerfPublishInterval ago.
+		inline PerfCounts GetPerfCounts()
+		{
+			return _PerfCounters.Read();
+		}
+
+		//From the thread that runs Loop(): publish them now, so GetPerfCounts() has everything.
+		void PublishPerfCounts();
+
+		//Count every opcode in PerfCounts::Opcodes. That needs the interpreter, so the JIT core runs as the block core.
+		inline void SetOpcodeCounting(bool count)
+		{
+			_CountOpcodes = count;
+		}
+
+		inline bool GetOpcodeCounting()
+		{
+			return _CountOpcodes;
+		}
+
+		//From the thread that runs Loop(): it slept between two of them, and woke up overshoot ns later than it asked for.
+		void AddSleep(uint64_t overshootNs);
+
+		//Any core: delay loops (DELA, DELB) and busy waits (KIND) are skipped in one step instead of running them,
+		//with the same registers and cycles at the end. See idle_loop.h.
+		//An IN in such a loop is only read once per Loop(), so a key press can be noticed one Loop() later.
+		inline void SetIdleSkip(bool skip)
+		{
+			_IdleSkip = skip;
+		}
+
+		inline bool GetIdleSkip()
+		{
+			return _IdleSkip;
+		}
+
+		//The last Loop() was waiting in a loop only an IN or an interrupt can end. Nothing to do until then.
+		inline bool IsIdle()
+		{
+			return _IdleSkip && _IdleLoops.IsIdle();
+		}
+
+		//Any core: the routines of the bootloader (STDM, DELA, KIND...) are done in C++ when they're called, instead of running them.
+		//The same outputs, registers, memory and cycles at the end. See bootloader_hle.h.
+		//Needs SetBootloaderLabels() first. Breakpoints and Step() always run them instruction by instruction.
+		inline void SetBootloaderHle(bool hle)
+		{
+			_BootloaderHle = hle;
+		}
+
+		inline bool GetBootloaderHle()
+		{
+			return _BootloaderHle;
+		}
+
+		//Where the assembler put the routines (Assembly::Labels). Call it before running, the code is checked against memory as it is now.
+		inline void SetBootloaderLabels(const std::vector<std::pair<std::string, uint16_t>>& labels)
+		{
+			_Bootloader.SetLabels(this, labels);
+		}
+
 		inline std::shared_ptr<Memory> GetMemory()
 		{
 			return _Memory;
 		}
 
+		//From the CPU's thread, between Loop()s: registers, interrupts, scheduled events, all 64 KB of memory and the peripherals'
+		//state (AddStateHandler()). Pages that didn't change since the last SaveState()/LoadState() are shared with that snapshot,
+		//so taking one is mostly comparing memory, a few microseconds.
+		//Breakpoints, settings (SetIdleSkip()...) and the performance counters are not part of it.
+		Snapshot SaveState();
+
+		//Only the pages that differ are copied back. Cached blocks on those are decoded again.
+		void LoadState(const Snapshot& snapshot);
+
+		//Peripherals the CPU doesn't know about (displays, latches) are saved and loaded with it. Add them before the first SaveState().
+		inline void AddStateHandler(StateHandler handler)
+		{
+			_StateHandlers.push_back(handler);
+		}
+
+		//Everything that comes from outside (INs, interrupts, events) is journaled into rewind, nullptr for nothing.
+		//Rewind::Start() sets it.
+		inline void SetRewind(Rewind* rewind)
+		{
+			_Rewind = rewind;
+		}
+
+		//Every instruction from now on is written to tracer (opened already), nullptr to stop. See trace.h.
+		//Any core: with a tracer, Loop() runs one instruction at a time like the table core, without idle loop skipping or the bootloader HLE.
+		//Without one, nothing in the cores looks at it, Loop() checks once.
+		void SetTracer(TraceWriter* tracer);
+
+		inline TraceWriter* GetTracer()
+		{
+			return _Tracer;
+		}
+
+		//Every instruction is counted into profiler, nullptr for nothing. See profiler.h.
+		//Any core, but it needs every instruction: the JIT core runs as the block core, and idle loop skipping and the bootloader HLE are off.
+		//Instructions run again while rewinding aren't counted twice.
+		inline void SetProfiler(Profiler* profiler)
+		{
+			_Profiler = profiler;
+		}
+
+		inline Profiler* GetProfiler()
+		{
+			return _Profiler;
+		}
+
 
 		//Read memory at location pointed by H,L. Return unsigned.
 		inline uint8_t GetUnsignedM()
 		{
-			uint8_t H = cpu->H->GetUnsigned();
-			uint8_t L = cpu->L->GetUnsigned();
-
-			uint16_t addr = (H << 8) | L;
-			uint8_t result = cpu->GetMemory()->GetDataAtAddr(addr);
+			uint16_t addr = (State.H << 8) | State.L;
+			uint8_t result = _Memory->GetDataAtAddr(addr);
 
 			return result;
 		}
@@ -150,20 +421,14 @@ namespace Emulator
 		//Read memory at location pointed by H,L. Return signed
 		inline int8_t GetSignedM()
 		{
-			uint8_t H = cpu->H->GetSigned();
-			uint8_t L = cpu->L->GetSigned();
-
-			uint16_t addr = (H << 8) | L;
-			uint8_t result = cpu->GetMemory()->GetDataAtAddr(addr);
-
-			return *(int8_t*)&result;
+			return (int8_t)GetUnsignedM();
 		}
 
 		//Increment PC and then read the data at that address.
 		inline uint8_t NextPC()
 		{
-			PC->Increment();
-			uint8_t ret = _Memory->GetDataAtAddr(PC->Get());
+			State.PC++;
+			uint8_t ret = _Memory->GetDataAtAddr(State.PC);
 
 			return ret;
 		}
@@ -171,15 +436,101 @@ namespace Emulator
 		//Read current PC without incrementing.
 		inline uint8_t ReadPC()
 		{
-			return _Memory->GetDataAtAddr(PC->Get());
+			return _Memory->GetDataAtAddr(State.PC);
+		}
+
+		//Only the handlers that are set are replaced. So one peripheral can take IN and another OUT on the same port.
+		inline void AddIOInterface(uint8_t port, OutputHandler OUTPUT, InputHandler INPUT)
+		{
+			if (OUTPUT)
+				_IOPorts[port].OUTPUT = OUTPUT;
+
+			if (INPUT)
+				_IOPorts[port].INPUT = INPUT;
+		}
+
+		//For handlers that don't need a context. The function itself is passed as the context.
+		inline void AddIOInterface(uint8_t port, void(*OUTPUT)(uint8_t out), uint8_t(*INPUT)())
+		{
+			OutputHandler output;
+			InputHandler input;
+
+			if (OUTPUT != nullptr)
+				output = { [](void* ctx, uint8_t out) { reinterpret_cast<void(*)(uint8_t)>(ctx)(out); }, reinterpret_cast<void*>(OUTPUT) };
+
+			if (INPUT != nullptr)
+				input = { [](void* ctx) { return reinterpret_cast<uint8_t(*)()>(ctx)(); }, reinterpret_cast<void*>(INPUT) };
+
+			AddIOInterface(port, output, input);
+		}
+
+		inline const IOPort& GetIOPort(uint8_t port) { return _IOPorts[port]; }
+
+		//IN and OUT, counted. A stays as it is on a port nobody reads.
+		//instruction is State.TotalInstructions at the IN (or before it), for the rewind journal.
+		inline uint8_t ReadPort(uint8_t port, uint8_t A, uint64_t instruction)
+		{
+			_Perf.In[port]++;
+
+			if (_Rewind != nullptr)
+				return RewindReadPort(port, A, instruction);
+
+			const IOPort& handler = _IOPorts[port];
+			return handler.INPUT ? handler.INPUT() : A;
+		}
+
+		inline void WritePort(uint8_t port, uint8_t value)
+		{
+			_Perf.Out[port]++;
+
+			const IOPort& handler = _IOPorts[port];
+
+			if (handler.OUTPUT)
+			{
+				handler.OUTPUT(value);
+			}
 		}
 
-		inline void AddIOInterface(uint16_t addr, void(*OUTPUT)(uint8_t out), uint8_t(*INPUT)())
+		//An interrupt was taken, before instruction (State.TotalInstructions).
+		inline void TookInterrupt(InterruptLines line, uint64_t instruction)
 		{
-			IOInterface.push_back({ addr, OUTPUT, INPUT });
+			_Perf.Interrupts[line]++;
+
+			if (_Rewind != nullptr)
+				RewindInterrupt(line, instruction);
+
+			if (_Tracer != nullptr)
+				TraceInterrupt(line);
 		}
 
-		inline std::vector<IOCallback> GetIOInterface() { return IOInterface; }
+	private:
+		//ReadPort() and TookInterrupt() while rewinding is on: from the journal when replaying, into it otherwise.
+		//Out of line, the cores inline the others.
+		uint8_t RewindReadPort(uint8_t port, uint8_t A, uint64_t instruction);
+		void RewindInterrupt(InterruptLines line, uint64_t instruction);
+
+		//See GetPerfCounts(). _Perf is only touched by the thread running the CPU, the others read _PerfCounters.
+		//Last, they're big: everything the cores use stays close to the start of the CPU.
+		bool _CountOpcodes = false;
+		PerfCounts _Perf;
+		PerfCounters _PerfCounters;
+
+		//Publishing copies all of them, it would take longer than a short Loop().
+		static constexpr std::chrono::milliseconds PerfPublishInterval{ 10 };
+		std::chrono::steady_clock::time_point _PerfPublished;
+
+		void PublishPerf(std::chrono::steady_clock::time_point now);
+
+		//See SetRewind().
+		Rewind* _Rewind = nullptr;
+
+		//See SetTracer(). The record of the next instruction, with the interrupt taken before it.
+		TraceWriter* _Tracer = nullptr;
+		TraceRecord _TracePending;
+		int8_t _TraceInterrupt = -1;
+
+		//See SetProfiler().
+		Profiler* _Profiler = nullptr;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Emulator
+{
+	//All of the CPU's state in one flat struct.
+	//No pointers in here, so it fits in a single cache line and copying it is a complete snapshot of the CPU.
+	//(Memory is not part of it.)
+
+	struct alignas(64) CpuState
+	{
+		uint8_t A = 0;
+		uint8_t B = 0;
+		uint8_t C = 0;
+		uint8_t D = 0;
+		uint8_t E = 0;
+		uint8_t H = 0;
+		uint8_t L = 0;
+
+		uint8_t Flags = 0;
+
+		uint16_t PC = 0;
+		uint16_t SP = 0xffff;
+
+		//Address of the "INTR_ROUTINE" label. 0 means there is no INTR routine.
+		uint16_t INTR_ADDR = 0;
+
+		bool InterruptsEnabled = false;
+
+		//M = mask
+		bool M55 = true;
+		bool M65 = true;
+		bool M75 = true;
+
+		//IP = Interrupt Pending
+		bool IP55 = false;
+		bool IP65 = false;
+		bool IP75 = false;
+		bool IPINTR = false;
+
+		//Each instruction takes multiple cycles in the real 8085.
+		//Here, we execute them all in one or in a few lines of code.
+		//So, for us it's only "one cycle". So we will do absolutely nothing for the next few cycles.
+		//how many, depending on the instruction.
+		int HangingCycles = 0;
+
+		//Cycles counted in the current loop.
+		long long CurrentCycles = 0;
+
+		//Cycles counted since the CPU was created.
+		uint64_t TotalCycles = 0;
+
+		//Instructions run since the CPU was created.
+		uint64_t TotalInstructions = 0;
+	};
+
+	static_assert(sizeof(CpuState) == 64, "CpuState should fit in one cache line");
+
+	//An interrupt that the core would take before the next instruction.
+	inline bool InterruptWaiting(const CpuState& s)
+	{
+		return s.InterruptsEnabled &&
+			((!s.M75 && s.IP75) || (!s.M65 && s.IP65) || (!s.M55 && s.IP55) || (s.IPINTR && s.INTR_ADDR != 0));
+	}
+
+	//Bit helpers, for Flags mostly.
+
+	inline uint8_t GetBit(uint8_t reg, uint8_t bit)
+	{
+		return (reg >> bit) & 0x01;
+	}
+
+	inline void ClearBit(uint8_t& reg, uint8_t bit)
+	{
+		reg = reg & (~(1 << bit));
+	}
+
+	inline void SetBit(uint8_t& reg, uint8_t bit, uint8_t value = 1)
+	{
+		value &= 0x01;
+		if (value)
+			reg = reg | (1 << bit);
+		else
+			ClearBit(reg, bit);
+	}
+}
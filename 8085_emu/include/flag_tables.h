@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "cpu.h"
+
+namespace InternalEmulator
+{
+	//Sign, zero and parity flags for every 8 bit value, generated at compile time.
+	//Everything else (aux carry, carry) depends on the operands, not only on the result.
+
+	constexpr std::array<uint8_t, 256> MakeSZPTable()
+	{
+		std::array<uint8_t, 256> table = {};
+
+		for (int n = 0; n < 256; n++)
+		{
+			int bits = 0;
+			for (int i = 0; i < 8; i++)
+			{
+				bits += (n >> i) & 1;
+			}
+
+			table[n] = ((n & 0x80) ? (1 << SIGN_FLAG) : 0) |
+				((n == 0) ? (1 << ZERO_FLAG) : 0) |
+				((bits % 2 == 0) ? (1 << PARITY_FLAG) : 0);
+		}
+
+		return table;
+	}
+
+	inline constexpr std::array<uint8_t, 256> SZPTable = MakeSZPTable();
+
+	//1 if n has an even number of set bits.
+	inline uint8_t Parity(uint8_t n)
+	{
+		return (SZPTable[n] >> PARITY_FLAG) & 1;
+	}
+
+	//The flags of the ALU instructions, shared by the switch core and the JIT.
+
+	//Same as SetFlagsBasedOn() in CPUinstructions.cpp. Aux carry and carry always end up set there.
+	inline uint8_t FlagsBasedOn(uint8_t n)
+	{
+		return SZPTable[n] | (1 << AUX_CARRY_FLAG) | (1 << CARRY_FLAG);
+	}
+
+	//Flags of AddSigned() and AddSignedWithCarry(). carry is 0 for ADD/ADI.
+	inline uint8_t AddFlags(uint8_t A, uint8_t value, uint8_t carry)
+	{
+		int8_t rA = A;
+		int8_t data = value;
+
+		int16_t result16 = rA + data + carry;
+		int8_t result = rA + data + carry;
+		int8_t result4 = rA + (data & 0x0f) + carry;
+
+		return (SZPTable[(uint8_t)result] & ((1 << SIGN_FLAG) | (1 << PARITY_FLAG))) |
+			((result != 0) << ZERO_FLAG) |
+			(((result4 & 0xf0) > 0) << AUX_CARRY_FLAG) |
+			(((result16 & 0b100000000) > 0) << CARRY_FLAG);
+	}
+
+	//Flags of SUB, SBB, SUI and SBI. carry is 0 for SUB/SUI.
+	inline uint8_t SubtractFlags(uint8_t A, uint8_t value, uint8_t carry)
+	{
+		int8_t rA = A;
+		int8_t other = (~(value + carry)) + 1;
+		int16_t res = rA + other;
+
+		uint8_t F = FlagsBasedOn(rA);
+
+		if ((res & 0xff) != res)
+			F |= (1 << CARRY_FLAG);
+		else
+			F &= ~(1 << CARRY_FLAG);
+
+		return F;
+	}
+
+	//Flags of ANA/ANI, from the result. Zero is set when the result is NOT 0, like in And().
+	inline uint8_t AndFlags(uint8_t result)
+	{
+		return (SZPTable[result] & ((1 << SIGN_FLAG) | (1 << PARITY_FLAG))) |
+			((result != 0) << ZERO_FLAG);
+	}
+
+	//CMP/CPI. Signed, and only carry and zero change.
+	inline void Compare(uint8_t A, uint8_t& F, int8_t other)
+	{
+		int8_t rA = A;
+
+		if (rA < other)
+		{
+			F |= (1 << CARRY_FLAG);
+			F &= ~(1 << ZERO_FLAG);
+		}
+		else if (rA == other)
+		{
+			F &= ~(1 << CARRY_FLAG);
+			F |= (1 << ZERO_FLAG);
+		}
+		else
+		{
+			F &= ~((1 << CARRY_FLAG) | (1 << ZERO_FLAG));
+		}
+	}
+
+	//DAD. Carry is bit 15 of the result.
+	inline void Dad(uint8_t& H, uint8_t& L, uint8_t& F, uint16_t value)
+	{
+		uint16_t HL = ((H << 8) | L) + value;
+
+		if (HL & 0x8000)
+			F |= (1 << CARRY_FLAG);
+		else
+			F &= ~(1 << CARRY_FLAG);
+
+		H = HL >> 8;
+		L = HL & 0xff;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Emulator
+{
+	class CPU;
+}
+
+namespace InternalEmulator
+{
+	//Delay loops and busy waits (CPU::SetIdleSkip()).
+	//The cores call Arrive() at the top of their loop, after a jump went backwards. From there we run ONE iteration of the loop
+	//ourselves, instruction by instruction, and keep track of what every value depends on:
+	//  - the same in every iteration (MVI A,02H / the return address of CALL DCD),
+	//  - the counter: the one register (or pair) that is counted up or down by 1 (DCX B in DELA),
+	//    and everything computed from it with MOV, CPI/CMP, INR/DCR,
+	//  - whatever a register had when the iteration started, as long as it's only moved around (PUSH PSW/POP PSW).
+	//If the iteration ends back at the start with the same memory, the same stack, and every register it actually used unchanged,
+	//the next iterations are the same except for the counter. We know which way every branch on the counter goes for each of them,
+	//so we skip as many as the branches and the cycles of this loop allow, in one step: the counter, the registers and flags
+	//computed from it, the cycles and the instruction count end up exactly where stepping would have put them.
+	//OUTs are done again for every skipped iteration, with the right values. INs are assumed to return the same thing
+	//until the end of the loop (one Loop() at most), that's what lets us skip KIND polling the keyboard.
+	//Anything else (HLT, EI/DI, RST, an ALU instruction on the counter...) and we just stop, after running it exactly like the core would.
+
+	class IdleLoops
+	{
+	private:
+		//Loops that couldn't be skipped aren't looked at again for a while.
+		//Running an iteration ourselves is slower than the core, so we don't when the loop doesn't have room to skip enough.
+		struct Head
+		{
+			uint16_t PC = 0;
+			uint16_t Wait = 0; // Arrivals to ignore.
+			uint8_t Failures = 0;
+			long long Cycles = 0; // Of one iteration, the last time we ran it.
+		};
+
+		static constexpr int HeadCount = 64;
+		Head _Heads[HeadCount];
+
+		bool _Idle = false;
+
+	public:
+		//At most this many instructions in one iteration, CALLs included.
+		static constexpr int MaxInstructions = 1024;
+
+		//Only worth it if at least this many iterations can be skipped after the one we run.
+		static constexpr int MinSkip = 4;
+
+		//State has to be written back, at the top of the loop: before the cycle check, with the hanging cycles not added yet.
+		void Arrive(Emulator::CPU* cpu);
+
+		//True if the last loop we skipped has no counter, so only an IN (or an interrupt) can end it.
+		//Reset at the start of every Loop().
+		inline bool IsIdle() { return _Idle; }
+		inline void ClearIdle() { _Idle = false; }
+	};
+}
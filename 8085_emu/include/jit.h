@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "block_cache.h"
+
+namespace InternalEmulator
+{
+	//x86-64 translator for the JIT core (JitCore).
+	//Blocks from the block cache that ran HotThreshold times are translated to native code. The native code runs the block
+	//up to the first instruction it can't translate (IN/OUT, HLT, EI/DI, RIM/SIM, POP B), and the interpreter takes it from there.
+	//It returns right after a store into code, like the block core does.
+	//A block that jumps back to its own start (delay loops) keeps looping in native code while the cycle budget allows.
+	//On other hosts IsSupported() is false, and the JIT core runs like the block core.
+
+	//The registers, as the native code sees them. Pairs are little endian words: BC at 0, DE at 2, HL at 4.
+	struct JitFrame
+	{
+		uint8_t C, B, E, D, L, H, A, F;
+		uint16_t PC;
+		uint16_t SP;
+		int32_t Hanging;
+		int64_t Cycles;
+		int64_t Limit; // CPU::_LoopLimit, rounded down. The end of the loop or the next event.
+		int64_t Instructions; // Run by the native code. Must be 0 on entry.
+
+		uint8_t* Memory;
+		Emulator::Memory* Tracker;
+		const std::atomic<uint64_t>* CodeBits;
+
+		uint8_t CodeWritten; // Set by the native code when a store hit code. Must be 0 on entry.
+		uint8_t Chain; // No interrupt is waiting, so a block that jumps to itself can loop without returning. Only an event before Limit could change that.
+	};
+
+	class Jit
+	{
+	private:
+		BlockCache* _Blocks;
+
+		uint8_t* _Code = nullptr; // Executable buffer. Translations are appended, everything is dropped when it's full.
+		size_t _CodeUsed = 0;
+		bool _Failed = false; // Couldn't get executable memory.
+
+		void Translate(Block* block, uint16_t addr);
+
+		//Make the buffer writable (or executable again). False if the OS said no.
+		bool SetWritable(bool writable);
+
+	public:
+		static constexpr uint32_t HotThreshold = 32;
+		static constexpr size_t CodeSize = 4 * 1024 * 1024;
+
+		Jit(BlockCache* blocks);
+		~Jit();
+
+		Jit(const Jit&) = delete;
+		Jit& operator=(const Jit&) = delete;
+
+		//True on x86-64.
+		static bool IsSupported();
+
+		//Native code for the block at addr, null if it isn't hot yet or can't be translated.
+		inline JitFunction Get(Block* block, uint16_t addr)
+		{
+			if (block->Native != nullptr || block->Translated)
+				return block->Native;
+
+			if (++block->Hits < HotThreshold)
+				return nullptr;
+
+			Translate(block, addr);
+			return block->Native;
+		}
+	};
+}
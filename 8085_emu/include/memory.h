@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <cmath>
 #include <cstring>
@@ -11,33 +12,62 @@ namespace Emulator
 	//Size should be 0xffff
 	//Data size is 8 bits
 
+	//It also keeps track of which addresses hold decoded code (see block_cache.h).
+	//Writing to one of those through SetDataAtAddr()/CopyToMemory() bumps the generation of its 256 byte page,
+	//and every cached block on that page is decoded again the next time it runs.
+	//Writes straight to GetData() are not tracked.
+
 	class Memory
 	{
 	private:
 		size_t _Size;
 		std::shared_ptr<uint8_t> _Data;
+
+		//Atomic, the GUI can write while the CPU thread is running.
+		std::atomic<uint64_t> _CodeBits[0x10000 / 64];
+		std::atomic<uint32_t> _PageGenerations[0x100];
+
+		void ResetCodeTracking()
+		{
+			for (auto& word : _CodeBits)
+				word.store(0, std::memory_order_relaxed);
+
+			for (auto& page : _PageGenerations)
+				page.store(0, std::memory_order_relaxed);
+		}
+
 	public:
 		Memory()
 		{
 			_Size = 0;
 			_Data = nullptr;
+			ResetCodeTracking();
 		}
 
 		Memory(std::shared_ptr<uint8_t> data, size_t size)
 		{
 			_Size = size;
 			_Data = data;
+			ResetCodeTracking();
 		}
 
+		Memory(const Memory&) = delete;
+		Memory& operator=(const Memory&) = delete;
+
 		void _SetData(std::shared_ptr<uint8_t> data, size_t size)
 		{
 			_Size = size;
 			_Data = data;
+
+			//Everything changed.
+			for (auto& page : _PageGenerations)
+				page.fetch_add(1, std::memory_order_relaxed);
 		}
 
 		void SetDataAtAddr(uint16_t addr, uint8_t val)
 		{
 			_Data.get()[addr] = val;
+			CodeWritten(addr);
 		}
 
 		uint8_t GetDataAtAddr(uint16_t addr)
@@ -48,6 +78,11 @@ namespace Emulator
 		void CopyToMemory(uint16_t addr, uint8_t* values, uint16_t size)
 		{
 			memcpy(_Data.get() + addr, values, size);
+
+			for (uint32_t i = 0; i < size; i++)
+			{
+				CodeWritten((uint16_t)(addr + i));
+			}
 		}
 
 		std::shared_ptr<uint8_t> GetData()
@@ -59,5 +94,44 @@ namespace Emulator
 		{
 			return _Size;
 		}
+
+		//-------------------Code tracking--------------------
+
+		inline void MarkCode(uint16_t addr)
+		{
+			_CodeBits[addr >> 6].fetch_or(1ull << (addr & 63), std::memory_order_relaxed);
+		}
+
+		inline bool IsCode(uint16_t addr)
+		{
+			return (_CodeBits[addr >> 6].load(std::memory_order_relaxed) >> (addr & 63)) & 1;
+		}
+
+		//Call after writing to addr. Returns true if it was code, i.e. cached blocks on that page are now stale.
+		inline bool CodeWritten(uint16_t addr)
+		{
+			if (!IsCode(addr))
+				return false;
+
+			_PageGenerations[addr >> 8].fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		//Call after writing over a whole page, without looking at which of its addresses were code.
+		inline void PageWritten(uint8_t page)
+		{
+			_PageGenerations[page].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		inline uint32_t GetPageGeneration(uint8_t page)
+		{
+			return _PageGenerations[page].load(std::memory_order_relaxed);
+		}
+
+		//For the JIT, which tests the bits itself: bit (addr & 63) of word (addr >> 6).
+		inline const std::atomic<uint64_t>* GetCodeBits()
+		{
+			return _CodeBits;
+		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace Emulator
+{
+	//What the CPU did since it was created. See CPU::GetPerfCounts().
+	//Only uint64_t in here, PerfCounters copies it as an array of them.
+
+	struct PerfCounts
+	{
+		uint64_t Instructions = 0;
+		uint64_t Cycles = 0;
+
+		uint64_t Loops = 0;
+		uint64_t LoopNs = 0; // Host time spent in Loop().
+		uint64_t LoopCycles = 0; // Cycles run by those Loop()s. Not the ones counted in HLT or while stepping.
+
+		//The simulation thread sleeps between Loop()s. How much later than asked it woke up, in total. See CPU::AddSleep().
+		uint64_t Sleeps = 0;
+		uint64_t SleepOvershootNs = 0;
+
+		uint64_t Opcodes[256] = {}; // Only with CPU::SetOpcodeCounting(), and not what idle loop skipping or the bootloader HLE ran.
+		uint64_t In[256] = {}; // Handler calls. An IN in a skipped idle loop is only read once.
+		uint64_t Out[256] = {};
+		uint64_t Interrupts[4] = {}; // Taken, by InterruptLines.
+
+		//Host time per emulated millisecond at clockHz. 0 if Loop() hasn't run yet.
+		inline double HostNsPerEmulatedMs(double clockHz) const
+		{
+			if (LoopCycles == 0)
+				return 0;
+
+			return LoopNs / (LoopCycles / (clockHz / 1000.0));
+		}
+	};
+
+	//PerfCounts for other threads. The CPU's thread counts in its own PerfCounts and publishes it every few Loop()s.
+	class PerfCounters
+	{
+	private:
+		static constexpr size_t Count = sizeof(PerfCounts) / sizeof(uint64_t);
+		static_assert(sizeof(PerfCounts) == Count * sizeof(uint64_t), "PerfCounts should only have uint64_t");
+
+		std::atomic<uint64_t> _Values[Count] = {};
+
+	public:
+		inline void Publish(const PerfCounts& counts)
+		{
+			uint64_t values[Count];
+			memcpy(values, &counts, sizeof(values));
+
+			for (size_t i = 0; i < Count; i++)
+			{
+				_Values[i].store(values[i], std::memory_order_relaxed);
+			}
+		}
+
+		//Each number is up to date, but they can be from different Loop()s.
+		inline PerfCounts Read() const
+		{
+			uint64_t values[Count];
+
+			for (size_t i = 0; i < Count; i++)
+			{
+				values[i] = _Values[i].load(std::memory_order_relaxed);
+			}
+
+			PerfCounts counts;
+			memcpy(&counts, values, sizeof(values));
+			return counts;
+		}
+	};
+}
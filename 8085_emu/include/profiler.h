@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Emulator
+{
+	//Where the cycles go. With CPU::SetProfiler(), every instruction adds one and its cycles to the address it starts at,
+	//and CALLs (RST too) and RETs are followed to get the cycles spent in every routine, with everything it called.
+	//The counts are written by the CPU's thread and can be read from any other while it runs. See GetReport().
+
+	//Instructions and cycles at an address, or for a label or a line.
+	struct ProfileCount
+	{
+		uint64_t Instructions = 0;
+		uint64_t Cycles = 0;
+	};
+
+	//Everything from a label up to the next one, flat: not what it called.
+	struct ProfileLabel
+	{
+		std::string Name;
+		uint16_t Address = 0;
+		ProfileCount Count;
+	};
+
+	//Everything that ran between a CALL to Address and its RET, including the routines it called.
+	//A recursive call doesn't count twice, only the outermost one.
+	struct ProfileRoutine
+	{
+		std::string Name; // The label, LABEL+N or the address.
+		uint16_t Address = 0;
+		uint64_t Calls = 0;
+		uint64_t Cycles = 0;
+	};
+
+	//Caller called Callee Calls times, which took Cycles in total.
+	struct ProfileCall
+	{
+		std::string Caller; // "(top)" if it was called from outside any routine.
+		std::string Callee;
+		uint64_t Calls = 0;
+		uint64_t Cycles = 0;
+	};
+
+	struct ProfileReport
+	{
+		ProfileCount Total;
+
+		//Most cycles first.
+		std::vector<ProfileLabel> Labels;
+		std::vector<ProfileRoutine> Routines;
+		std::vector<ProfileCall> Calls;
+
+		//Line of the source, its count. Only lines that ran, in order.
+		std::vector<std::pair<int, ProfileCount>> Lines;
+	};
+
+	class Profiler
+	{
+	private:
+		//What a routine was called from, if not from another routine.
+		static constexpr uint32_t TopLevel = 0x10000;
+
+		//More than this many CALLs deep, the oldest ones are forgotten (a program that never returns, or jumps out of its routines).
+		static constexpr size_t MaxDepth = 1024;
+
+		enum Kinds : uint8_t
+		{
+			Other,
+			Call, // CALL, Cxx, RST
+			Return // RET, Rxx
+		};
+
+		struct Frame
+		{
+			uint16_t Routine;
+			uint16_t SP; // After the return address was pushed.
+			uint64_t Start; // _Now when it was called.
+		};
+
+		struct CallCount
+		{
+			uint64_t Calls = 0;
+			uint64_t Cycles = 0;
+		};
+
+		Kinds _Kinds[256];
+
+		//Written by the CPU's thread only, relaxed. They're just counts, a reader can be a few instructions behind.
+		std::atomic<uint64_t> _Instructions[0x10000];
+		std::atomic<uint64_t> _Cycles[0x10000];
+
+		//The CPU's thread only. _Now is every cycle counted so far.
+		uint64_t _Now = 0;
+		std::vector<Frame> _Stack;
+
+		//Updated at every RET, read by GetReport().
+		std::mutex _CallsMutex;
+		std::map<std::pair<uint32_t, uint16_t>, CallCount> _Calls; // Caller, callee.
+		std::map<uint16_t, CallCount> _Routines;
+
+		void Called(uint16_t routine, uint16_t sp);
+		void Returned(uint16_t sp);
+
+	public:
+		Profiler();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		//From the CPU's thread, or while it doesn't run.
+		void Clear();
+
+		//From the CPU's thread: the instruction at pc ran, with SP at sp. After it, PC is next and SP is stack.
+		inline void Count(uint16_t pc, uint8_t op, uint32_t cycles, uint16_t sp, uint16_t next, uint16_t stack)
+		{
+			_Instructions[pc].store(_Instructions[pc].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			_Cycles[pc].store(_Cycles[pc].load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+
+			_Now += cycles;
+
+			//Only if it was taken: it pushed or popped the return address.
+			if (_Kinds[op] == Call && stack == (uint16_t)(sp - 2))
+				Called(next, stack);
+			else if (_Kinds[op] == Return && stack == (uint16_t)(sp + 2))
+				Returned(stack);
+		}
+
+		inline uint64_t GetInstructions(uint16_t address)
+		{
+			return _Instructions[address].load(std::memory_order_relaxed);
+		}
+
+		inline uint64_t GetCycles(uint16_t address)
+		{
+			return _Cycles[address].load(std::memory_order_relaxed);
+		}
+
+		//From any thread. labels and symbols are the program's (Assembler::Assembly::Labels and Symbols, address and line).
+		//Addresses before the first label are counted for "(no label)".
+		ProfileReport GetReport(const std::vector<std::pair<std::string, uint16_t>>& labels, const std::vector<std::pair<uint16_t, int>>& symbols);
+	};
+}
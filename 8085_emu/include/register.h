@@ -2,84 +2,84 @@
 
 #include <cstdint>
 
+#include "cpu_state.h"
+
 namespace Emulator
 {
+	//The actual registers live in CpuState.
+	//These are just views into it, so code outside of the emulator (e.g. Registers Window) doesn't need to know the layout.
+
 	//8 bit register.
 
 	class Register8
 	{
 	private:
-		union Data //Union of data for use in SIGNED and UNSIGNED operations.
-		{
-			uint8_t _DataUnsigned;
-			int8_t _DataSigned;
-		};
-
-		Data _Data;
+		uint8_t* _Data;
 
 	public:
+		Register8(uint8_t* data)
+		{
+			_Data = data;
+		}
+
 		//Set data with an unsigned value
 		void SetUnsigned(uint8_t value = 0xff)
 		{
-			_Data._DataUnsigned = value;
+			*_Data = value;
 		}
 
 		//Set data with a signed value
 		void SetSigned(int8_t value = 0b01111111)
 		{
-			_Data._DataSigned = value;
+			*_Data = (uint8_t)value;
 		}
 
 		//Set a certain bit
 		void SetBit(uint8_t bit, uint8_t value = 1)
 		{
-			value &= 0x01;
-			if (value)
-				_Data._DataUnsigned = _Data._DataUnsigned | (1 << bit);
-			else
-				ClearBit(bit);
+			Emulator::SetBit(*_Data, bit, value);
 		}
 
 		//Clear the register
 		void Clear()
 		{
-			_Data._DataSigned = 0;
+			*_Data = 0;
 		}
 
 		//Clear a certain bit.
 		void ClearBit(uint8_t bit)
 		{
-			_Data._DataUnsigned = _Data._DataUnsigned & (~(1 << bit));
+			Emulator::ClearBit(*_Data, bit);
 		}
 
 		//Increment signed data.
 		void Increment()
 		{
-			_Data._DataSigned++;
+			(*_Data)++;
 		}
 
 		//Decrement signed data.
 		void Decrement()
 		{
-			_Data._DataSigned--;
+			(*_Data)--;
 		}
 
 		//Get data with type unsigned
 		uint8_t GetUnsigned()
 		{
-			return _Data._DataUnsigned;
+			return *_Data;
 		}
 
 		//Get data with type signed
 		int8_t GetSigned()
 		{
-			return _Data._DataSigned;
+			return (int8_t)*_Data;
 		}
 
 		//Get a certain bit
 		uint8_t GetBit(uint8_t bit)
 		{
-			return (_Data._DataUnsigned >> bit) & 0x01;
+			return Emulator::GetBit(*_Data, bit);
 		}
 	};
 
@@ -87,56 +87,48 @@ namespace Emulator
 	class Register
 	{
 	private:
-		//This time, _Data is a pointer
-		//This does not affect the use of Register at all outside of this class
-		//This is needed for SP, so we can point _Data to the ACTUAL stack pointer in _Stack.
-		std::shared_ptr<uint16_t> _Data;
+		uint16_t* _Data;
 
 	public:
-		Register()
-		{
-			_Data = std::shared_ptr<uint16_t>((uint16_t*)calloc(1, sizeof(uint16_t)), free);
-		}
-
-		void SetRef(std::shared_ptr<uint16_t> ref) //Set the reference to point to
+		Register(uint16_t* data)
 		{
-			_Data = ref;
+			_Data = data;
 		}
 
-		//Everything else is the same as Register8, but with pointer.
+		//Everything else is the same as Register8.
 
 		void Set(uint16_t value = 0xffff)
 		{
-			*(_Data.get()) = value;
+			*_Data = value;
 		}
 
 		void SetBit(uint8_t bit, int value = 1)
 		{
 			value &= 0x01;
 			if (value)
-				*(_Data.get()) = *(_Data.get()) | (1 << bit);
+				*_Data = *_Data | (1 << bit);
 			else
 				ClearBit(bit);
 		}
 
 		void Clear()
 		{
-			*(_Data.get()) = 0;
+			*_Data = 0;
 		}
 
 		void ClearBit(uint8_t bit)
 		{
-			*(_Data.get()) = *(_Data.get()) & (~(1 << bit));
+			*_Data = *_Data & (~(1 << bit));
 		}
 
 		void Increment()
 		{
-			(*(_Data.get()))++;
+			(*_Data)++;
 		}
 
 		void Decrement()
 		{
-			(*(_Data.get()))--;
+			(*_Data)--;
 		}
 
 		uint16_t Get()
@@ -146,17 +138,17 @@ namespace Emulator
 
 		uint8_t GetHigh()
 		{
-			return (*(_Data.get())) >> 8;
+			return (*_Data) >> 8;
 		}
 
 		uint8_t GetLow()
 		{
-			return (*(_Data.get())) & 0xff;
+			return (*_Data) & 0xff;
 		}
 
 		uint8_t GetBit(uint8_t bit)
 		{
-			return (*(_Data.get()) >> bit) & 0x01;
+			return (*_Data >> bit) & 0x01;
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace Emulator
+{
+	class CPU;
+
+	//Reverse debugging. Every KeyframeInterval instructions the whole machine is saved (CPU::SaveState()), and in between
+	//everything the CPU gets from outside goes into a journal: what IN read, interrupts raised by other threads, events,
+	//when an interrupt was taken and the cycles counted in HLT. Everything else follows from the state and the code.
+	//So any instruction since the oldest keyframe can be rebuilt: load the keyframe before it, and run up to it
+	//one instruction at a time with the journal instead of the peripherals. OUTs still go to the peripherals, so they show it too.
+	//The oldest keyframes are dropped to stay within the memory budget.
+	//Everything here is for the CPU's thread, except GetFirst(), GetLast() and GetPosition().
+
+	class Rewind
+	{
+	public:
+		struct Entry
+		{
+			enum Kinds : uint8_t
+			{
+				In, // What IN read on Port. Only when it's not what the last one read.
+				Posted, // CPU::RaiseInterrupt(), Port is the line.
+				Events, // Events ran at cycle Value (CPU::RunEvents()).
+				Interrupt, // Taken, Port is the line.
+				HaltedCycles // CPU::AddHaltedCycles()
+			};
+
+			uint64_t Instruction; // Instructions run before it happened (State.TotalInstructions).
+			uint64_t Value;
+			uint8_t Kind;
+			uint8_t Port;
+		};
+
+		//Instructions between keyframes. Rebuilding one takes at most this many, a few ms.
+		static constexpr uint64_t KeyframeInterval = 100000;
+
+		//Stop looking back when this returns true. See SeekBack().
+		using StopFunction = bool(*)(CPU* cpu, void* ctx);
+
+	private:
+		struct Keyframe
+		{
+			Snapshot State;
+			std::vector<Entry> Journal; // Up to the next keyframe.
+			size_t Bytes = 0; // Counted against the budget once the journal is complete.
+		};
+
+		std::deque<Keyframe> _Keyframes;
+		size_t _Budget;
+		size_t _Bytes = 0;
+
+		//Recording: what the journal of the last keyframe has for every port, 0x100 if nothing yet.
+		uint16_t _LastIn[256];
+
+		//Replaying: what IN reads on every port, 0x100 if the journal doesn't say.
+		bool _Replaying = false;
+		uint16_t _ReplayIn[256];
+
+		//Where the CPU is if it was rewound: in _Keyframes[_Frame], before _Entry in its journal.
+		//Running on from there drops everything after it, see Resume().
+		bool _Rewound = false;
+		size_t _Frame = 0;
+		size_t _Entry = 0;
+
+		std::atomic<uint64_t> _First{ 0 };
+		std::atomic<uint64_t> _Last{ 0 };
+		std::atomic<uint64_t> _Position{ 0 };
+
+		void AddKeyframe(CPU* cpu);
+		size_t GetBytes(const Keyframe& keyframe, const Keyframe* previous);
+
+		void Apply(CPU* cpu, const Entry& entry);
+
+		//Loads _Keyframes[frame] and runs until instruction until. Nothing in the journal at until is applied yet,
+		//the CPU is as it was when it stopped there. _Entry is where the journal got to.
+		//stop is called at every instruction on the way, the same way; the last one it returns true for is returned, UINT64_MAX if none.
+		uint64_t Replay(CPU* cpu, size_t frame, uint64_t until, StopFunction stop = nullptr, void* ctx = nullptr);
+
+	public:
+		Rewind(size_t budget = 64 * 1024 * 1024);
+
+		//Forget everything and start again from the CPU as it is now. The CPU records into this from now on.
+		void Start(CPU* cpu);
+
+		//Nothing is recorded anymore.
+		void Stop(CPU* cpu);
+
+		//After every Loop() or Step(): takes a keyframe when it's time.
+		void Record(CPU* cpu);
+
+		//Before every Loop(), Step(), RunEvents()...: if the CPU was rewound, what came after is gone now. It's recorded again as it runs.
+		void Resume(CPU* cpu);
+
+		//To instruction (State.TotalInstructions), between GetFirst() and GetLast().
+		//The CPU is as it was after that many instructions, before what came after them (an interrupt taken...). Returns false if there's nothing recorded.
+		bool Seek(CPU* cpu, uint64_t instruction);
+
+		//Back to the last instruction before the current one where stop returns true, or to GetFirst() if there's none.
+		//Returns false if the CPU is at GetFirst() already.
+		bool SeekBack(CPU* cpu, StopFunction stop, void* ctx);
+
+		//Bytes. The oldest keyframes go at the next one.
+		inline void SetBudget(size_t budget)
+		{
+			_Budget = budget;
+		}
+
+		//Seek() was called, and the CPU didn't run on from there yet.
+		inline bool IsRewound()
+		{
+			return _Rewound;
+		}
+
+		inline uint64_t GetFirst() { return _First; }
+		inline uint64_t GetLast() { return _Last; }
+		inline uint64_t GetPosition() { return _Position; }
+
+		//-------------------For the CPU--------------------
+
+		inline bool IsReplaying()
+		{
+			return _Replaying;
+		}
+
+		inline void RecordIn(uint64_t instruction, uint8_t port, uint8_t value)
+		{
+			if (_Replaying || _LastIn[port] == value)
+				return;
+
+			_LastIn[port] = value;
+			RecordEntry({ instruction, value, Entry::In, port });
+		}
+
+		//False if the journal doesn't say, then the peripheral is read.
+		inline bool ReplayIn(uint8_t port, uint8_t& value)
+		{
+			if (_ReplayIn[port] > 0xff)
+				return false;
+
+			value = (uint8_t)_ReplayIn[port];
+			return true;
+		}
+
+		//Kept in order of Instruction. Idle loop skipping can read an IN ahead of instructions that are run after it.
+		void RecordEntry(const Entry& entry);
+	};
+}
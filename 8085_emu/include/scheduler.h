@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "IO_cb.h"
+
+namespace InternalEmulator
+{
+	//Events for one CPU, keyed by the cycle (State.TotalCycles) they're due at. See CPU::Schedule().
+	//The cores run until the earliest one is due instead of checking for something new before every instruction.
+	//Only the CPU's thread touches the heap. Other threads Post(), and the CPU picks those up at the start of the next Loop().
+
+	struct Event
+	{
+		uint64_t Cycle = 0;
+		uint64_t Order = 0; // Events due at the same cycle run in the order they were scheduled.
+
+		int8_t Interrupt = -1; // An Emulator::InterruptLines to set pending. Otherwise Handler is called.
+		Emulator::EventHandler Handler;
+	};
+
+	class Scheduler
+	{
+	private:
+		std::vector<Event> _Heap; // std::push_heap/pop_heap, the earliest on top.
+		uint64_t _Order = 0;
+
+		std::mutex _PostedMutex;
+		std::vector<Event> _Posted;
+		std::atomic<bool> _HasPosted = false;
+
+	public:
+		//CPU thread only.
+		void Schedule(Event event);
+
+		//Any thread.
+		void Post(Event event);
+
+		//CPU thread. Moves what was posted into the heap, and returns it.
+		std::vector<Event> TakePosted();
+
+		inline bool HasPosted()
+		{
+			return _HasPosted.load(std::memory_order_relaxed);
+		}
+
+		//UINT64_MAX if there's nothing.
+		inline uint64_t Next()
+		{
+			return _Heap.empty() ? UINT64_MAX : _Heap.front().Cycle;
+		}
+
+		//The earliest event, if it's due at now or before.
+		bool PopDue(uint64_t now, Event& event);
+
+		//For snapshots (CPU::SaveState()). The heap as it is, and the Order of the next event.
+		inline const std::vector<Event>& GetEvents() { return _Heap; }
+		inline uint64_t GetOrder() { return _Order; }
+
+		//Replaces the heap. Posted events stay.
+		inline void SetEvents(const std::vector<Event>& events, uint64_t order)
+		{
+			_Heap = events;
+			_Order = order;
+		}
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cpu_state.h"
+#include "scheduler.h"
+
+namespace Emulator
+{
+	//Everything CPU::LoadState() needs to put the machine back where CPU::SaveState() was.
+	//Memory is kept in 256 byte pages that are never written again, so snapshots share the pages they have in common.
+	//Copying a Snapshot only copies the pointers.
+
+	constexpr int SnapshotPageSize = 0x100;
+	constexpr int SnapshotPageCount = 0x10000 / SnapshotPageSize;
+
+	using SnapshotPage = std::shared_ptr<const std::array<uint8_t, SnapshotPageSize>>;
+
+	struct Snapshot
+	{
+		CpuState State;
+
+		bool Running = false;
+		bool Halted = false;
+		bool AlreadyHalted = false;
+		bool WaitingForInterrupt = false;
+		int ErrorCode = 0; // ErrorCodes
+
+		//Scheduled events (CPU::Schedule()). What other threads posted and the CPU hasn't picked up yet isn't in here.
+		std::vector<InternalEmulator::Event> Events;
+		uint64_t EventOrder = 0;
+
+		//All 64 KB, 0000H to FFFFH.
+		std::array<SnapshotPage, SnapshotPageCount> Pages;
+
+		//One per CPU::AddStateHandler(), in the order they were added.
+		std::vector<std::vector<uint8_t>> Peripherals;
+	};
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace InternalEmulator
+{
+	//T-states of every opcode, as documented for the 8085 (Intel 8080/8085 Assembly Language Programming Manual).
+	//Used by CPU::SetCycleExact(). Conditional jumps, calls and returns cost less when they aren't taken;
+	//for everything else Taken and NotTaken are the same.
+
+	struct TStates
+	{
+		uint8_t Taken;
+		uint8_t NotTaken;
+	};
+
+	constexpr TStates OpcodeTStates(uint8_t op)
+	{
+		//Conditional branches first, they're the only ones with two costs.
+		if ((op & 0xc7) == 0xc2) return { 10, 7 }; // Jcc
+		if ((op & 0xc7) == 0xc4) return { 18, 9 }; // Ccc
+		if ((op & 0xc7) == 0xc0) return { 12, 6 }; // Rcc
+
+		if (op == 0x76) return { 5, 5 }; // HLT
+
+		//MOV. M on either side reads or writes memory.
+		if ((op & 0xc0) == 0x40)
+		{
+			uint8_t cost = ((op & 0x07) == 0x06 || (op & 0x38) == 0x30) ? 7 : 4;
+			return { cost, cost };
+		}
+
+		//ADD ADC SUB SBB ANA XRA ORA CMP
+		if ((op & 0xc0) == 0x80)
+		{
+			uint8_t cost = (op & 0x07) == 0x06 ? 7 : 4;
+			return { cost, cost };
+		}
+
+		//RST
+		if ((op & 0xc7) == 0xc7) return { 12, 12 };
+
+		switch (op)
+		{
+		//MVI, INR, DCR. The M versions read and write memory.
+		case 0x06: case 0x0e: case 0x16: case 0x1e: case 0x26: case 0x2e: case 0x3e: return { 7, 7 };
+		case 0x36: return { 10, 10 };
+		case 0x04: case 0x0c: case 0x14: case 0x1c: case 0x24: case 0x2c: case 0x3c:
+		case 0x05: case 0x0d: case 0x15: case 0x1d: case 0x25: case 0x2d: case 0x3d: return { 4, 4 };
+		case 0x34: case 0x35: return { 10, 10 };
+
+		//LXI, DAD, INX, DCX
+		case 0x01: case 0x11: case 0x21: case 0x31: return { 10, 10 };
+		case 0x09: case 0x19: case 0x29: case 0x39: return { 10, 10 };
+		case 0x03: case 0x13: case 0x23: case 0x33:
+		case 0x0b: case 0x1b: case 0x2b: case 0x3b: return { 6, 6 };
+
+		//Loads and stores
+		case 0x02: case 0x12: case 0x0a: case 0x1a: return { 7, 7 }; // STAX, LDAX
+		case 0x32: case 0x3a: return { 13, 13 }; // STA, LDA
+		case 0x22: case 0x2a: return { 16, 16 }; // SHLD, LHLD
+
+		//Immediate arithmetic
+		case 0xc6: case 0xce: case 0xd6: case 0xde: case 0xe6: case 0xee: case 0xf6: case 0xfe: return { 7, 7 };
+
+		//Jumps, calls, returns
+		case 0xc3: return { 10, 10 }; // JMP
+		case 0xcd: return { 18, 18 }; // CALL
+		case 0xc9: return { 10, 10 }; // RET
+		case 0xe9: return { 6, 6 }; // PCHL
+
+		//Stack
+		case 0xc5: case 0xd5: case 0xe5: case 0xf5: return { 12, 12 }; // PUSH
+		case 0xc1: case 0xd1: case 0xe1: case 0xf1: return { 10, 10 }; // POP
+		case 0xe3: return { 16, 16 }; // XTHL
+		case 0xf9: return { 6, 6 }; // SPHL
+
+		case 0xdb: case 0xd3: return { 10, 10 }; // IN, OUT
+
+		//Everything else (rotates, CMA, STC, CMC, DAA, XCHG, EI, DI, RIM, SIM, NOP) takes 4.
+		//So do the empty slots, which run as NOP here.
+		default: return { 4, 4 };
+		}
+	}
+
+	constexpr std::array<TStates, 256> MakeTStatesTable()
+	{
+		std::array<TStates, 256> table = {};
+
+		for (int op = 0; op < 256; op++)
+		{
+			table[op] = OpcodeTStates((uint8_t)op);
+		}
+
+		return table;
+	}
+
+	constexpr std::array<TStates, 256> TStatesTable = MakeTStatesTable();
+
+	static_assert(TStatesTable[0x7e].Taken == 7 && TStatesTable[0x77].Taken == 7 && TStatesTable[0x78].Taken == 4, "MOV");
+	static_assert(TStatesTable[0xc2].Taken == 10 && TStatesTable[0xc2].NotTaken == 7, "JNZ");
+	static_assert(TStatesTable[0xcc].Taken == 18 && TStatesTable[0xcc].NotTaken == 9, "CZ");
+	static_assert(TStatesTable[0xc8].Taken == 12 && TStatesTable[0xc8].NotTaken == 6, "RZ");
+	static_assert(TStatesTable[0xc9].Taken == 10 && TStatesTable[0xeb].Taken == 4 && TStatesTable[0xe3].Taken == 16, "RET, XCHG, XTHL");
+
+	//The cores count 1 + hanging cycles per instruction, with the hanging cycles the instruction returns.
+	//This is what to use instead, given what it returned: a branch that isn't taken always returns 1.
+	inline int ExactHanging(uint8_t op, int hanging)
+	{
+		const TStates& t = TStatesTable[op];
+		return (hanging == 1 ? t.NotTaken : t.Taken) - 1;
+	}
+}
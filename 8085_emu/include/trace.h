@@ -0,0 +1,209 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpu_state.h"
+
+namespace Emulator
+{
+	//Execution traces. With CPU::SetTracer(), every instruction the CPU runs is written to a file: where it was, the opcode and its operands,
+	//A and the flags after it, the bytes of memory it changed, the port of an IN or OUT and the interrupt taken before it.
+	//The file is a TraceHeader and one record per instruction, each only with what isn't the same as predicted from the one before it,
+	//2 to 8 bytes for most instructions. See TraceBits.
+	//The CPU's thread only encodes into a buffer, a thread of the TraceWriter writes the full ones to the file.
+
+	struct TraceHeader
+	{
+		char Magic[8] = { '8', '0', '8', '5', 'T', 'R', 'C', '1' };
+		uint32_t Version = 1;
+		uint32_t Reserved = 0;
+
+		//The CPU when tracing started.
+		uint64_t Instruction = 0; // State.TotalInstructions
+		uint64_t Cycle = 0; // State.TotalCycles
+		uint16_t PC = 0;
+		uint8_t A = 0;
+		uint8_t Flags = 0;
+		uint32_t Reserved2 = 0;
+	};
+
+	static_assert(sizeof(TraceHeader) == 40, "TraceHeader is written as it is");
+
+	//Every record starts with these, then in this order:
+	//  Gap: varint, instructions that ran untraced before this one (rewinding, Clock() called directly).
+	//  PC: u16, if it's not the PC of the record before + its length.
+	//  Cycle: varint, cycles since the record before, if that's not what it was the last time after the same opcode.
+	//  Interrupt: u8, the InterruptLines taken right before this instruction.
+	//  The opcode and its operand bytes, always. The length comes from the opcode.
+	//  A: u8, after the instruction, if it changed.
+	//  Flags: u8, the same.
+	//  Writes: u8 count, then u16 address and u8 value each.
+	//Varints are 7 bits a byte, lowest first, the top bit set on every byte but the last.
+	enum TraceBits : uint8_t
+	{
+		TracePC = 0x01,
+		TraceA = 0x02,
+		TraceFlags = 0x04,
+		TraceInterrupt = 0x08,
+		TraceWrites = 0x10,
+		TraceGap = 0x20,
+		TraceCycle = 0x40
+	};
+
+	struct TraceWrite
+	{
+		uint16_t Address;
+		uint8_t Value;
+	};
+
+	//One instruction.
+	struct TraceRecord
+	{
+		//Most an instruction changes: an interrupt's return address, and two bytes of its own (CALL, SHLD, XTHL...).
+		static constexpr int MaxWrites = 8;
+
+		uint64_t Instruction = 0; // State.TotalInstructions before it.
+		uint64_t Cycle = 0; // The cycle it started at, State.TotalCycles + CurrentCycles.
+		uint16_t PC = 0;
+		uint8_t Opcode = 0;
+		uint8_t Operands[2] = {};
+		uint8_t Length = 1; // Opcode and operands.
+
+		//After it.
+		uint8_t A = 0;
+		uint8_t Flags = 0;
+
+		int8_t Interrupt = -1; // InterruptLines, -1 if none.
+
+		//IN and OUT. The value is A after it, for both.
+		bool In = false;
+		bool Out = false;
+		uint8_t Port = 0;
+		uint8_t PortValue = 0;
+
+		//Bytes that changed, with what's in them after it, each address once. A write of the value that was already there isn't in here.
+		uint8_t WriteCount = 0;
+		TraceWrite Writes[MaxWrites];
+	};
+
+	//What the writer and the reader both keep to predict the next record. Both have to do exactly the same with it.
+	struct TracePrediction
+	{
+		uint64_t Instruction = 0;
+		uint64_t Cycle = 0;
+		uint16_t NextPC = 0;
+		uint8_t A = 0;
+		uint8_t Flags = 0;
+		uint8_t Opcode = 0;
+		bool First = true;
+		uint64_t CycleAfter[256] = {}; // Cycles after the last instruction with that opcode.
+
+		void Start(const TraceHeader& header);
+		void Update(const TraceRecord& record);
+	};
+
+	//Encodes records for one CPU and writes them to a file. Write() is for the CPU's thread only.
+	//Full buffers go to a thread that writes them and hands them back, the CPU gets a new one if none is back yet.
+	//So it never waits on the disk, it takes more memory for a while if the disk is slower than the CPU.
+	class TraceWriter
+	{
+	public:
+		static constexpr size_t BufferSize = 1024 * 1024;
+
+		//Longer than any record.
+		static constexpr size_t MaxRecordBytes = 64;
+
+	private:
+		FILE* _File = nullptr;
+		bool _Failed = false;
+		bool _Started = false;
+
+		std::vector<uint8_t> _Buffer;
+		size_t _Used = 0;
+
+		std::thread _Thread;
+		std::mutex _Mutex;
+		std::condition_variable _Condition;
+		std::deque<std::pair<std::vector<uint8_t>, size_t>> _Full;
+		std::vector<std::vector<uint8_t>> _Free;
+		bool _Stopping = false;
+
+		TracePrediction _Prediction;
+		uint64_t _Records = 0;
+
+		void WriteLoop();
+		void Flush();
+
+	public:
+		TraceWriter() = default;
+		~TraceWriter();
+
+		TraceWriter(const TraceWriter&) = delete;
+		TraceWriter& operator=(const TraceWriter&) = delete;
+
+		//False if the file can't be created.
+		bool Open(const std::string& fileName);
+
+		//Writes what's left and closes the file. False if anything couldn't be written.
+		bool Close();
+
+		//The header, from the CPU as it is now. CPU::SetTracer() calls it.
+		void Start(const CpuState& state);
+
+		void Write(const TraceRecord& record);
+
+		inline uint64_t GetRecords()
+		{
+			return _Records;
+		}
+	};
+
+	//Reads a trace file, mapped into memory.
+	class TraceReader
+	{
+	private:
+		const uint8_t* _Data = nullptr;
+		size_t _Size = 0;
+		size_t _Position = 0;
+
+#ifdef _WIN32
+		void* _FileHandle = nullptr;
+		void* _Mapping = nullptr;
+#else
+		int _FileDescriptor = -1;
+#endif
+
+		TraceHeader _Header;
+		TracePrediction _Prediction;
+
+	public:
+		TraceReader() = default;
+		~TraceReader();
+
+		TraceReader(const TraceReader&) = delete;
+		TraceReader& operator=(const TraceReader&) = delete;
+
+		//False if the file can't be read or isn't a trace.
+		bool Open(const std::string& fileName);
+		void Close();
+
+		inline const TraceHeader& GetHeader()
+		{
+			return _Header;
+		}
+
+		//The next record. False at the end of the file, or at a record cut short (the emulator didn't close the file).
+		bool Next(TraceRecord& record);
+
+		//Back to the first record.
+		void Restart();
+	};
+}
@@ -0,0 +1,114 @@
+#include "block_cache.h"
+
+#include "CPUinstructions.h"
+
+namespace InternalEmulator
+{
+	BlockCache::BlockCache(std::shared_ptr<Emulator::Memory> memory)
+	{
+		_Memory = memory;
+		_Blocks.resize(0x10000);
+	}
+
+	void BlockCache::DropNative()
+	{
+		for (auto& block : _Blocks)
+		{
+			if (block != nullptr)
+			{
+				block->Hits = 0;
+				block->Translated = false;
+				block->Native = nullptr;
+			}
+		}
+	}
+
+	uint8_t BlockCache::GetLength(uint8_t opcode)
+	{
+		uint8_t bytes = CPUInstructions[opcode].bytes;
+		return bytes == 0 ? 1 : bytes;
+	}
+
+	bool BlockCache::EndsBlock(uint8_t opcode)
+	{
+		switch (opcode)
+		{
+		//Jumps, calls, returns, RST, PCHL
+		case 0xc3: case 0xc2: case 0xca: case 0xd2: case 0xda: case 0xe2: case 0xea: case 0xf2: case 0xfa:
+		case 0xcd: case 0xc4: case 0xcc: case 0xd4: case 0xdc: case 0xe4: case 0xec: case 0xf4: case 0xfc:
+		case 0xc9: case 0xc0: case 0xc8: case 0xd0: case 0xd8: case 0xe0: case 0xe8: case 0xf0: case 0xf8:
+		case 0xc7: case 0xcf: case 0xd7: case 0xdf: case 0xe7: case 0xef: case 0xf7: case 0xff:
+		case 0xe9:
+		//HLT, and POP B which halts on an empty stack.
+		case 0x76: case 0xc1:
+		//EI, DI, SIM. Interrupts are only checked between blocks.
+		case 0xfb: case 0xf3: case 0x30:
+		//IN, OUT. The handlers can raise interrupts or touch memory.
+		case 0xdb: case 0xd3:
+			return true;
+		}
+
+		return false;
+	}
+
+	Block* BlockCache::Decode(uint16_t addr)
+	{
+		std::unique_ptr<Block>& slot = _Blocks[addr];
+
+		if (slot == nullptr)
+			slot = std::make_unique<Block>();
+
+		Block* block = slot.get();
+		uint8_t* data = _Memory->GetData().get();
+
+		//Mark first, then read the generations, then the bytes.
+		//If something writes in between, the generation we keep is already old and the block is decoded again next time.
+		uint16_t pc = addr;
+		int bytes = 0;
+		for (int i = 0; i < Block::MaxInstructions; i++)
+		{
+			uint8_t length = GetLength(data[pc]);
+
+			for (int j = 0; j < length; j++)
+			{
+				_Memory->MarkCode((uint16_t)(pc + j));
+			}
+
+			bytes += length;
+
+			if (EndsBlock(data[pc]))
+				break;
+
+			pc += length;
+		}
+
+		block->Pages[0] = addr >> 8;
+		block->Pages[1] = (uint16_t)(addr + bytes - 1) >> 8;
+		block->Generations[0] = _Memory->GetPageGeneration(block->Pages[0]);
+		block->Generations[1] = _Memory->GetPageGeneration(block->Pages[1]);
+
+		block->Hits = 0;
+		block->Translated = false;
+		block->Native = nullptr;
+		block->NativeCost = 0;
+
+		pc = addr;
+		block->Count = 0;
+		for (int i = 0; i < Block::MaxInstructions; i++)
+		{
+			uint8_t opcode = data[pc];
+
+			DecodedInstruction& instr = block->Instructions[block->Count++];
+			instr.Opcode = opcode;
+			instr.Low = data[(uint16_t)(pc + 1)];
+			instr.High = data[(uint16_t)(pc + 2)];
+
+			if (EndsBlock(opcode))
+				break;
+
+			pc += GetLength(opcode);
+		}
+
+		return block;
+	}
+}
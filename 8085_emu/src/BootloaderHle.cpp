@@ -0,0 +1,766 @@
+#include "bootloader_hle.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "cpu.h"
+#include "flag_tables.h"
+
+//See bootloader_hle.h. Everything here has to do EXACTLY what the routines in Bootloader.h do on the switch core, cycles included.
+//If you change a routine there, change it here too. 8085_batch --check --hle compares the two.
+
+namespace InternalEmulator
+{
+	namespace
+	{
+		//What a straight run of instructions does to the cycle counters.
+		//Every instruction adds the hanging cycles of the one before it plus 1, and leaves its own hanging.
+		struct Cost
+		{
+			long long Cycles = 0; // On top of the hanging cycles that were already there.
+			int Hanging = 0; // Of the last instruction.
+			long long Instructions = 0;
+		};
+
+		constexpr Cost Op(int hanging)
+		{
+			return { 1, hanging, 1 };
+		}
+
+		//a, then b.
+		constexpr Cost operator+(Cost a, Cost b)
+		{
+			return { a.Cycles + a.Hanging + b.Cycles, b.Hanging, a.Instructions + b.Instructions };
+		}
+
+		constexpr Cost Times(Cost a, long long n)
+		{
+			if (n == 0)
+				return {};
+
+			return { n * a.Cycles + (n - 1) * a.Hanging, a.Hanging, n * a.Instructions };
+		}
+
+		//Hanging cycles, the same as in the cores.
+		constexpr Cost PushOp = Op(12);
+		constexpr Cost PopOp = Op(10);
+		constexpr Cost CallOp = Op(18);
+		constexpr Cost RetOp = Op(12);
+		constexpr Cost JumpOp = Op(10); // JMP, or a Jcc that's taken.
+		constexpr Cost NotTaken = Op(1);
+		constexpr Cost MviOp = Op(7);
+		constexpr Cost MovOp = Op(4);
+		constexpr Cost MovMOp = Op(7);
+		constexpr Cost ImmOp = Op(7); // ANI, CPI, ADI
+		constexpr Cost InrOp = Op(4);
+		constexpr Cost PairOp = Op(6); // INX, DCX
+		constexpr Cost LxiOp = Op(10);
+		constexpr Cost XchgOp = Op(4);
+		constexpr Cost IoOp = Op(10);
+
+		//DCD: PUSH PSW, MVI A,02H, OUT 56H, POP PSW, RET.
+		constexpr Cost DcdCost = PushOp + MviOp + IoOp + PopOp + RetOp;
+		constexpr Cost CallDcd = CallOp + DcdCost;
+
+		//DELA: LXI B,30 and CALL DCD until BC is 0.
+		constexpr int DelaCount = 30;
+		static_assert(DelaCount > 0 && DelaCount < 0x100, "DELA only ever counts down C");
+
+		//One round of the loops in DELA and DELB, by what DCX B left in BC:
+		//C isn't 0 yet (JNZ on C taken), only C is 0 (JNZ on B taken), or BC is 0 (out of the loop).
+		constexpr Cost LoopNext(Cost call) { return call + PairOp + MovOp + ImmOp + JumpOp; }
+		constexpr Cost LoopCarry(Cost call) { return call + PairOp + MovOp + ImmOp + NotTaken + MovOp + ImmOp + JumpOp; }
+		constexpr Cost LoopLast(Cost call) { return call + PairOp + MovOp + ImmOp + NotTaken + MovOp + ImmOp + NotTaken; }
+
+		constexpr Cost DelaTail = PopOp + PopOp + PopOp + RetOp;
+		constexpr Cost DelaCost = PushOp + PushOp + PushOp + LxiOp + Times(LoopNext(CallDcd), DelaCount - 1) + LoopLast(CallDcd) + DelaTail;
+		constexpr Cost CallDela = CallOp + DelaCost;
+
+		//DELB: CALL DELA until BC is 0.
+		constexpr Cost DelbHead = PushOp + PushOp;
+		constexpr Cost DelbTail = PopOp + PopOp + RetOp;
+
+		//STDM and STDC: a character for each of the 6 bytes at DE, with INX H in between.
+		constexpr Cost DisplayHead = PushOp + XchgOp;
+		constexpr Cost DisplayTail = XchgOp + PopOp + RetOp;
+
+		//MOV A,M, CALL _STDM1 (ANI, CPI, JC, ADI, RET), OUT. JC is taken for 0-9.
+		constexpr Cost StdmDigit(bool below10) { return MovMOp + CallOp + ImmOp + ImmOp + (below10 ? JumpOp : NotTaken) + ImmOp + RetOp + IoOp; }
+		constexpr Cost StdcDigit = MovMOp + IoOp;
+		constexpr Cost StdcCost = DisplayHead + Times(StdcDigit + PairOp, 5) + StdcDigit + DisplayTail;
+
+		constexpr Cost ClearDisplayCost = PushOp + MviOp + Times(IoOp, 6) + PopOp + RetOp;
+
+		//BEEP and BEEPFD, up to _WAIT_BEEP.
+		constexpr Cost BeepHead = PushOp + Times(MviOp + IoOp, 4) + JumpOp;
+		constexpr Cost BeepFdHead = PushOp + Times(MovOp + IoOp, 4);
+
+		//_WAIT_BEEP: CALL DELA, IN, CPI 00H, then a JNZ. Twice.
+		constexpr Cost WaitBeepHalf = CallDela + IoOp + ImmOp;
+		constexpr Cost WaitBeepMost = WaitBeepHalf + JumpOp + WaitBeepHalf + JumpOp + PopOp + RetOp;
+
+		//KIND: a line is MVI A, OUT 28H, CALL DCD, IN 18H, CPI FFH, then JZ to the next line if nothing is pressed.
+		constexpr Cost KindHead = PushOp + PushOp;
+		constexpr Cost KindLine = MviOp + IoOp + CallDcd + IoOp + ImmOp;
+		constexpr Cost KindTail = PopOp + MovOp + PopOp + RetOp;
+		//More than any way through a line can take, up to the next line or the end of KIND.
+		constexpr Cost KindMost = KindLine + NotTaken + MviOp + Times(ImmOp + JumpOp + InrOp, 4) + KindTail;
+
+		//What the scan lines output, and what IN reads for the key on each column.
+		constexpr uint8_t KindLines[4] = { 0b11111110, 0b11111101, 0b11111011, 0b11110111 };
+
+		//The first opcode of every label, to see that the code is the one in Bootloader.h.
+		struct LabelInfo
+		{
+			const char* Name;
+			uint8_t Opcode;
+		};
+
+		//The routines, DCD to KIND, are in this order in memory. Each one goes up to the next.
+		constexpr int RoutineCount = BootloaderHle::LabelKIND + 1;
+
+		//Which routines every label runs, one bit each.
+		constexpr uint16_t Bit(int label) { return 1 << label; }
+
+		constexpr uint16_t DelaUses = Bit(BootloaderHle::LabelDELA) | Bit(BootloaderHle::LabelDCD);
+		constexpr uint16_t WaitBeepUses = Bit(BootloaderHle::LabelBEEPFD) | DelaUses;
+		constexpr uint16_t KindUses = Bit(BootloaderHle::LabelKIND) | Bit(BootloaderHle::LabelDCD);
+
+		constexpr uint16_t Uses[BootloaderHle::LabelCount] = {
+			0,
+			Bit(BootloaderHle::LabelDCD), Bit(BootloaderHle::LabelSTDM), Bit(BootloaderHle::LabelSTDC), Bit(BootloaderHle::LabelCLEARDISPLAY),
+			Bit(BootloaderHle::LabelBEEP) | WaitBeepUses, WaitBeepUses,
+			DelaUses, Bit(BootloaderHle::LabelDELB) | DelaUses, KindUses,
+			WaitBeepUses, DelaUses, Bit(BootloaderHle::LabelDELB) | DelaUses,
+			KindUses, KindUses, KindUses, KindUses,
+			0
+		};
+
+		constexpr LabelInfo Labels[BootloaderHle::LabelCount] = {
+			{ nullptr, 0 },
+			{ "DCD", 0xf5 }, { "STDM", 0xf5 }, { "STDC", 0xf5 }, { "CLEARDISPLAY", 0xf5 }, { "BEEP", 0xf5 }, { "BEEPFD", 0xf5 },
+			{ "DELA", 0xf5 }, { "DELB", 0xf5 }, { "KIND", 0xc5 },
+			{ "_WAIT_BEEP", 0xcd }, { "_DELA1", 0xcd }, { "_DELB1", 0xcd },
+			{ "_KIND0", 0x3e }, { "_KIND1", 0x3e }, { "_KIND2", 0x3e }, { "_KIND3", 0x3e },
+			{ "_KINDDONE", 0xf1 }
+		};
+
+		//One routine, run on State.
+		class Call
+		{
+		private:
+			Emulator::CPU* _Cpu;
+			Emulator::CpuState& _State;
+			Emulator::Memory* _Memory;
+			uint8_t* _Mem;
+			long long _Limit;
+
+			const uint16_t* _Addresses;
+			uint16_t _CodeStart, _CodeEnd;
+
+			bool _Cleared = false;
+
+			//-------------------Cycles--------------------
+
+			//All of it would run in this Loop(). Every instruction in it starts before the end, so the cycle check lets it through.
+			bool Fits(const Cost& cost)
+			{
+				return _State.CurrentCycles + _State.HangingCycles + cost.Cycles <= _Limit;
+			}
+
+			void Charge(const Cost& cost)
+			{
+				_State.CurrentCycles += _State.HangingCycles + cost.Cycles;
+				_State.HangingCycles = cost.Hanging;
+				_State.TotalInstructions += cost.Instructions;
+			}
+
+			//A loop in a routine stops here, the core runs the rest or calls us again.
+			bool CanGoOn(const Cost& most)
+			{
+				return Fits(most) && _Cpu->GetRunning() && !_Cpu->GetHalted() && !Emulator::InterruptWaiting(_State);
+			}
+
+			//-------------------Memory--------------------
+
+			//The stack from SP - below + 1 up to SP + above is all we touch. It can't wrap around or be over the routines.
+			bool StackFits(int below, int above)
+			{
+				int low = _State.SP - below + 1;
+				int high = _State.SP + above;
+
+				return low >= 0 && high <= 0xffff && (high < _CodeStart || low >= _CodeEnd);
+			}
+
+			//The count bytes at addr aren't in the stack space of StackFits(below, above). They're read after the stack is written.
+			bool OutsideStack(uint16_t addr, int count, int below, int above)
+			{
+				for (int i = 0; i < count; i++)
+				{
+					int a = (uint16_t)(addr + i);
+
+					if (a > _State.SP - below && a <= _State.SP + above)
+						return false;
+				}
+
+				return true;
+			}
+
+			void Write(uint16_t addr, uint8_t value)
+			{
+				_Mem[addr] = value;
+				_Memory->CodeWritten(addr);
+			}
+
+			void Push(uint8_t value)
+			{
+				Write(_State.SP, value);
+				_State.SP--;
+			}
+
+			uint8_t Pop()
+			{
+				_State.SP++;
+				uint8_t value = _Mem[_State.SP];
+				Write(_State.SP, 0);
+				return value;
+			}
+
+			void Return()
+			{
+				uint8_t low = Pop();
+				uint8_t high = Pop();
+				_State.PC = (high << 8) | low;
+			}
+
+			//The CALLs inside (and the PUSHes in what they call) leave 0s below SP, everything that's pushed is popped again.
+			void ClearBelow(int bytes)
+			{
+				if (_Cleared)
+					return;
+
+				for (int i = 0; i < bytes; i++)
+				{
+					Write((uint16_t)(_State.SP - i), 0);
+				}
+
+				_Cleared = true;
+			}
+
+			//-------------------IO--------------------
+
+			void Out(uint8_t port, uint8_t value)
+			{
+				_Cpu->WritePort(port, value);
+			}
+
+			uint8_t In(uint8_t port, uint8_t A)
+			{
+				return _Cpu->ReadPort(port, A, _State.TotalInstructions);
+			}
+
+			//What DCD outputs.
+			void Dcd()
+			{
+				Out(0x56, 0x02);
+			}
+
+			//What DELA outputs.
+			void Dela()
+			{
+				for (int i = 0; i < DelaCount; i++)
+				{
+					Dcd();
+				}
+			}
+
+			//DCX B, MOV A,C, CPI 00H, JNZ, and maybe MOV A,B, CPI 00H, JNZ. The cost of the round, and if it was the last one.
+			Cost CountDown(Cost call, bool& last)
+			{
+				uint16_t bc = ((_State.B << 8) | _State.C) - 1;
+				_State.B = bc >> 8;
+				_State.C = bc & 0xff;
+
+				_State.A = _State.C;
+				Compare(_State.A, _State.Flags, 0);
+
+				if (_State.C != 0)
+				{
+					last = false;
+					return LoopNext(call);
+				}
+
+				_State.A = _State.B;
+				Compare(_State.A, _State.Flags, 0);
+
+				last = bc == 0;
+				return last ? LoopLast(call) : LoopCarry(call);
+			}
+
+			void GoTo(BootloaderHle::Label label)
+			{
+				_State.PC = _Addresses[label];
+			}
+
+		public:
+			Call(Emulator::CPU* cpu, uint8_t* mem, const uint16_t* addresses, uint16_t codeStart, uint16_t codeEnd)
+				: _State(cpu->State)
+			{
+				_Cpu = cpu;
+				_Memory = cpu->_Memory.get();
+				_Mem = mem;
+				_Limit = (long long)std::floor(cpu->_LoopLimit);
+
+				_Addresses = addresses;
+				_CodeStart = codeStart;
+				_CodeEnd = codeEnd;
+			}
+
+			//-------------------Routines--------------------
+			//Each one starts with the return address on the stack, like after the CALL.
+
+			void STDM()
+			{
+				if (!StackFits(4, 2))
+					return;
+
+				uint16_t DE = (_State.D << 8) | _State.E;
+				if (!OutsideStack(DE, 6, 4, 2))
+					return;
+
+				uint8_t characters[6];
+				Cost cost = DisplayHead;
+
+				for (int i = 0; i < 6; i++)
+				{
+					//_STDM1: 0-9 become '0'-'9', A-F become 'A'-'F'.
+					uint8_t digit = _Mem[(uint16_t)(DE + i)] & 0x0f;
+					bool below10 = digit < 0x0a;
+
+					characters[i] = digit + (below10 ? 0x30 : 0x37);
+					cost = cost + (i > 0 ? PairOp : Cost()) + StdmDigit(below10);
+				}
+
+				cost = cost + DisplayTail;
+
+				if (!Fits(cost))
+					return;
+
+				for (int i = 0; i < 6; i++)
+				{
+					Out(0x55 - i, characters[i]);
+				}
+
+				DE += 5;
+				_State.D = DE >> 8;
+				_State.E = DE & 0xff;
+
+				ClearBelow(4);
+				Return();
+				Charge(cost);
+			}
+
+			void STDC()
+			{
+				if (!StackFits(2, 2) || !Fits(StdcCost))
+					return;
+
+				uint16_t DE = (_State.D << 8) | _State.E;
+				if (!OutsideStack(DE, 6, 2, 2))
+					return;
+
+				for (int i = 0; i < 6; i++)
+				{
+					Out(0x55 - i, _Mem[(uint16_t)(DE + i)]);
+				}
+
+				DE += 5;
+				_State.D = DE >> 8;
+				_State.E = DE & 0xff;
+
+				ClearBelow(2);
+				Return();
+				Charge(StdcCost);
+			}
+
+			void CLEARDISPLAY()
+			{
+				if (!StackFits(2, 2) || !Fits(ClearDisplayCost))
+					return;
+
+				for (uint8_t port = 0x50; port <= 0x55; port++)
+				{
+					Out(port, 0x00);
+				}
+
+				ClearBelow(2);
+				Return();
+				Charge(ClearDisplayCost);
+			}
+
+			void BEEP()
+			{
+				if (!StackFits(2, 2) || !Fits(BeepHead))
+					return;
+
+				Push(_State.A);
+				Push(_State.Flags);
+
+				Out(0x62, 0xb8);
+				Out(0x63, 0x01);
+				Out(0x60, 0xe8);
+				Out(0x61, 0x03);
+				_State.A = 0x03;
+
+				Charge(BeepHead);
+				GoTo(BootloaderHle::LabelWAIT_BEEP);
+
+				WAIT_BEEP();
+			}
+
+			void BEEPFD()
+			{
+				if (!StackFits(2, 2) || !Fits(BeepFdHead))
+					return;
+
+				Push(_State.A);
+				Push(_State.Flags);
+
+				Out(0x62, _State.C);
+				Out(0x63, _State.B);
+				Out(0x60, _State.E);
+				Out(0x61, _State.D);
+				_State.A = _State.D;
+
+				Charge(BeepFdHead);
+				GoTo(BootloaderHle::LabelWAIT_BEEP);
+
+				WAIT_BEEP();
+			}
+
+			//PSW is on the stack. Until both bytes of the beeper's countdown read 0.
+			void WAIT_BEEP()
+			{
+				if (!StackFits(12, 4))
+					return;
+
+				while (CanGoOn(WaitBeepMost))
+				{
+					ClearBelow(12);
+
+					bool done = true;
+
+					for (uint8_t port = 0x60; port <= 0x61 && done; port++)
+					{
+						Dela();
+
+						_State.A = In(port, _State.A);
+						Compare(_State.A, _State.Flags, 0);
+						Charge(WaitBeepHalf);
+
+						done = _State.A == 0;
+						Charge(done ? NotTaken : JumpOp);
+					}
+
+					if (done)
+					{
+						_State.Flags = Pop();
+						_State.A = Pop();
+						Return();
+						Charge(PopOp + RetOp);
+						return;
+					}
+				}
+			}
+
+			void DELA()
+			{
+				if (!StackFits(10, 2) || !Fits(DelaCost))
+					return;
+
+				Dela();
+
+				ClearBelow(10);
+				Return();
+				Charge(DelaCost);
+			}
+
+			//PSW, B and H are on the stack, BC is the count.
+			void DELA1()
+			{
+				if (!StackFits(4, 8))
+					return;
+
+				//The last round includes the end of DELA.
+				while (CanGoOn(LoopCarry(CallDcd) + DelaTail))
+				{
+					ClearBelow(4);
+					Dcd();
+
+					bool last;
+					Charge(CountDown(CallDcd, last));
+
+					if (last)
+					{
+						_State.L = Pop();
+						_State.H = Pop();
+						_State.C = Pop();
+						_State.B = Pop();
+						_State.Flags = Pop();
+						_State.A = Pop();
+						Return();
+						Charge(DelaTail);
+						return;
+					}
+				}
+			}
+
+			void DELB()
+			{
+				if (!StackFits(4, 2) || !Fits(DelbHead))
+					return;
+
+				Push(_State.A);
+				Push(_State.Flags);
+				Push(_State.B);
+				Push(_State.C);
+
+				Charge(DelbHead);
+				GoTo(BootloaderHle::LabelDELB1);
+
+				DELB1();
+			}
+
+			//PSW and B are on the stack, BC is the count.
+			void DELB1()
+			{
+				if (!StackFits(12, 6))
+					return;
+
+				while (CanGoOn(LoopCarry(CallDela) + DelbTail))
+				{
+					ClearBelow(12);
+					Dela();
+
+					bool last;
+					Charge(CountDown(CallDela, last));
+
+					if (last)
+					{
+						_State.C = Pop();
+						_State.B = Pop();
+						_State.Flags = Pop();
+						_State.A = Pop();
+						Return();
+						Charge(DelbTail);
+						return;
+					}
+				}
+			}
+
+			void KIND()
+			{
+				if (!StackFits(4, 2) || !Fits(KindHead))
+					return;
+
+				Push(_State.B);
+				Push(_State.C);
+				Push(_State.A);
+				Push(_State.Flags);
+
+				Charge(KindHead);
+				GoTo(BootloaderHle::LabelKIND0);
+
+				KINDLINE(0);
+			}
+
+			//B and PSW are on the stack. Scan the lines from line on, until a key is pressed.
+			void KINDLINE(int line)
+			{
+				if (!StackFits(4, 6))
+					return;
+
+				while (CanGoOn(KindMost))
+				{
+					ClearBelow(4);
+
+					uint8_t A = KindLines[line];
+					Out(0x28, A);
+					Dcd();
+					A = In(0x18, A);
+
+					_State.A = A;
+					Compare(A, _State.Flags, 0xff);
+					Charge(KindLine);
+
+					//Nothing on this line. After line 3 it's line 0 again.
+					if (A == 0xff)
+					{
+						Charge(JumpOp);
+						line = (line + 1) & 3;
+						GoTo((BootloaderHle::Label)(BootloaderHle::LabelKIND0 + line));
+						continue;
+					}
+
+					Charge(NotTaken);
+
+					//MVI B, then CPI and JZ _KINDDONE for every column. Line 3 doesn't check the last one.
+					_State.B = line * 4;
+					Charge(MviOp);
+
+					int columns = line < 3 ? 4 : 3;
+					bool found = false;
+
+					for (int column = 0; column < columns; column++)
+					{
+						Compare(A, _State.Flags, KindLines[column]);
+						Charge(ImmOp);
+
+						if (A == KindLines[column])
+						{
+							Charge(JumpOp);
+							found = true;
+							break;
+						}
+
+						Charge(NotTaken);
+
+						if (column < 3)
+						{
+							_State.B++;
+							_State.Flags = FlagsBasedOn(_State.B);
+							Charge(InrOp);
+						}
+					}
+
+					//_KINDDONE
+					if (found || line == 3)
+					{
+						_State.Flags = Pop();
+						_State.A = Pop();
+						_State.A = _State.B;
+						_State.C = Pop();
+						_State.B = Pop();
+						Return();
+						Charge(KindTail);
+						return;
+					}
+
+					//More than one key pressed. It goes on to the next line.
+					line++;
+					GoTo((BootloaderHle::Label)(BootloaderHle::LabelKIND0 + line));
+				}
+			}
+		};
+	}
+
+	void BootloaderHle::SetLabels(Emulator::CPU* cpu, const std::vector<std::pair<std::string, uint16_t>>& labels)
+	{
+		memset(_Labels, 0, sizeof(_Labels));
+		memset(_Addresses, 0, sizeof(_Addresses));
+		_Code.clear();
+
+		uint8_t* mem = cpu->_Memory->GetData().get();
+
+		for (int i = 1; i < LabelCount; i++)
+		{
+			for (auto& label : labels)
+			{
+				if (label.first == Labels[i].Name)
+				{
+					//Labels are one before the address, like the PC before an instruction runs.
+					_Addresses[i] = label.second + 1;
+				}
+			}
+
+			if (_Addresses[i] == 0 || _Addresses[i] >= Size || mem[_Addresses[i]] != Labels[i].Opcode)
+			{
+				memset(_Addresses, 0, sizeof(_Addresses));
+				return;
+			}
+		}
+
+		//DCD is the first routine, and _KINDDONE (POP PSW, MOV A,B, POP B, RET) is the end of the last.
+		_CodeStart = _Addresses[LabelDCD];
+		uint16_t end = _Addresses[LabelKINDDONE] + 4;
+
+		for (int i = LabelDCD; i < RoutineCount; i++)
+		{
+			uint16_t next = i + 1 < RoutineCount ? _Addresses[i + 1] : end;
+
+			if (next <= _Addresses[i])
+			{
+				memset(_Addresses, 0, sizeof(_Addresses));
+				return;
+			}
+		}
+
+		_Code.assign(mem + _CodeStart, mem + end);
+
+		//Not DCD: it's only a few instructions, the checks would cost more than running it. It is done here only when DELA or KIND call it.
+		for (int i = LabelSTDM; i < LabelKINDDONE; i++)
+		{
+			_Labels[_Addresses[i]] = i;
+		}
+	}
+
+	bool BootloaderHle::IsIntact(uint8_t* mem, uint8_t label)
+	{
+		uint16_t end = _CodeStart + _Code.size();
+
+		for (int i = LabelDCD; i < RoutineCount; i++)
+		{
+			if (!(Uses[label] & Bit(i)))
+				continue;
+
+			uint16_t start = _Addresses[i];
+			uint16_t next = i + 1 < RoutineCount ? _Addresses[i + 1] : end;
+
+			if (memcmp(mem + start, _Code.data() + (start - _CodeStart), next - start) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool BootloaderHle::Arrive(Emulator::CPU* cpu)
+	{
+		Emulator::CpuState& state = cpu->State;
+
+		//Breakpoints need every instruction. An interrupt is taken by the core before anything else.
+		//The costs here are the usual ones, not SetCycleExact()'s.
+		if (cpu->GetCycleExact() || cpu->_BreakpointMap.Any() || Emulator::InterruptWaiting(state) || !cpu->GetRunning() || cpu->GetHalted())
+			return false;
+
+		uint8_t* mem = cpu->_Memory->GetData().get();
+
+		if (!IsIntact(mem, _Labels[state.PC]))
+			return false;
+
+		uint64_t instructions = state.TotalInstructions;
+
+		Call call(cpu, mem, _Addresses, _CodeStart, (uint16_t)(_CodeStart + _Code.size()));
+
+		switch (_Labels[state.PC])
+		{
+		case LabelSTDM: call.STDM(); break;
+		case LabelSTDC: call.STDC(); break;
+		case LabelCLEARDISPLAY: call.CLEARDISPLAY(); break;
+		case LabelBEEP: call.BEEP(); break;
+		case LabelBEEPFD: call.BEEPFD(); break;
+		case LabelWAIT_BEEP: call.WAIT_BEEP(); break;
+		case LabelDELA: call.DELA(); break;
+		case LabelDELA1: call.DELA1(); break;
+		case LabelDELB: call.DELB(); break;
+		case LabelDELB1: call.DELB1(); break;
+		case LabelKIND: call.KIND(); break;
+		case LabelKIND0: call.KINDLINE(0); break;
+		case LabelKIND1: call.KINDLINE(1); break;
+		case LabelKIND2: call.KINDLINE(2); break;
+		case LabelKIND3: call.KINDLINE(3); break;
+		default: break;
+		}
+
+		return state.TotalInstructions != instructions;
+	}
+}
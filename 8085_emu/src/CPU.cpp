@@ -1,6 +1,10 @@
 #include "cpu.h"
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "CPUinstructions.h"
@@ -8,38 +12,31 @@
 namespace Emulator
 {
 
-	CPU* CPU::cpu;
-
-	CPU::CPU(std::shared_ptr<Memory> memory, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>>& symbols)
+	CPU::CPU(std::shared_ptr<Memory> memory, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>>& symbols, CPUCores core)
 		: _Breakpoints(breakpoints)
 	{
-		cpu = this;
+		_Core = core;
 
 		_Running = true;
 		_Halted = false;
-		_HangingCycles = 0;
 		_Memory = memory;
 
-		_Stack = std::make_shared<InternalEmulator::Stack>(16);
-		_Stack->SetDataPointer(_Memory->GetData());
-
-		A = std::make_shared<Register8>();
-		B = std::make_shared<Register8>();
-		C = std::make_shared<Register8>();
-		D = std::make_shared<Register8>();
-		E = std::make_shared<Register8>();
-		H = std::make_shared<Register8>();
-		L = std::make_shared<Register8>();
+		//The cores, the stack (SP starts at FFFFH) and snapshots use every address, so the memory has to be all of them.
+		assert(_Memory->GetSize() >= 0x10000);
 
-		Flags = std::make_shared<Register8>();
-
-		PC = std::make_shared<Register>();
-		PC->Clear();
-		SP = std::make_shared<Register>();
+		//The stack sets State.SP to the top of the stack.
+		_Stack = std::make_shared<InternalEmulator::Stack>(16, &State.SP);
+		_Stack->SetDataPointer(_Memory->GetData());
 
+		if (_Core == BlockCore || _Core == JitCore)
+		{
+			_BlockCache = std::make_unique<InternalEmulator::BlockCache>(_Memory);
+		}
 
-		//SP is literally a pointer to the address of the stack.
-		SP->SetRef(_Stack->GetSPPointer());
+		if (_Core == JitCore && InternalEmulator::Jit::IsSupported())
+		{
+			_Jit = std::make_unique<InternalEmulator::Jit>(_BlockCache.get());
+		}
 
 		//The following code is done because it's much faster to use a pointer array than a vector
 		int maxLine = 0;
@@ -66,8 +63,8 @@ namespace Emulator
 		UpdateBreakpoints();
 	}
 
-	CPU::CPU(std::shared_ptr<uint8_t> memory, size_t size, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>> symbols)
-		: CPU(std::make_shared<Memory>(memory, size), breakpoints, symbols) {}
+	CPU::CPU(std::shared_ptr<uint8_t> memory, size_t size, std::vector<int>& breakpoints, std::vector<std::pair<uint16_t, int>> symbols, CPUCores core)
+		: CPU(std::make_shared<Memory>(memory, size), breakpoints, symbols, core) {}
 
 	void CPU::SetClock(int clock_speed, int accuracy)
 	{
@@ -78,7 +75,7 @@ namespace Emulator
 	{
 		//TODO: SHOULD INTERRUPTS BE DISABLED DURING OTHER INTERRUPT HANDLING?
 
-		if (!_InterruptsEnabled)
+		if (!State.InterruptsEnabled)
 		{
 			return false;
 		}
@@ -88,71 +85,197 @@ namespace Emulator
 
 		//If interrupts enabled, and if it's NOT masked, and if it's pending . . .
 
-		if (!_M75 && _IP75) // Interrupt 7.5, highest priority
+		InterruptLines line;
+
+		if (!State.M75 && State.IP75) // Interrupt 7.5, highest priority
+		{
+			line = Interrupt75;
+		}
+		else if (!State.M65 && State.IP65) // Interrupt 6.5
 		{
-			_IP75 = false;
+			line = Interrupt65;
+		}
+		else if (!State.M55 && State.IP55) // Interrupt 5.5
+		{
+			line = Interrupt55;
+		}
+		else if (State.IPINTR && State.INTR_ADDR != 0) // Interrupt INTR, lowest priority
+		{
+			line = InterruptINTR;
+		}
+		else
+		{
+			return false;
+		}
 
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+		TookInterrupt(line, State.TotalInstructions);
+		TakeInterrupt(line);
 
-			CPU::cpu->PC->Set(0x003C);
+		return true;
+	}
 
-			_InterruptsEnabled = false;
+	void CPU::TakeInterrupt(InterruptLines line)
+	{
+		uint16_t vector = 0;
 
-			return true;
+		switch (line)
+		{
+		case Interrupt75: State.IP75 = false; vector = 0x003C; break;
+		case Interrupt65: State.IP65 = false; vector = 0x0034; break;
+		case Interrupt55: State.IP55 = false; vector = 0x002C; break;
+		case InterruptINTR: State.IPINTR = false; vector = State.INTR_ADDR + 1; break;
 		}
 
-		if (!_M65 && _IP65) // Interrupt 6.5
+		_Stack->Push(State.PC >> 8);
+		_Stack->Push(State.PC & 0xff);
+
+		State.PC = vector;
+
+		State.InterruptsEnabled = false;
+	}
+
+	void CPU::SetPending(InterruptLines line)
+	{
+		switch (line)
 		{
-			_IP65 = false;
+		case Interrupt55: State.IP55 = true; break;
+		case Interrupt65: State.IP65 = true; break;
+		case Interrupt75: State.IP75 = true; break;
+		case InterruptINTR: State.IPINTR = true; break;
+		}
+	}
 
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+	void CPU::RaiseInterrupt(InterruptLines line)
+	{
+		InternalEmulator::Event event;
+		event.Interrupt = line;
 
-			CPU::cpu->PC->Set(0x0034);
+		_Scheduler.Post(event); // Cycle 0, due right away.
 
-			_InterruptsEnabled = false;
+		Wake();
+	}
 
-			return true;
-		}
+	void CPU::Schedule(uint64_t cycle, EventHandler handler)
+	{
+		InternalEmulator::Event event;
+		event.Cycle = cycle;
+		event.Handler = handler;
 
-		if (!_M55 && _IP55) // Interrupt 5.5
+		_Scheduler.Schedule(event);
+		UpdateLoopLimit();
+	}
+
+	void CPU::ScheduleInterrupt(uint64_t cycle, InterruptLines line)
+	{
+		InternalEmulator::Event event;
+		event.Cycle = cycle;
+		event.Interrupt = line;
+
+		_Scheduler.Schedule(event);
+		UpdateLoopLimit();
+	}
+
+	void CPU::RunEvents()
+	{
+		if (_Scheduler.HasPosted())
 		{
-			_IP55 = false;
+			for (const InternalEmulator::Event& event : _Scheduler.TakePosted())
+			{
+				if (_Rewind != nullptr)
+					_Rewind->RecordEntry({ State.TotalInstructions, 0, Rewind::Entry::Posted, (uint8_t)event.Interrupt });
+			}
+		}
 
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-			CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+		RunDueEvents(State.TotalCycles + State.CurrentCycles);
+	}
 
-			CPU::cpu->PC->Set(0x002C);
+	void CPU::RunDueEvents(uint64_t now)
+	{
+		InternalEmulator::Event event;
+		bool ran = false;
 
-			_InterruptsEnabled = false;
+		while (_Scheduler.PopDue(now, event))
+		{
+			ran = true;
 
-			return true;
+			if (event.Interrupt >= 0)
+				SetPending((InterruptLines)event.Interrupt);
+			else if (event.Handler)
+				event.Handler(event.Cycle);
 		}
 
+		if (ran && _Rewind != nullptr)
+			_Rewind->RecordEntry({ State.TotalInstructions, now, Rewind::Entry::Events, 0 });
 
-		if (_IPINTR) // Interrupt INTR, lowest priority
-		{
-			if (INTR_ADDR != 0)
-			{
-				_IPINTR = false;
+		UpdateLoopLimit();
+	}
+
+	uint8_t CPU::RewindReadPort(uint8_t port, uint8_t A, uint64_t instruction)
+	{
+		uint8_t value;
 
-				CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-				CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+		if (_Rewind->IsReplaying() && _Rewind->ReplayIn(port, value))
+			return value;
 
-				CPU::cpu->PC->Set(INTR_ADDR + 1);
+		const IOPort& handler = _IOPorts[port];
+		value = handler.INPUT ? handler.INPUT() : A;
 
-				_InterruptsEnabled = false;
+		_Rewind->RecordIn(instruction, port, value);
 
-				return true;
-			}
+		return value;
+	}
+
+	void CPU::RewindInterrupt(InterruptLines line, uint64_t instruction)
+	{
+		_Rewind->RecordEntry({ instruction, 0, Rewind::Entry::Interrupt, (uint8_t)line });
+	}
+
+	void CPU::UpdateLoopLimit()
+	{
+		uint64_t next = _Scheduler.Next();
+		_LoopLimit = _ClockCyclesPerLoop;
+
+		if (next == UINT64_MAX)
+			return;
+
+		//Due already (scheduled for the past, from an IN/OUT handler): stop before the next instruction.
+		if (next <= State.TotalCycles)
+		{
+			_LoopLimit = -1;
+			return;
 		}
 
-		return false;
+		//Cycle next is CurrentCycles next - TotalCycles. Instructions can start until one cycle before that.
+		if ((double)(next - State.TotalCycles - 1) < _LoopLimit)
+		{
+			_LoopLimit = (double)(next - State.TotalCycles - 1);
+		}
+	}
+
+	void CPU::Wake()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_WakeMutex);
+			_Wakes++;
+		}
+
+		_WakeCondition.notify_all();
+	}
+
+	uint64_t CPU::GetWakes()
+	{
+		std::lock_guard<std::mutex> lock(_WakeMutex);
+		return _Wakes;
+	}
+
+	bool CPU::WaitForWake(uint64_t wakes, std::chrono::steady_clock::time_point deadline)
+	{
+		std::unique_lock<std::mutex> lock(_WakeMutex);
+		return _WakeCondition.wait_until(lock, deadline, [&]() { return _Wakes != wakes; });
 	}
 
 	//In my program, a Loop is something that happens as many times as "CLOCK_ACCURACY" describes per second.
-	//"CLOCK" is something that happens as many times as "CLOCK_SPEED" says per second. _HangingCycles are clock cycles that are skipped.
+	//"CLOCK" is something that happens as many times as "CLOCK_SPEED" says per second. HangingCycles are clock cycles that are skipped.
 
 	// Since we are dividing our clock cycles into loops, we will have CLOCK_SPEED/CLOCK_ACURACY clocks per loop. Thus, _ClockCyclesPerLoop
 
@@ -161,80 +284,167 @@ namespace Emulator
 	void CPU::Loop()
 	{
 		_Running = true;
-		_Halted = false;
+		SetHalted(false);
+		_IdleLoops.ClearIdle();
 
-		while (_Running && !_Halted && _CurrentCycles <= _ClockCyclesPerLoop) //If we're running and if we STILL have cycles in our loop.
+		auto start = std::chrono::steady_clock::now();
+
+		RunEvents();
+
+		if (_Tracer != nullptr)
+		{
+			RunTraced();
+		}
+		else if (_Core == SwitchCore)
+		{
+			//Same loop, but everything is inlined. See CPUswitch.cpp
+			if (_LazyFlags)
+				RunSwitch<false, true, false>();
+			else
+				RunSwitch<false, false, false>();
+		}
+		else if (_Core == BlockCore || _Core == JitCore)
 		{
-			_CurrentCycles += _HangingCycles; //We completely skip _HangingCycles
+			if (_LazyFlags)
+				RunSwitch<false, true, true>();
+			else
+				RunSwitch<false, false, true>();
+		}
+		else
+		{
+			while (_Running && !_Halted && State.CurrentCycles <= _ClockCyclesPerLoop) //If we're running and if we STILL have cycles in our loop.
+			{
+				//An event is due. See Schedule().
+				if (State.CurrentCycles > _LoopLimit)
+				{
+					RunEvents();
+				}
 
-			_HangingCycles = 0; // And then make them 0.
+				//A bootloader routine. See SetBootloaderHle().
+				if (_BootloaderHle && _Profiler == nullptr && _Bootloader.Has(State.PC) && _Bootloader.Arrive(this))
+				{
+					continue;
+				}
+
+				State.CurrentCycles += State.HangingCycles; //We completely skip HangingCycles
+
+				State.HangingCycles = 0; // And then make them 0.
+
+				Interrupts(); // Check for interrupts.
+
+				uint16_t pc = State.PC;
+				uint8_t op = _Memory->GetDataAtAddr(pc);
 
-			Interrupts(); // Check for interrupts.
+				Clock(); //Clock.
 
-			Clock(); //Clock.
+				State.CurrentCycles++; //Increment clock cycles.
 
-			_CurrentCycles++; //Increment clock cycles.
+				//A jump backwards (JMP or Jcc), maybe a delay loop. See SetIdleSkip().
+				if (_IdleSkip && _Profiler == nullptr && State.PC <= pc && (op == 0xc3 || (op & 0xc7) == 0xc2))
+				{
+					_IdleLoops.Arrive(this);
+				}
+			}
 		}
 
-		_CurrentCycles = 0; //Reset _CurrentCycles too 0.
-		//"_CurrentCycles" counts cycles per loop.
+		auto end = std::chrono::steady_clock::now();
+
+		_Perf.Loops++;
+		_Perf.LoopNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		_Perf.LoopCycles += State.CurrentCycles;
+
+		State.TotalCycles += State.CurrentCycles;
+		State.CurrentCycles = 0; //Reset CurrentCycles too 0.
+
+		PublishPerf(end);
+		//"CurrentCycles" counts cycles per loop.
 		//Max is equal to _ClockCyclesPerLoop
 	}
 
-	bool alreadyHalted = false;
-
 	void CPU::Clock()
 	{
-		if (!_Halted && !alreadyHalted) //We don't want to halt on the same line twice. We want to continue.
+		if (_Core == SwitchCore)
 		{
-			int currentLine = 0; //Search for the line that corresponds to the current opcode
+			RunSwitch<true, false, false>(); //Lazy flags don't help for a single instruction.
+			return;
+		}
 
-			uint16_t currentAddr = PC->Get();
+		if (_Core == BlockCore || _Core == JitCore)
+		{
+			RunSwitch<true, false, true>();
+			return;
+		}
 
-			for (int i = 0; i < _BreakpointsArrSize; i++) // Search the Breakpoint Array.
+		if (!_Halted && !_AlreadyHalted) //We don't want to halt on the same line twice. We want to continue.
+		{
+			if (_BreakpointMap.Check(State.PC)) // If there's a breakpoint on the current address, break.
 			{
-				if (_BreakpointsArr.get()[i] == currentAddr) // If the currentAddr is in there, break.
-				{
-					_Halted = true;
-					alreadyHalted = true;
-					return;
-				}
+				_Halted = true;
+				_AlreadyHalted = true;
+				return;
 			}
 		}
 
-		alreadyHalted = false;
+		_AlreadyHalted = false;
 
-		uint8_t op = _Memory->GetDataAtAddr(PC->Get()); //Get opcode.
+		uint16_t pc = State.PC;
+		uint16_t sp = State.SP;
+		uint8_t op = _Memory->GetDataAtAddr(State.PC); //Get opcode.
 
 		InternalEmulator::CPUInstruction instr = InternalEmulator::CPUInstructions[op]; //CPUInstructions is sorted with OPCODE, so we just get it using [op]
 
-		_HangingCycles = instr.ACTION(instr.bytes);
+		int hanging = instr.ACTION(this, instr.bytes);
+		State.HangingCycles = _CycleExact ? InternalEmulator::ExactHanging(op, hanging) : hanging;
 
-		PC->Increment();
+		if (_CountOpcodes)
+		{
+			_Perf.Opcodes[op]++;
+		}
+
+		State.PC++;
+		State.TotalInstructions++;
+
+		if (_Profiler != nullptr)
+		{
+			_Profiler->Count(pc, op, State.HangingCycles + 1, sp, State.PC, State.SP);
+		}
 	}
 
 
 
 	void CPU::Step(std::vector<std::pair<uint16_t, int>> Symbols)
 	{
-		_CurrentCycles = 0;
+		State.CurrentCycles = 0;
 
 		bool first = true;
 		bool hasSymbol = false;
 
-		while (((!hasSymbol && _CurrentCycles < _ClockCyclesPerLoop) || first) && GetRunning())
+		while (((!hasSymbol && State.CurrentCycles < _ClockCyclesPerLoop) || first) && GetRunning())
 		{
 			first = false;
 			hasSymbol = false;
 
-			Interrupts();
-			Clock();
+			RunEvents();
 
-			_CurrentCycles += _HangingCycles + 1;
+			if (_Tracer != nullptr)
+			{
+				TracedInstruction(_Memory->GetData().get());
+			}
+			else
+			{
+				//Counted like in Loop(), so the hanging cycles of the last step are counted once, by whatever runs next.
+				State.CurrentCycles += State.HangingCycles;
+				State.HangingCycles = 0;
+
+				Interrupts();
+				Clock();
+
+				State.CurrentCycles++;
+			}
 
 			for (int i = 0; i < Symbols.size(); i++)
 			{
-				if (Symbols.at(i).first == PC->Get())
+				if (Symbols.at(i).first == State.PC)
 				{
 					hasSymbol = true;
 					break;
@@ -242,42 +452,154 @@ namespace Emulator
 			}
 
 		}
+
+		State.TotalCycles += State.CurrentCycles;
+		State.CurrentCycles = 0;
+
+		PublishPerf(std::chrono::steady_clock::now());
+	}
+
+	void CPU::AddSleep(uint64_t overshootNs)
+	{
+		_Perf.Sleeps++;
+		_Perf.SleepOvershootNs += overshootNs;
+
+		PublishPerf(std::chrono::steady_clock::now());
+	}
+
+	void CPU::PublishPerfCounts()
+	{
+		_Perf.Instructions = State.TotalInstructions;
+		_Perf.Cycles = State.TotalCycles;
+
+		_PerfCounters.Publish(_Perf);
+		_PerfPublished = std::chrono::steady_clock::now();
+	}
+
+	void CPU::PublishPerf(std::chrono::steady_clock::time_point now)
+	{
+		if (now - _PerfPublished >= PerfPublishInterval)
+		{
+			PublishPerfCounts();
+		}
 	}
 
 
 	//Set all flags accordingly. If it's -1, don't affect it.
 	void CPU::SetFlags(uint8_t sign, uint8_t zero, uint8_t aux_c, uint8_t parity, uint8_t carry)
 	{
-		Flags->SetUnsigned(
-			((sign != -1) ? (sign & 1) << 7 : Flags->GetBit(SIGN_FLAG)) |
-			((zero != -1) ? (zero & 1) << 6 : Flags->GetBit(ZERO_FLAG)) |
-			((aux_c != -1) ? (aux_c & 1) << 4 : Flags->GetBit(AUX_CARRY_FLAG)) |
-			((parity != -1) ? (parity & 1) << 2 : Flags->GetBit(PARITY_FLAG)) |
-			((carry != -1) ? (carry & 1) << 0 : Flags->GetBit(CARRY_FLAG))
-		);
+		State.Flags =
+			((sign != -1) ? (sign & 1) << 7 : GetBit(State.Flags, SIGN_FLAG)) |
+			((zero != -1) ? (zero & 1) << 6 : GetBit(State.Flags, ZERO_FLAG)) |
+			((aux_c != -1) ? (aux_c & 1) << 4 : GetBit(State.Flags, AUX_CARRY_FLAG)) |
+			((parity != -1) ? (parity & 1) << 2 : GetBit(State.Flags, PARITY_FLAG)) |
+			((carry != -1) ? (carry & 1) << 0 : GetBit(State.Flags, CARRY_FLAG));
 	}
 
+	//Only the lines that changed since the last call are added to / removed from the map.
 	void CPU::UpdateBreakpoints()
 	{
-		_BreakpointsArr = std::shared_ptr<uint16_t>((uint16_t*)calloc(_Breakpoints.size(), sizeof(uint16_t)), free);
-		_BreakpointsArrSize = _Breakpoints.size();
+		//We convert from Breakpoint Line to Memory Address.
+		auto lineToAddr = [this](int line) -> uint16_t
+		{
+			return (line >= 0 && (size_t)line < _SymbolSize) ? _Symbols.get()[line] : 0;
+		};
 
-		if (_BreakpointsArr == nullptr)
+		for (int line : _BreakpointLines)
 		{
-			//exit(1); //TODO: Better error handling
-			return;
+			if (std::find(_Breakpoints.begin(), _Breakpoints.end(), line) == _Breakpoints.end())
+			{
+				_BreakpointMap.Remove(lineToAddr(line));
+			}
 		}
 
-		for (int i = 0; i < _Breakpoints.size(); i++) // We convert from Breakpoint Line to Memory Address.
+		for (int line : _Breakpoints)
 		{
-			for (int j = 0; j < _SymbolSize; j++)
+			if (std::find(_BreakpointLines.begin(), _BreakpointLines.end(), line) == _BreakpointLines.end())
 			{
-				if (_Breakpoints.at(i) == j)
-				{
-					_BreakpointsArr.get()[i] = _Symbols.get()[j];
-				}
+				_BreakpointMap.Add(lineToAddr(line));
+			}
+		}
+
+		_BreakpointLines = _Breakpoints;
+	}
+
+	Snapshot CPU::SaveState()
+	{
+		Snapshot snapshot;
+
+		snapshot.State = State;
+		snapshot.Running = _Running;
+		snapshot.Halted = _Halted;
+		snapshot.AlreadyHalted = _AlreadyHalted;
+		snapshot.WaitingForInterrupt = _WaitingForInterrupt;
+		snapshot.ErrorCode = ErrorCode;
+
+		snapshot.Events = _Scheduler.GetEvents();
+		snapshot.EventOrder = _Scheduler.GetOrder();
+
+		uint8_t* mem = _Memory->GetData().get();
+
+		for (int page = 0; page < SnapshotPageCount; page++)
+		{
+			const uint8_t* data = mem + page * SnapshotPageSize;
+			SnapshotPage& last = _SnapshotPages[page];
+
+			//Changed (or the first snapshot): a new page. The old one stays as it is for the snapshots that have it.
+			if (last == nullptr || memcmp(last->data(), data, SnapshotPageSize) != 0)
+			{
+				auto copy = std::make_shared<std::array<uint8_t, SnapshotPageSize>>();
+				memcpy(copy->data(), data, SnapshotPageSize);
+				last = copy;
 			}
+
+			snapshot.Pages[page] = last;
+		}
+
+		snapshot.Peripherals.resize(_StateHandlers.size());
+
+		for (size_t i = 0; i < _StateHandlers.size(); i++)
+		{
+			_StateHandlers[i].Save(_StateHandlers[i].Context, snapshot.Peripherals[i]);
+		}
+
+		return snapshot;
+	}
+
+	void CPU::LoadState(const Snapshot& snapshot)
+	{
+		State = snapshot.State;
+		_Running = snapshot.Running;
+		_Halted = snapshot.Halted;
+		_AlreadyHalted = snapshot.AlreadyHalted;
+		_WaitingForInterrupt = snapshot.WaitingForInterrupt;
+		ErrorCode = (ErrorCodes)snapshot.ErrorCode;
+
+		_Scheduler.SetEvents(snapshot.Events, snapshot.EventOrder);
+		UpdateLoopLimit();
+
+		uint8_t* mem = _Memory->GetData().get();
+
+		for (int page = 0; page < SnapshotPageCount; page++)
+		{
+			uint8_t* data = mem + page * SnapshotPageSize;
+			const SnapshotPage& saved = snapshot.Pages[page];
+
+			if (memcmp(data, saved->data(), SnapshotPageSize) != 0)
+			{
+				memcpy(data, saved->data(), SnapshotPageSize);
+				_Memory->PageWritten((uint8_t)page);
+			}
+
+			_SnapshotPages[page] = saved;
 		}
+
+		for (size_t i = 0; i < _StateHandlers.size() && i < snapshot.Peripherals.size(); i++)
+		{
+			_StateHandlers[i].Load(_StateHandlers[i].Context, snapshot.Peripherals[i]);
+		}
+
+		_IdleLoops.ClearIdle();
 	}
 
 	int CPU::GetInstructionBytes()
@@ -2,42 +2,29 @@
 
 #include <stdio.h>
 #include <vector>
-#include <bitset>
 
 #include "cpu.h"
 #include "IO_cb.h"
+#include "flag_tables.h"
 
 namespace InternalEmulator
 {
 
     using namespace Emulator;
 
-    int bits_in(uint64_t u)
-    {
-        auto bs = std::bitset<64>(u);
-        return bs.count();
-    }
-
     //Set sign, zero and parity flag, depending on a certain number.
     //Not enough info to know aux_c and carry.
-    void SetFlagsBasedOn(int8_t n)
-    {
-        CPU::cpu->SetFlags(
-            n < 0,
-            n == 0,
-            -1,
-            !(bits_in(*(uint8_t*)&n) % 2),
-            -1
-        );
+    //This used to call SetFlags() with -1 for aux_c and carry, which is 0xff as uint8_t, so both always ended up set. Kept that way.
+    void SetFlagsBasedOn(CPU* cpu, int8_t n)
+    {
+        cpu->State.Flags = SZPTable[(uint8_t)n] | (1 << AUX_CARRY_FLAG) | (1 << CARRY_FLAG);
     }
 
     //Get double register BC unsigned uint16_t
-    uint16_t GetBCUnsigned()
+    uint16_t GetBCUnsigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t B = cpu->B->GetUnsigned();
-        uint8_t C = cpu->C->GetUnsigned();
+        uint8_t B = cpu->State.B;
+        uint8_t C = cpu->State.C;
 
         uint16_t BC = (B << 8) | C;
 
@@ -45,12 +32,10 @@ namespace InternalEmulator
     }
 
     //Get double regsiter DE unsigned uint16_t
-    uint16_t GetDEUnsigned()
+    uint16_t GetDEUnsigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t D = cpu->D->GetUnsigned();
-        uint8_t E = cpu->E->GetUnsigned();
+        uint8_t D = cpu->State.D;
+        uint8_t E = cpu->State.E;
 
         uint16_t DE = (D << 8) | E;
 
@@ -58,12 +43,10 @@ namespace InternalEmulator
     }
 
     //Get double regsiter HL unsigned uint16_t
-    uint16_t GetHLUnsigned()
+    uint16_t GetHLUnsigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t H = cpu->H->GetUnsigned();
-        uint8_t L = cpu->L->GetUnsigned();
+        uint8_t H = cpu->State.H;
+        uint8_t L = cpu->State.L;
 
         uint16_t HL = (H << 8) | L;
 
@@ -71,12 +54,10 @@ namespace InternalEmulator
     }
 
     //Get double regsiter BC signed int16_t
-    int16_t GetBCSigned()
+    int16_t GetBCSigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t B = cpu->B->GetUnsigned();
-        uint8_t C = cpu->C->GetUnsigned();
+        uint8_t B = cpu->State.B;
+        uint8_t C = cpu->State.C;
 
         uint16_t BC = (B << 8) | C;
 
@@ -84,12 +65,10 @@ namespace InternalEmulator
     }
 
     //Get double regsiter DE signed int16_t
-    int16_t GetDESigned()
+    int16_t GetDESigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t D = cpu->D->GetUnsigned();
-        uint8_t E = cpu->E->GetUnsigned();
+        uint8_t D = cpu->State.D;
+        uint8_t E = cpu->State.E;
 
         uint16_t DE = (D << 8) | E;
 
@@ -97,12 +76,10 @@ namespace InternalEmulator
     }
 
     //Get double regsiter HL signed int16_t
-    int16_t GetHLSigned()
+    int16_t GetHLSigned(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t H = cpu->H->GetUnsigned();
-        uint8_t L = cpu->L->GetUnsigned();
+        uint8_t H = cpu->State.H;
+        uint8_t L = cpu->State.L;
 
         uint16_t HL = (H << 8) | L;
 
@@ -111,10 +88,8 @@ namespace InternalEmulator
 
 
     //Get the next 2 bytes in memory, using PC
-    uint16_t GetNextPC16()
+    uint16_t GetNextPC16(CPU* cpu)
     {
-        CPU* cpu = CPU::cpu;
-
         uint8_t LOW = cpu->NextPC();
         uint8_t HIGH = cpu->NextPC();
 
@@ -124,34 +99,31 @@ namespace InternalEmulator
     }
 
     //Compare Register A with another number. Set the flags accordingly.
-    void Compare(int8_t other)
+    void Compare(CPU* cpu, int8_t other)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t A = cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
         if (A < other)
         {
-            cpu->Flags->SetBit(CARRY_FLAG, 1);
-            cpu->Flags->ClearBit(ZERO_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG, 1);
+            ClearBit(cpu->State.Flags, ZERO_FLAG);
         }
         else if (A == other)
         {
-            cpu->Flags->ClearBit(CARRY_FLAG);
-            cpu->Flags->SetBit(ZERO_FLAG, 1);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
+            SetBit(cpu->State.Flags, ZERO_FLAG, 1);
         }
         else if (A > other)
         {
-            cpu->Flags->ClearBit(CARRY_FLAG);
-            cpu->Flags->ClearBit(ZERO_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
+            ClearBit(cpu->State.Flags, ZERO_FLAG);
         }
     }
 
     //Add signed number to Register A
-    void AddSigned(int8_t data)
+    void AddSigned(CPU* cpu, int8_t data)
     {
-        CPU* cpu = CPU::cpu;
-
-        int8_t rA = cpu->A->GetSigned();
+        int8_t rA = (int8_t)cpu->State.A;
 
         int16_t result16 = rA + data;
         int8_t result = rA + data;
@@ -161,20 +133,18 @@ namespace InternalEmulator
             result < 0,
             result != 0,
             (result4 & 0xf0) > 0,
-            !(bits_in(*(uint8_t*)&result) % 2),
+            Parity((uint8_t)result),
             (result16 & 0b100000000) > 0
         );
 
-        cpu->A->SetSigned(result);
+        cpu->State.A = result;
     }
 
     //Add signed number to Register A with carry
-    void AddSignedWithCarry(int8_t data)
+    void AddSignedWithCarry(CPU* cpu, int8_t data)
     {
-        CPU* cpu = CPU::cpu;
-
-        int8_t rA = cpu->A->GetSigned();
-        int8_t rC = cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t rA = (int8_t)cpu->State.A;
+        int8_t rC = GetBit(cpu->State.Flags, CARRY_FLAG);
 
         int16_t result16 = rA + data + rC;
         int8_t result = rA + data + rC;
@@ -184,20 +154,18 @@ namespace InternalEmulator
             result < 0,
             result != 0,
             (result4 & 0xf0) > 0,
-            !(bits_in(*(uint8_t*)&result) % 2),
+            Parity((uint8_t)result),
             (result16 & 0b100000000) > 0
         );
 
-        cpu->A->SetSigned(result);
+        cpu->State.A = result;
     }
 
     //Add unsigned number to Register A with carry
-    void AddUnignedWithCarry(uint8_t data)
+    void AddUnignedWithCarry(CPU* cpu, uint8_t data)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t rA = cpu->A->GetUnsigned();
-        uint8_t rC = cpu->Flags->GetBit(CARRY_FLAG);
+        uint8_t rA = cpu->State.A;
+        uint8_t rC = GetBit(cpu->State.Flags, CARRY_FLAG);
 
         uint16_t result16 = rA + data + rC;
         uint8_t result = rA + data + rC;
@@ -208,19 +176,17 @@ namespace InternalEmulator
             0,
             result != 0,
             (result4 & 0xf0) > 0,
-            !(bits_in(result) % 2),
+            Parity(result),
             (result16 & 0b100000000) > 0
         );
 
-        cpu->A->SetUnsigned(result);
+        cpu->State.A = result;
     }
 
     //Bitwise And Register A with another number.
-    void And(uint8_t data)
+    void And(CPU* cpu, uint8_t data)
     {
-        CPU* cpu = CPU::cpu;
-
-        int8_t rA = cpu->A->GetUnsigned();
+        int8_t rA = cpu->State.A;
 
         uint8_t result = rA & data;
 
@@ -228,11 +194,11 @@ namespace InternalEmulator
             (result & 0b10000000) > 0,
             result != 0,
             0,
-            !(bits_in(*(uint8_t*)&result) % 2),
+            Parity((uint8_t)result),
             0
         );
 
-        cpu->A->SetSigned(result);
+        cpu->State.A = result;
     }
 
     //-------------------Instructions--------------------
@@ -240,206 +206,202 @@ namespace InternalEmulator
     //Only comments on "weird" stuff.
     //Questions, pointing out mistakes/bugs etc. is all welcome.
 
-    int ACIData(int bytes)
+    int ACIData(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
         int8_t data = cpu->NextPC();
 
-        AddSignedWithCarry(data);
+        AddSignedWithCarry(cpu, data);
 
         return 7;
     }
 
-    int ADCA(int bytes)
+    int ADCA(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->A->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.A);
 
         return 4;
     }
 
-    int ADCB(int bytes)
+    int ADCB(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->B->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.B);
 
         return 4;
     }
 
-    int ADCC(int bytes)
+    int ADCC(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->C->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.C);
 
         return 4;
     }
 
-    int ADCD(int bytes)
+    int ADCD(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->D->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.D);
 
         return 4;
     }
 
-    int ADCE(int bytes)
+    int ADCE(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->E->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.E);
 
         return 4;
     }
 
-    int ADCH(int bytes)
+    int ADCH(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->H->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.H);
 
         return 4;
     }
 
-    int ADCL(int bytes)
+    int ADCL(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->L->GetSigned());
+        AddSignedWithCarry(cpu, (int8_t)cpu->State.L);
 
         return 4;
     }
 
-    int ADCM(int bytes)
+    int ADCM(CPU* cpu, int bytes)
     {
-        AddSignedWithCarry(CPU::cpu->GetSignedM());
+        AddSignedWithCarry(cpu, cpu->GetSignedM());
 
         return 7;
     }
 
-    int ADDA(int bytes)
+    int ADDA(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->A->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.A);
     
         return 4;
     }
 
-    int ADDB(int bytes)
+    int ADDB(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->B->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.B);
 
         return 4;
     }
 
-    int ADDC(int bytes)
+    int ADDC(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->C->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.C);
 
         return 4;
     }
 
-    int ADDD(int bytes)
+    int ADDD(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->D->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.D);
 
         return 4;
     }
 
-    int ADDE(int bytes)
+    int ADDE(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->E->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.E);
 
         return 4;
     }
 
-    int ADDH(int bytes)
+    int ADDH(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->H->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.H);
 
         return 4;
     }
 
-    int ADDL(int bytes)
+    int ADDL(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->L->GetSigned());
+        AddSigned(cpu, (int8_t)cpu->State.L);
 
         return 4;
     }
 
-    int ADDM(int bytes)
+    int ADDM(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->GetSignedM());
+        AddSigned(cpu, cpu->GetSignedM());
 
         return 7;
     }
 
-    int ADIData(int bytes)
+    int ADIData(CPU* cpu, int bytes)
     {
-        AddSigned(CPU::cpu->NextPC());
+        AddSigned(cpu, cpu->NextPC());
 
         return 7;
     }
 
-    int ANAA(int bytes)
+    int ANAA(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->A->GetUnsigned());
+        And(cpu, cpu->State.A);
 
         return 4;
     }
 
-    int ANAB(int bytes)
+    int ANAB(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->B->GetUnsigned());
+        And(cpu, cpu->State.B);
 
         return 4;
     }
 
-    int ANAC(int bytes)
+    int ANAC(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->C->GetUnsigned());
+        And(cpu, cpu->State.C);
 
         return 4;
     }
 
-    int ANAD(int bytes)
+    int ANAD(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->D->GetUnsigned());
+        And(cpu, cpu->State.D);
 
         return 4;
     }
 
-    int ANAE(int bytes)
+    int ANAE(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->E->GetUnsigned());
+        And(cpu, cpu->State.E);
 
         return 4;
     }
 
-    int ANAH(int bytes)
+    int ANAH(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->H->GetUnsigned());
+        And(cpu, cpu->State.H);
 
         return 4;
     }
 
-    int ANAL(int bytes)
+    int ANAL(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->L->GetUnsigned());
+        And(cpu, cpu->State.L);
 
         return 4;
     }
 
-    int ANAM(int bytes)
+    int ANAM(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->GetUnsignedM());
+        And(cpu, cpu->GetUnsignedM());
 
         return 7;
     }
 
-    int ANIData(int bytes)
+    int ANIData(CPU* cpu, int bytes)
     {
-        And(CPU::cpu->NextPC());
+        And(cpu, cpu->NextPC());
 
         return 7;
     }
 
-    int CALLLabel(int bytes)
+    int CALLLabel(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
-
-        CPU* cpu = CPU::cpu;
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -448,25 +410,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CCLabel(int bytes)
+    int CCLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-    
-        if (!cpu->Flags->GetBit(CARRY_FLAG))
+        if (!GetBit(cpu->State.Flags, CARRY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -475,25 +435,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CMLabel(int bytes)
+    int CMLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (!cpu->Flags->GetBit(SIGN_FLAG))
+        if (!GetBit(cpu->State.Flags, SIGN_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -502,121 +460,112 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CMA(int bytes)
+    int CMA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(~CPU::cpu->A->GetUnsigned());
+        cpu->State.A = ~cpu->State.A;
 
         return 4;
     }
 
-    int CMC(int bytes)
+    int CMC(CPU* cpu, int bytes)
     {
-        uint8_t newCy = (~CPU::cpu->Flags->GetBit(CARRY_FLAG) & 1);
+        uint8_t newCy = (~GetBit(cpu->State.Flags, CARRY_FLAG) & 1);
         if(newCy)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int CMPA(int bytes)
+    int CMPA(CPU* cpu, int bytes)
     {
-        CPU::cpu->Flags->ClearBit(CARRY_FLAG);
-        CPU::cpu->Flags->SetBit(ZERO_FLAG, 1);
+        ClearBit(cpu->State.Flags, CARRY_FLAG);
+        SetBit(cpu->State.Flags, ZERO_FLAG, 1);
 
         return 4;
     }
 
-    int CMPB(int bytes)
+    int CMPB(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t B = cpu->B->GetSigned();
+        int8_t B = (int8_t)cpu->State.B;
     
-        Compare(B);
+        Compare(cpu, B);
 
         return 4;
     }
 
-    int CMPC(int bytes)
+    int CMPC(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t C = cpu->C->GetSigned();
+        int8_t C = (int8_t)cpu->State.C;
 
-        Compare(C);
+        Compare(cpu, C);
 
         return 4;
     }
 
-    int CMPD(int bytes)
+    int CMPD(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t D = cpu->D->GetSigned();
+        int8_t D = (int8_t)cpu->State.D;
 
-        Compare(D);
+        Compare(cpu, D);
 
         return 4;
     }
 
-    int CMPE(int bytes)
+    int CMPE(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t E = cpu->E->GetSigned();
+        int8_t E = (int8_t)cpu->State.E;
 
-        Compare(E);
+        Compare(cpu, E);
 
         return 4;
     }
 
-    int CMPH(int bytes)
+    int CMPH(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t H = cpu->H->GetSigned();
+        int8_t H = (int8_t)cpu->State.H;
 
-        Compare(H);
+        Compare(cpu, H);
 
         return 4;
     }
 
-    int CMPL(int bytes)
+    int CMPL(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-        int8_t L = cpu->L->GetSigned();
+        int8_t L = (int8_t)cpu->State.L;
 
-        Compare(L);
+        Compare(cpu, L);
 
         return 4;
     }
 
-    int CMPM(int bytes)
+    int CMPM(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
         int8_t M= cpu->GetSignedM();
 
-        Compare(M);
+        Compare(cpu, M);
 
         return 7;
     }
 
-    int CNCLabel(int bytes)
+    int CNCLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (cpu->Flags->GetBit(CARRY_FLAG))
+        if (GetBit(cpu->State.Flags, CARRY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -625,25 +574,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CNZLabel(int bytes)
+    int CNZLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (cpu->Flags->GetBit(ZERO_FLAG))
+        if (GetBit(cpu->State.Flags, ZERO_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -652,25 +599,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CPLabel(int bytes)
+    int CPLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (cpu->Flags->GetBit(SIGN_FLAG))
+        if (GetBit(cpu->State.Flags, SIGN_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -679,25 +624,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CPELabel(int bytes)
+    int CPELabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (!cpu->Flags->GetBit(PARITY_FLAG))
+        if (!GetBit(cpu->State.Flags, PARITY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -706,35 +649,32 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CPIData(int bytes)
+    int CPIData(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
         int8_t L = cpu->NextPC();
 
-        Compare(L);
+        Compare(cpu, L);
 
         return 7;
     }
 
-    int CPOLabel(int bytes)
+    int CPOLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (cpu->Flags->GetBit(PARITY_FLAG))
+        if (GetBit(cpu->State.Flags, PARITY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -743,25 +683,23 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int CZLabel(int bytes)
+    int CZLabel(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        if (!cpu->Flags->GetBit(ZERO_FLAG))
+        if (!GetBit(cpu->State.Flags, ZERO_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        uint16_t PC = cpu->PC->Get();
+        uint16_t PC = cpu->State.PC;
         PC += (1);
 
         uint8_t HIGH = (PC >> 8);
@@ -770,39 +708,37 @@ namespace InternalEmulator
         cpu->_Stack->Push(HIGH);
         cpu->_Stack->Push(LOW);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 18;
     }
 
-    int DAA(int bytes)
+    int DAA(CPU* cpu, int bytes)
     {
-        CPU* cpu = CPU::cpu;
-
-        uint8_t A = cpu->A->GetUnsigned();
+        uint8_t A = cpu->State.A;
 
         uint8_t tens = A / 10;
         uint8_t ones = A - (tens*10); // A % 10
 
         uint8_t result = ((tens & 0x0f) << 4) | (ones & 0x0f);
 
-        cpu->A->SetUnsigned(result);
+        cpu->State.A = result;
 
         cpu->SetFlags(
             (result & 0b10000000) > 0,
             result == 0,
             0,
-            !(bits_in(result) % 2),
+            Parity(result),
             0 // TODO: CARRY SHOULD BE CALCULATED!
         );
 
         return 4;
     }
 
-    int DADB(int bytes)
+    int DADB(CPU* cpu, int bytes)
     {
-        int16_t BC = GetBCSigned();
-        int16_t HL = GetHLSigned();
+        int16_t BC = GetBCSigned(cpu);
+        int16_t HL = GetHLSigned(cpu);
 
         int32_t res = BC + HL;
 
@@ -810,26 +746,26 @@ namespace InternalEmulator
 
         if ((newHL & 0xffff0000) > 1)
         {
-            CPU::cpu->Flags->SetBit(CARRY_FLAG, 1);
+            SetBit(cpu->State.Flags, CARRY_FLAG, 1);
         }
         else
         {
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
         }
 
         uint8_t high = (newHL >> 8) & 0xff;
         uint8_t low = newHL & 0xff;
 
-        CPU::cpu->H->SetSigned(high);
-        CPU::cpu->L->SetSigned(low);
+        cpu->State.H = high;
+        cpu->State.L = low;
 
         return 10;
     }
 
-    int DADD(int bytes)
+    int DADD(CPU* cpu, int bytes)
     {
-        int16_t DE = GetDESigned();
-        int16_t HL = GetHLSigned();
+        int16_t DE = GetDESigned(cpu);
+        int16_t HL = GetHLSigned(cpu);
 
         int32_t res = DE + HL;
 
@@ -837,25 +773,25 @@ namespace InternalEmulator
 
         if ((newHL & 0xffff0000) > 1)
         {
-            CPU::cpu->Flags->SetBit(CARRY_FLAG, 1);
+            SetBit(cpu->State.Flags, CARRY_FLAG, 1);
         }
         else
         {
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
         }
 
         uint8_t high = (newHL >> 8) & 0xff;
         uint8_t low = newHL & 0xff;
 
-        CPU::cpu->H->SetSigned(high);
-        CPU::cpu->L->SetSigned(low);
+        cpu->State.H = high;
+        cpu->State.L = low;
 
         return 10;
     }
 
-    int DADH(int bytes)
+    int DADH(CPU* cpu, int bytes)
     {
-        int16_t HL = GetHLSigned();
+        int16_t HL = GetHLSigned(cpu);
 
         int32_t res = HL + HL;
 
@@ -863,27 +799,27 @@ namespace InternalEmulator
 
         if ((newHL & 0xffff0000) > 1)
         {
-            CPU::cpu->Flags->SetBit(CARRY_FLAG, 1);
+            SetBit(cpu->State.Flags, CARRY_FLAG, 1);
         }
         else
         {
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
         }
 
         uint8_t high = (newHL >> 8) & 0xff;
         uint8_t low = newHL & 0xff;
 
-        CPU::cpu->H->SetSigned(high);
-        CPU::cpu->L->SetSigned(low);
+        cpu->State.H = high;
+        cpu->State.L = low;
 
         return 10;
     }
 
-    int DADSP(int bytes)
+    int DADSP(CPU* cpu, int bytes)
     {
-        uint16_t uSP = CPU::cpu->SP->Get();
+        uint16_t uSP = cpu->State.SP;
         int16_t SP = *(int16_t*)&uSP;
-        int16_t HL = GetHLSigned();
+        int16_t HL = GetHLSigned(cpu);
 
         int32_t res = SP + HL;
 
@@ -891,2115 +827,2086 @@ namespace InternalEmulator
 
         if ((newHL & 0xffff0000) > 1)
         {
-            CPU::cpu->Flags->SetBit(CARRY_FLAG, 1);
+            SetBit(cpu->State.Flags, CARRY_FLAG, 1);
         }
         else
         {
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
         }
 
         uint8_t high = (newHL >> 8) & 0xff;
         uint8_t low = newHL & 0xff;
 
-        CPU::cpu->H->SetSigned(high);
-        CPU::cpu->L->SetSigned(low);
+        cpu->State.H = high;
+        cpu->State.L = low;
 
         return 10;
     }
 
-    int DCRA(int bytes)
+    int DCRA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->Decrement();
+        cpu->State.A--;
     
-        SetFlagsBasedOn(CPU::cpu->A->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.A);
 
         return 4;
     }
 
-    int DCRB(int bytes)
+    int DCRB(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->Decrement();
+        cpu->State.B--;
 
-        SetFlagsBasedOn(CPU::cpu->B->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.B);
 
         return 4;
     }
 
-    int DCRC(int bytes)
+    int DCRC(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->Decrement();
+        cpu->State.C--;
 
-        SetFlagsBasedOn(CPU::cpu->C->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.C);
 
         return 4;
     }
 
-    int DCRD(int bytes)
+    int DCRD(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->Decrement();
+        cpu->State.D--;
 
-        SetFlagsBasedOn(CPU::cpu->D->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.D);
 
         return 4;
     }
 
-    int DCRE(int bytes)
+    int DCRE(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->Decrement();
+        cpu->State.E--;
 
-        SetFlagsBasedOn(CPU::cpu->E->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.E);
 
         return 4;
     }
 
-    int DCRH(int bytes)
+    int DCRH(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->Decrement();
+        cpu->State.H--;
 
-        SetFlagsBasedOn(CPU::cpu->H->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.H);
 
         return 4;
     }
 
-    int DCRL(int bytes)
+    int DCRL(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->Decrement();
+        cpu->State.L--;
 
-        SetFlagsBasedOn(CPU::cpu->L->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.L);
 
         return 4;
     }
 
-    int DCRM(int bytes)
+    int DCRM(CPU* cpu, int bytes)
     {
-        uint8_t M = CPU::cpu->GetUnsignedM();
+        uint8_t M = cpu->GetUnsignedM();
         M--;
 
-        uint16_t addr = GetHLUnsigned();
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, M);
+        uint16_t addr = GetHLUnsigned(cpu);
+        cpu->GetMemory()->SetDataAtAddr(addr, M);
 
-        SetFlagsBasedOn(M);
+        SetFlagsBasedOn(cpu, M);
 
         return 10;
     }
 
-    int DCXB(int bytes)
+    int DCXB(CPU* cpu, int bytes)
     {
-        int16_t BC = GetBCSigned();
+        int16_t BC = GetBCSigned(cpu);
         BC--;
 
         int8_t HIGH = (BC >> 8) & 0xff;
         int8_t LOW = BC & 0xff;
 
-        CPU::cpu->B->SetSigned(HIGH);
-        CPU::cpu->C->SetSigned(LOW);
+        cpu->State.B = HIGH;
+        cpu->State.C = LOW;
 
         return 6;
     }
 
-    int DCXD(int bytes)
+    int DCXD(CPU* cpu, int bytes)
     {
-        int16_t DE = GetDESigned();
+        int16_t DE = GetDESigned(cpu);
         DE--;
 
         int8_t HIGH = (DE >> 8) & 0xff;
         int8_t LOW = DE & 0xff;
 
-        CPU::cpu->D->SetSigned(HIGH);
-        CPU::cpu->E->SetSigned(LOW);
+        cpu->State.D = HIGH;
+        cpu->State.E = LOW;
 
         return 6;
     }
 
-    int DCXH(int bytes)
+    int DCXH(CPU* cpu, int bytes)
     {
-        int16_t HL = GetHLSigned();
+        int16_t HL = GetHLSigned(cpu);
         HL--;
 
         int8_t HIGH = (HL >> 8) & 0xff;
         int8_t LOW = HL & 0xff;
 
-        CPU::cpu->H->SetSigned(HIGH);
-        CPU::cpu->L->SetSigned(LOW);
+        cpu->State.H = HIGH;
+        cpu->State.L = LOW;
 
         return 6;
     }
 
-    int DCXSP(int bytes)
+    int DCXSP(CPU* cpu, int bytes)
     {
-        CPU::cpu->SP->Decrement();
+        cpu->State.SP--;
         return 6;
     }
 
-    int DI(int bytes) // INTERRUPTS
+    int DI(CPU* cpu, int bytes) // INTERRUPTS
     {
-        CPU::cpu->_InterruptsEnabled = false;
+        cpu->State.InterruptsEnabled = false;
 
         return 4;
     }
 
-    int EI(int bytes)
+    int EI(CPU* cpu, int bytes)
     {
-        CPU::cpu->_InterruptsEnabled = true;
+        cpu->State.InterruptsEnabled = true;
 
         return 4;
     }
 
-    int HLT(int bytes)
+    int HLT(CPU* cpu, int bytes)
     {
-        //CPU::cpu->SetRunning(false);
-        CPU::cpu->SetHalted(true);
+        //cpu->SetRunning(false);
+        cpu->Hlt();
 
         return 5;
     }
 
-    int INPortAddress(int bytes) // PORTS
+    int INPortAddress(CPU* cpu, int bytes) // PORTS
     {
-        uint8_t addr = CPU::cpu->NextPC();
-
-        std::vector<IOCallback> io = CPU::cpu->GetIOInterface();
-
-        for (int i = 0; i < io.size(); i++)
-        {
-            if (io.at(i).addr == addr)
-            {
-                if (io.at(i).INPUT != nullptr)
-                {
-                    uint8_t val = io.at(i).INPUT();
-                    CPU::cpu->A->SetUnsigned(val);
-                }
-
-                return 10;
-            }
-        }
+        uint8_t port = cpu->NextPC();
+        cpu->State.A = cpu->ReadPort(port, cpu->State.A, cpu->State.TotalInstructions);
 
         return 10;
     }
 
-    int INRA(int bytes)
+    int INRA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->Increment();
+        cpu->State.A++;
 
-        SetFlagsBasedOn(CPU::cpu->A->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.A);
 
         return 4;
     }
 
-    int INRB(int bytes)
+    int INRB(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->Increment();
+        cpu->State.B++;
 
-        SetFlagsBasedOn(CPU::cpu->B->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.B);
 
         return 4;
     }
 
-    int INRC(int bytes)
+    int INRC(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->Increment();
+        cpu->State.C++;
 
-        SetFlagsBasedOn(CPU::cpu->C->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.C);
 
         return 4;
     }
 
-    int INRD(int bytes)
+    int INRD(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->Increment();
+        cpu->State.D++;
 
-        SetFlagsBasedOn(CPU::cpu->D->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.D);
 
         return 4;
     }
 
-    int INRE(int bytes)
+    int INRE(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->Increment();
+        cpu->State.E++;
 
-        SetFlagsBasedOn(CPU::cpu->E->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.E);
 
         return 4;
     }
 
-    int INRH(int bytes)
+    int INRH(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->Increment();
+        cpu->State.H++;
 
-        SetFlagsBasedOn(CPU::cpu->H->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.H);
 
         return 4;
     }
 
-    int INRL(int bytes)
+    int INRL(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->Increment();
+        cpu->State.L++;
 
-        SetFlagsBasedOn(CPU::cpu->L->GetSigned());
+        SetFlagsBasedOn(cpu, (int8_t)cpu->State.L);
 
         return 4;
     }
 
-    int INRM(int bytes)
+    int INRM(CPU* cpu, int bytes)
     {
-        uint8_t M = CPU::cpu->GetUnsignedM();
+        uint8_t M = cpu->GetUnsignedM();
         M--;
 
-        uint16_t addr = GetHLUnsigned();
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, M);
+        uint16_t addr = GetHLUnsigned(cpu);
+        cpu->GetMemory()->SetDataAtAddr(addr, M);
 
-        SetFlagsBasedOn(M);
+        SetFlagsBasedOn(cpu, M);
 
         return 10;
     }
 
-    int INXB(int bytes)
+    int INXB(CPU* cpu, int bytes)
     {
-        int16_t BC = GetBCSigned();
+        int16_t BC = GetBCSigned(cpu);
         BC++;
 
         int8_t HIGH = (BC >> 8) & 0xff;
         int8_t LOW = BC & 0xff;
 
-        CPU::cpu->B->SetSigned(HIGH);
-        CPU::cpu->C->SetSigned(LOW);
+        cpu->State.B = HIGH;
+        cpu->State.C = LOW;
 
         return 6;
     }
 
-    int INXD(int bytes)
+    int INXD(CPU* cpu, int bytes)
     {
-        int16_t DE = GetDESigned();
+        int16_t DE = GetDESigned(cpu);
         DE++;
 
         int8_t HIGH = (DE >> 8) & 0xff;
         int8_t LOW = DE & 0xff;
 
-        CPU::cpu->D->SetSigned(HIGH);
-        CPU::cpu->E->SetSigned(LOW);
+        cpu->State.D = HIGH;
+        cpu->State.E = LOW;
 
         return 6;
     }
 
-    int INXH(int bytes)
+    int INXH(CPU* cpu, int bytes)
     {
-        int16_t HL = GetHLSigned();
+        int16_t HL = GetHLSigned(cpu);
         HL++;
 
         int8_t HIGH = (HL >> 8) & 0xff;
         int8_t LOW = HL & 0xff;
 
-        CPU::cpu->H->SetSigned(HIGH);
-        CPU::cpu->L->SetSigned(LOW);
+        cpu->State.H = HIGH;
+        cpu->State.L = LOW;
 
         return 6;
     }
 
-    int INXSP(int bytes)
+    int INXSP(CPU* cpu, int bytes)
     {
-        CPU::cpu->SP->Increment();
+        cpu->State.SP++;
         return 6;
     }
 
-    int JCLabel(int bytes)
+    int JCLabel(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(CARRY_FLAG))
+        if (!GetBit(cpu->State.Flags, CARRY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JMLabel(int bytes)
+    int JMLabel(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(SIGN_FLAG))
+        if (!GetBit(cpu->State.Flags, SIGN_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JMPLabel(int bytes)
+    int JMPLabel(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JNCLabel(int bytes)
+    int JNCLabel(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(CARRY_FLAG))
+        if (GetBit(cpu->State.Flags, CARRY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JNZLabel(int bytes)
+    int JNZLabel(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(ZERO_FLAG))
+        if (GetBit(cpu->State.Flags, ZERO_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JPLabel(int bytes)
+    int JPLabel(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(SIGN_FLAG))
+        if (GetBit(cpu->State.Flags, SIGN_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JPELabel(int bytes)
+    int JPELabel(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(PARITY_FLAG))
+        if (!GetBit(cpu->State.Flags, PARITY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JPOLabel(int bytes)
+    int JPOLabel(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(PARITY_FLAG))
+        if (GetBit(cpu->State.Flags, PARITY_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int JZLabel(int bytes)
+    int JZLabel(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(ZERO_FLAG))
+        if (!GetBit(cpu->State.Flags, ZERO_FLAG))
         {
-            CPU::cpu->PC->Increment();
-            CPU::cpu->PC->Increment();
+            cpu->State.PC++;
+            cpu->State.PC++;
             return 1;
         }
 
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->PC->Set(addr);
+        cpu->State.PC = addr;
 
         return 10;
     }
 
-    int LDAAddress(int bytes)
+    int LDAAddress(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->A->SetUnsigned(CPU::cpu->GetMemory()->GetDataAtAddr(addr));
+        cpu->State.A = cpu->GetMemory()->GetDataAtAddr(addr);
 
         return 13;
     }
 
-    int LDAXB(int bytes)
+    int LDAXB(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetBCUnsigned();
+        uint16_t addr = GetBCUnsigned(cpu);
 
-        CPU::cpu->A->SetUnsigned(CPU::cpu->GetMemory()->GetDataAtAddr(addr));
+        cpu->State.A = cpu->GetMemory()->GetDataAtAddr(addr);
 
         return 7;
     }
 
-    int LDAXD(int bytes)
+    int LDAXD(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetDEUnsigned();
+        uint16_t addr = GetDEUnsigned(cpu);
 
-        CPU::cpu->A->SetUnsigned(CPU::cpu->GetMemory()->GetDataAtAddr(addr));
+        cpu->State.A = cpu->GetMemory()->GetDataAtAddr(addr);
 
         return 7;
     }
 
-    int LHLDAddress(int bytes)
+    int LHLDAddress(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->L->SetUnsigned(CPU::cpu->GetMemory()->GetDataAtAddr(addr));
-        CPU::cpu->H->SetUnsigned(CPU::cpu->GetMemory()->GetDataAtAddr(addr+1));
+        cpu->State.L = cpu->GetMemory()->GetDataAtAddr(addr);
+        cpu->State.H = cpu->GetMemory()->GetDataAtAddr(addr+1);
 
         return 16;
     }
 
-    int LXIB(int bytes)
+    int LXIB(CPU* cpu, int bytes)
     {
-        uint16_t val = GetNextPC16();
+        uint16_t val = GetNextPC16(cpu);
 
         int8_t HIGH = (val >> 8) & 0xff;
         int8_t LOW = val & 0xff;
 
-        CPU::cpu->B->SetSigned(HIGH);
-        CPU::cpu->C->SetSigned(LOW);
+        cpu->State.B = HIGH;
+        cpu->State.C = LOW;
 
         return 10;
     }
 
-    int LXID(int bytes)
+    int LXID(CPU* cpu, int bytes)
     {
-        uint16_t val = GetNextPC16();
+        uint16_t val = GetNextPC16(cpu);
 
         int8_t HIGH = (val >> 8) & 0xff;
         int8_t LOW = val & 0xff;
 
-        CPU::cpu->D->SetSigned(HIGH);
-        CPU::cpu->E->SetSigned(LOW);
+        cpu->State.D = HIGH;
+        cpu->State.E = LOW;
 
         return 10;
     }
 
-    int LXIH(int bytes)
+    int LXIH(CPU* cpu, int bytes)
     {
-        uint16_t val = GetNextPC16();
+        uint16_t val = GetNextPC16(cpu);
 
         int8_t HIGH = (val >> 8) & 0xff;
         int8_t LOW = val & 0xff;
 
-        CPU::cpu->H->SetSigned(HIGH);
-        CPU::cpu->L->SetSigned(LOW);
+        cpu->State.H = HIGH;
+        cpu->State.L = LOW;
 
         return 10;
     }
 
-    int LXISP(int bytes)
+    int LXISP(CPU* cpu, int bytes)
     {
-        uint16_t val = GetNextPC16();
+        uint16_t val = GetNextPC16(cpu);
 
-        CPU::cpu->SP->Set(val);
+        cpu->State.SP = val;
 
         return 10;
     }
 
-    int MOVAA(int bytes)
+    int MOVAA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.A = cpu->State.A;
 
         return 4;
     }
 
-    int MOVAB(int bytes)
+    int MOVAB(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.A = cpu->State.B;
 
         return 4;
     }
 
-    int MOVAC(int bytes)
+    int MOVAC(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.A = cpu->State.C;
 
         return 4;
     }
 
-    int MOVAD(int bytes)
+    int MOVAD(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.A = cpu->State.D;
 
         return 4;
     }
 
-    int MOVAE(int bytes)
+    int MOVAE(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.A = cpu->State.E;
 
         return 4;
     }
 
-    int MOVAH(int bytes)
+    int MOVAH(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.A = cpu->State.H;
 
         return 4;
     }
 
-    int MOVAL(int bytes)
+    int MOVAL(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.A = cpu->State.L;
 
         return 4;
     }
 
-    int MOVAM(int bytes)
+    int MOVAM(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.A = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVBA(int bytes)
+    int MOVBA(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.B = cpu->State.A;
 
         return 4;
     }
 
-    int MOVBB(int bytes)
+    int MOVBB(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.B = cpu->State.B;
 
         return 4;
     }
 
-    int MOVBC(int bytes)
+    int MOVBC(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.B = cpu->State.C;
 
         return 4;
     }
 
-    int MOVBD(int bytes)
+    int MOVBD(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.B = cpu->State.D;
 
         return 4;
     }
 
-    int MOVBE(int bytes)
+    int MOVBE(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.B = cpu->State.E;
 
         return 4;
     }
 
-    int MOVBH(int bytes)
+    int MOVBH(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.B = cpu->State.H;
 
         return 4;
     }
 
-    int MOVBL(int bytes)
+    int MOVBL(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.B = cpu->State.L;
 
         return 4;
     }
 
-    int MOVBM(int bytes)
+    int MOVBM(CPU* cpu, int bytes)
     {
-        CPU::cpu->B->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.B = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVCA(int bytes)
+    int MOVCA(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.C = cpu->State.A;
 
         return 4;
     }
 
-    int MOVCB(int bytes)
+    int MOVCB(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.C = cpu->State.B;
 
         return 4;
     }
 
-    int MOVCC(int bytes)
+    int MOVCC(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.C = cpu->State.C;
 
         return 4;
     }
 
-    int MOVCD(int bytes)
+    int MOVCD(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.C = cpu->State.D;
 
         return 4;
     }
 
-    int MOVCE(int bytes)
+    int MOVCE(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.C = cpu->State.E;
 
         return 4;
     }
 
-    int MOVCH(int bytes)
+    int MOVCH(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.C = cpu->State.H;
 
         return 4;
     }
 
-    int MOVCL(int bytes)
+    int MOVCL(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.C = cpu->State.L;
 
         return 4;
     }
 
-    int MOVCM(int bytes)
+    int MOVCM(CPU* cpu, int bytes)
     {
-        CPU::cpu->C->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.C = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVDA(int bytes)
+    int MOVDA(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.D = cpu->State.A;
 
         return 4;
     }
 
-    int MOVDB(int bytes)
+    int MOVDB(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.D = cpu->State.B;
 
         return 4;
     }
 
-    int MOVDC(int bytes)
+    int MOVDC(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.D = cpu->State.C;
 
         return 4;
     }
 
-    int MOVDD(int bytes)
+    int MOVDD(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.D = cpu->State.D;
 
         return 4;
     }
 
-    int MOVDE(int bytes)
+    int MOVDE(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.D = cpu->State.E;
 
         return 4;
     }
 
-    int MOVDH(int bytes)
+    int MOVDH(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.D = cpu->State.H;
 
         return 4;
     }
 
-    int MOVDL(int bytes)
+    int MOVDL(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.D = cpu->State.L;
 
         return 4;
     }
 
-    int MOVDM(int bytes)
+    int MOVDM(CPU* cpu, int bytes)
     {
-        CPU::cpu->D->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.D = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVEA(int bytes)
+    int MOVEA(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.E = cpu->State.A;
 
         return 4;
     }
 
-    int MOVEB(int bytes)
+    int MOVEB(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.E = cpu->State.B;
 
         return 4;
     }
 
-    int MOVEC(int bytes)
+    int MOVEC(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.E = cpu->State.C;
 
         return 4;
     }
 
-    int MOVED(int bytes)
+    int MOVED(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.E = cpu->State.D;
 
         return 4;
     }
 
-    int MOVEE(int bytes)
+    int MOVEE(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.E = cpu->State.E;
 
         return 4;
     }
 
-    int MOVEH(int bytes)
+    int MOVEH(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.E = cpu->State.H;
 
         return 4;
     }
 
-    int MOVEL(int bytes)
+    int MOVEL(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.E = cpu->State.L;
 
         return 4;
     }
 
-    int MOVEM(int bytes)
+    int MOVEM(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.E = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVHA(int bytes)
+    int MOVHA(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.H = cpu->State.A;
 
         return 4;
     }
 
-    int MOVHB(int bytes)
+    int MOVHB(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.H = cpu->State.B;
 
         return 4;
     }
 
-    int MOVHC(int bytes)
+    int MOVHC(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.H = cpu->State.C;
 
         return 4;
     }
 
-    int MOVHD(int bytes)
+    int MOVHD(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.H = cpu->State.D;
 
         return 4;
     }
 
-    int MOVHE(int bytes)
+    int MOVHE(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.H = cpu->State.E;
 
         return 4;
     }
 
-    int MOVHH(int bytes)
+    int MOVHH(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.H = cpu->State.H;
 
         return 4;
     }
 
-    int MOVHL(int bytes)
+    int MOVHL(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.H = cpu->State.L;
 
         return 4;
     }
 
-    int MOVHM(int bytes)
+    int MOVHM(CPU* cpu, int bytes)
     {
-        CPU::cpu->H->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.H = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVLA(int bytes)
+    int MOVLA(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->A->GetUnsigned());
+        cpu->State.L = cpu->State.A;
 
         return 4;
     }
 
-    int MOVLB(int bytes)
+    int MOVLB(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->B->GetUnsigned());
+        cpu->State.L = cpu->State.B;
 
         return 4;
     }
 
-    int MOVLC(int bytes)
+    int MOVLC(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->C->GetUnsigned());
+        cpu->State.L = cpu->State.C;
 
         return 4;
     }
 
-    int MOVLD(int bytes)
+    int MOVLD(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->D->GetUnsigned());
+        cpu->State.L = cpu->State.D;
 
         return 4;
     }
 
-    int MOVLE(int bytes)
+    int MOVLE(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->E->GetUnsigned());
+        cpu->State.L = cpu->State.E;
 
         return 4;
     }
 
-    int MOVLH(int bytes)
+    int MOVLH(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->H->GetUnsigned());
+        cpu->State.L = cpu->State.H;
 
         return 4;
     }
 
-    int MOVLL(int bytes)
+    int MOVLL(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->L->GetUnsigned());
+        cpu->State.L = cpu->State.L;
 
         return 4;
     }
 
-    int MOVLM(int bytes)
+    int MOVLM(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->GetUnsignedM());
+        cpu->State.L = cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int MOVMA(int bytes)
+    int MOVMA(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->A->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.A);
 
         return 7;
     }
 
-    int MOVMB(int bytes)
+    int MOVMB(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->B->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.B);
 
         return 7;
     }
 
-    int MOVMC(int bytes)
+    int MOVMC(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->C->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.C);
 
         return 7;
     }
 
-    int MOVMD(int bytes)
+    int MOVMD(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->D->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.D);
 
         return 7;
     }
 
-    int MOVME(int bytes)
+    int MOVME(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->E->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.E);
 
         return 7;
     }
 
-    int MOVMH(int bytes)
+    int MOVMH(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->H->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.H);
 
         return 7;
     }
 
-    int MOVML(int bytes)
+    int MOVML(CPU* cpu, int bytes)
     {
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), CPU::cpu->L->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), cpu->State.L);
 
         return 7;
     }
 
-    int MVIAData(int bytes)
+    int MVIAData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->A->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.A = val;
 
         return 7;
     }
 
-    int MVIBData(int bytes)
+    int MVIBData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->B->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.B = val;
 
         return 7;
     }
 
-    int MVICData(int bytes)
+    int MVICData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->C->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.C = val;
 
         return 7;
     }
 
-    int MVIDData(int bytes)
+    int MVIDData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->D->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.D = val;
 
         return 7;
     }
 
-    int MVIEData(int bytes)
+    int MVIEData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->E->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.E = val;
 
         return 7;
     }
 
-    int MVIHData(int bytes)
+    int MVIHData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->H->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.H = val;
 
         return 7;
     }
 
-    int MVILData(int bytes)
+    int MVILData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->L->SetUnsigned(val);
+        uint8_t val = cpu->NextPC();
+        cpu->State.L = val;
 
         return 7;
     }
 
-    int MVIMData(int bytes)
+    int MVIMData(CPU* cpu, int bytes)
     {
-        uint8_t val = CPU::cpu->NextPC();
-        CPU::cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(), val);
+        uint8_t val = cpu->NextPC();
+        cpu->GetMemory()->SetDataAtAddr(GetHLUnsigned(cpu), val);
 
         return 10;
     }
 
-    int NOP(int bytes)
+    int NOP(CPU* cpu, int bytes)
     {
         return 4;
     }
 
-    int ORAA(int bytes)
+    int ORAA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->A->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.A;
 
         return 4;
     }
 
-    int ORAB(int bytes)
+    int ORAB(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->B->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.B;
 
         return 4;
     }
 
-    int ORAC(int bytes)
+    int ORAC(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->C->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.C;
 
         return 4;
     }
 
-    int ORAD(int bytes)
+    int ORAD(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->D->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.D;
 
         return 4;
     }
 
-    int ORAE(int bytes)
+    int ORAE(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->E->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.E;
 
         return 4;
     }
 
-    int ORAH(int bytes)
+    int ORAH(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->H->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.H;
 
         return 4;
     }
 
-    int ORAL(int bytes)
+    int ORAL(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->L->GetUnsigned());
+        cpu->State.A = cpu->State.A | cpu->State.L;
 
         return 4;
     }
 
-    int ORAM(int bytes)
+    int ORAM(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->GetUnsignedM());
+        cpu->State.A = cpu->State.A | cpu->GetUnsignedM();
 
         return 7;
     }
 
-    int ORIData(int bytes)
+    int ORIData(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(CPU::cpu->A->GetUnsigned() | CPU::cpu->NextPC());
+        cpu->State.A = cpu->State.A | cpu->NextPC();
 
         return 7;
     }
 
-    int OUTPortAddress(int bytes) // PORT
+    int OUTPortAddress(CPU* cpu, int bytes) // PORT
     {
-        uint8_t addr = CPU::cpu->NextPC();
-    
-        std::vector<IOCallback> io = CPU::cpu->GetIOInterface();
-
-        for (int i = 0; i < io.size(); i++)
-        {
-            if (io.at(i).addr == addr)
-            {
-                if (io.at(i).OUTPUT != nullptr)
-                {
-                    io.at(i).OUTPUT(CPU::cpu->A->GetUnsigned());
-                }
-
-                return 10;
-            }
-        }
+        uint8_t port = cpu->NextPC();
+        cpu->WritePort(port, cpu->State.A);
 
         return 10;
     }
 
-    int PCHL(int bytes)
+    int PCHL(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetHLUnsigned();
+        uint16_t addr = GetHLUnsigned(cpu);
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 6;
     }
 
-    int POPB(int bytes)
+    int POPB(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->_Stack->GetSP() == 0xffff)
+        if (cpu->_Stack->GetSP() == 0xffff)
         {
             printf("Error: Trying to POP from empty stack!");
-            CPU::cpu->ErrorCode = ErrorCodes::EmptyStackPop;
-            HLT(0);
+            cpu->ErrorCode = ErrorCodes::EmptyStackPop;
+            cpu->SetHalted(true);
         }
 
-        CPU::cpu->C->SetUnsigned(CPU::cpu->_Stack->Pop());
-        CPU::cpu->B->SetUnsigned(CPU::cpu->_Stack->Pop());
+        cpu->State.C = cpu->_Stack->Pop();
+        cpu->State.B = cpu->_Stack->Pop();
 
         return 10;
     }
 
-    int POPD(int bytes)
+    int POPD(CPU* cpu, int bytes)
     {
-        CPU::cpu->E->SetUnsigned(CPU::cpu->_Stack->Pop());
-        CPU::cpu->D->SetUnsigned(CPU::cpu->_Stack->Pop());
+        cpu->State.E = cpu->_Stack->Pop();
+        cpu->State.D = cpu->_Stack->Pop();
 
         return 10;
     }
 
-    int POPH(int bytes)
+    int POPH(CPU* cpu, int bytes)
     {
-        CPU::cpu->L->SetUnsigned(CPU::cpu->_Stack->Pop());
-        CPU::cpu->H->SetUnsigned(CPU::cpu->_Stack->Pop());
+        cpu->State.L = cpu->_Stack->Pop();
+        cpu->State.H = cpu->_Stack->Pop();
 
         return 10;
     }
 
-    int POPPSW(int bytes)
+    int POPPSW(CPU* cpu, int bytes)
     {
-        CPU::cpu->Flags->SetUnsigned(CPU::cpu->_Stack->Pop());
-        CPU::cpu->A->SetUnsigned(CPU::cpu->_Stack->Pop());
+        cpu->State.Flags = cpu->_Stack->Pop();
+        cpu->State.A = cpu->_Stack->Pop();
 
         return 10;
     }
 
-    int PUSHB(int bytes)
+    int PUSHB(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->B->GetUnsigned());
-        CPU::cpu->_Stack->Push(CPU::cpu->C->GetUnsigned());
+        cpu->_Stack->Push(cpu->State.B);
+        cpu->_Stack->Push(cpu->State.C);
 
         return 12;
     }
 
-    int PUSHD(int bytes)
+    int PUSHD(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->D->GetUnsigned());
-        CPU::cpu->_Stack->Push(CPU::cpu->E->GetUnsigned());
+        cpu->_Stack->Push(cpu->State.D);
+        cpu->_Stack->Push(cpu->State.E);
 
         return 12;
     }
 
-    int PUSHH(int bytes)
+    int PUSHH(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->H->GetUnsigned());
-        CPU::cpu->_Stack->Push(CPU::cpu->L->GetUnsigned());
+        cpu->_Stack->Push(cpu->State.H);
+        cpu->_Stack->Push(cpu->State.L);
 
         return 12;
     }
 
-    int PUSHPSW(int bytes)
+    int PUSHPSW(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->A->GetUnsigned());
-        CPU::cpu->_Stack->Push(CPU::cpu->Flags->GetUnsigned());
+        cpu->_Stack->Push(cpu->State.A);
+        cpu->_Stack->Push(cpu->State.Flags);
 
         return 12;
     }
 
-    int RAL(int bytes)
+    int RAL(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
+        uint8_t A = cpu->State.A;
 
         uint8_t newCy = (A & 0b10000000) > 0;
 
         A = A << 1;
-        CPU::cpu->A->SetUnsigned(A);
-        CPU::cpu->A->SetBit(0, CPU::cpu->Flags->GetBit(CARRY_FLAG));
+        cpu->State.A = A;
+        SetBit(cpu->State.A, 0, GetBit(cpu->State.Flags, CARRY_FLAG));
 
         if(newCy)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int RAR(int bytes)
+    int RAR(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
+        uint8_t A = cpu->State.A;
 
         uint8_t newCy = (A & 0b00000001) > 0;
 
         A = A >> 1;
-        CPU::cpu->A->SetUnsigned(A);
-        CPU::cpu->A->SetBit(7, CPU::cpu->Flags->GetBit(CARRY_FLAG));
+        cpu->State.A = A;
+        SetBit(cpu->State.A, 7, GetBit(cpu->State.Flags, CARRY_FLAG));
 
         if (newCy)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int RC(int bytes)
+    int RC(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(CARRY_FLAG))
+        if (!GetBit(cpu->State.Flags, CARRY_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RET(int bytes)
+    int RET(CPU* cpu, int bytes)
     {
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RIM(int bytes) // INTERRUPT
+    int RIM(CPU* cpu, int bytes) // INTERRUPT
     {
 
-        bool M55 = CPU::cpu->_M55; 
-        bool M65 = CPU::cpu->_M65; 
-        bool M75 = CPU::cpu->_M75; 
-        bool IE = CPU::cpu->_InterruptsEnabled; 
-        bool IP55 = CPU::cpu->_IP55;
-        bool IP65 = CPU::cpu->_IP65;
-        bool IP75 = CPU::cpu->_IP75;
+        bool M55 = cpu->State.M55; 
+        bool M65 = cpu->State.M65; 
+        bool M75 = cpu->State.M75; 
+        bool IE = cpu->State.InterruptsEnabled; 
+        bool IP55 = cpu->State.IP55;
+        bool IP65 = cpu->State.IP65;
+        bool IP75 = cpu->State.IP75;
 
-        CPU::cpu->A->SetBit(0, M55);
-        CPU::cpu->A->SetBit(1, M65);
-        CPU::cpu->A->SetBit(2, M75);
-        CPU::cpu->A->SetBit(3, IE);
-        CPU::cpu->A->SetBit(4, IP55);
-        CPU::cpu->A->SetBit(5, IP65);
-        CPU::cpu->A->SetBit(6, IP75);
-        CPU::cpu->A->SetBit(7, 0);
+        SetBit(cpu->State.A, 0, M55);
+        SetBit(cpu->State.A, 1, M65);
+        SetBit(cpu->State.A, 2, M75);
+        SetBit(cpu->State.A, 3, IE);
+        SetBit(cpu->State.A, 4, IP55);
+        SetBit(cpu->State.A, 5, IP65);
+        SetBit(cpu->State.A, 6, IP75);
+        SetBit(cpu->State.A, 7, 0);
 
         return 4;
     }
 
-    int RLC(int bytes)
+    int RLC(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
+        uint8_t A = cpu->State.A;
 
         uint8_t newCy = (A & 0b10000000) > 0;
 
         A = A << 1;
-        CPU::cpu->A->SetUnsigned(A);
-        CPU::cpu->A->SetBit(0, newCy);
+        cpu->State.A = A;
+        SetBit(cpu->State.A, 0, newCy);
 
         if (newCy)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int DSUB(int bytes)
+    int DSUB(CPU* cpu, int bytes)
     {
-        uint16_t HL = GetHLSigned();
-        uint16_t BC = GetBCSigned();
+        uint16_t HL = GetHLSigned(cpu);
+        uint16_t BC = GetBCSigned(cpu);
 
         uint16_t result = HL - BC;
 
         int8_t HIGH = (result >> 8) & 0xff;
         int8_t LOW = result & 0xff;
 
-        CPU::cpu->H->SetSigned(HIGH);
-        CPU::cpu->L->SetSigned(LOW);
+        cpu->State.H = HIGH;
+        cpu->State.L = LOW;
 
         return 8;
     }
 
-    int RM(int bytes)
+    int RM(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(SIGN_FLAG))
+        if (!GetBit(cpu->State.Flags, SIGN_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RNC(int bytes)
+    int RNC(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(CARRY_FLAG))
+        if (GetBit(cpu->State.Flags, CARRY_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RNZ(int bytes)
+    int RNZ(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(ZERO_FLAG))
+        if (GetBit(cpu->State.Flags, ZERO_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RP(int bytes)
+    int RP(CPU* cpu, int bytes)
     {
 
-        if (CPU::cpu->Flags->GetBit(SIGN_FLAG))
+        if (GetBit(cpu->State.Flags, SIGN_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RPE(int bytes)
+    int RPE(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(PARITY_FLAG))
+        if (!GetBit(cpu->State.Flags, PARITY_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RPO(int bytes)
+    int RPO(CPU* cpu, int bytes)
     {
-        if (CPU::cpu->Flags->GetBit(PARITY_FLAG))
+        if (GetBit(cpu->State.Flags, PARITY_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int RRC(int bytes)
+    int RRC(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
+        uint8_t A = cpu->State.A;
 
         uint8_t newCy = (A & 0b00000001) > 0;
 
         A = A >> 1;
-        CPU::cpu->A->SetUnsigned(A);
-        CPU::cpu->A->SetBit(7, newCy);
+        cpu->State.A = A;
+        SetBit(cpu->State.A, 7, newCy);
 
         if (newCy)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int RST0(int bytes) 
+    int RST0(CPU* cpu, int bytes) 
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0000 - 1); //Intentional overflow.
+        cpu->State.PC = 0x0000 - 1; //Intentional overflow.
 
         return 12;
     }
 
-    int RST1(int bytes)
+    int RST1(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0008 - 1);
+        cpu->State.PC = 0x0008 - 1;
 
         return 12;
     }
 
-    int RST2(int bytes)
+    int RST2(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0010 - 1);
+        cpu->State.PC = 0x0010 - 1;
 
         return 12;
     }
 
-    int RST3(int bytes)
+    int RST3(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0018 - 1);
+        cpu->State.PC = 0x0018 - 1;
 
         return 12;
     }
 
-    int RST4(int bytes)
+    int RST4(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0020 - 1);
+        cpu->State.PC = 0x0020 - 1;
 
         return 12;
     }
 
-    int RST5(int bytes)
+    int RST5(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0028 - 1);
+        cpu->State.PC = 0x0028 - 1;
 
         return 12;
     }
 
-    int RST6(int bytes)
+    int RST6(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0030 - 1);
+        cpu->State.PC = 0x0030 - 1;
 
         return 12;
     }
 
-    int RST7(int bytes)
+    int RST7(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetHigh());
-        CPU::cpu->_Stack->Push(CPU::cpu->PC->GetLow());
+        cpu->_Stack->Push(cpu->State.PC >> 8);
+        cpu->_Stack->Push(cpu->State.PC & 0xff);
 
-        CPU::cpu->PC->Set(0x0038 - 1);
+        cpu->State.PC = 0x0038 - 1;
 
         return 12;
     }
 
-    int RZ(int bytes)
+    int RZ(CPU* cpu, int bytes)
     {
-        if (!CPU::cpu->Flags->GetBit(ZERO_FLAG))
+        if (!GetBit(cpu->State.Flags, ZERO_FLAG))
         {
             return 1;
         }
 
-        uint8_t LOW = CPU::cpu->_Stack->Pop();
-        uint8_t HIGH = CPU::cpu->_Stack->Pop();
+        uint8_t LOW = cpu->_Stack->Pop();
+        uint8_t HIGH = cpu->_Stack->Pop();
 
         uint16_t addr = (HIGH << 8) | LOW;
 
-        CPU::cpu->PC->Set(addr - 1);
+        cpu->State.PC = addr - 1;
 
         return 12;
     }
 
-    int SBBA(int bytes)
+    int SBBA(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
     
         int8_t other = (~(A+Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBB(int bytes)
+    int SBBB(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->B->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.B + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBC(int bytes)
+    int SBBC(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->C->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.C + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBD(int bytes)
+    int SBBD(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->D->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.D + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBE(int bytes)
+    int SBBE(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->E->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.E + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBH(int bytes)
+    int SBBH(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->H->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.H + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBL(int bytes)
+    int SBBL(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->L->GetSigned() + Cy)) + 1;
+        int8_t other = (~((int8_t)cpu->State.L + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SBBM(int bytes)
+    int SBBM(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->GetSignedM() + Cy)) + 1;
+        int8_t other = (~(cpu->GetSignedM() + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 7;
     }
 
-    int SBIData(int bytes)
+    int SBIData(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t Cy = CPU::cpu->Flags->GetBit(CARRY_FLAG);
+        int8_t Cy = GetBit(cpu->State.Flags, CARRY_FLAG);
 
-        int8_t other = (~(CPU::cpu->NextPC() + Cy)) + 1;
+        int8_t other = (~(cpu->NextPC() + Cy)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 7;
     }
 
-    int SHLDAddress(int bytes)
+    int SHLDAddress(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, CPU::cpu->L->GetUnsigned());
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr+1, CPU::cpu->H->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(addr, cpu->State.L);
+        cpu->GetMemory()->SetDataAtAddr(addr+1, cpu->State.H);
 
         return 16;
     }
 
-    int SIM(int bytes) // interrupt
+    int SIM(CPU* cpu, int bytes) // interrupt
     {
-        bool M55 = CPU::cpu->A->GetBit(0);
-        bool M65 = CPU::cpu->A->GetBit(1);
-        bool M75 = CPU::cpu->A->GetBit(2);
-        bool MSE = CPU::cpu->A->GetBit(3);
-        bool R75 = CPU::cpu->A->GetBit(4);
+        bool M55 = GetBit(cpu->State.A, 0);
+        bool M65 = GetBit(cpu->State.A, 1);
+        bool M75 = GetBit(cpu->State.A, 2);
+        bool MSE = GetBit(cpu->State.A, 3);
+        bool R75 = GetBit(cpu->State.A, 4);
 
         if (MSE)
         {
-            CPU::cpu->_M55 = M55;
-            CPU::cpu->_M65 = M65;
-            CPU::cpu->_M75 = M75;
+            cpu->State.M55 = M55;
+            cpu->State.M65 = M65;
+            cpu->State.M75 = M75;
         }
 
         if (R75)
         {
-            CPU::cpu->_IP75 = false;
+            cpu->State.IP75 = false;
         }
 
         return 4;
     }
 
-    int SPHL(int bytes)
+    int SPHL(CPU* cpu, int bytes)
     {
-        CPU::cpu->SP->Set(GetHLUnsigned());
+        cpu->State.SP = GetHLUnsigned(cpu);
 
         return 6;
     }
 
-    int STAAddress(int bytes)
+    int STAAddress(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetNextPC16();
+        uint16_t addr = GetNextPC16(cpu);
 
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, CPU::cpu->A->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(addr, cpu->State.A);
 
         return 13;
     }
 
-    int STAXB(int bytes)
+    int STAXB(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetBCUnsigned();
+        uint16_t addr = GetBCUnsigned(cpu);
 
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, CPU::cpu->A->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(addr, cpu->State.A);
 
         return 7;
     }
 
-    int STAXD(int bytes)
+    int STAXD(CPU* cpu, int bytes)
     {
-        uint16_t addr = GetDEUnsigned();
+        uint16_t addr = GetDEUnsigned(cpu);
 
-        CPU::cpu->GetMemory()->SetDataAtAddr(addr, CPU::cpu->A->GetUnsigned());
+        cpu->GetMemory()->SetDataAtAddr(addr, cpu->State.A);
 
         return 7;
     }
 
-    int STC(int bytes)
+    int STC(CPU* cpu, int bytes)
     {
-        CPU::cpu->Flags->SetBit(CARRY_FLAG);
+        SetBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBA(int bytes)
+    int SUBA(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
         int8_t other = (~(A)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBB(int bytes)
+    int SUBB(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->B->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.B)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBC(int bytes)
+    int SUBC(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->C->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.C)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBD(int bytes)
+    int SUBD(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->D->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.D)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBE(int bytes)
+    int SUBE(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->E->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.E)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBH(int bytes)
+    int SUBH(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->H->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.H)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBL(int bytes)
+    int SUBL(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->L->GetSigned())) + 1;
+        int8_t other = (~((int8_t)cpu->State.L)) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 4;
     }
 
-    int SUBM(int bytes)
+    int SUBM(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->GetSignedM())) + 1;
+        int8_t other = (~(cpu->GetSignedM())) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 7;
     }
 
-    int SUIData(int bytes)
+    int SUIData(CPU* cpu, int bytes)
     {
-        int8_t A = CPU::cpu->A->GetSigned();
+        int8_t A = (int8_t)cpu->State.A;
 
-        int8_t other = (~(CPU::cpu->NextPC())) + 1;
+        int8_t other = (~(cpu->NextPC())) + 1;
 
         int16_t res = A + other;
 
-        CPU::cpu->A->SetSigned(res & 0xff);
+        cpu->State.A = res & 0xff;
 
-        SetFlagsBasedOn(A);
+        SetFlagsBasedOn(cpu, A);
 
         if ((res & 0xff) != res)
-            CPU::cpu->Flags->SetBit(CARRY_FLAG);
+            SetBit(cpu->State.Flags, CARRY_FLAG);
         else
-            CPU::cpu->Flags->ClearBit(CARRY_FLAG);
+            ClearBit(cpu->State.Flags, CARRY_FLAG);
 
         return 7;
     }
 
-    int XCHG(int bytes)
+    int XCHG(CPU* cpu, int bytes)
     {
-        uint8_t H = CPU::cpu->H->GetUnsigned();
-        uint8_t L = CPU::cpu->L->GetUnsigned();
+        uint8_t H = cpu->State.H;
+        uint8_t L = cpu->State.L;
 
-        uint8_t D = CPU::cpu->D->GetUnsigned();
-        uint8_t E = CPU::cpu->E->GetUnsigned();
+        uint8_t D = cpu->State.D;
+        uint8_t E = cpu->State.E;
 
-        CPU::cpu->H->SetUnsigned(D);
-        CPU::cpu->L->SetUnsigned(E);
+        cpu->State.H = D;
+        cpu->State.L = E;
 
-        CPU::cpu->D->SetUnsigned(H);
-        CPU::cpu->E->SetUnsigned(L);
+        cpu->State.D = H;
+        cpu->State.E = L;
 
         return 4;
     }
 
-    int XRAA(int bytes)
+    int XRAA(CPU* cpu, int bytes)
     {
-        CPU::cpu->A->SetUnsigned(0);
+        cpu->State.A = 0;
 
         return 4;
     }
 
-    int XRAB(int bytes)
+    int XRAB(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->B->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.B;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAC(int bytes)
+    int XRAC(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->C->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.C;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAD(int bytes)
+    int XRAD(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->D->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.D;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAE(int bytes)
+    int XRAE(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->E->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.E;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAH(int bytes)
+    int XRAH(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->H->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.H;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAL(int bytes)
+    int XRAL(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->L->GetUnsigned();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->State.L;
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 4;
     }
 
-    int XRAM(int bytes)
+    int XRAM(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->GetUnsignedM();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->GetUnsignedM();
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 7;
     }
 
-    int XRIData(int bytes)
+    int XRIData(CPU* cpu, int bytes)
     {
-        uint8_t A = CPU::cpu->A->GetUnsigned();
-        uint8_t other = CPU::cpu->NextPC();
+        uint8_t A = cpu->State.A;
+        uint8_t other = cpu->NextPC();
 
-        CPU::cpu->A->SetUnsigned(A ^ other);
+        cpu->State.A = A ^ other;
 
         return 7;
     }
 
-    int XTHL(int bytes)
+    int XTHL(CPU* cpu, int bytes)
     {
-        CPU::cpu->_Stack->Pop();
-        CPU::cpu->_Stack->Pop();
+        cpu->_Stack->Pop();
+        cpu->_Stack->Pop();
 
-        CPU::cpu->_Stack->Push(CPU::cpu->H->GetUnsigned());
-        CPU::cpu->_Stack->Push(CPU::cpu->L->GetUnsigned());
+        cpu->_Stack->Push(cpu->State.H);
+        cpu->_Stack->Push(cpu->State.L);
 
         return 16;
     }
@@ -0,0 +1,792 @@
+#include "cpu.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include "flag_tables.h"
+
+//The "switch core".
+//The table core (CPUInstructions in CPUinstructions.cpp) does an indirect call for every instruction,
+//and every register access inside the handlers goes through the CPU pointer.
+//Here we copy the registers out of State into local variables once per Loop(), decode everything in one switch,
+//and write the registers back at the end. The compiler can keep the locals in real registers.
+
+//The block core (BlockCore) is this same switch, but it takes the opcodes and operands from predecoded basic blocks
+//(block_cache.h) and runs a whole block before looking at interrupts again.
+//The JIT core (JitCore) is the block core, but hot blocks run as native code (jit.h).
+
+//The table core is still the reference implementation. This one has to behave EXACTLY the same,
+//including the weird flag behaviour and the returned cycle counts. If you change an instruction there, change it here too.
+
+namespace Emulator
+{
+	using InternalEmulator::SZPTable;
+	using InternalEmulator::FlagsBasedOn;
+	using InternalEmulator::AddFlags;
+	using InternalEmulator::SubtractFlags;
+	using InternalEmulator::AndFlags;
+	using InternalEmulator::Compare;
+	using InternalEmulator::Dad;
+
+	namespace
+	{
+		//Lazy flags (CPU::SetLazyFlags()).
+		//Instead of computing F after every ALU instruction, we remember which kind of instruction it was and its operands,
+		//and compute F only when something reads it: a conditional branch, ADC/SBB, PUSH PSW, the end of the loop etc.
+		enum LazyFlagsOp : uint8_t
+		{
+			FlagsReady = 0, // F is up to date.
+			FlagsOfResult, // X = result
+			FlagsOfAdd, // X = A before, Y = value, Carry
+			FlagsOfSubtract, // X = A before, Y = value, Carry
+			FlagsOfAnd // X = result
+		};
+
+		struct PendingFlags
+		{
+			uint8_t Op;
+			uint8_t X;
+			uint8_t Y;
+			uint8_t Carry;
+		};
+
+		inline uint8_t EvaluateFlags(uint8_t op, uint8_t x, uint8_t y, uint8_t carry)
+		{
+			switch (op)
+			{
+			case FlagsOfResult: return FlagsBasedOn(x);
+			case FlagsOfAdd: return AddFlags(x, y, carry);
+			case FlagsOfSubtract: return SubtractFlags(x, y, carry);
+			default: return AndFlags(x);
+			}
+		}
+	}
+
+//Helpers for the switch below. They work on the local variables of RunSwitch().
+
+#define SW_PAIR(high, low) ((uint16_t)(((high) << 8) | (low)))
+#define SW_HL SW_PAIR(H, L)
+#define SW_M mem[SW_HL]
+#define SW_FLAG(flag) ((flags() >> (flag)) & 1)
+
+//Flags of an ALU instruction. With lazy flags, only remember what to compute.
+#define SW_SET_FLAGS(op, x, y, carry) \
+	if (LazyFlags) { lazy = { op, (uint8_t)(x), (uint8_t)(y), (uint8_t)(carry) }; } \
+	else { F = EvaluateFlags(op, x, y, carry); }
+
+//AddSigned(), Subtract() and And() on the local registers. value is only read once.
+#define SW_ADD(value, carry) { uint8_t data = (value); uint8_t cy = (carry); SW_SET_FLAGS(FlagsOfAdd, A, data, cy); A = A + data + cy; }
+#define SW_SUB(value, carry) { uint8_t data = (value); uint8_t cy = (carry); SW_SET_FLAGS(FlagsOfSubtract, A, data, cy); A = A - data - cy; }
+#define SW_AND(value) { A &= (value); SW_SET_FLAGS(FlagsOfAnd, A, 0, 0); }
+
+//Every store goes through here. In the block core, a store to code ends the block (see block_cache.h).
+#define SW_WRITE(addr, value) \
+	{ uint16_t where = (addr); mem[where] = (value); if (Blocks && memory->CodeWritten(where)) { codeWritten = true; } }
+
+#define SW_PUSH(value) { SW_WRITE(SP, value); SP--; }
+#define SW_POP(value) { SP++; value = mem[SP]; SW_WRITE(SP, 0); }
+
+//Read the 8 bit operand and move PC onto it. The block core already has it decoded.
+#define SW_IMM8 (Blocks ? (PC++, ins->Low) : mem[++PC])
+
+//Read the 16 bit operand. Leaves PC on the last byte of the instruction, like GetNextPC16().
+#define SW_NEXT16(addr) \
+	{ \
+		if (Blocks) { PC += 2; addr = (ins->High << 8) | ins->Low; } \
+		else { uint8_t LOW = mem[++PC]; uint8_t HIGH = mem[++PC]; addr = (HIGH << 8) | LOW; } \
+	}
+
+#define SW_INCREMENT_PAIR(high, low) { uint16_t pair = SW_PAIR(high, low) + 1; high = pair >> 8; low = pair & 0xff; }
+#define SW_DECREMENT_PAIR(high, low) { uint16_t pair = SW_PAIR(high, low) - 1; high = pair >> 8; low = pair & 0xff; }
+
+//Not taken: skip the operand, 1 cycle. Same as the table core.
+//A jump backwards can be a delay loop, see CPU::SetIdleSkip().
+#define SW_JUMP_IF(condition) \
+	if (condition) { uint16_t addr; SW_NEXT16(addr); if (idleSkip && addr < PC) { loopHead = true; } PC = addr; hanging = 10; } \
+	else { PC += 2; hanging = 1; }
+
+#define SW_CALL_IF(condition) \
+	if (condition) { uint16_t addr; SW_NEXT16(addr); uint16_t ret = PC + 1; SW_PUSH(ret >> 8); SW_PUSH(ret & 0xff); PC = addr; hanging = 18; } \
+	else { PC += 2; hanging = 1; }
+
+#define SW_RET_IF(condition) \
+	if (condition) { uint8_t LOW, HIGH; SW_POP(LOW); SW_POP(HIGH); PC = SW_PAIR(HIGH, LOW) - 1; hanging = 12; } \
+	else { hanging = 1; }
+
+//RST pushes the address of the RST itself.
+#define SW_RST(vector) { SW_PUSH(PC >> 8); SW_PUSH(PC & 0xff); PC = (vector) - 1; hanging = 12; }
+
+//Interrupts(), but on the local registers. The interrupt flags stay in State, other threads set them.
+#define SW_INTERRUPT(vector) { SW_PUSH(PC >> 8); SW_PUSH(PC & 0xff); PC = (vector); State.InterruptsEnabled = false; }
+
+	template <bool SingleStep, bool LazyFlags, bool Blocks>
+	void CPU::RunSwitch()
+	{
+		Memory* memory = _Memory.get();
+		uint8_t* mem = memory->GetData().get();
+
+		uint8_t A = State.A;
+		uint8_t B = State.B;
+		uint8_t C = State.C;
+		uint8_t D = State.D;
+		uint8_t E = State.E;
+		uint8_t H = State.H;
+		uint8_t L = State.L;
+		uint8_t F = State.Flags;
+
+		uint16_t PC = State.PC;
+		uint16_t SP = State.SP;
+
+		long long cycles = State.CurrentCycles;
+		int hanging = State.HangingCycles;
+		uint64_t instructions = 0;
+
+		//Everything that reads F goes through flags(), which computes the pending lazy flags first.
+		//Instructions that overwrite all of F use flagsWrite(), which just drops them.
+		//Without LazyFlags both are just F.
+		PendingFlags lazy = { FlagsReady, 0, 0, 0 };
+
+		auto flags = [&]() -> uint8_t&
+		{
+			if (LazyFlags && lazy.Op != FlagsReady)
+			{
+				F = EvaluateFlags(lazy.Op, lazy.X, lazy.Y, lazy.Carry);
+				lazy.Op = FlagsReady;
+			}
+			return F;
+		};
+
+		auto flagsWrite = [&]() -> uint8_t&
+		{
+			if (LazyFlags)
+				lazy.Op = FlagsReady;
+			return F;
+		};
+
+		//See SetProfiler(). It needs every instruction.
+		Profiler* profiler = _Profiler;
+
+		//Idle loop skipping (SetIdleSkip()) works on State, so the locals are written back around it.
+		bool idleSkip = !SingleStep && _IdleSkip && profiler == nullptr;
+		bool loopHead = false;
+
+		//So does the bootloader HLE (SetBootloaderHle()).
+		bool hle = !SingleStep && _BootloaderHle && profiler == nullptr;
+
+		//See SetCycleExact() and SetOpcodeCounting().
+		bool exact = _CycleExact;
+		bool countOpcodes = _CountOpcodes;
+
+		//An interrupt would be taken. Only EI, DI, SIM, taking one or an event (Schedule()) can change that,
+		//so it's worked out there instead of before every instruction.
+		bool interrupt = InterruptWaiting(State);
+
+		auto store = [&]()
+		{
+			State.A = A;
+			State.B = B;
+			State.C = C;
+			State.D = D;
+			State.E = E;
+			State.H = H;
+			State.L = L;
+			State.Flags = flags();
+
+			State.PC = PC;
+			State.SP = SP;
+
+			State.CurrentCycles = cycles;
+			State.HangingCycles = hanging;
+			State.TotalInstructions += instructions;
+			instructions = 0;
+		};
+
+		auto load = [&]()
+		{
+			A = State.A;
+			B = State.B;
+			C = State.C;
+			D = State.D;
+			E = State.E;
+			H = State.H;
+			L = State.L;
+			flagsWrite() = State.Flags;
+
+			PC = State.PC;
+			SP = State.SP;
+
+			cycles = State.CurrentCycles;
+			hanging = State.HangingCycles;
+		};
+
+		//Block core: the instruction we're on, and where the block stops.
+		const InternalEmulator::DecodedInstruction* ins = nullptr;
+		const InternalEmulator::DecodedInstruction* end = nullptr;
+		bool codeWritten = false;
+
+		while (true)
+		{
+			if (!SingleStep)
+			{
+				if (hle && _Bootloader.Has(PC))
+				{
+					store();
+
+					//Somewhere else now, the loop head is gone.
+					if (_Bootloader.Arrive(this))
+					{
+						loopHead = false;
+					}
+
+					load();
+				}
+
+				if (loopHead)
+				{
+					loopHead = false;
+
+					store();
+					_IdleLoops.Arrive(this);
+					load();
+				}
+
+				if (!(_Running && !_Halted && cycles <= _LoopLimit))
+				{
+					//Not the end of the Loop(), an event is due.
+					if (_Running && !_Halted && cycles <= _ClockCyclesPerLoop)
+					{
+						store();
+						RunEvents();
+						load();
+
+						interrupt = InterruptWaiting(State);
+						continue;
+					}
+
+					break;
+				}
+
+				cycles += hanging;
+				hanging = 0;
+
+				if (interrupt)
+				{
+					interrupt = false; // Taking one disables interrupts.
+
+					if (!State.M75 && State.IP75)
+					{
+						State.IP75 = false;
+						TookInterrupt(Interrupt75, State.TotalInstructions + instructions);
+						SW_INTERRUPT(0x003C);
+					}
+					else if (!State.M65 && State.IP65)
+					{
+						State.IP65 = false;
+						TookInterrupt(Interrupt65, State.TotalInstructions + instructions);
+						SW_INTERRUPT(0x0034);
+					}
+					else if (!State.M55 && State.IP55)
+					{
+						State.IP55 = false;
+						TookInterrupt(Interrupt55, State.TotalInstructions + instructions);
+						SW_INTERRUPT(0x002C);
+					}
+					else if (State.IPINTR && State.INTR_ADDR != 0)
+					{
+						State.IPINTR = false;
+						TookInterrupt(InterruptINTR, State.TotalInstructions + instructions);
+						SW_INTERRUPT(State.INTR_ADDR + 1);
+					}
+				}
+			}
+
+			//Breakpoints, same as in Clock().
+			bool hitBreakpoint = false;
+
+			if (!_Halted && !_AlreadyHalted && _BreakpointMap.Check(PC))
+			{
+				_Halted = true;
+				_AlreadyHalted = true;
+				hitBreakpoint = true;
+			}
+
+			if (!hitBreakpoint)
+			{
+				_AlreadyHalted = false;
+
+				bool ranNative = false;
+
+				if (Blocks)
+				{
+					//One instruction at a time when breakpoints are set, they're checked between instructions.
+					bool stepping = SingleStep || _BreakpointMap.Any();
+
+					InternalEmulator::Block* block = _BlockCache->Get(PC);
+					ins = block->Instructions;
+					end = stepping ? ins + 1 : ins + block->Count;
+					codeWritten = false;
+
+					//JIT core: run the native code instead, if the block is hot and the whole block fits in this loop.
+					if (!stepping && _Jit != nullptr && !exact && !countOpcodes && profiler == nullptr)
+					{
+						InternalEmulator::JitFunction native = _Jit->Get(block, PC);
+
+						if (native != nullptr && cycles + block->NativeCost <= _LoopLimit)
+						{
+							uint16_t start = PC;
+							uint16_t stack = SP;
+
+							InternalEmulator::JitFrame frame = {
+								C, B, E, D, L, H, A, flags(), PC, SP, hanging, cycles, (int64_t)std::floor(_LoopLimit), 0,
+								mem, memory, memory->GetCodeBits(), 0, !interrupt
+							};
+
+							native(&frame);
+
+							A = frame.A; B = frame.B; C = frame.C; D = frame.D; E = frame.E; H = frame.H; L = frame.L; F = frame.F;
+							PC = frame.PC;
+							SP = frame.SP;
+							hanging = frame.Hanging;
+							cycles = frame.Cycles;
+							instructions += frame.Instructions;
+
+							//Back at the start or before it, without a CALL/RET: a jump backwards.
+							if (idleSkip && PC <= start && SP == stack)
+							{
+								loopHead = true;
+							}
+
+							ranNative = true;
+						}
+					}
+				}
+
+				while (!ranNative)
+				{
+					uint8_t op = Blocks ? ins->Opcode : mem[PC];
+					uint16_t at = PC;
+					uint16_t stack = SP;
+
+					switch (op)
+					{
+					//-------------------Data transfer--------------------
+
+					case 0x40: hanging = 4; break;
+					case 0x41: B = C; hanging = 4; break;
+					case 0x42: B = D; hanging = 4; break;
+					case 0x43: B = E; hanging = 4; break;
+					case 0x44: B = H; hanging = 4; break;
+					case 0x45: B = L; hanging = 4; break;
+					case 0x46: B = SW_M; hanging = 7; break;
+					case 0x47: B = A; hanging = 4; break;
+
+					case 0x48: C = B; hanging = 4; break;
+					case 0x49: hanging = 4; break;
+					case 0x4a: C = D; hanging = 4; break;
+					case 0x4b: C = E; hanging = 4; break;
+					case 0x4c: C = H; hanging = 4; break;
+					case 0x4d: C = L; hanging = 4; break;
+					case 0x4e: C = SW_M; hanging = 7; break;
+					case 0x4f: C = A; hanging = 4; break;
+
+					case 0x50: D = B; hanging = 4; break;
+					case 0x51: D = C; hanging = 4; break;
+					case 0x52: hanging = 4; break;
+					case 0x53: D = E; hanging = 4; break;
+					case 0x54: D = H; hanging = 4; break;
+					case 0x55: D = L; hanging = 4; break;
+					case 0x56: D = SW_M; hanging = 7; break;
+					case 0x57: D = A; hanging = 4; break;
+
+					case 0x58: E = B; hanging = 4; break;
+					case 0x59: E = C; hanging = 4; break;
+					case 0x5a: E = D; hanging = 4; break;
+					case 0x5b: hanging = 4; break;
+					case 0x5c: E = H; hanging = 4; break;
+					case 0x5d: E = L; hanging = 4; break;
+					case 0x5e: E = SW_M; hanging = 7; break;
+					case 0x5f: E = A; hanging = 4; break;
+
+					case 0x60: H = B; hanging = 4; break;
+					case 0x61: H = C; hanging = 4; break;
+					case 0x62: H = D; hanging = 4; break;
+					case 0x63: H = E; hanging = 4; break;
+					case 0x64: hanging = 4; break;
+					case 0x65: H = L; hanging = 4; break;
+					case 0x66: H = SW_M; hanging = 7; break;
+					case 0x67: H = A; hanging = 4; break;
+
+					case 0x68: L = B; hanging = 4; break;
+					case 0x69: L = C; hanging = 4; break;
+					case 0x6a: L = D; hanging = 4; break;
+					case 0x6b: L = E; hanging = 4; break;
+					case 0x6c: L = H; hanging = 4; break;
+					case 0x6d: hanging = 4; break;
+					case 0x6e: L = SW_M; hanging = 7; break;
+					case 0x6f: L = A; hanging = 4; break;
+
+					case 0x70: SW_WRITE(SW_HL, B); hanging = 7; break;
+					case 0x71: SW_WRITE(SW_HL, C); hanging = 7; break;
+					case 0x72: SW_WRITE(SW_HL, D); hanging = 7; break;
+					case 0x73: SW_WRITE(SW_HL, E); hanging = 7; break;
+					case 0x74: SW_WRITE(SW_HL, H); hanging = 7; break;
+					case 0x75: SW_WRITE(SW_HL, L); hanging = 7; break;
+					case 0x77: SW_WRITE(SW_HL, A); hanging = 7; break;
+
+					case 0x78: A = B; hanging = 4; break;
+					case 0x79: A = C; hanging = 4; break;
+					case 0x7a: A = D; hanging = 4; break;
+					case 0x7b: A = E; hanging = 4; break;
+					case 0x7c: A = H; hanging = 4; break;
+					case 0x7d: A = L; hanging = 4; break;
+					case 0x7e: A = SW_M; hanging = 7; break;
+					case 0x7f: hanging = 4; break;
+
+					case 0x06: B = SW_IMM8; hanging = 7; break;
+					case 0x0e: C = SW_IMM8; hanging = 7; break;
+					case 0x16: D = SW_IMM8; hanging = 7; break;
+					case 0x1e: E = SW_IMM8; hanging = 7; break;
+					case 0x26: H = SW_IMM8; hanging = 7; break;
+					case 0x2e: L = SW_IMM8; hanging = 7; break;
+					case 0x36: { uint8_t val = SW_IMM8; SW_WRITE(SW_HL, val); hanging = 10; break; }
+					case 0x3e: A = SW_IMM8; hanging = 7; break;
+
+					case 0x01: { uint16_t value; SW_NEXT16(value); B = value >> 8; C = value & 0xff; hanging = 10; break; }
+					case 0x11: { uint16_t value; SW_NEXT16(value); D = value >> 8; E = value & 0xff; hanging = 10; break; }
+					case 0x21: { uint16_t value; SW_NEXT16(value); H = value >> 8; L = value & 0xff; hanging = 10; break; }
+					case 0x31: SW_NEXT16(SP); hanging = 10; break;
+
+					case 0x3a: { uint16_t addr; SW_NEXT16(addr); A = mem[addr]; hanging = 13; break; }
+					case 0x32: { uint16_t addr; SW_NEXT16(addr); SW_WRITE(addr, A); hanging = 13; break; }
+					case 0x2a: { uint16_t addr; SW_NEXT16(addr); L = mem[addr]; H = mem[(uint16_t)(addr + 1)]; hanging = 16; break; }
+					case 0x22: { uint16_t addr; SW_NEXT16(addr); SW_WRITE(addr, L); SW_WRITE(addr + 1, H); hanging = 16; break; }
+
+					case 0x0a: A = mem[SW_PAIR(B, C)]; hanging = 7; break;
+					case 0x1a: A = mem[SW_PAIR(D, E)]; hanging = 7; break;
+					case 0x02: SW_WRITE(SW_PAIR(B, C), A); hanging = 7; break;
+					case 0x12: SW_WRITE(SW_PAIR(D, E), A); hanging = 7; break;
+
+					case 0xeb: { uint8_t h = H; uint8_t l = L; H = D; L = E; D = h; E = l; hanging = 4; break; }
+
+					//-------------------Arithmetic--------------------
+
+					case 0x80: SW_ADD(B, 0); hanging = 4; break;
+					case 0x81: SW_ADD(C, 0); hanging = 4; break;
+					case 0x82: SW_ADD(D, 0); hanging = 4; break;
+					case 0x83: SW_ADD(E, 0); hanging = 4; break;
+					case 0x84: SW_ADD(H, 0); hanging = 4; break;
+					case 0x85: SW_ADD(L, 0); hanging = 4; break;
+					case 0x86: SW_ADD(SW_M, 0); hanging = 7; break;
+					case 0x87: SW_ADD(A, 0); hanging = 4; break;
+					case 0xc6: SW_ADD(SW_IMM8, 0); hanging = 7; break;
+
+					case 0x88: SW_ADD(B, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x89: SW_ADD(C, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x8a: SW_ADD(D, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x8b: SW_ADD(E, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x8c: SW_ADD(H, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x8d: SW_ADD(L, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x8e: SW_ADD(SW_M, SW_FLAG(CARRY_FLAG)); hanging = 7; break;
+					case 0x8f: SW_ADD(A, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0xce: SW_ADD(SW_IMM8, SW_FLAG(CARRY_FLAG)); hanging = 7; break;
+
+					case 0x90: SW_SUB(B, 0); hanging = 4; break;
+					case 0x91: SW_SUB(C, 0); hanging = 4; break;
+					case 0x92: SW_SUB(D, 0); hanging = 4; break;
+					case 0x93: SW_SUB(E, 0); hanging = 4; break;
+					case 0x94: SW_SUB(H, 0); hanging = 4; break;
+					case 0x95: SW_SUB(L, 0); hanging = 4; break;
+					case 0x96: SW_SUB(SW_M, 0); hanging = 7; break;
+					case 0x97: SW_SUB(A, 0); hanging = 4; break;
+					case 0xd6: SW_SUB(SW_IMM8, 0); hanging = 7; break;
+
+					case 0x98: SW_SUB(B, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x99: SW_SUB(C, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x9a: SW_SUB(D, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x9b: SW_SUB(E, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x9c: SW_SUB(H, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x9d: SW_SUB(L, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0x9e: SW_SUB(SW_M, SW_FLAG(CARRY_FLAG)); hanging = 7; break;
+					case 0x9f: SW_SUB(A, SW_FLAG(CARRY_FLAG)); hanging = 4; break;
+					case 0xde: SW_SUB(SW_IMM8, SW_FLAG(CARRY_FLAG)); hanging = 7; break;
+
+					case 0x04: B++; SW_SET_FLAGS(FlagsOfResult, B, 0, 0); hanging = 4; break;
+					case 0x0c: C++; SW_SET_FLAGS(FlagsOfResult, C, 0, 0); hanging = 4; break;
+					case 0x14: D++; SW_SET_FLAGS(FlagsOfResult, D, 0, 0); hanging = 4; break;
+					case 0x1c: E++; SW_SET_FLAGS(FlagsOfResult, E, 0, 0); hanging = 4; break;
+					case 0x24: H++; SW_SET_FLAGS(FlagsOfResult, H, 0, 0); hanging = 4; break;
+					case 0x2c: L++; SW_SET_FLAGS(FlagsOfResult, L, 0, 0); hanging = 4; break;
+					case 0x3c: A++; SW_SET_FLAGS(FlagsOfResult, A, 0, 0); hanging = 4; break;
+					case 0x34: // INR M decrements in the table core too.
+					case 0x35: { uint8_t M = SW_M - 1; SW_WRITE(SW_HL, M); SW_SET_FLAGS(FlagsOfResult, M, 0, 0); hanging = 10; break; }
+
+					case 0x05: B--; SW_SET_FLAGS(FlagsOfResult, B, 0, 0); hanging = 4; break;
+					case 0x0d: C--; SW_SET_FLAGS(FlagsOfResult, C, 0, 0); hanging = 4; break;
+					case 0x15: D--; SW_SET_FLAGS(FlagsOfResult, D, 0, 0); hanging = 4; break;
+					case 0x1d: E--; SW_SET_FLAGS(FlagsOfResult, E, 0, 0); hanging = 4; break;
+					case 0x25: H--; SW_SET_FLAGS(FlagsOfResult, H, 0, 0); hanging = 4; break;
+					case 0x2d: L--; SW_SET_FLAGS(FlagsOfResult, L, 0, 0); hanging = 4; break;
+					case 0x3d: A--; SW_SET_FLAGS(FlagsOfResult, A, 0, 0); hanging = 4; break;
+
+					case 0x03: SW_INCREMENT_PAIR(B, C); hanging = 6; break;
+					case 0x13: SW_INCREMENT_PAIR(D, E); hanging = 6; break;
+					case 0x23: SW_INCREMENT_PAIR(H, L); hanging = 6; break;
+					case 0x33: SP++; hanging = 6; break;
+
+					case 0x0b: SW_DECREMENT_PAIR(B, C); hanging = 6; break;
+					case 0x1b: SW_DECREMENT_PAIR(D, E); hanging = 6; break;
+					case 0x2b: SW_DECREMENT_PAIR(H, L); hanging = 6; break;
+					case 0x3b: SP--; hanging = 6; break;
+
+					case 0x09: Dad(H, L, flags(), SW_PAIR(B, C)); hanging = 10; break;
+					case 0x19: Dad(H, L, flags(), SW_PAIR(D, E)); hanging = 10; break;
+					case 0x29: Dad(H, L, flags(), SW_HL); hanging = 10; break;
+					case 0x39: Dad(H, L, flags(), SP); hanging = 10; break;
+
+					case 0x08: { uint16_t HL = SW_HL - SW_PAIR(B, C); H = HL >> 8; L = HL & 0xff; hanging = 8; break; }
+
+					case 0x27:
+					{
+						uint8_t tens = A / 10;
+						uint8_t ones = A - (tens * 10);
+						A = ((tens & 0x0f) << 4) | (ones & 0x0f);
+
+						flagsWrite() = SZPTable[A];
+
+						hanging = 4;
+						break;
+					}
+
+					//-------------------Logical--------------------
+
+					case 0xa0: SW_AND(B); hanging = 4; break;
+					case 0xa1: SW_AND(C); hanging = 4; break;
+					case 0xa2: SW_AND(D); hanging = 4; break;
+					case 0xa3: SW_AND(E); hanging = 4; break;
+					case 0xa4: SW_AND(H); hanging = 4; break;
+					case 0xa5: SW_AND(L); hanging = 4; break;
+					case 0xa6: SW_AND(SW_M); hanging = 7; break;
+					case 0xa7: SW_AND(A); hanging = 4; break;
+					case 0xe6: SW_AND(SW_IMM8); hanging = 7; break;
+
+					case 0xa8: A ^= B; hanging = 4; break;
+					case 0xa9: A ^= C; hanging = 4; break;
+					case 0xaa: A ^= D; hanging = 4; break;
+					case 0xab: A ^= E; hanging = 4; break;
+					case 0xac: A ^= H; hanging = 4; break;
+					case 0xad: A ^= L; hanging = 4; break;
+					case 0xae: A ^= SW_M; hanging = 7; break;
+					case 0xaf: A = 0; hanging = 4; break;
+					case 0xee: A ^= SW_IMM8; hanging = 7; break;
+
+					case 0xb0: A |= B; hanging = 4; break;
+					case 0xb1: A |= C; hanging = 4; break;
+					case 0xb2: A |= D; hanging = 4; break;
+					case 0xb3: A |= E; hanging = 4; break;
+					case 0xb4: A |= H; hanging = 4; break;
+					case 0xb5: A |= L; hanging = 4; break;
+					case 0xb6: A |= SW_M; hanging = 7; break;
+					case 0xb7: A |= A; hanging = 4; break;
+					case 0xf6: A |= SW_IMM8; hanging = 7; break;
+
+					case 0xb8: Compare(A, flags(), B); hanging = 4; break;
+					case 0xb9: Compare(A, flags(), C); hanging = 4; break;
+					case 0xba: Compare(A, flags(), D); hanging = 4; break;
+					case 0xbb: Compare(A, flags(), E); hanging = 4; break;
+					case 0xbc: Compare(A, flags(), H); hanging = 4; break;
+					case 0xbd: Compare(A, flags(), SW_M); hanging = 7; break; // The table has CMP M at 0xbd.
+					case 0xbf: flags(); F = (F & ~(1 << CARRY_FLAG)) | (1 << ZERO_FLAG); hanging = 4; break;
+					case 0xfe: Compare(A, flags(), SW_IMM8); hanging = 7; break;
+
+					case 0x07: { flags(); uint8_t newCy = A >> 7; A = (A << 1) | newCy; F = (F & ~1) | newCy; hanging = 4; break; }
+					case 0x0f: { flags(); uint8_t newCy = A & 1; A = (A >> 1) | (newCy << 7); F = (F & ~1) | newCy; hanging = 4; break; }
+					case 0x17: { flags(); uint8_t newCy = A >> 7; A = (A << 1) | (F & 1); F = (F & ~1) | newCy; hanging = 4; break; }
+					case 0x1f: { flags(); uint8_t newCy = A & 1; A = (A >> 1) | ((F & 1) << 7); F = (F & ~1) | newCy; hanging = 4; break; }
+
+					case 0x2f: A = ~A; hanging = 4; break;
+					case 0x3f: flags() ^= (1 << CARRY_FLAG); hanging = 4; break;
+					case 0x37: flags() |= (1 << CARRY_FLAG); hanging = 4; break;
+
+					//-------------------Branching--------------------
+
+					case 0xc3: SW_JUMP_IF(true); break;
+					case 0xc2: SW_JUMP_IF(!SW_FLAG(ZERO_FLAG)); break;
+					case 0xca: SW_JUMP_IF(SW_FLAG(ZERO_FLAG)); break;
+					case 0xd2: SW_JUMP_IF(!SW_FLAG(CARRY_FLAG)); break;
+					case 0xda: SW_JUMP_IF(SW_FLAG(CARRY_FLAG)); break;
+					case 0xe2: SW_JUMP_IF(!SW_FLAG(PARITY_FLAG)); break;
+					case 0xea: SW_JUMP_IF(SW_FLAG(PARITY_FLAG)); break;
+					case 0xf2: SW_JUMP_IF(!SW_FLAG(SIGN_FLAG)); break;
+					case 0xfa: SW_JUMP_IF(SW_FLAG(SIGN_FLAG)); break;
+
+					case 0xcd: SW_CALL_IF(true); break;
+					case 0xc4: SW_CALL_IF(!SW_FLAG(ZERO_FLAG)); break;
+					case 0xcc: SW_CALL_IF(SW_FLAG(ZERO_FLAG)); break;
+					case 0xd4: SW_CALL_IF(!SW_FLAG(CARRY_FLAG)); break;
+					case 0xdc: SW_CALL_IF(SW_FLAG(CARRY_FLAG)); break;
+					case 0xe4: SW_CALL_IF(!SW_FLAG(PARITY_FLAG)); break;
+					case 0xec: SW_CALL_IF(SW_FLAG(PARITY_FLAG)); break;
+					case 0xf4: SW_CALL_IF(!SW_FLAG(SIGN_FLAG)); break;
+					case 0xfc: SW_CALL_IF(SW_FLAG(SIGN_FLAG)); break;
+
+					case 0xc9: SW_RET_IF(true); break;
+					case 0xc0: SW_RET_IF(!SW_FLAG(ZERO_FLAG)); break;
+					case 0xc8: SW_RET_IF(SW_FLAG(ZERO_FLAG)); break;
+					case 0xd0: SW_RET_IF(!SW_FLAG(CARRY_FLAG)); break;
+					case 0xd8: SW_RET_IF(SW_FLAG(CARRY_FLAG)); break;
+					case 0xe0: SW_RET_IF(!SW_FLAG(PARITY_FLAG)); break;
+					case 0xe8: SW_RET_IF(SW_FLAG(PARITY_FLAG)); break;
+					case 0xf0: SW_RET_IF(!SW_FLAG(SIGN_FLAG)); break;
+					case 0xf8: SW_RET_IF(SW_FLAG(SIGN_FLAG)); break;
+
+					case 0xc7: SW_RST(0x0000); break;
+					case 0xcf: SW_RST(0x0008); break;
+					case 0xd7: SW_RST(0x0010); break;
+					case 0xdf: SW_RST(0x0018); break;
+					case 0xe7: SW_RST(0x0020); break;
+					case 0xef: SW_RST(0x0028); break;
+					case 0xf7: SW_RST(0x0030); break;
+					case 0xff: SW_RST(0x0038); break;
+
+					case 0xe9: PC = SW_HL - 1; hanging = 6; break;
+
+					//-------------------Stack--------------------
+
+					case 0xc5: SW_PUSH(B); SW_PUSH(C); hanging = 12; break;
+					case 0xd5: SW_PUSH(D); SW_PUSH(E); hanging = 12; break;
+					case 0xe5: SW_PUSH(H); SW_PUSH(L); hanging = 12; break;
+					case 0xf5: SW_PUSH(A); SW_PUSH(flags()); hanging = 12; break;
+
+					case 0xc1:
+						if (SP == 0xffff)
+						{
+							printf("Error: Trying to POP from empty stack!");
+							ErrorCode = ErrorCodes::EmptyStackPop;
+							_Halted = true;
+						}
+
+						SW_POP(C); SW_POP(B); hanging = 10; break;
+					case 0xd1: SW_POP(E); SW_POP(D); hanging = 10; break;
+					case 0xe1: SW_POP(L); SW_POP(H); hanging = 10; break;
+					case 0xf1: SW_POP(flagsWrite()); SW_POP(A); hanging = 10; break;
+
+					case 0xe3: SW_WRITE(SP + 1, 0); SW_WRITE(SP + 2, 0); SP += 2; SW_PUSH(H); SW_PUSH(L); hanging = 16; break; // The two popped bytes are cleared, like Pop() does.
+					case 0xf9: SP = SW_HL; hanging = 6; break;
+
+					//-------------------IO and machine control--------------------
+
+					case 0xdb: A = ReadPort(SW_IMM8, A, State.TotalInstructions + instructions); hanging = 10; break;
+					case 0xd3: WritePort(SW_IMM8, A); hanging = 10; break;
+
+					case 0xf3: State.InterruptsEnabled = false; interrupt = false; hanging = 4; break;
+					case 0xfb: State.InterruptsEnabled = true; interrupt = InterruptWaiting(State); hanging = 4; break;
+
+					case 0x20:
+						A = State.M55 | (State.M65 << 1) | (State.M75 << 2) | (State.InterruptsEnabled << 3) |
+							(State.IP55 << 4) | (State.IP65 << 5) | (State.IP75 << 6);
+						hanging = 4;
+						break;
+
+					case 0x30:
+						if (A & 0b00001000) // MSE
+						{
+							State.M55 = A & 0b00000001;
+							State.M65 = A & 0b00000010;
+							State.M75 = A & 0b00000100;
+						}
+
+						if (A & 0b00010000) // R7.5
+						{
+							State.IP75 = false;
+						}
+
+						interrupt = InterruptWaiting(State);
+						hanging = 4;
+						break;
+
+					case 0x76: Hlt(); hanging = 5; break;
+
+					case 0x00: hanging = 4; break;
+
+					//Empty slots in the table (0x10, 0x18, 0x28, 0x38, 0xbe, 0xcb, 0xd9, 0xdd, 0xed, 0xfd).
+					//The table core crashes on them, we treat them as NOP.
+					default: hanging = 4; break;
+					}
+
+					if (exact)
+					{
+						hanging = InternalEmulator::ExactHanging(op, hanging);
+					}
+
+					if (countOpcodes)
+					{
+						_Perf.Opcodes[op]++;
+					}
+
+					PC++;
+					instructions++;
+
+					if (profiler != nullptr)
+					{
+						profiler->Count(at, op, hanging + 1, stack, PC, SP);
+					}
+
+					if (!Blocks || ++ins == end || codeWritten)
+					{
+						break;
+					}
+
+					//Same as going around the outer loop, without the interrupt and breakpoint checks.
+					//Nothing inside a block can enable interrupts, it ends on EI/SIM/IN/OUT.
+					if (!_Running || cycles + 1 > _LoopLimit)
+					{
+						break;
+					}
+
+					cycles++;
+					cycles += hanging;
+					hanging = 0;
+				}
+			}
+
+			if (SingleStep)
+			{
+				break;
+			}
+
+			cycles++;
+		}
+
+		store();
+	}
+
+#undef SW_PAIR
+#undef SW_HL
+#undef SW_M
+#undef SW_FLAG
+#undef SW_SET_FLAGS
+#undef SW_ADD
+#undef SW_SUB
+#undef SW_AND
+#undef SW_WRITE
+#undef SW_PUSH
+#undef SW_POP
+#undef SW_IMM8
+#undef SW_NEXT16
+#undef SW_INCREMENT_PAIR
+#undef SW_DECREMENT_PAIR
+#undef SW_JUMP_IF
+#undef SW_CALL_IF
+#undef SW_RET_IF
+#undef SW_RST
+#undef SW_INTERRUPT
+
+	template void CPU::RunSwitch<true, false, false>();
+	template void CPU::RunSwitch<false, false, false>();
+	template void CPU::RunSwitch<false, true, false>();
+
+	template void CPU::RunSwitch<true, false, true>();
+	template void CPU::RunSwitch<false, false, true>();
+	template void CPU::RunSwitch<false, true, true>();
+}
@@ -0,0 +1,1014 @@
+#include "idle_loop.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "cpu.h"
+#include "flag_tables.h"
+
+//See idle_loop.h. The instructions below have to do EXACTLY what the switch core does (CPUswitch.cpp), cycles included.
+
+namespace InternalEmulator
+{
+	namespace
+	{
+		//Same numbers as in the opcodes: B C D E H L (M) A. There's no register M, so F takes its slot.
+		enum Registers : uint8_t
+		{
+			RegB = 0, RegC, RegD, RegE, RegH, RegL, RegF, RegA,
+			RegisterCount
+		};
+
+		//A byte, and where each of its bits comes from.
+		struct Value
+		{
+			uint8_t Now = 0; // In the iteration we're running.
+			uint8_t Fixed = 0xff; // Bits that are the same in every iteration.
+			uint8_t Head = 0; // Bits that still are what register HeadOf had when the iteration started.
+			uint8_t HeadOf = 0;
+			int8_t Expr = -1; // The rest of the bits: _Expressions[Expr], computed from the counter.
+
+			inline uint8_t Computed() const
+			{
+				return ~(Fixed | Head);
+			}
+		};
+
+		inline Value FixedValue(uint8_t n)
+		{
+			Value v;
+			v.Now = n;
+			return v;
+		}
+
+		enum ExpressionKind : uint8_t
+		{
+			CounterByte, // A byte of (counter + Delta).
+			CompareFlags, // Zero and carry of CMP/CPI between that byte and Other.
+			IncDecFlags // Flags of INR/DCR that ended on that byte.
+		};
+
+		struct Expression
+		{
+			uint8_t Kind;
+			bool High;
+			int Delta;
+			uint8_t Other;
+			bool CounterIsA;
+		};
+
+		//A conditional branch on a flag computed from the counter, and which way it went.
+		struct Branch
+		{
+			int8_t Expr;
+			uint8_t Bit;
+			bool Set;
+		};
+
+		struct Output
+		{
+			uint8_t Port;
+			Value Data;
+		};
+
+		struct Store
+		{
+			uint16_t Addr;
+			uint8_t Original;
+			Value Data;
+		};
+
+		enum RunResult
+		{
+			Looped, // Back at the start.
+			OutOfCycles, // Nothing wrong with the loop, the budget just ended.
+			Left, // Returned from the function the loop is in. Probably the last iteration, nothing wrong with the loop either.
+			Failed // Something we can't follow, or not a loop at all.
+		};
+
+		class Iteration
+		{
+		private:
+			static constexpr int MaxEntries = 64;
+
+			Emulator::CPU* _Cpu;
+			Emulator::Memory* _Memory;
+			uint8_t* _Mem;
+
+			Value _Regs[RegisterCount];
+			uint8_t _Start[RegisterCount]; // The registers when the iteration started.
+			uint8_t _Used[RegisterCount] = {}; // Bits of those that something depended on.
+
+			uint16_t _PC, _SP;
+			uint16_t _StartPC, _StartSP;
+			long long _Cycles, _StartCycles;
+			int _Hanging, _StartHanging;
+			int _Instructions = 0;
+
+			//The counter. High is -1 for a single register.
+			int _CounterLow = -1;
+			int _CounterHigh = -1;
+			int _Step = 0;
+			uint16_t _CounterStart = 0;
+
+			Expression _Expressions[MaxEntries];
+			Branch _Branches[MaxEntries];
+			Output _Outputs[MaxEntries];
+			Store _Stores[MaxEntries];
+			int _ExpressionCount = 0, _BranchCount = 0, _OutputCount = 0, _StoreCount = 0;
+			uint16_t _StoreLow = 0xffff, _StoreHigh = 0; // Every store is in between. Most reads aren't.
+
+			bool _Lost = false; // Can't follow the values anymore. Stop after this instruction.
+
+			//-------------------Values--------------------
+
+			inline uint16_t CounterMask()
+			{
+				return _CounterHigh >= 0 ? 0xffff : 0xff;
+			}
+
+			uint8_t Evaluate(const Expression& e, uint16_t counter)
+			{
+				uint16_t value = (counter + e.Delta) & CounterMask();
+				uint8_t byte = e.High ? value >> 8 : value & 0xff;
+
+				switch (e.Kind)
+				{
+				case CounterByte:
+					return byte;
+				case CompareFlags:
+				{
+					uint8_t F = 0;
+					if (e.CounterIsA)
+						Compare(byte, F, e.Other);
+					else
+						Compare(e.Other, F, byte);
+					return F;
+				}
+				default:
+					return FlagsBasedOn(byte);
+				}
+			}
+
+			//The value in the iteration where the counter started at counter. Head bits are left 0.
+			uint8_t Evaluate(const Value& v, uint16_t counter)
+			{
+				uint8_t result = v.Now & v.Fixed;
+
+				if (v.Expr >= 0)
+					result |= Evaluate(_Expressions[v.Expr], counter) & v.Computed();
+
+				return result;
+			}
+
+			int AddExpression(Expression e)
+			{
+				if (_ExpressionCount == MaxEntries)
+				{
+					_Lost = true;
+					return -1;
+				}
+
+				_Expressions[_ExpressionCount] = e;
+				return _ExpressionCount++;
+			}
+
+			Value CounterValue(bool high, int delta, uint8_t now)
+			{
+				Value v;
+				v.Now = now;
+				v.Fixed = 0;
+				v.Expr = AddExpression({ CounterByte, high, delta, 0, false });
+				return v;
+			}
+
+			inline bool IsCounterByte(const Value& v)
+			{
+				return v.Fixed == 0 && v.Head == 0 && v.Expr >= 0 && _Expressions[v.Expr].Kind == CounterByte;
+			}
+
+			inline bool IsCounterByte(const Value& v, bool high)
+			{
+				return IsCounterByte(v) && _Expressions[v.Expr].High == high;
+			}
+
+			//Nothing has touched register reg yet.
+			inline bool IsUntouched(int reg)
+			{
+				return _Regs[reg].Head == 0xff && _Regs[reg].HeadOf == reg;
+			}
+
+			//Something depends on the actual value of these bits, so they have to be the same in every iteration.
+			uint8_t Use(const Value& v, uint8_t mask = 0xff)
+			{
+				_Used[v.HeadOf] |= v.Head & mask;
+
+				if (v.Computed() & mask)
+					_Lost = true;
+
+				return v.Now;
+			}
+
+			uint16_t Address(int high, int low)
+			{
+				return (Use(_Regs[high]) << 8) | Use(_Regs[low]);
+			}
+
+			//-------------------Flags--------------------
+
+			Value& F()
+			{
+				return _Regs[RegF];
+			}
+
+			void SetFlagBits(uint8_t mask, uint8_t bits)
+			{
+				Value& f = F();
+				f.Now = (f.Now & ~mask) | (bits & mask);
+				f.Fixed |= mask;
+				f.Head &= ~mask;
+
+				if (f.Computed() == 0)
+					f.Expr = -1;
+			}
+
+			//Bits in mask become expr. The other bits can't come from another expression, there's only one per value.
+			void SetComputedFlagBits(uint8_t mask, uint8_t bits, int expr)
+			{
+				Value& f = F();
+
+				if ((f.Computed() & ~mask) || expr < 0)
+					_Lost = true;
+
+				f.Now = (f.Now & ~mask) | (bits & mask);
+				f.Fixed &= ~mask;
+				f.Head &= ~mask;
+				f.Expr = expr;
+			}
+
+			bool Flag(uint8_t bit)
+			{
+				Value& f = F();
+				uint8_t mask = 1 << bit;
+
+				if (f.Computed() & mask)
+				{
+					if (_BranchCount == MaxEntries)
+						_Lost = true;
+					else
+						_Branches[_BranchCount++] = { f.Expr, bit, (f.Now & mask) != 0 };
+				}
+				else
+				{
+					Use(f, mask);
+				}
+
+				return (f.Now & mask) != 0;
+			}
+
+			//cc of the conditional jumps, calls and returns: NZ Z NC C PO PE P M.
+			bool Condition(int cc)
+			{
+				static const uint8_t bits[4] = { ZERO_FLAG, CARRY_FLAG, PARITY_FLAG, SIGN_FLAG };
+
+				bool set = Flag(bits[cc >> 1]);
+				return (cc & 1) ? set : !set;
+			}
+
+			//-------------------Memory--------------------
+
+			Store* FindStore(uint16_t addr)
+			{
+				if (addr < _StoreLow || addr > _StoreHigh)
+					return nullptr;
+
+				for (int i = 0; i < _StoreCount; i++)
+				{
+					if (_Stores[i].Addr == addr)
+						return &_Stores[i];
+				}
+
+				return nullptr;
+			}
+
+			Value Load(uint16_t addr)
+			{
+				Store* store = FindStore(addr);
+				return store != nullptr ? store->Data : FixedValue(_Mem[addr]);
+			}
+
+			void StoreTo(uint16_t addr, const Value& v)
+			{
+				Store* store = FindStore(addr);
+
+				if (store == nullptr)
+				{
+					if (_StoreCount == MaxEntries)
+						_Lost = true;
+					else
+						store = &_Stores[_StoreCount++];
+
+					if (store != nullptr)
+					{
+						*store = { addr, _Mem[addr], v };
+						_StoreLow = std::min(_StoreLow, addr);
+						_StoreHigh = std::max(_StoreHigh, addr);
+					}
+				}
+				else
+				{
+					store->Data = v;
+				}
+
+				_Mem[addr] = v.Now;
+				_Memory->CodeWritten(addr);
+			}
+
+			void Push(const Value& v)
+			{
+				StoreTo(_SP, v);
+				_SP--;
+			}
+
+			Value Pop()
+			{
+				_SP++;
+				Value v = Load(_SP);
+				StoreTo(_SP, FixedValue(0));
+				return v;
+			}
+
+			//-------------------Instructions--------------------
+
+			void Alu(int kind, const Value& x, bool isA)
+			{
+				Value& A = _Regs[RegA];
+
+				switch (kind)
+				{
+				case 0: // ADD
+				case 1: // ADC
+				{
+					uint8_t data = Use(x);
+					uint8_t cy = kind == 1 ? Use(F(), 1 << CARRY_FLAG) & 1 : 0;
+					uint8_t a = Use(A);
+					F() = FixedValue(AddFlags(a, data, cy));
+					A = FixedValue(a + data + cy);
+					break;
+				}
+				case 2: // SUB
+				case 3: // SBB
+				{
+					uint8_t data = Use(x);
+					uint8_t cy = kind == 3 ? Use(F(), 1 << CARRY_FLAG) & 1 : 0;
+					uint8_t a = Use(A);
+					F() = FixedValue(SubtractFlags(a, data, cy));
+					A = FixedValue(a - data - cy);
+					break;
+				}
+				case 4: // ANA
+				{
+					uint8_t result = Use(A) & Use(x);
+					A = FixedValue(result);
+					F() = FixedValue(AndFlags(result));
+					break;
+				}
+				case 5: // XRA, no flags
+					A = FixedValue(isA ? 0 : Use(A) ^ Use(x));
+					break;
+				case 6: // ORA, no flags
+					if (!isA)
+						A = FixedValue(Use(A) | Use(x));
+					break;
+				default: // CMP
+				{
+					uint8_t flags = F().Now;
+					Compare(A.Now, flags, x.Now);
+
+					uint8_t mask = (1 << ZERO_FLAG) | (1 << CARRY_FLAG);
+
+					if (IsCounterByte(A) && x.Computed() == 0)
+					{
+						const Expression& e = _Expressions[A.Expr];
+						SetComputedFlagBits(mask, flags, AddExpression({ CompareFlags, e.High, e.Delta, Use(x), true }));
+					}
+					else if (IsCounterByte(x) && A.Computed() == 0)
+					{
+						const Expression& e = _Expressions[x.Expr];
+						SetComputedFlagBits(mask, flags, AddExpression({ CompareFlags, e.High, e.Delta, Use(A), false }));
+					}
+					else
+					{
+						Use(A);
+						Use(x);
+						SetFlagBits(mask, flags);
+					}
+					break;
+				}
+				}
+			}
+
+			//INR/DCR on a register.
+			void IncDec(int reg, int delta)
+			{
+				Value& v = _Regs[reg];
+				uint8_t n = v.Now + delta;
+
+				uint8_t sign = (1 << SIGN_FLAG) | (1 << ZERO_FLAG) | (1 << PARITY_FLAG);
+				int d;
+
+				//The low byte of counter + d, plus or minus 1, is the low byte of counter + d +- 1.
+				if (IsCounterByte(v, false))
+				{
+					d = _Expressions[v.Expr].Delta + delta;
+				}
+				else if (_CounterLow < 0 && IsUntouched(reg))
+				{
+					_CounterLow = reg;
+					_Step = delta;
+					_CounterStart = _Start[reg];
+					d = delta;
+				}
+				else
+				{
+					Use(v);
+					v = FixedValue(n);
+					F() = FixedValue(FlagsBasedOn(n));
+					return;
+				}
+
+				v = CounterValue(false, d, n);
+
+				F() = FixedValue(FlagsBasedOn(n));
+				SetComputedFlagBits(sign, FlagsBasedOn(n), AddExpression({ IncDecFlags, false, d, 0, false }));
+			}
+
+			//INX/DCX on a pair.
+			void PairStep(int high, int low, int delta)
+			{
+				Value& h = _Regs[high];
+				Value& l = _Regs[low];
+				uint16_t n = ((h.Now << 8) | l.Now) + delta;
+				int d;
+
+				if (_CounterHigh == high && IsCounterByte(h, true) && IsCounterByte(l, false) &&
+					_Expressions[h.Expr].Delta == _Expressions[l.Expr].Delta)
+				{
+					d = _Expressions[h.Expr].Delta + delta;
+				}
+				else if (_CounterLow < 0 && IsUntouched(high) && IsUntouched(low))
+				{
+					_CounterHigh = high;
+					_CounterLow = low;
+					_Step = delta;
+					_CounterStart = (_Start[high] << 8) | _Start[low];
+					d = delta;
+				}
+				else
+				{
+					Use(h);
+					Use(l);
+					h = FixedValue(n >> 8);
+					l = FixedValue(n & 0xff);
+					return;
+				}
+
+				h = CounterValue(true, d, n >> 8);
+				l = CounterValue(false, d, n & 0xff);
+			}
+
+			//One instruction. Returns its hanging cycles, or -1 if we can't run it (and nothing changed).
+			int Execute()
+			{
+				uint16_t pc = _PC;
+
+				//Code that changes itself: no.
+				for (int i = 0; i < 3; i++)
+				{
+					if (FindStore((uint16_t)(pc + i)) != nullptr)
+						return -1;
+				}
+
+				uint8_t op = _Mem[pc];
+				uint8_t imm = _Mem[(uint16_t)(pc + 1)];
+				uint16_t imm16 = imm | (_Mem[(uint16_t)(pc + 2)] << 8);
+
+				uint16_t next = pc + BlockCache::GetLength(op);
+				int hanging;
+
+				Value& A = _Regs[RegA];
+
+				//MOV
+				if (op >= 0x40 && op <= 0x7f && op != 0x76)
+				{
+					int dst = (op >> 3) & 7;
+					int src = op & 7;
+
+					if (src == RegF)
+						_Regs[dst] = Load(Address(RegH, RegL));
+					else if (dst == RegF)
+						StoreTo(Address(RegH, RegL), _Regs[src]);
+					else
+						_Regs[dst] = _Regs[src];
+
+					hanging = (src == RegF || dst == RegF) ? 7 : 4;
+				}
+				//ADD ADC SUB SBB ANA XRA ORA CMP
+				else if (op >= 0x80 && op <= 0xbf)
+				{
+					int kind = (op >> 3) & 7;
+					int src = op & 7;
+
+					if (op == 0xbd) // The table has CMP M at 0xbd, and nothing at 0xbe.
+						src = RegF;
+
+					if (op == 0xbe)
+					{
+						hanging = 4;
+					}
+					else if (op == 0xbf)
+					{
+						SetFlagBits((1 << ZERO_FLAG) | (1 << CARRY_FLAG), 1 << ZERO_FLAG);
+						hanging = 4;
+					}
+					else if (src == RegF)
+					{
+						Alu(kind, Load(Address(RegH, RegL)), false);
+						hanging = 7;
+					}
+					else
+					{
+						Alu(kind, _Regs[src], src == RegA);
+						hanging = 4;
+					}
+				}
+				//MVI
+				else if ((op & 0xc7) == 0x06)
+				{
+					int dst = (op >> 3) & 7;
+
+					if (dst == RegF)
+					{
+						StoreTo(Address(RegH, RegL), FixedValue(imm));
+						hanging = 10;
+					}
+					else
+					{
+						_Regs[dst] = FixedValue(imm);
+						hanging = 7;
+					}
+				}
+				//INR, DCR. INR M decrements, like in the table core.
+				else if ((op & 0xc6) == 0x04)
+				{
+					int reg = (op >> 3) & 7;
+
+					if (reg == RegF)
+					{
+						uint16_t addr = Address(RegH, RegL);
+						uint8_t M = Use(Load(addr)) - 1;
+						StoreTo(addr, FixedValue(M));
+						F() = FixedValue(FlagsBasedOn(M));
+						hanging = 10;
+					}
+					else
+					{
+						IncDec(reg, (op & 1) ? -1 : 1);
+						hanging = 4;
+					}
+				}
+				//ADI ACI SUI SBI ANI XRI ORI CPI
+				else if ((op & 0xc7) == 0xc6)
+				{
+					Alu((op >> 3) & 7, FixedValue(imm), false);
+					hanging = 7;
+				}
+				//Jcc, JMP
+				else if ((op & 0xc7) == 0xc2 || op == 0xc3)
+				{
+					if (op == 0xc3 || Condition((op >> 3) & 7))
+					{
+						next = imm16 + 1;
+						hanging = 10;
+					}
+					else
+					{
+						hanging = 1;
+					}
+				}
+				//Ccc, CALL
+				else if ((op & 0xc7) == 0xc4 || op == 0xcd)
+				{
+					if (op == 0xcd || Condition((op >> 3) & 7))
+					{
+						uint16_t ret = pc + 3;
+						Push(FixedValue(ret >> 8));
+						Push(FixedValue(ret & 0xff));
+						next = imm16 + 1;
+						hanging = 18;
+					}
+					else
+					{
+						hanging = 1;
+					}
+				}
+				//Rcc, RET
+				else if ((op & 0xc7) == 0xc0 || op == 0xc9)
+				{
+					if (op == 0xc9 || Condition((op >> 3) & 7))
+					{
+						Value low = Pop();
+						Value high = Pop();
+						next = (Use(high) << 8) | Use(low);
+						hanging = 12;
+					}
+					else
+					{
+						hanging = 1;
+					}
+				}
+				else
+				{
+					switch (op)
+					{
+					case 0x01: _Regs[RegB] = FixedValue(imm16 >> 8); _Regs[RegC] = FixedValue(imm); hanging = 10; break;
+					case 0x11: _Regs[RegD] = FixedValue(imm16 >> 8); _Regs[RegE] = FixedValue(imm); hanging = 10; break;
+					case 0x21: _Regs[RegH] = FixedValue(imm16 >> 8); _Regs[RegL] = FixedValue(imm); hanging = 10; break;
+					case 0x31: _SP = imm16; hanging = 10; break;
+
+					case 0x3a: A = Load(imm16); hanging = 13; break;
+					case 0x32: StoreTo(imm16, A); hanging = 13; break;
+					case 0x2a: _Regs[RegL] = Load(imm16); _Regs[RegH] = Load(imm16 + 1); hanging = 16; break;
+					case 0x22: StoreTo(imm16, _Regs[RegL]); StoreTo(imm16 + 1, _Regs[RegH]); hanging = 16; break;
+
+					case 0x0a: A = Load(Address(RegB, RegC)); hanging = 7; break;
+					case 0x1a: A = Load(Address(RegD, RegE)); hanging = 7; break;
+					case 0x02: StoreTo(Address(RegB, RegC), A); hanging = 7; break;
+					case 0x12: StoreTo(Address(RegD, RegE), A); hanging = 7; break;
+
+					case 0xeb: std::swap(_Regs[RegH], _Regs[RegD]); std::swap(_Regs[RegL], _Regs[RegE]); hanging = 4; break;
+
+					case 0x03: PairStep(RegB, RegC, 1); hanging = 6; break;
+					case 0x13: PairStep(RegD, RegE, 1); hanging = 6; break;
+					case 0x23: PairStep(RegH, RegL, 1); hanging = 6; break;
+					case 0x33: _SP++; hanging = 6; break;
+
+					case 0x0b: PairStep(RegB, RegC, -1); hanging = 6; break;
+					case 0x1b: PairStep(RegD, RegE, -1); hanging = 6; break;
+					case 0x2b: PairStep(RegH, RegL, -1); hanging = 6; break;
+					case 0x3b: _SP--; hanging = 6; break;
+
+					case 0x09: case 0x19: case 0x29: case 0x39:
+					{
+						uint16_t value = op == 0x39 ? _SP : Address((op >> 4) * 2, (op >> 4) * 2 + 1);
+						uint8_t h = Use(_Regs[RegH]);
+						uint8_t l = Use(_Regs[RegL]);
+						uint8_t flags = F().Now;
+						Dad(h, l, flags, value);
+
+						_Regs[RegH] = FixedValue(h);
+						_Regs[RegL] = FixedValue(l);
+						SetFlagBits(1 << CARRY_FLAG, flags);
+						hanging = 10;
+						break;
+					}
+
+					case 0x08:
+					{
+						uint16_t HL = Address(RegH, RegL) - Address(RegB, RegC);
+						_Regs[RegH] = FixedValue(HL >> 8);
+						_Regs[RegL] = FixedValue(HL & 0xff);
+						hanging = 8;
+						break;
+					}
+
+					case 0x27:
+					{
+						uint8_t a = Use(A);
+						uint8_t tens = a / 10;
+						uint8_t ones = a - (tens * 10);
+						a = ((tens & 0x0f) << 4) | (ones & 0x0f);
+
+						A = FixedValue(a);
+						F() = FixedValue(SZPTable[a]);
+						hanging = 4;
+						break;
+					}
+
+					case 0x07: { uint8_t a = Use(A); uint8_t newCy = a >> 7; A = FixedValue((a << 1) | newCy); SetFlagBits(1, newCy); hanging = 4; break; }
+					case 0x0f: { uint8_t a = Use(A); uint8_t newCy = a & 1; A = FixedValue((a >> 1) | (newCy << 7)); SetFlagBits(1, newCy); hanging = 4; break; }
+					case 0x17: { uint8_t a = Use(A); uint8_t cy = Use(F(), 1) & 1; A = FixedValue((a << 1) | cy); SetFlagBits(1, a >> 7); hanging = 4; break; }
+					case 0x1f: { uint8_t a = Use(A); uint8_t cy = Use(F(), 1) & 1; A = FixedValue((a >> 1) | (cy << 7)); SetFlagBits(1, a & 1); hanging = 4; break; }
+
+					case 0x2f: A = FixedValue(~Use(A)); hanging = 4; break;
+					case 0x3f: SetFlagBits(1, Use(F(), 1) ^ 1); hanging = 4; break;
+					case 0x37: SetFlagBits(1, 1); hanging = 4; break;
+
+					case 0xe9: next = Address(RegH, RegL); hanging = 6; break;
+
+					case 0xc5: Push(_Regs[RegB]); Push(_Regs[RegC]); hanging = 12; break;
+					case 0xd5: Push(_Regs[RegD]); Push(_Regs[RegE]); hanging = 12; break;
+					case 0xe5: Push(_Regs[RegH]); Push(_Regs[RegL]); hanging = 12; break;
+					case 0xf5: Push(A); Push(F()); hanging = 12; break;
+
+					case 0xc1:
+						//Empty stack: the core halts with an error.
+						if (_SP == 0xffff)
+							return -1;
+
+						_Regs[RegC] = Pop(); _Regs[RegB] = Pop(); hanging = 10; break;
+					case 0xd1: _Regs[RegE] = Pop(); _Regs[RegD] = Pop(); hanging = 10; break;
+					case 0xe1: _Regs[RegL] = Pop(); _Regs[RegH] = Pop(); hanging = 10; break;
+					case 0xf1: F() = Pop(); A = Pop(); hanging = 10; break;
+
+					case 0xe3: Pop(); Pop(); Push(_Regs[RegH]); Push(_Regs[RegL]); hanging = 16; break;
+					case 0xf9: _SP = Address(RegH, RegL); hanging = 6; break;
+
+					//The value is taken as it is for the rest of the loop. The handler can raise an interrupt.
+					case 0xdb:
+					{
+						A = FixedValue(_Cpu->ReadPort(imm, A.Now, _Cpu->State.TotalInstructions + _Instructions));
+
+						if (Emulator::InterruptWaiting(_Cpu->State))
+							_Lost = true;
+
+						hanging = 10;
+						break;
+					}
+
+					//Done again for every iteration we skip, so we need to know the value for each one.
+					case 0xd3:
+					{
+						if (A.Head != 0 || _OutputCount == MaxEntries)
+							_Lost = true;
+						else
+							_Outputs[_OutputCount++] = { imm, A };
+
+						_Cpu->WritePort(imm, A.Now);
+
+						if (Emulator::InterruptWaiting(_Cpu->State))
+							_Lost = true;
+
+						hanging = 10;
+						break;
+					}
+
+					case 0x00:
+					case 0x10: case 0x18: case 0x28: case 0x38: case 0xcb: case 0xd9: case 0xdd: case 0xed: case 0xfd:
+						hanging = 4;
+						break;
+
+					//HLT, EI, DI, RIM, SIM, RST: the core does those.
+					default:
+						return -1;
+					}
+				}
+
+				_PC = next;
+				return _Cpu->GetCycleExact() ? ExactHanging(op, hanging) : hanging;
+			}
+
+		public:
+			Iteration(Emulator::CPU* cpu)
+			{
+				_Cpu = cpu;
+				_Memory = cpu->_Memory.get();
+				_Mem = _Memory->GetData().get();
+
+				const Emulator::CpuState& s = cpu->State;
+				uint8_t regs[RegisterCount] = { s.B, s.C, s.D, s.E, s.H, s.L, s.Flags, s.A };
+
+				for (int i = 0; i < RegisterCount; i++)
+				{
+					_Start[i] = regs[i];
+
+					_Regs[i].Now = regs[i];
+					_Regs[i].Fixed = 0;
+					_Regs[i].Head = 0xff;
+					_Regs[i].HeadOf = i;
+				}
+
+				_PC = _StartPC = s.PC;
+				_SP = _StartSP = s.SP;
+				_Cycles = _StartCycles = s.CurrentCycles;
+				_Hanging = _StartHanging = s.HangingCycles;
+			}
+
+			//Same checks and cycle counting as the loop in RunSwitch().
+			RunResult Run()
+			{
+				double limit = _Cpu->_LoopLimit;
+
+				while (true)
+				{
+					if (!(_Cpu->GetRunning() && !_Cpu->GetHalted() && _Cycles <= limit))
+						return OutOfCycles;
+
+					if (_Instructions == IdleLoops::MaxInstructions)
+						return Failed;
+
+					int hanging = Execute();
+					if (hanging < 0)
+						return Failed;
+
+					_Cycles += _Hanging + 1;
+					_Hanging = hanging;
+					_Instructions++;
+
+					if (_Lost)
+						return Failed;
+
+					if (_PC == _StartPC)
+						return Looped;
+
+					if (_SP > _StartSP)
+						return Left;
+				}
+			}
+
+			//How many more iterations we can skip, -1 if the next one isn't the same as this one.
+			long long CountSkippable()
+			{
+				if (_SP != _StartSP || _Hanging != _StartHanging)
+					return -1;
+
+				//Memory has to be back to what it was.
+				for (int i = 0; i < _StoreCount; i++)
+				{
+					if (_Stores[i].Data.Fixed != 0xff || _Stores[i].Data.Now != _Stores[i].Original)
+						return -1;
+				}
+
+				//Every register that was used has to be the same again. The counter moved by one step.
+				for (int r = 0; r < RegisterCount; r++)
+				{
+					const Value& v = _Regs[r];
+
+					if (r == _CounterLow || r == _CounterHigh)
+					{
+						if (_Used[r] != 0 || !IsCounterByte(v, r == _CounterHigh) || _Expressions[v.Expr].Delta != _Step)
+							return -1;
+
+						continue;
+					}
+
+					if (v.Head != 0 && v.HeadOf != r)
+						return -1;
+
+					uint8_t changed = _Used[r] & ~v.Head;
+					if ((changed & ~v.Fixed) || ((v.Now ^ _Start[r]) & changed))
+						return -1;
+				}
+
+				long long cycles = _Cycles - _StartCycles;
+				long long budget = (long long)std::floor(_Cpu->_LoopLimit) - _Cycles;
+
+				if (cycles <= 0 || budget < cycles)
+					return 0;
+
+				//Iteration k starts at _Cycles + (k - 1) * cycles. It fits if the one after it could start.
+				long long count = budget / cycles;
+
+				if (_CounterLow < 0)
+					return count;
+
+				for (long long k = 1; k <= count; k++)
+				{
+					uint16_t counter = _CounterStart + k * _Step;
+
+					for (int i = 0; i < _BranchCount; i++)
+					{
+						const Branch& branch = _Branches[i];
+
+						if (((Evaluate(_Expressions[branch.Expr], counter) >> branch.Bit) & 1) != branch.Set)
+							return k - 1;
+					}
+				}
+
+				return count;
+			}
+
+			//Skip count iterations, the same way they would have run.
+			void Skip(long long count)
+			{
+				long long k = 1;
+
+				for (; k <= count; k++)
+				{
+					uint16_t counter = _CounterStart + k * _Step;
+
+					for (int i = 0; i < _OutputCount; i++)
+					{
+						_Cpu->WritePort(_Outputs[i].Port, Evaluate(_Outputs[i].Data, counter));
+					}
+
+					//The handler raised an interrupt. Stop here, the core takes it.
+					if (Emulator::InterruptWaiting(_Cpu->State))
+						break;
+				}
+
+				count = std::min(k, count);
+
+				uint16_t last = _CounterStart + count * _Step;
+
+				for (int r = 0; r < RegisterCount; r++)
+				{
+					Value& v = _Regs[r];
+					v.Now = Evaluate(v, last) | (v.Now & v.Head);
+				}
+
+				_Cycles += count * (_Cycles - _StartCycles);
+				_Instructions += count * _Instructions;
+			}
+
+			long long GetCycles()
+			{
+				return _Cycles - _StartCycles;
+			}
+
+			bool HasCounter()
+			{
+				return _CounterLow >= 0;
+			}
+
+			//Write everything back to State, from wherever we stopped.
+			void Commit()
+			{
+				Emulator::CpuState& s = _Cpu->State;
+
+				s.B = _Regs[RegB].Now;
+				s.C = _Regs[RegC].Now;
+				s.D = _Regs[RegD].Now;
+				s.E = _Regs[RegE].Now;
+				s.H = _Regs[RegH].Now;
+				s.L = _Regs[RegL].Now;
+				s.A = _Regs[RegA].Now;
+				s.Flags = _Regs[RegF].Now;
+
+				s.PC = _PC;
+				s.SP = _SP;
+
+				s.CurrentCycles = _Cycles;
+				s.HangingCycles = _Hanging;
+				s.TotalInstructions += _Instructions;
+			}
+		};
+	}
+
+	void IdleLoops::Arrive(Emulator::CPU* cpu)
+	{
+		Emulator::CpuState& state = cpu->State;
+
+		//Breakpoints need every instruction. An interrupt is taken by the core before anything else.
+		if (cpu->_BreakpointMap.Any() || Emulator::InterruptWaiting(state))
+			return;
+
+		Head& head = _Heads[state.PC % HeadCount];
+
+		if (head.PC == state.PC)
+		{
+			if (head.Wait > 0)
+			{
+				head.Wait--;
+				return;
+			}
+
+			long long budget = (long long)std::floor(cpu->_LoopLimit) - state.CurrentCycles;
+			if (budget < (MinSkip + 1) * head.Cycles)
+				return;
+		}
+
+		uint16_t pc = state.PC;
+
+		Iteration iteration(cpu);
+		RunResult result = iteration.Run();
+
+		long long count = result == Looped ? iteration.CountSkippable() : 0;
+		long long cycles = iteration.GetCycles();
+
+		if (count > 0)
+		{
+			iteration.Skip(count);
+			_Idle = !iteration.HasCounter();
+		}
+
+		iteration.Commit();
+
+		head.PC = pc;
+
+		if (result != Left)
+			head.Cycles = cycles;
+
+		if (result == Failed || count < 0)
+		{
+			//Try again later, and less often every time.
+			head.Failures = std::min(head.Failures + 1, 8);
+			head.Wait = 16 << head.Failures;
+		}
+		else
+		{
+			head.Failures = 0;
+			head.Wait = 0;
+		}
+	}
+}
@@ -0,0 +1,1093 @@
+#include "jit.h"
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include "cpu.h"
+#include "flag_tables.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_X64 1
+#endif
+
+#ifdef JIT_X64
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+//The translator. Every 8085 instruction becomes a few x86-64 instructions working on a JitFrame:
+//  rbx = the frame, r12 = the 8085 memory, r13 = SZPTable, r14 = the code bits of Memory.
+//The flags are computed the same way as in flag_tables.h, weird parts included. Only DAA and stores into code call back into C++.
+
+namespace InternalEmulator
+{
+	namespace
+	{
+		//-------------------Helpers called by the native code--------------------
+
+		//Slow path of a store: the byte was code.
+		void JitCodeWritten(JitFrame* f, uint32_t addr)
+		{
+			if (f->Tracker->CodeWritten((uint16_t)addr))
+				f->CodeWritten = 1;
+		}
+
+		void JitDaa(JitFrame* f)
+		{
+			uint8_t tens = f->A / 10;
+			uint8_t ones = f->A - (tens * 10);
+
+			f->A = ((tens & 0x0f) << 4) | (ones & 0x0f);
+			f->F = SZPTable[f->A];
+		}
+
+#ifdef JIT_X64
+		//-------------------x86-64 encoding--------------------
+
+		enum X64Register
+		{
+			RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+			R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14
+		};
+
+		enum X64Condition
+		{
+			CondB = 0x2, CondAE = 0x3, CondE = 0x4, CondNE = 0x5, CondL = 0xc, CondG = 0xf
+		};
+
+#ifdef _WIN32
+		const int ARG0 = RCX, ARG1 = RDX, ARG2 = R8;
+		const int ShadowSpace = 32;
+#else
+		const int ARG0 = RDI, ARG1 = RSI, ARG2 = RDX;
+		const int ShadowSpace = 0;
+#endif
+
+		//A memory operand: [base + disp8] (the frame, the code bits), [base + index] or [r12 + disp32].
+		struct Operand
+		{
+			enum Kind { Frame, Indexed, Absolute } Type;
+			int Base;
+			int Index;
+			int32_t Displacement;
+		};
+
+		inline Operand FrameAt(size_t offset) { return { Operand::Frame, RBX, 0, (int32_t)offset }; }
+		inline Operand MemoryAt(int index) { return { Operand::Indexed, R12, index, 0 }; }
+		inline Operand TableAt(int index) { return { Operand::Indexed, R13, index, 0 }; }
+		inline Operand MemoryAbsolute(uint16_t addr) { return { Operand::Absolute, R12, 0, addr }; }
+		inline Operand CodeBits() { return { Operand::Frame, R14, 0, 0 }; }
+
+		class Emitter
+		{
+		public:
+			std::vector<uint8_t> Code;
+
+			void Byte(uint8_t b) { Code.push_back(b); }
+			void Word(uint16_t w) { Byte(w & 0xff); Byte(w >> 8); }
+			void Dword(uint32_t d) { for (int i = 0; i < 4; i++) Byte((d >> (i * 8)) & 0xff); }
+			void Qword(uint64_t q) { for (int i = 0; i < 8; i++) Byte((q >> (i * 8)) & 0xff); }
+
+			//opcode reg, [mem]. wide = REX.W, word = 16 bit operand.
+			void Op(std::initializer_list<uint8_t> opcode, int reg, const Operand& m, bool wide = false, bool word = false)
+			{
+				if (word)
+					Byte(0x66);
+
+				uint8_t rex = 0x40 | (wide << 3) | (((reg >> 3) & 1) << 2) | ((m.Base >> 3) & 1);
+				if (m.Type == Operand::Indexed)
+					rex |= ((m.Index >> 3) & 1) << 1;
+
+				if (rex != 0x40)
+					Byte(rex);
+
+				for (uint8_t b : opcode)
+					Byte(b);
+
+				switch (m.Type)
+				{
+				case Operand::Frame:
+					Byte(0x40 | ((reg & 7) << 3) | (m.Base & 7));
+					Byte((uint8_t)m.Displacement);
+					break;
+				case Operand::Indexed: // Always with a disp8 of 0, r13 can't be a base without one.
+					Byte(0x44 | ((reg & 7) << 3));
+					Byte(((m.Index & 7) << 3) | (m.Base & 7));
+					Byte(0);
+					break;
+				case Operand::Absolute:
+					Byte(0x84 | ((reg & 7) << 3));
+					Byte(0x24);
+					Dword(m.Displacement);
+					break;
+				}
+			}
+
+			//opcode reg, rm. Both registers.
+			void OpReg(std::initializer_list<uint8_t> opcode, int reg, int rm, bool wide = false)
+			{
+				uint8_t rex = 0x40 | (wide << 3) | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1);
+				if (rex != 0x40)
+					Byte(rex);
+
+				for (uint8_t b : opcode)
+					Byte(b);
+
+				Byte(0xc0 | ((reg & 7) << 3) | (rm & 7));
+			}
+
+			void Load8(int reg, const Operand& m) { Op({ 0x8a }, reg, m); }
+			void Store8(const Operand& m, int reg) { Op({ 0x88 }, reg, m); }
+			void Store16(const Operand& m, int reg) { Op({ 0x89 }, reg, m, false, true); }
+			void LoadZeroExtend8(int reg, const Operand& m) { Op({ 0x0f, 0xb6 }, reg, m); }
+			void LoadZeroExtend16(int reg, const Operand& m) { Op({ 0x0f, 0xb7 }, reg, m); }
+
+			void StoreImm8(const Operand& m, uint8_t imm) { Op({ 0xc6 }, 0, m); Byte(imm); }
+			void StoreImm16(const Operand& m, uint16_t imm) { Op({ 0xc7 }, 0, m, false, true); Word(imm); }
+			void StoreImm32(const Operand& m, uint32_t imm) { Op({ 0xc7 }, 0, m); Dword(imm); }
+			void AddImm64(const Operand& m, uint32_t imm) { Op({ 0x81 }, 0, m, true); Dword(imm); }
+
+			//80 /n ib on memory: 1 = or, 4 = and, 6 = xor.
+			void GroupImm8(int n, const Operand& m, uint8_t imm) { Op({ 0x80 }, n, m); Byte(imm); }
+			//80 /n ib on a byte register: 1 = or, 4 = and, 7 = cmp.
+			void GroupRegImm8(int n, int reg, uint8_t imm) { OpReg({ 0x80 }, n, reg); Byte(imm); }
+
+			void Increment8(const Operand& m) { Op({ 0xfe }, 0, m); }
+			void Decrement8(const Operand& m) { Op({ 0xfe }, 1, m); }
+			void Increment16(const Operand& m) { Op({ 0xff }, 0, m, false, true); }
+			void Decrement16(const Operand& m) { Op({ 0xff }, 1, m, false, true); }
+			void Not8(const Operand& m) { Op({ 0xf6 }, 2, m); }
+			void TestImm8(const Operand& m, uint8_t imm) { Op({ 0xf6 }, 0, m); Byte(imm); }
+
+			//C0 /n ib on a byte register: 0 = rol, 1 = ror, 4 = shl, 5 = shr.
+			void Shift8(int n, int reg, uint8_t count) { OpReg({ 0xc0 }, n, reg); Byte(count); }
+			void Shift32(int n, int reg, uint8_t count) { OpReg({ 0xc1 }, n, reg); Byte(count); }
+
+			void SetCondition(int condition, int reg) { OpReg({ 0x0f, (uint8_t)(0x90 | condition) }, 0, reg); }
+
+			void MoveImm32(int reg, uint32_t imm)
+			{
+				if (reg >= 8)
+					Byte(0x41);
+				Byte(0xb8 + (reg & 7));
+				Dword(imm);
+			}
+
+			void MoveImm64(int reg, uint64_t imm)
+			{
+				Byte(0x48 | ((reg >> 3) & 1));
+				Byte(0xb8 + (reg & 7));
+				Qword(imm);
+			}
+
+			void Move64(int dst, int src) { OpReg({ 0x89 }, src, dst, true); }
+			void Move32(int dst, int src) { OpReg({ 0x89 }, src, dst); }
+
+			void Call(const void* function)
+			{
+				MoveImm64(RAX, (uint64_t)function);
+				Byte(0xff);
+				Byte(0xd0);
+			}
+
+			//Jump with a 32 bit displacement, returns where to Patch() it.
+			size_t JumpIf(int condition)
+			{
+				Byte(0x0f);
+				Byte(0x80 | condition);
+				Dword(0);
+				return Code.size() - 4;
+			}
+
+			//Jump back to an earlier position.
+			void JumpTo(size_t target)
+			{
+				Byte(0xe9);
+				Dword((uint32_t)(target - (Code.size() + 4)));
+			}
+
+			//Point the jump at the current position.
+			void Patch(size_t at)
+			{
+				uint32_t rel = (uint32_t)(Code.size() - (at + 4));
+				memcpy(&Code[at], &rel, 4);
+			}
+
+			void Prologue()
+			{
+				Byte(0x53); // push rbx
+				Byte(0x41); Byte(0x54); // push r12
+				Byte(0x41); Byte(0x55); // push r13
+				Byte(0x41); Byte(0x56); // push r14
+
+				//Keep rsp 16 byte aligned for the calls.
+				Byte(0x48); Byte(0x83); Byte(0xec); Byte(8 + ShadowSpace); // sub rsp, 8 (+ shadow space)
+
+				Move64(RBX, ARG0);
+				Op({ 0x8b }, R12, FrameAt(offsetof(JitFrame, Memory)), true);
+				MoveImm64(R13, (uint64_t)SZPTable.data());
+				Op({ 0x8b }, R14, FrameAt(offsetof(JitFrame, CodeBits)), true);
+			}
+
+			void Epilogue()
+			{
+				Byte(0x48); Byte(0x83); Byte(0xc4); Byte(8 + ShadowSpace); // add rsp, 8 (+ shadow space)
+
+				Byte(0x41); Byte(0x5e); // pop r14
+				Byte(0x41); Byte(0x5d); // pop r13
+				Byte(0x41); Byte(0x5c); // pop r12
+				Byte(0x5b); // pop rbx
+				Byte(0xc3); // ret
+			}
+		};
+
+		//-------------------Translation--------------------
+
+		const size_t OffsetF = offsetof(JitFrame, F);
+		const size_t OffsetA = offsetof(JitFrame, A);
+		const size_t OffsetBC = offsetof(JitFrame, C);
+		const size_t OffsetDE = offsetof(JitFrame, E);
+		const size_t OffsetHL = offsetof(JitFrame, L);
+		const size_t OffsetSP = offsetof(JitFrame, SP);
+
+		//Frame offset of the register in the low 3 bits of an opcode (B C D E H L M A). -1 for M.
+		int RegisterOffset(int code)
+		{
+			switch (code & 7)
+			{
+			case 0: return offsetof(JitFrame, B);
+			case 1: return offsetof(JitFrame, C);
+			case 2: return offsetof(JitFrame, D);
+			case 3: return offsetof(JitFrame, E);
+			case 4: return offsetof(JitFrame, H);
+			case 5: return offsetof(JitFrame, L);
+			case 7: return offsetof(JitFrame, A);
+			}
+
+			return -1;
+		}
+
+		//Offset of the pair in bits 4-5 (BC DE HL SP).
+		size_t PairOffset(uint8_t opcode)
+		{
+			switch ((opcode >> 4) & 3)
+			{
+			case 0: return OffsetBC;
+			case 1: return OffsetDE;
+			case 2: return OffsetHL;
+			}
+
+			return OffsetSP;
+		}
+
+		//The flag tested by a conditional jump/call/return, and whether it has to be set.
+		void BranchCondition(uint8_t opcode, uint8_t& mask, bool& set)
+		{
+			static const int flags[4] = { ZERO_FLAG, CARRY_FLAG, PARITY_FLAG, SIGN_FLAG };
+
+			mask = 1 << flags[(opcode >> 4) & 3];
+			set = (opcode >> 3) & 1;
+		}
+
+		bool CanTranslate(uint8_t opcode)
+		{
+			switch (opcode)
+			{
+			case 0xdb: case 0xd3: // IN, OUT
+			case 0x76: // HLT
+			case 0xfb: case 0xf3: // EI, DI
+			case 0x20: case 0x30: // RIM, SIM
+			case 0xc1: // POP B, halts on an empty stack.
+				return false;
+			}
+
+			return true;
+		}
+
+		class Translator
+		{
+		private:
+			Emitter& e;
+
+		public:
+			//Instructions run when the one being emitted is done. Every exit adds it to JitFrame::Instructions.
+			int Done = 0;
+
+			Translator(Emitter& emitter) : e(emitter) {}
+
+			//Value of a register (or M) into reg, zero extended.
+			void LoadOperand(int reg, int code)
+			{
+				int offset = RegisterOffset(code);
+
+				if (offset < 0)
+				{
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.LoadZeroExtend8(reg, MemoryAt(RAX));
+				}
+				else
+				{
+					e.LoadZeroExtend8(reg, FrameAt(offset));
+				}
+			}
+
+			//Register code, or the immediate if code < 0.
+			void LoadValue(int reg, int code, uint8_t imm)
+			{
+				if (code < 0)
+					e.MoveImm32(reg, imm);
+				else
+					LoadOperand(reg, code);
+			}
+
+			//mem[eax] = cl. If the byte is code, JitCodeWritten() bumps its page and sets CodeWritten.
+			void Store()
+			{
+				e.Store8(MemoryAt(RAX), RCX);
+				e.Op({ 0x0f, 0xa3 }, RAX, CodeBits(), true); // bt [r14], rax
+				size_t notCode = e.JumpIf(CondAE);
+
+				e.Move32(ARG1, RAX);
+				e.Move64(ARG0, RBX);
+				e.Call((const void*)JitCodeWritten);
+
+				e.Patch(notCode);
+			}
+
+			//Store the register (or imm) at the pair at offset, or at a fixed address.
+			void StoreTo(size_t pairOffset, int code, uint8_t imm)
+			{
+				LoadValue(RCX, code, imm);
+				e.LoadZeroExtend16(RAX, FrameAt(pairOffset));
+				Store();
+			}
+
+			void StoreAt(uint16_t addr, int code)
+			{
+				LoadOperand(RCX, code);
+				e.MoveImm32(RAX, addr);
+				Store();
+			}
+
+			//SW_PUSH: mem[SP] = value, SP--. offset < 0 pushes imm.
+			void Push(int offset, uint8_t imm)
+			{
+				if (offset < 0)
+					e.MoveImm32(RCX, imm);
+				else
+					e.LoadZeroExtend8(RCX, FrameAt(offset));
+
+				e.LoadZeroExtend16(RAX, FrameAt(OffsetSP));
+				Store();
+				e.Decrement16(FrameAt(OffsetSP));
+			}
+
+			//SW_POP: SP++, value = mem[SP], mem[SP] = 0. Into the frame at offset.
+			void Pop(size_t offset)
+			{
+				e.Increment16(FrameAt(OffsetSP));
+				e.LoadZeroExtend16(RAX, FrameAt(OffsetSP));
+				e.Load8(RCX, MemoryAt(RAX));
+				e.Store8(FrameAt(offset), RCX);
+				e.MoveImm32(RCX, 0);
+				Store();
+			}
+
+			//F = FlagsBasedOn(reg)
+			void FlagsOfResult(int reg)
+			{
+				e.OpReg({ 0x0f, 0xb6 }, RDX, reg); // movzx edx, reg8
+				e.Load8(RDX, TableAt(RDX));
+				e.GroupRegImm8(1, RDX, (1 << AUX_CARRY_FLAG) | (1 << CARRY_FLAG));
+				e.Store8(FrameAt(OffsetF), RDX);
+			}
+
+			//ecx = value, edx = carry in.
+			void LoadArithmetic(int code, uint8_t imm, bool withCarry)
+			{
+				LoadValue(RCX, code, imm);
+
+				if (withCarry)
+				{
+					e.LoadZeroExtend8(RDX, FrameAt(OffsetF));
+					e.OpReg({ 0x83 }, 4, RDX); e.Byte(1); // and edx, 1
+				}
+				else
+				{
+					e.MoveImm32(RDX, 0);
+				}
+			}
+
+			//ADD/ADC/ADI/ACI, like AddFlags().
+			void Add(int code, uint8_t imm, bool withCarry)
+			{
+				LoadArithmetic(code, imm, withCarry);
+				e.LoadZeroExtend8(RAX, FrameAt(OffsetA));
+
+				//Carry: (int8)A + (int8)value + carry is negative.
+				e.OpReg({ 0x0f, 0xbe }, R8, RAX); // movsx r8d, al
+				e.OpReg({ 0x0f, 0xbe }, R9, RCX); // movsx r9d, cl
+				e.OpReg({ 0x01 }, R9, R8); // add r8d, r9d
+				e.OpReg({ 0x01 }, RDX, R8); // add r8d, edx
+				e.Shift32(5, R8, 31);
+
+				//Aux carry: A + (value & 0x0f) + carry has any of the high 4 bits set.
+				e.Move32(R9, RCX);
+				e.OpReg({ 0x83 }, 4, R9); e.Byte(0x0f); // and r9d, 0x0f
+				e.OpReg({ 0x01 }, RAX, R9); // add r9d, eax
+				e.OpReg({ 0x01 }, RDX, R9); // add r9d, edx
+				e.OpReg({ 0xf6 }, 0, R9); e.Byte(0xf0); // test r9b, 0xf0
+				e.SetCondition(CondNE, R9);
+				e.Shift8(4, R9, AUX_CARRY_FLAG);
+
+				e.OpReg({ 0x01 }, RCX, RAX); // add eax, ecx
+				e.OpReg({ 0x01 }, RDX, RAX); // add eax, edx
+				e.Store8(FrameAt(OffsetA), RAX);
+
+				//Sign and parity of the result, zero is set when the result is NOT 0.
+				e.OpReg({ 0x0f, 0xb6 }, RAX, RAX); // movzx eax, al
+				e.LoadZeroExtend8(R10, TableAt(RAX));
+				e.GroupRegImm8(4, R10, (1 << SIGN_FLAG) | (1 << PARITY_FLAG));
+				e.OpReg({ 0x84 }, RAX, RAX); // test al, al
+				e.SetCondition(CondNE, RAX);
+				e.Shift8(4, RAX, ZERO_FLAG);
+
+				e.OpReg({ 0x08 }, RAX, R10); // or r10b, al
+				e.OpReg({ 0x08 }, R8, R10); // or r10b, r8b
+				e.OpReg({ 0x08 }, R9, R10); // or r10b, r9b
+				e.Store8(FrameAt(OffsetF), R10);
+			}
+
+			//SUB/SBB/SUI/SBI, like SubtractFlags(): the flags of the OLD A, and the carry.
+			void Subtract(int code, uint8_t imm, bool withCarry)
+			{
+				LoadArithmetic(code, imm, withCarry);
+				e.LoadZeroExtend8(RAX, FrameAt(OffsetA));
+
+				e.LoadZeroExtend8(R10, TableAt(RAX));
+				e.GroupRegImm8(1, R10, 1 << AUX_CARRY_FLAG);
+
+				//Carry: (int8)A + (int8)-(value + carry) is negative.
+				e.Move32(R8, RCX);
+				e.OpReg({ 0x01 }, RDX, R8); // add r8d, edx
+				e.OpReg({ 0xf7 }, 3, R8); // neg r8d
+				e.OpReg({ 0x0f, 0xbe }, R8, R8); // movsx r8d, r8b
+				e.OpReg({ 0x0f, 0xbe }, R9, RAX); // movsx r9d, al
+				e.OpReg({ 0x01 }, R8, R9); // add r9d, r8d
+				e.Shift32(5, R9, 31);
+				e.OpReg({ 0x08 }, R9, R10); // or r10b, r9b
+
+				e.OpReg({ 0x29 }, RCX, RAX); // sub eax, ecx
+				e.OpReg({ 0x29 }, RDX, RAX); // sub eax, edx
+				e.Store8(FrameAt(OffsetA), RAX);
+				e.Store8(FrameAt(OffsetF), R10);
+			}
+
+			//ANA/ANI. F = AndFlags(A).
+			void And(int code, uint8_t imm)
+			{
+				LoadValue(RCX, code, imm);
+
+				e.Load8(RAX, FrameAt(OffsetA));
+				e.OpReg({ 0x20 }, RCX, RAX); // and al, cl
+				e.Store8(FrameAt(OffsetA), RAX);
+
+				e.OpReg({ 0x0f, 0xb6 }, RCX, RAX); // movzx ecx, al
+				e.LoadZeroExtend8(RDX, TableAt(RCX));
+				e.GroupRegImm8(4, RDX, (1 << SIGN_FLAG) | (1 << PARITY_FLAG));
+				e.OpReg({ 0x84 }, RAX, RAX); // test al, al
+				e.SetCondition(CondNE, RAX);
+				e.Shift8(4, RAX, ZERO_FLAG);
+				e.OpReg({ 0x08 }, RAX, RDX); // or dl, al
+				e.Store8(FrameAt(OffsetF), RDX);
+			}
+
+			//XRA/ORA and friends, no flags. opcode: 0x30 = xor, 0x08 = or (r/m8, r8 form).
+			void Logical(uint8_t opcode, int code, uint8_t imm)
+			{
+				LoadValue(RCX, code, imm);
+
+				e.Load8(RAX, FrameAt(OffsetA));
+				e.OpReg({ opcode }, RCX, RAX);
+				e.Store8(FrameAt(OffsetA), RAX);
+			}
+
+			//CMP/CPI, same as Compare() in CPUswitch.cpp. Signed.
+			void Compare(int code, uint8_t imm)
+			{
+				LoadValue(RCX, code, imm);
+
+				e.Load8(RAX, FrameAt(OffsetA));
+				e.OpReg({ 0x3a }, RAX, RCX); // cmp al, cl
+				e.SetCondition(CondL, RCX);
+				e.SetCondition(CondE, RDX);
+				e.Shift8(4, RDX, ZERO_FLAG);
+				e.OpReg({ 0x08 }, RDX, RCX); // or cl, dl
+
+				e.Load8(RAX, FrameAt(OffsetF));
+				e.GroupRegImm8(4, RAX, (uint8_t)~((1 << CARRY_FLAG) | (1 << ZERO_FLAG)));
+				e.OpReg({ 0x08 }, RCX, RAX); // or al, cl
+				e.Store8(FrameAt(OffsetF), RAX);
+			}
+
+			//F = (F & ~CY) | the carry in the low bit of reg.
+			void SetCarryFrom(int reg)
+			{
+				e.GroupRegImm8(4, reg, 1);
+				e.GroupImm8(4, FrameAt(OffsetF), (uint8_t)~(1 << CARRY_FLAG));
+				e.Op({ 0x08 }, reg, FrameAt(OffsetF)); // or [F], reg
+			}
+
+			//Leave the native code: cycles, hanging and PC as the interpreter would have them after this instruction.
+			//pc < 0 means PC is already in the frame.
+			void Exit(long long cycles, int hanging, int pc)
+			{
+				if (cycles != 0)
+					e.AddImm64(FrameAt(offsetof(JitFrame, Cycles)), (uint32_t)cycles);
+
+				e.StoreImm32(FrameAt(offsetof(JitFrame, Hanging)), hanging);
+				e.AddImm64(FrameAt(offsetof(JitFrame, Instructions)), Done);
+
+				if (pc >= 0)
+					e.StoreImm16(FrameAt(offsetof(JitFrame, PC)), (uint16_t)pc);
+
+				e.Epilogue();
+			}
+
+			//After an instruction that stores: leave if it wrote into code.
+			void ExitIfCodeWritten(long long cycles, int hanging, uint16_t next)
+			{
+				e.Op({ 0x80 }, 7, FrameAt(offsetof(JitFrame, CodeWritten))); e.Byte(0); // cmp byte [CodeWritten], 0
+				size_t skip = e.JumpIf(CondE);
+				Exit(cycles, hanging, next);
+				e.Patch(skip);
+			}
+
+			//Conditional branch: the not taken exit, then the caller emits the taken path.
+			void Branch(uint8_t opcode, long long cycles, uint16_t notTakenPC)
+			{
+				uint8_t mask;
+				bool set;
+				BranchCondition(opcode, mask, set);
+
+				e.TestImm8(FrameAt(OffsetF), mask);
+				size_t taken = e.JumpIf(set ? CondNE : CondE);
+
+				Exit(cycles, 1, notTakenPC);
+				e.Patch(taken);
+			}
+
+			//Taken jump. When it goes back to the start of the block, run the block again right here, if the interpreter
+			//would: no interrupt is waiting (nothing to check between blocks) and the whole block still fits before Limit.
+			//That's one PC++/cycles++ and the hanging cycles of the jump, then the same check as in CPUswitch.cpp.
+			void Jump(uint16_t target, uint16_t blockStart, size_t bodyStart, long long cycles, long long cost)
+			{
+				if (target == blockStart)
+				{
+					long long loop = cycles + 1 + 10;
+
+					e.Op({ 0x80 }, 7, FrameAt(offsetof(JitFrame, Chain))); e.Byte(0); // cmp byte [Chain], 0
+					size_t noChain = e.JumpIf(CondE);
+
+					e.Op({ 0x8b }, RAX, FrameAt(offsetof(JitFrame, Cycles)), true); // mov rax, [Cycles]
+					e.OpReg({ 0x81 }, 0, RAX, true); e.Dword((uint32_t)(loop + cost)); // add rax, imm32
+					e.Op({ 0x3b }, RAX, FrameAt(offsetof(JitFrame, Limit)), true); // cmp rax, [Limit]
+					size_t noRoom = e.JumpIf(CondG);
+
+					e.AddImm64(FrameAt(offsetof(JitFrame, Cycles)), (uint32_t)loop);
+					e.AddImm64(FrameAt(offsetof(JitFrame, Instructions)), Done);
+					e.JumpTo(bodyStart);
+
+					e.Patch(noChain);
+					e.Patch(noRoom);
+				}
+
+				Exit(cycles, 10, target);
+			}
+
+			//Emit one instruction. Returns its hanging cycles, or -1 when it ended the native code itself (branches).
+			//cycles is what the interpreter would have added to the cycle counter before this instruction,
+			//cost is Block::NativeCost (only used by the last instruction).
+			int Instruction(const DecodedInstruction& ins, uint16_t pc, uint16_t blockStart, size_t bodyStart, long long cycles, long long cost, bool& stores)
+			{
+				uint8_t op = ins.Opcode;
+				uint8_t imm = ins.Low;
+				uint16_t imm16 = (ins.High << 8) | ins.Low;
+				uint16_t next = pc + BlockCache::GetLength(op);
+
+				stores = false;
+
+				//MOV
+				if (op >= 0x40 && op <= 0x7f && op != 0x76)
+				{
+					int dst = (op >> 3) & 7;
+					int src = op & 7;
+
+					if (dst == src)
+						return 4;
+
+					if (dst == 6)
+					{
+						StoreTo(OffsetHL, src, 0);
+						stores = true;
+						return 7;
+					}
+
+					LoadOperand(RCX, src);
+					e.Store8(FrameAt(RegisterOffset(dst)), RCX);
+					return src == 6 ? 7 : 4;
+				}
+
+				switch (op)
+				{
+				//-------------------Data transfer--------------------
+
+				case 0x06: case 0x0e: case 0x16: case 0x1e: case 0x26: case 0x2e: case 0x3e:
+					e.StoreImm8(FrameAt(RegisterOffset(op >> 3)), imm);
+					return 7;
+
+				case 0x36:
+					StoreTo(OffsetHL, -1, imm);
+					stores = true;
+					return 10;
+
+				case 0x01: case 0x11: case 0x21: case 0x31:
+					e.StoreImm16(FrameAt(PairOffset(op)), imm16);
+					return 10;
+
+				case 0x3a:
+					e.Load8(RAX, MemoryAbsolute(imm16));
+					e.Store8(FrameAt(OffsetA), RAX);
+					return 13;
+
+				case 0x32:
+					StoreAt(imm16, 7);
+					stores = true;
+					return 13;
+
+				case 0x2a:
+					e.Load8(RAX, MemoryAbsolute(imm16));
+					e.Store8(FrameAt(offsetof(JitFrame, L)), RAX);
+					e.Load8(RAX, MemoryAbsolute((uint16_t)(imm16 + 1)));
+					e.Store8(FrameAt(offsetof(JitFrame, H)), RAX);
+					return 16;
+
+				case 0x22:
+					StoreAt(imm16, 5);
+					StoreAt((uint16_t)(imm16 + 1), 4);
+					stores = true;
+					return 16;
+
+				case 0x0a: case 0x1a:
+					e.LoadZeroExtend16(RAX, FrameAt(PairOffset(op)));
+					e.Load8(RAX, MemoryAt(RAX));
+					e.Store8(FrameAt(OffsetA), RAX);
+					return 7;
+
+				case 0x02: case 0x12:
+					StoreTo(PairOffset(op), 7, 0);
+					stores = true;
+					return 7;
+
+				case 0xeb:
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.LoadZeroExtend16(RCX, FrameAt(OffsetDE));
+					e.Store16(FrameAt(OffsetHL), RCX);
+					e.Store16(FrameAt(OffsetDE), RAX);
+					return 4;
+
+				//-------------------Arithmetic--------------------
+
+				case 0x80: case 0x81: case 0x82: case 0x83: case 0x84: case 0x85: case 0x86: case 0x87:
+					Add(op & 7, 0, false);
+					return op == 0x86 ? 7 : 4;
+				case 0x88: case 0x89: case 0x8a: case 0x8b: case 0x8c: case 0x8d: case 0x8e: case 0x8f:
+					Add(op & 7, 0, true);
+					return op == 0x8e ? 7 : 4;
+				case 0x90: case 0x91: case 0x92: case 0x93: case 0x94: case 0x95: case 0x96: case 0x97:
+					Subtract(op & 7, 0, false);
+					return op == 0x96 ? 7 : 4;
+				case 0x98: case 0x99: case 0x9a: case 0x9b: case 0x9c: case 0x9d: case 0x9e: case 0x9f:
+					Subtract(op & 7, 0, true);
+					return op == 0x9e ? 7 : 4;
+
+				case 0xc6: Add(-1, imm, false); return 7;
+				case 0xce: Add(-1, imm, true); return 7;
+				case 0xd6: Subtract(-1, imm, false); return 7;
+				case 0xde: Subtract(-1, imm, true); return 7;
+
+				case 0x04: case 0x0c: case 0x14: case 0x1c: case 0x24: case 0x2c: case 0x3c:
+					e.Increment8(FrameAt(RegisterOffset(op >> 3)));
+					e.Load8(RAX, FrameAt(RegisterOffset(op >> 3)));
+					FlagsOfResult(RAX);
+					return 4;
+
+				case 0x05: case 0x0d: case 0x15: case 0x1d: case 0x25: case 0x2d: case 0x3d:
+					e.Decrement8(FrameAt(RegisterOffset(op >> 3)));
+					e.Load8(RAX, FrameAt(RegisterOffset(op >> 3)));
+					FlagsOfResult(RAX);
+					return 4;
+
+				case 0x34: // INR M decrements in the table core too.
+				case 0x35:
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.Load8(RCX, MemoryAt(RAX));
+					e.OpReg({ 0xfe }, 1, RCX); // dec cl
+					FlagsOfResult(RCX);
+					Store();
+					stores = true;
+					return 10;
+
+				case 0x03: case 0x13: case 0x23: case 0x33:
+					e.Increment16(FrameAt(PairOffset(op)));
+					return 6;
+
+				case 0x0b: case 0x1b: case 0x2b: case 0x3b:
+					e.Decrement16(FrameAt(PairOffset(op)));
+					return 6;
+
+				case 0x09: case 0x19: case 0x29: case 0x39:
+					//DAD. Carry is bit 15 of the result.
+					e.LoadZeroExtend16(RAX, FrameAt(PairOffset(op)));
+					e.LoadZeroExtend16(RCX, FrameAt(OffsetHL));
+					e.OpReg({ 0x01 }, RCX, RAX); // add eax, ecx
+					e.Store16(FrameAt(OffsetHL), RAX);
+					e.Shift32(5, RAX, 15);
+					SetCarryFrom(RAX);
+					return 10;
+
+				case 0x08:
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.Op({ 0x2b }, RAX, FrameAt(OffsetBC), false, true); // sub ax, [BC]
+					e.Store16(FrameAt(OffsetHL), RAX);
+					return 8;
+
+				case 0x27:
+					e.Move64(ARG0, RBX);
+					e.Call((const void*)JitDaa);
+					return 4;
+
+				//-------------------Logical--------------------
+
+				case 0xa0: case 0xa1: case 0xa2: case 0xa3: case 0xa4: case 0xa5: case 0xa6: case 0xa7:
+					And(op & 7, 0);
+					return op == 0xa6 ? 7 : 4;
+				case 0xe6: And(-1, imm); return 7;
+
+				case 0xa8: case 0xa9: case 0xaa: case 0xab: case 0xac: case 0xad: case 0xae: case 0xaf:
+					Logical(0x30, op & 7, 0);
+					return op == 0xae ? 7 : 4;
+				case 0xee: Logical(0x30, -1, imm); return 7;
+
+				case 0xb0: case 0xb1: case 0xb2: case 0xb3: case 0xb4: case 0xb5: case 0xb6: case 0xb7:
+					Logical(0x08, op & 7, 0);
+					return op == 0xb6 ? 7 : 4;
+				case 0xf6: Logical(0x08, -1, imm); return 7;
+
+				case 0xb8: case 0xb9: case 0xba: case 0xbb: case 0xbc:
+					Compare(op & 7, 0);
+					return 4;
+				case 0xbd: Compare(6, 0); return 7; // The table has CMP M at 0xbd.
+				case 0xfe: Compare(-1, imm); return 7;
+				case 0xbf:
+					e.GroupImm8(4, FrameAt(OffsetF), (uint8_t)~(1 << CARRY_FLAG));
+					e.GroupImm8(1, FrameAt(OffsetF), 1 << ZERO_FLAG);
+					return 4;
+
+				case 0x07: // RLC
+					e.Load8(RAX, FrameAt(OffsetA));
+					e.Shift8(0, RAX, 1);
+					e.Store8(FrameAt(OffsetA), RAX);
+					SetCarryFrom(RAX);
+					return 4;
+
+				case 0x0f: // RRC
+					e.Load8(RAX, FrameAt(OffsetA));
+					e.OpReg({ 0x88 }, RAX, RCX); // mov cl, al
+					e.Shift8(1, RAX, 1);
+					e.Store8(FrameAt(OffsetA), RAX);
+					SetCarryFrom(RCX);
+					return 4;
+
+				case 0x17: // RAL
+					e.Load8(RAX, FrameAt(OffsetA));
+					e.OpReg({ 0x88 }, RAX, RCX);
+					e.Shift8(5, RCX, 7);
+					e.Shift8(4, RAX, 1);
+					e.Load8(RDX, FrameAt(OffsetF));
+					e.GroupRegImm8(4, RDX, 1);
+					e.OpReg({ 0x08 }, RDX, RAX); // or al, dl
+					e.Store8(FrameAt(OffsetA), RAX);
+					SetCarryFrom(RCX);
+					return 4;
+
+				case 0x1f: // RAR
+					e.Load8(RAX, FrameAt(OffsetA));
+					e.OpReg({ 0x88 }, RAX, RCX);
+					e.Shift8(5, RAX, 1);
+					e.Load8(RDX, FrameAt(OffsetF));
+					e.Shift8(4, RDX, 7);
+					e.OpReg({ 0x08 }, RDX, RAX);
+					e.Store8(FrameAt(OffsetA), RAX);
+					SetCarryFrom(RCX);
+					return 4;
+
+				case 0x2f: e.Not8(FrameAt(OffsetA)); return 4;
+				case 0x3f: e.GroupImm8(6, FrameAt(OffsetF), 1 << CARRY_FLAG); return 4;
+				case 0x37: e.GroupImm8(1, FrameAt(OffsetF), 1 << CARRY_FLAG); return 4;
+
+				//-------------------Branching--------------------
+				//The "+ 1"s: a jump sets PC to the operand, then PC++ runs like after every instruction.
+
+				case 0xc3:
+					Jump((uint16_t)(imm16 + 1), blockStart, bodyStart, cycles, cost);
+					return -1;
+
+				case 0xc2: case 0xca: case 0xd2: case 0xda: case 0xe2: case 0xea: case 0xf2: case 0xfa:
+					Branch(op, cycles, next);
+					Jump((uint16_t)(imm16 + 1), blockStart, bodyStart, cycles, cost);
+					return -1;
+
+				case 0xcd:
+				case 0xc4: case 0xcc: case 0xd4: case 0xdc: case 0xe4: case 0xec: case 0xf4: case 0xfc:
+					if (op != 0xcd)
+						Branch(op, cycles, next);
+
+					Push(-1, next >> 8);
+					Push(-1, next & 0xff);
+					Exit(cycles, 18, (uint16_t)(imm16 + 1));
+					return -1;
+
+				case 0xc9:
+				case 0xc0: case 0xc8: case 0xd0: case 0xd8: case 0xe0: case 0xe8: case 0xf0: case 0xf8:
+					if (op != 0xc9)
+						Branch(op, cycles, next);
+
+					//Straight into PC. The "- 1" and the PC++ cancel out.
+					Pop(offsetof(JitFrame, PC));
+					Pop(offsetof(JitFrame, PC) + 1);
+					Exit(cycles, 12, -1);
+					return -1;
+
+				case 0xc7: case 0xcf: case 0xd7: case 0xdf: case 0xe7: case 0xef: case 0xf7: case 0xff:
+					//RST pushes the address of the RST itself.
+					Push(-1, pc >> 8);
+					Push(-1, pc & 0xff);
+					Exit(cycles, 12, op & 0x38);
+					return -1;
+
+				case 0xe9:
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.Store16(FrameAt(offsetof(JitFrame, PC)), RAX);
+					Exit(cycles, 6, -1);
+					return -1;
+
+				//-------------------Stack--------------------
+
+				case 0xc5: case 0xd5: case 0xe5:
+					Push(PairOffset(op) + 1, 0);
+					Push(PairOffset(op), 0);
+					stores = true;
+					return 12;
+
+				case 0xf5:
+					Push(OffsetA, 0);
+					Push(OffsetF, 0);
+					stores = true;
+					return 12;
+
+				case 0xd1: case 0xe1:
+					Pop(PairOffset(op));
+					Pop(PairOffset(op) + 1);
+					stores = true;
+					return 10;
+
+				case 0xf1:
+					Pop(OffsetF);
+					Pop(OffsetA);
+					stores = true;
+					return 10;
+
+				case 0xe3:
+					//Two pops into nothing: SP += 2 and both bytes are zeroed. Then push HL.
+					e.Increment16(FrameAt(OffsetSP));
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetSP));
+					e.MoveImm32(RCX, 0);
+					Store();
+					e.Increment16(FrameAt(OffsetSP));
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetSP));
+					e.MoveImm32(RCX, 0);
+					Store();
+					Push(offsetof(JitFrame, H), 0);
+					Push(offsetof(JitFrame, L), 0);
+					stores = true;
+					return 16;
+
+				case 0xf9:
+					e.LoadZeroExtend16(RAX, FrameAt(OffsetHL));
+					e.Store16(FrameAt(OffsetSP), RAX);
+					return 6;
+				}
+
+				//NOP, and the empty slots which the switch core runs as NOP.
+				return 4;
+			}
+		};
+#endif
+	}
+
+	Jit::Jit(BlockCache* blocks)
+	{
+		_Blocks = blocks;
+	}
+
+	Jit::~Jit()
+	{
+#ifdef JIT_X64
+		if (_Code != nullptr)
+		{
+#ifdef _WIN32
+			VirtualFree(_Code, 0, MEM_RELEASE);
+#else
+			munmap(_Code, CodeSize);
+#endif
+		}
+#endif
+	}
+
+	bool Jit::IsSupported()
+	{
+#ifdef JIT_X64
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool Jit::SetWritable(bool writable)
+	{
+#ifdef JIT_X64
+#ifdef _WIN32
+		DWORD old;
+		if (!VirtualProtect(_Code, CodeSize, writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &old))
+			return false;
+
+		if (!writable)
+			FlushInstructionCache(GetCurrentProcess(), _Code, CodeSize);
+
+		return true;
+#else
+		return mprotect(_Code, CodeSize, writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC)) == 0;
+#endif
+#else
+		return false;
+#endif
+	}
+
+	void Jit::Translate(Block* block, uint16_t addr)
+	{
+		block->Translated = true;
+
+#ifdef JIT_X64
+		if (_Failed)
+			return;
+
+		int count = 0;
+		while (count < block->Count && CanTranslate(block->Instructions[count].Opcode))
+		{
+			count++;
+		}
+
+		if (count == 0)
+			return;
+
+		Emitter e;
+		Translator t(e);
+
+		e.Prologue();
+		size_t bodyStart = e.Code.size();
+
+		//cycles[i] = what the interpreter adds to the cycle counter between the start of the block and instruction i.
+		std::vector<long long> cycles(count + 1, 0);
+		uint16_t pc = addr;
+
+		for (int i = 0; i < count; i++)
+		{
+			const DecodedInstruction& ins = block->Instructions[i];
+			uint16_t next = pc + BlockCache::GetLength(ins.Opcode);
+
+			//The interpreter checks the cycle budget before every instruction after the first one.
+			//The native code doesn't, so it only runs if all of those checks would pass.
+			if (i == count - 1)
+				block->NativeCost = count >= 2 ? cycles[count - 2] + 1 : 0;
+
+			bool stores;
+			t.Done = i + 1;
+			int hanging = t.Instruction(ins, pc, addr, bodyStart, cycles[i], block->NativeCost, stores);
+
+			if (hanging < 0)
+				break; // A branch, it's the last one.
+
+			if (i == count - 1)
+			{
+				t.Exit(cycles[i], hanging, next);
+			}
+			else if (stores)
+			{
+				t.ExitIfCodeWritten(cycles[i], hanging, next);
+			}
+
+			cycles[i + 1] = cycles[i] + 1 + hanging;
+			pc = next;
+		}
+
+		if (_Code == nullptr)
+		{
+#ifdef _WIN32
+			_Code = (uint8_t*)VirtualAlloc(nullptr, CodeSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+			void* code = mmap(nullptr, CodeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			_Code = code == MAP_FAILED ? nullptr : (uint8_t*)code;
+#endif
+			if (_Code == nullptr)
+			{
+				_Failed = true;
+				return;
+			}
+		}
+
+		if (!SetWritable(true))
+		{
+			_Failed = true;
+			return;
+		}
+
+		if (_CodeUsed + e.Code.size() > CodeSize)
+		{
+			_Blocks->DropNative();
+			block->Translated = true;
+			_CodeUsed = 0;
+		}
+
+		uint8_t* native = _Code + _CodeUsed;
+		memcpy(native, e.Code.data(), e.Code.size());
+		_CodeUsed += (e.Code.size() + 15) & ~(size_t)15;
+
+		if (!SetWritable(false))
+		{
+			_Failed = true;
+			_Blocks->DropNative();
+			return;
+		}
+
+		block->Native = (JitFunction)native;
+#endif
+	}
+}
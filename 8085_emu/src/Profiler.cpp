@@ -0,0 +1,187 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+
+namespace Emulator
+{
+	Profiler::Profiler()
+	{
+		std::fill(std::begin(_Kinds), std::end(_Kinds), Other);
+
+		//CALL, the conditional ones and RST. RET and the conditional ones.
+		for (uint8_t op : { 0xcd, 0xc4, 0xcc, 0xd4, 0xdc, 0xe4, 0xec, 0xf4, 0xfc, 0xc7, 0xcf, 0xd7, 0xdf, 0xe7, 0xef, 0xf7, 0xff })
+			_Kinds[op] = Call;
+
+		for (uint8_t op : { 0xc9, 0xc0, 0xc8, 0xd0, 0xd8, 0xe0, 0xe8, 0xf0, 0xf8 })
+			_Kinds[op] = Return;
+
+		Clear();
+	}
+
+	void Profiler::Clear()
+	{
+		for (int i = 0; i < 0x10000; i++)
+		{
+			_Instructions[i].store(0, std::memory_order_relaxed);
+			_Cycles[i].store(0, std::memory_order_relaxed);
+		}
+
+		_Now = 0;
+		_Stack.clear();
+
+		std::lock_guard<std::mutex> lock(_CallsMutex);
+		_Calls.clear();
+		_Routines.clear();
+	}
+
+	void Profiler::Called(uint16_t routine, uint16_t sp)
+	{
+		if (_Stack.size() >= MaxDepth)
+			_Stack.erase(_Stack.begin());
+
+		_Stack.push_back({ routine, sp, _Now });
+	}
+
+	void Profiler::Returned(uint16_t sp)
+	{
+		std::lock_guard<std::mutex> lock(_CallsMutex);
+
+		//Every routine the stack is above now returned. Usually the last one, but a routine can drop its return address and jump.
+		//An interrupt's RET doesn't return from anything here, the stack is back where the interrupted routine had it.
+		while (!_Stack.empty() && _Stack.back().SP < sp)
+		{
+			Frame frame = _Stack.back();
+			_Stack.pop_back();
+
+			uint64_t cycles = _Now - frame.Start;
+			uint32_t caller = _Stack.empty() ? TopLevel : _Stack.back().Routine;
+
+			CallCount& call = _Calls[{ caller, frame.Routine }];
+			call.Calls++;
+			call.Cycles += cycles;
+
+			CallCount& routine = _Routines[frame.Routine];
+			routine.Calls++;
+
+			bool recursive = std::any_of(_Stack.begin(), _Stack.end(), [&](const Frame& other) { return other.Routine == frame.Routine; });
+
+			if (!recursive)
+				routine.Cycles += cycles;
+		}
+	}
+
+	ProfileReport Profiler::GetReport(const std::vector<std::pair<std::string, uint16_t>>& labels, const std::vector<std::pair<uint16_t, int>>& symbols)
+	{
+		ProfileReport report;
+
+		//By address. Where two labels are at the same address, the first one.
+		//Labels are one before the address, like the PC before an instruction runs, the counts are at the instruction.
+		std::vector<std::pair<std::string, uint16_t>> sorted = labels;
+		for (auto& label : sorted)
+			label.second++;
+
+		std::stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.second < b.second; });
+		sorted.erase(std::unique(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.second == b.second; }), sorted.end());
+
+		//Index into sorted of the label address is under, -1 if it's before all of them.
+		auto labelOf = [&](uint16_t address) -> int
+		{
+			auto after = std::upper_bound(sorted.begin(), sorted.end(), address, [](uint16_t address, auto& label) { return address < label.second; });
+			return (int)(after - sorted.begin()) - 1;
+		};
+
+		auto nameOf = [&](uint32_t address) -> std::string
+		{
+			if (address == TopLevel)
+				return "(top)";
+
+			int label = labelOf((uint16_t)address);
+			char name[64];
+
+			if (label < 0)
+				snprintf(name, sizeof(name), "%04XH", address);
+			else if (sorted[label].second == address)
+				return sorted[label].first;
+			else
+				snprintf(name, sizeof(name), "%s+%d", sorted[label].first.c_str(), (int)(address - sorted[label].second));
+
+			return name;
+		};
+
+		std::vector<ProfileCount> perLabel(sorted.size() + 1); // The last one is "(no label)".
+
+		for (int address = 0; address < 0x10000; address++)
+		{
+			ProfileCount count = { GetInstructions((uint16_t)address), GetCycles((uint16_t)address) };
+
+			if (count.Instructions == 0)
+				continue;
+
+			int label = labelOf((uint16_t)address);
+			ProfileCount& total = perLabel[label < 0 ? sorted.size() : label];
+
+			total.Instructions += count.Instructions;
+			total.Cycles += count.Cycles;
+
+			report.Total.Instructions += count.Instructions;
+			report.Total.Cycles += count.Cycles;
+		}
+
+		for (size_t i = 0; i < perLabel.size(); i++)
+		{
+			if (perLabel[i].Instructions == 0)
+				continue;
+
+			ProfileLabel label;
+			label.Name = i < sorted.size() ? sorted[i].first : "(no label)";
+			label.Address = i < sorted.size() ? sorted[i].second : 0;
+			label.Count = perLabel[i];
+
+			report.Labels.push_back(label);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_CallsMutex);
+
+			for (auto& routine : _Routines)
+			{
+				report.Routines.push_back({ nameOf(routine.first), routine.first, routine.second.Calls, routine.second.Cycles });
+			}
+
+			for (auto& call : _Calls)
+			{
+				report.Calls.push_back({ nameOf(call.first.first), nameOf(call.first.second), call.second.Calls, call.second.Cycles });
+			}
+		}
+
+		//The same instruction can be in there more than once (macros).
+		std::vector<std::pair<uint16_t, int>> unique = symbols;
+		std::sort(unique.begin(), unique.end());
+		unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+		std::map<int, ProfileCount> lines;
+
+		for (auto& symbol : unique)
+		{
+			ProfileCount count = { GetInstructions(symbol.first), GetCycles(symbol.first) };
+
+			if (count.Instructions == 0)
+				continue;
+
+			ProfileCount& line = lines[symbol.second];
+			line.Instructions += count.Instructions;
+			line.Cycles += count.Cycles;
+		}
+
+		report.Lines.assign(lines.begin(), lines.end());
+
+		auto byCycles = [](auto& a, auto& b) { return a.Cycles > b.Cycles; };
+		std::stable_sort(report.Labels.begin(), report.Labels.end(), [](auto& a, auto& b) { return a.Count.Cycles > b.Count.Cycles; });
+		std::stable_sort(report.Routines.begin(), report.Routines.end(), byCycles);
+		std::stable_sort(report.Calls.begin(), report.Calls.end(), byCycles);
+
+		return report;
+	}
+}
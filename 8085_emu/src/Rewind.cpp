@@ -0,0 +1,304 @@
+#include "rewind.h"
+
+#include <algorithm>
+
+#include "cpu.h"
+
+namespace Emulator
+{
+	namespace
+	{
+		//A page and its shared_ptr control block, roughly.
+		constexpr size_t PageBytes = SnapshotPageSize + 32;
+	}
+
+	Rewind::Rewind(size_t budget)
+	{
+		_Budget = budget;
+
+		std::fill(std::begin(_LastIn), std::end(_LastIn), 0x100);
+		std::fill(std::begin(_ReplayIn), std::end(_ReplayIn), 0x100);
+	}
+
+	void Rewind::Start(CPU* cpu)
+	{
+		_Keyframes.clear();
+		_Bytes = 0;
+		_Rewound = false;
+
+		AddKeyframe(cpu);
+		cpu->SetRewind(this);
+
+		_Last = _Position = cpu->State.TotalInstructions;
+	}
+
+	void Rewind::Stop(CPU* cpu)
+	{
+		cpu->SetRewind(nullptr);
+
+		_Keyframes.clear();
+		_Bytes = 0;
+		_Rewound = false;
+
+		_First = _Last = _Position = cpu->State.TotalInstructions;
+	}
+
+	size_t Rewind::GetBytes(const Keyframe& keyframe, const Keyframe* previous)
+	{
+		size_t bytes = sizeof(Keyframe) + keyframe.Journal.capacity() * sizeof(Entry);
+
+		for (int page = 0; page < SnapshotPageCount; page++)
+		{
+			if (previous == nullptr || keyframe.State.Pages[page] != previous->State.Pages[page])
+				bytes += PageBytes;
+		}
+
+		for (auto& peripheral : keyframe.State.Peripherals)
+		{
+			bytes += peripheral.capacity();
+		}
+
+		return bytes;
+	}
+
+	void Rewind::AddKeyframe(CPU* cpu)
+	{
+		//The journal of the last one is complete, it counts now.
+		if (!_Keyframes.empty())
+		{
+			Keyframe& last = _Keyframes.back();
+			last.Bytes = GetBytes(last, _Keyframes.size() > 1 ? &_Keyframes[_Keyframes.size() - 2] : nullptr);
+			_Bytes += last.Bytes;
+		}
+
+		_Keyframes.emplace_back();
+		_Keyframes.back().State = cpu->SaveState();
+
+		std::fill(std::begin(_LastIn), std::end(_LastIn), 0x100);
+
+		//The oldest one goes, its pages count for the one after it now.
+		while (_Bytes > _Budget && _Keyframes.size() > 2)
+		{
+			_Bytes -= _Keyframes[0].Bytes;
+			_Keyframes.pop_front();
+
+			_Bytes -= _Keyframes[0].Bytes;
+			_Keyframes[0].Bytes = GetBytes(_Keyframes[0], nullptr);
+			_Bytes += _Keyframes[0].Bytes;
+		}
+
+		_First = _Keyframes.front().State.State.TotalInstructions;
+	}
+
+	void Rewind::Record(CPU* cpu)
+	{
+		if (_Keyframes.empty())
+			return;
+
+		uint64_t instruction = cpu->State.TotalInstructions;
+
+		if (instruction - _Keyframes.back().State.State.TotalInstructions >= KeyframeInterval)
+		{
+			AddKeyframe(cpu);
+		}
+
+		_Last = _Position = instruction;
+	}
+
+	void Rewind::Resume(CPU* cpu)
+	{
+		if (!_Rewound)
+			return;
+
+		_Rewound = false;
+
+		for (size_t i = _Frame + 1; i < _Keyframes.size(); i++)
+		{
+			_Bytes -= _Keyframes[i].Bytes;
+		}
+
+		_Keyframes.erase(_Keyframes.begin() + _Frame + 1, _Keyframes.end());
+
+		//The last keyframe's journal isn't counted yet.
+		Keyframe& last = _Keyframes.back();
+		_Bytes -= last.Bytes;
+		last.Bytes = 0;
+
+		//From where Seek() stopped in the journal, it didn't happen. Something posted in that future is lost, the key wasn't pressed yet.
+		last.Journal.erase(last.Journal.begin() + _Entry, last.Journal.end());
+
+		uint64_t instruction = cpu->State.TotalInstructions;
+
+		std::fill(std::begin(_LastIn), std::end(_LastIn), 0x100);
+
+		_Last = _Position = instruction;
+	}
+
+	void Rewind::RecordEntry(const Entry& entry)
+	{
+		if (_Replaying)
+			return;
+
+		std::vector<Entry>& journal = _Keyframes.back().Journal;
+
+		//One entry for a whole wait in HLT.
+		if (entry.Kind == Entry::HaltedCycles && !journal.empty() &&
+			journal.back().Kind == Entry::HaltedCycles && journal.back().Instruction == entry.Instruction)
+		{
+			journal.back().Value += entry.Value;
+			return;
+		}
+
+		if (journal.empty() || journal.back().Instruction <= entry.Instruction)
+		{
+			journal.push_back(entry);
+			return;
+		}
+
+		auto after = std::upper_bound(journal.begin(), journal.end(), entry.Instruction, [](uint64_t instruction, const Entry& other) { return instruction < other.Instruction; });
+		journal.insert(after, entry);
+	}
+
+	void Rewind::Apply(CPU* cpu, const Entry& entry)
+	{
+		switch (entry.Kind)
+		{
+		case Entry::In:
+			_ReplayIn[entry.Port] = (uint8_t)entry.Value;
+			break;
+
+		case Entry::Posted:
+		{
+			InternalEmulator::Event event;
+			event.Interrupt = entry.Port;
+
+			cpu->_Scheduler.Schedule(event);
+			break;
+		}
+
+		case Entry::Events:
+			cpu->RunDueEvents(entry.Value);
+			break;
+
+		case Entry::Interrupt:
+			cpu->TakeInterrupt((InterruptLines)entry.Port);
+			break;
+
+		case Entry::HaltedCycles:
+			cpu->State.TotalCycles += entry.Value;
+			break;
+		}
+	}
+
+	uint64_t Rewind::Replay(CPU* cpu, size_t frame, uint64_t until, StopFunction stop, void* ctx)
+	{
+		const Keyframe& keyframe = _Keyframes[frame];
+		const std::vector<Entry>& journal = keyframe.Journal;
+
+		cpu->LoadState(keyframe.State);
+
+		_Replaying = true;
+		std::fill(std::begin(_ReplayIn), std::end(_ReplayIn), 0x100);
+
+		//It ran already, it was counted then.
+		Profiler* profiler = cpu->_Profiler;
+		cpu->_Profiler = nullptr;
+
+		CpuState& s = cpu->State;
+		size_t next = 0;
+		uint64_t found = UINT64_MAX;
+
+		//Like Step(), one instruction at a time. Clock() doesn't take interrupts, only the journal does.
+		//Everything in the journal at an instruction happened before it, and it ran, whatever HLT says: Step() runs on in HLT.
+		while (true)
+		{
+			uint64_t instruction = s.TotalInstructions;
+
+			if (instruction >= until)
+				break;
+
+			if (stop != nullptr && stop(cpu, ctx))
+				found = instruction;
+
+			while (next < journal.size() && journal[next].Instruction <= instruction)
+			{
+				Apply(cpu, journal[next++]);
+			}
+
+			if (!cpu->GetRunning())
+				break;
+
+			s.CurrentCycles += s.HangingCycles;
+			s.HangingCycles = 0;
+
+			cpu->_AlreadyHalted = true; // No breakpoints on the way.
+			cpu->Clock();
+
+			s.CurrentCycles++;
+		}
+
+		s.TotalCycles += s.CurrentCycles;
+		s.CurrentCycles = 0;
+
+		_Replaying = false;
+		_Entry = next;
+
+		cpu->_Profiler = profiler;
+
+		//Running on from here doesn't stop on the breakpoint it's on.
+		cpu->_AlreadyHalted = true;
+		cpu->UpdateLoopLimit();
+
+		return found;
+	}
+
+	bool Rewind::Seek(CPU* cpu, uint64_t instruction)
+	{
+		if (_Keyframes.empty())
+			return false;
+
+		instruction = std::min(std::max(instruction, (uint64_t)_First), (uint64_t)_Last);
+
+		//The last keyframe at or before it. In HLT, a few keyframes can be at the same instruction.
+		size_t frame = _Keyframes.size() - 1;
+		while (frame > 0 && _Keyframes[frame].State.State.TotalInstructions > instruction)
+		{
+			frame--;
+		}
+
+		Replay(cpu, frame, instruction);
+
+		_Rewound = true;
+		_Frame = frame;
+		_Position = cpu->State.TotalInstructions;
+
+		return true;
+	}
+
+	bool Rewind::SeekBack(CPU* cpu, StopFunction stop, void* ctx)
+	{
+		uint64_t current = _Position;
+
+		if (_Keyframes.empty() || current <= _First)
+			return false;
+
+		//From the keyframe before the current instruction back, the first one where stop is true somewhere before it.
+		for (size_t frame = _Keyframes.size(); frame-- > 0;)
+		{
+			uint64_t start = _Keyframes[frame].State.State.TotalInstructions;
+			uint64_t end = frame + 1 < _Keyframes.size() ? _Keyframes[frame + 1].State.State.TotalInstructions : (uint64_t)_Last;
+
+			end = std::min(end, current);
+
+			if (start >= end)
+				continue;
+
+			uint64_t found = Replay(cpu, frame, end, stop, ctx);
+
+			if (found != UINT64_MAX)
+				return Seek(cpu, found);
+		}
+
+		return Seek(cpu, _First);
+	}
+}
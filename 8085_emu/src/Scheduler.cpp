@@ -0,0 +1,65 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+namespace InternalEmulator
+{
+	namespace
+	{
+		//std::push_heap makes a max-heap, so "less" is "later".
+		bool Later(const Event& a, const Event& b)
+		{
+			if (a.Cycle != b.Cycle)
+				return a.Cycle > b.Cycle;
+
+			return a.Order > b.Order;
+		}
+	}
+
+	void Scheduler::Schedule(Event event)
+	{
+		event.Order = _Order++;
+
+		_Heap.push_back(event);
+		std::push_heap(_Heap.begin(), _Heap.end(), Later);
+	}
+
+	void Scheduler::Post(Event event)
+	{
+		std::lock_guard<std::mutex> lock(_PostedMutex);
+
+		_Posted.push_back(event);
+		_HasPosted = true;
+	}
+
+	std::vector<Event> Scheduler::TakePosted()
+	{
+		std::vector<Event> posted;
+
+		{
+			std::lock_guard<std::mutex> lock(_PostedMutex);
+
+			posted.swap(_Posted);
+			_HasPosted = false;
+		}
+
+		for (const Event& event : posted)
+		{
+			Schedule(event);
+		}
+
+		return posted;
+	}
+
+	bool Scheduler::PopDue(uint64_t now, Event& event)
+	{
+		if (_Heap.empty() || _Heap.front().Cycle > now)
+			return false;
+
+		std::pop_heap(_Heap.begin(), _Heap.end(), Later);
+		event = _Heap.back();
+		_Heap.pop_back();
+
+		return true;
+	}
+}
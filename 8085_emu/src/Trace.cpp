@@ -0,0 +1,399 @@
+#include "trace.h"
+
+#include <cstring>
+
+#include "cpu.h"
+#include "CPUinstructions.h"
+
+namespace Emulator
+{
+	namespace
+	{
+		inline uint8_t* PutVarint(uint8_t* out, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				*out++ = (uint8_t)(value | 0x80);
+				value >>= 7;
+			}
+
+			*out++ = (uint8_t)value;
+			return out;
+		}
+
+		//The last value if the address is in there already.
+		inline void AddTraceWrite(TraceRecord& record, uint16_t address, uint8_t value)
+		{
+			for (int i = 0; i < record.WriteCount; i++)
+			{
+				if (record.Writes[i].Address == address)
+				{
+					record.Writes[i].Value = value;
+					return;
+				}
+			}
+
+			if (record.WriteCount < TraceRecord::MaxWrites)
+				record.Writes[record.WriteCount++] = { address, value };
+		}
+	}
+
+	void TracePrediction::Start(const TraceHeader& header)
+	{
+		*this = TracePrediction();
+
+		Instruction = header.Instruction;
+		Cycle = header.Cycle;
+		NextPC = header.PC;
+		A = header.A;
+		Flags = header.Flags;
+	}
+
+	void TracePrediction::Update(const TraceRecord& record)
+	{
+		if (!First)
+			CycleAfter[Opcode] = record.Cycle - Cycle;
+
+		First = false;
+
+		Instruction = record.Instruction + 1;
+		Cycle = record.Cycle;
+		NextPC = (uint16_t)(record.PC + record.Length);
+		A = record.A;
+		Flags = record.Flags;
+		Opcode = record.Opcode;
+	}
+
+	TraceWriter::~TraceWriter()
+	{
+		Close();
+	}
+
+	bool TraceWriter::Open(const std::string& fileName)
+	{
+		Close();
+
+		_File = fopen(fileName.c_str(), "wb");
+		if (_File == nullptr)
+			return false;
+
+		_Failed = false;
+		_Stopping = false;
+		_Started = false;
+		_Records = 0;
+
+		//Two to start with: one to fill, one being written.
+		_Buffer.resize(BufferSize);
+		_Used = 0;
+		_Free.emplace_back(BufferSize);
+
+		_Thread = std::thread(&TraceWriter::WriteLoop, this);
+
+		return true;
+	}
+
+	bool TraceWriter::Close()
+	{
+		if (_File == nullptr)
+			return true;
+
+		Flush();
+
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			_Stopping = true;
+		}
+
+		_Condition.notify_one();
+		_Thread.join();
+
+		_Failed |= fclose(_File) != 0;
+		_File = nullptr;
+
+		_Buffer.clear();
+		_Buffer.shrink_to_fit();
+		_Free.clear();
+
+		return !_Failed;
+	}
+
+	void TraceWriter::WriteLoop()
+	{
+		std::unique_lock<std::mutex> lock(_Mutex);
+
+		while (true)
+		{
+			_Condition.wait(lock, [this]() { return _Stopping || !_Full.empty(); });
+
+			if (_Full.empty())
+				return;
+
+			std::pair<std::vector<uint8_t>, size_t> full = std::move(_Full.front());
+			_Full.pop_front();
+
+			lock.unlock();
+
+			bool failed = fwrite(full.first.data(), 1, full.second, _File) != full.second;
+
+			lock.lock();
+
+			_Failed |= failed;
+			_Free.push_back(std::move(full.first));
+		}
+	}
+
+	void TraceWriter::Flush()
+	{
+		if (_Used == 0)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+
+			_Full.emplace_back(std::move(_Buffer), _Used);
+
+			if (!_Free.empty())
+			{
+				_Buffer = std::move(_Free.back());
+				_Free.pop_back();
+			}
+		}
+
+		_Condition.notify_one();
+
+		//None back yet.
+		if (_Buffer.size() != BufferSize)
+			_Buffer.resize(BufferSize);
+
+		_Used = 0;
+	}
+
+	void TraceWriter::Start(const CpuState& state)
+	{
+		if (_File == nullptr)
+			return;
+
+		TraceHeader header;
+		header.Instruction = state.TotalInstructions;
+		header.Cycle = state.TotalCycles + state.CurrentCycles;
+		header.PC = state.PC;
+		header.A = state.A;
+		header.Flags = state.Flags;
+
+		//Once. Tracing the same CPU again later goes on from the last record, a gap and the PC tell the reader where it is.
+		if (_Started)
+			return;
+
+		_Started = true;
+
+		memcpy(_Buffer.data(), &header, sizeof(header));
+		_Used = sizeof(header);
+
+		_Prediction.Start(header);
+	}
+
+	void TraceWriter::Write(const TraceRecord& record)
+	{
+		if (_File == nullptr)
+			return;
+
+		if (BufferSize - _Used < MaxRecordBytes)
+			Flush();
+
+		TracePrediction& p = _Prediction;
+
+		uint8_t* start = _Buffer.data() + _Used;
+		uint8_t* out = start + 1;
+		uint8_t bits = 0;
+
+		if (record.Instruction != p.Instruction)
+		{
+			bits |= TraceGap;
+			out = PutVarint(out, record.Instruction - p.Instruction);
+		}
+
+		if (record.PC != p.NextPC)
+		{
+			bits |= TracePC;
+			*out++ = (uint8_t)record.PC;
+			*out++ = (uint8_t)(record.PC >> 8);
+		}
+
+		uint64_t cycles = record.Cycle - p.Cycle;
+
+		if (p.First || cycles != p.CycleAfter[p.Opcode])
+		{
+			bits |= TraceCycle;
+			out = PutVarint(out, cycles);
+		}
+
+		if (record.Interrupt >= 0)
+		{
+			bits |= TraceInterrupt;
+			*out++ = (uint8_t)record.Interrupt;
+		}
+
+		*out++ = record.Opcode;
+
+		for (int i = 1; i < record.Length; i++)
+		{
+			*out++ = record.Operands[i - 1];
+		}
+
+		if (record.A != p.A)
+		{
+			bits |= TraceA;
+			*out++ = record.A;
+		}
+
+		if (record.Flags != p.Flags)
+		{
+			bits |= TraceFlags;
+			*out++ = record.Flags;
+		}
+
+		if (record.WriteCount > 0)
+		{
+			bits |= TraceWrites;
+			*out++ = record.WriteCount;
+
+			for (int i = 0; i < record.WriteCount; i++)
+			{
+				*out++ = (uint8_t)record.Writes[i].Address;
+				*out++ = (uint8_t)(record.Writes[i].Address >> 8);
+				*out++ = record.Writes[i].Value;
+			}
+		}
+
+		*start = bits;
+		_Used += out - start;
+
+		p.Update(record);
+		_Records++;
+	}
+
+	//-------------------The CPU's side--------------------
+
+	void CPU::SetTracer(TraceWriter* tracer)
+	{
+		_Tracer = tracer;
+		_TracePending = TraceRecord();
+		_TraceInterrupt = -1;
+
+		if (tracer != nullptr)
+			tracer->Start(State);
+	}
+
+	void CPU::TraceInterrupt(InterruptLines line)
+	{
+		//Taken between Loop()s too (a program woken up from HLT), it's in the record of the next instruction.
+		_TraceInterrupt = line;
+
+		TraceRecord& record = _TracePending;
+
+		//The return address, pushed like TakeInterrupt() does.
+		uint8_t* mem = _Memory->GetData().get();
+		uint16_t sp = State.SP;
+
+		if (mem[sp] != (State.PC >> 8))
+			AddTraceWrite(record, sp, (uint8_t)(State.PC >> 8));
+
+		sp--;
+
+		if (mem[sp] != (State.PC & 0xff))
+			AddTraceWrite(record, sp, (uint8_t)(State.PC & 0xff));
+	}
+
+	void CPU::TracedInstruction(uint8_t* mem)
+	{
+		TraceRecord& record = _TracePending;
+
+		record.Instruction = State.TotalInstructions;
+
+		State.CurrentCycles += State.HangingCycles;
+		State.HangingCycles = 0;
+
+		record.Cycle = State.TotalCycles + State.CurrentCycles;
+
+		Interrupts();
+
+		uint16_t pc = State.PC;
+		uint8_t op = mem[pc];
+		uint8_t length = (uint8_t)InternalEmulator::CPUInstructions[op].bytes;
+
+		//Everything this instruction can write: around the stack, at HL, BC, DE, or at its address (STA, SHLD).
+		//Some can be the same address, a change there is only recorded once.
+		uint16_t sp = State.SP;
+		uint16_t de = (uint16_t)((State.D << 8) | State.E);
+		uint16_t address = (uint16_t)(mem[(uint16_t)(pc + 1)] | (mem[(uint16_t)(pc + 2)] << 8));
+
+		uint16_t candidates[] =
+		{
+			(uint16_t)(sp - 2), (uint16_t)(sp - 1), sp, (uint16_t)(sp + 1), (uint16_t)(sp + 2),
+			(uint16_t)((State.H << 8) | State.L),
+			(uint16_t)((State.B << 8) | State.C),
+			de, (uint16_t)(de + 1), // SHLX
+			address, (uint16_t)(address + 1)
+		};
+
+		constexpr int Candidates = sizeof(candidates) / sizeof(candidates[0]);
+		int count = length == 3 ? Candidates : Candidates - 2;
+
+		uint8_t before[Candidates];
+		for (int i = 0; i < count; i++)
+		{
+			before[i] = mem[candidates[i]];
+		}
+
+		record.PC = pc;
+		record.Opcode = op;
+		record.Length = length;
+		record.Operands[0] = mem[(uint16_t)(pc + 1)];
+		record.Operands[1] = mem[(uint16_t)(pc + 2)];
+
+		uint64_t instructions = State.TotalInstructions;
+
+		Clock();
+
+		State.CurrentCycles++;
+
+		//Stopped on a breakpoint, it didn't run. An interrupt taken before it goes with the next one.
+		if (State.TotalInstructions == instructions)
+			return;
+
+		for (int i = 0; i < count; i++)
+		{
+			if (mem[candidates[i]] != before[i])
+				AddTraceWrite(record, candidates[i], mem[candidates[i]]);
+		}
+
+		record.A = State.A;
+		record.Flags = State.Flags;
+		record.Interrupt = _TraceInterrupt;
+		record.In = op == 0xdb;
+		record.Out = op == 0xd3;
+		record.Port = record.Operands[0];
+		record.PortValue = State.A;
+
+		_Tracer->Write(record);
+
+		_TraceInterrupt = -1;
+		record.WriteCount = 0;
+	}
+
+	void CPU::RunTraced()
+	{
+		//The table core's loop, without bootloader HLE or idle loop skipping: they run many instructions at once.
+		uint8_t* mem = _Memory->GetData().get();
+
+		while (_Running && !_Halted && State.CurrentCycles <= _ClockCyclesPerLoop)
+		{
+			if (State.CurrentCycles > _LoopLimit)
+			{
+				RunEvents();
+			}
+
+			TracedInstruction(mem);
+		}
+	}
+}
@@ -0,0 +1,224 @@
+#include "trace.h"
+
+#include <cstring>
+
+#include "CPUinstructions.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Emulator
+{
+	TraceReader::~TraceReader()
+	{
+		Close();
+	}
+
+	bool TraceReader::Open(const std::string& fileName)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		_FileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || (size_t)size.QuadPart < sizeof(TraceHeader))
+		{
+			Close();
+			return false;
+		}
+
+		_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (_Mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		_Data = (const uint8_t*)MapViewOfFile(_Mapping, FILE_MAP_READ, 0, 0, 0);
+		_Size = (size_t)size.QuadPart;
+#else
+		_FileDescriptor = open(fileName.c_str(), O_RDONLY);
+		if (_FileDescriptor < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(_FileDescriptor, &info) != 0 || (size_t)info.st_size < sizeof(TraceHeader))
+		{
+			Close();
+			return false;
+		}
+
+		void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, _FileDescriptor, 0);
+		_Data = data == MAP_FAILED ? nullptr : (const uint8_t*)data;
+		_Size = info.st_size;
+#endif
+
+		if (_Data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		memcpy(&_Header, _Data, sizeof(_Header));
+
+		if (memcmp(_Header.Magic, TraceHeader().Magic, sizeof(_Header.Magic)) != 0 || _Header.Version != 1)
+		{
+			Close();
+			return false;
+		}
+
+		Restart();
+
+		return true;
+	}
+
+	void TraceReader::Close()
+	{
+#ifdef _WIN32
+		if (_Data != nullptr)
+			UnmapViewOfFile(_Data);
+
+		if (_Mapping != nullptr)
+			CloseHandle(_Mapping);
+
+		if (_FileHandle != nullptr)
+			CloseHandle(_FileHandle);
+
+		_Mapping = nullptr;
+		_FileHandle = nullptr;
+#else
+		if (_Data != nullptr)
+			munmap((void*)_Data, _Size);
+
+		if (_FileDescriptor >= 0)
+			close(_FileDescriptor);
+
+		_FileDescriptor = -1;
+#endif
+
+		_Data = nullptr;
+		_Size = 0;
+		_Position = 0;
+	}
+
+	void TraceReader::Restart()
+	{
+		_Position = sizeof(TraceHeader);
+		_Prediction.Start(_Header);
+	}
+
+	bool TraceReader::Next(TraceRecord& record)
+	{
+		if (_Data == nullptr)
+			return false;
+
+		const uint8_t* in = _Data + _Position;
+		const uint8_t* end = _Data + _Size;
+
+		//Every read is checked against the end, the last record can be cut short.
+		bool ok = true;
+
+		auto byte = [&]() -> uint8_t
+		{
+			if (in >= end)
+			{
+				ok = false;
+				return 0;
+			}
+
+			return *in++;
+		};
+
+		auto varint = [&]() -> uint64_t
+		{
+			uint64_t value = 0;
+
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				uint8_t b = byte();
+				value |= (uint64_t)(b & 0x7f) << shift;
+
+				if (!(b & 0x80))
+					break;
+			}
+
+			return value;
+		};
+
+		if (in >= end)
+			return false;
+
+		TracePrediction& p = _Prediction;
+		uint8_t bits = byte();
+
+		record.Instruction = p.Instruction;
+		if (bits & TraceGap)
+			record.Instruction += varint();
+
+		record.PC = p.NextPC;
+		if (bits & TracePC)
+		{
+			record.PC = byte();
+			record.PC |= byte() << 8;
+		}
+
+		record.Cycle = p.Cycle + ((bits & TraceCycle) ? varint() : p.CycleAfter[p.Opcode]);
+
+		record.Interrupt = (bits & TraceInterrupt) ? (int8_t)byte() : -1;
+
+		record.Opcode = byte();
+		record.Length = (uint8_t)InternalEmulator::CPUInstructions[record.Opcode].bytes;
+		record.Operands[0] = record.Operands[1] = 0;
+
+		for (int i = 1; i < record.Length; i++)
+		{
+			record.Operands[i - 1] = byte();
+		}
+
+		record.A = (bits & TraceA) ? byte() : p.A;
+		record.Flags = (bits & TraceFlags) ? byte() : p.Flags;
+
+		record.WriteCount = 0;
+		if (bits & TraceWrites)
+		{
+			int count = byte();
+
+			for (int i = 0; i < count; i++)
+			{
+				TraceWrite write;
+				write.Address = byte();
+				write.Address |= byte() << 8;
+				write.Value = byte();
+
+				if (i < TraceRecord::MaxWrites)
+					record.Writes[record.WriteCount++] = write;
+			}
+		}
+
+		record.In = record.Opcode == 0xdb;
+		record.Out = record.Opcode == 0xd3;
+		record.Port = record.Operands[0];
+		record.PortValue = record.A;
+
+		if (!ok)
+			return false;
+
+		_Position = in - _Data;
+		p.Update(record);
+
+		return true;
+	}
+}
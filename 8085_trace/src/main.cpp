@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+#include "trace.h"
+#include "CPUinstructions.h"
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: 8085_trace <command> [options]\n"
+		"\n"
+		"  dump FILE [--from N] [--count N]\n"
+		"                    Print the records, one instruction per line, starting\n"
+		"                    at instruction N.\n"
+		"  grep FILE TERM... Print the records that match every term:\n"
+		"                    pc=ADDR   at that address\n"
+		"                    op=XX     that opcode, or op=NAME (op=OUT)\n"
+		"                    a=XX      A is that after it\n"
+		"                    port=XX   an IN or OUT on that port\n"
+		"                    mem=ADDR  writes to that address\n"
+		"                    int       an interrupt was taken before it\n"
+		"                    Numbers are hex.\n"
+		"  diff A B [--no-cycles]\n"
+		"                    Print the first instruction where two traces differ,\n"
+		"                    e.g. from two emulator builds, or a capture converted to\n"
+		"                    this format. --no-cycles ignores the timing.\n"
+		"\n"
+		"Traces are written by 8085_batch --trace, or anything else using\n"
+		"CPU::SetTracer().\n");
+}
+
+static const char* InterruptNames[] = { "RST 5.5", "RST 6.5", "RST 7.5", "INTR" };
+
+static void PrintRecord(const Emulator::TraceRecord& record)
+{
+	char bytes[16];
+	if (record.Length == 3)
+		snprintf(bytes, sizeof(bytes), "%02X %02X %02X", record.Opcode, record.Operands[0], record.Operands[1]);
+	else if (record.Length == 2)
+		snprintf(bytes, sizeof(bytes), "%02X %02X", record.Opcode, record.Operands[0]);
+	else
+		snprintf(bytes, sizeof(bytes), "%02X", record.Opcode);
+
+	printf("%10llu %12llu  %04X  %-9s %-5s A=%02X F=%02X",
+		(unsigned long long)record.Instruction, (unsigned long long)record.Cycle, record.PC, bytes,
+		InternalEmulator::CPUInstructions[record.Opcode].OPERAND, record.A, record.Flags);
+
+	if (record.Interrupt >= 0 && record.Interrupt < 4)
+		printf("  after %s", InterruptNames[record.Interrupt]);
+
+	if (record.In)
+		printf("  in %02X=%02X", record.Port, record.PortValue);
+
+	if (record.Out)
+		printf("  out %02X=%02X", record.Port, record.PortValue);
+
+	for (int i = 0; i < record.WriteCount; i++)
+	{
+		printf("  [%04X]=%02X", record.Writes[i].Address, record.Writes[i].Value);
+	}
+
+	printf("\n");
+}
+
+static bool OpenTrace(Emulator::TraceReader& reader, const std::string& fileName)
+{
+	if (reader.Open(fileName))
+		return true;
+
+	fprintf(stderr, "Can't read %s, or it isn't a trace.\n", fileName.c_str());
+	return false;
+}
+
+static int Dump(const std::vector<std::string>& args)
+{
+	uint64_t from = 0, count = UINT64_MAX;
+
+	for (size_t i = 1; i < args.size(); i++)
+	{
+		if (args[i] == "--from" && i + 1 < args.size())
+			from = std::stoull(args[++i], nullptr, 0);
+		else if (args[i] == "--count" && i + 1 < args.size())
+			count = std::stoull(args[++i], nullptr, 0);
+		else
+			throw std::invalid_argument(args[i]);
+	}
+
+	Emulator::TraceReader reader;
+	if (!OpenTrace(reader, args[0]))
+		return 1;
+
+	Emulator::TraceRecord record;
+
+	while (count > 0 && reader.Next(record))
+	{
+		if (record.Instruction < from)
+			continue;
+
+		PrintRecord(record);
+		count--;
+	}
+
+	return 0;
+}
+
+//One grep term. Matches() is true if the record has it.
+struct Term
+{
+	enum Kinds { PC, Opcode, Name, A, Port, Memory, Interrupt } Kind;
+	unsigned Value = 0;
+	std::string Text;
+
+	bool Matches(const Emulator::TraceRecord& record) const
+	{
+		switch (Kind)
+		{
+		case PC: return record.PC == Value;
+		case Opcode: return record.Opcode == Value;
+		case Name: return Text == InternalEmulator::CPUInstructions[record.Opcode].OPERAND;
+		case A: return record.A == Value;
+		case Port: return (record.In || record.Out) && record.Port == Value;
+		case Interrupt: return record.Interrupt >= 0;
+		case Memory:
+			for (int i = 0; i < record.WriteCount; i++)
+			{
+				if (record.Writes[i].Address == Value)
+					return true;
+			}
+
+			return false;
+		}
+
+		return false;
+	}
+};
+
+static Term ParseTerm(const std::string& text)
+{
+	Term term;
+
+	if (text == "int")
+	{
+		term.Kind = Term::Interrupt;
+		return term;
+	}
+
+	size_t equals = text.find('=');
+	if (equals == std::string::npos)
+		throw std::invalid_argument(text);
+
+	std::string key = text.substr(0, equals);
+	std::string value = text.substr(equals + 1);
+
+	if (key == "op")
+	{
+		//A name if it isn't a hex number.
+		bool name = false;
+		for (char c : value)
+		{
+			if (!isxdigit((unsigned char)c))
+				name = true;
+		}
+
+		if (name || value.size() > 2)
+		{
+			term.Kind = Term::Name;
+			for (char& c : value)
+				c = (char)toupper((unsigned char)c);
+
+			term.Text = value;
+			return term;
+		}
+
+		term.Kind = Term::Opcode;
+	}
+	else if (key == "pc")
+		term.Kind = Term::PC;
+	else if (key == "a")
+		term.Kind = Term::A;
+	else if (key == "port")
+		term.Kind = Term::Port;
+	else if (key == "mem")
+		term.Kind = Term::Memory;
+	else
+		throw std::invalid_argument(text);
+
+	term.Value = std::stoul(value, nullptr, 16);
+	return term;
+}
+
+static int Grep(const std::vector<std::string>& args)
+{
+	std::vector<Term> terms;
+
+	for (size_t i = 1; i < args.size(); i++)
+	{
+		terms.push_back(ParseTerm(args[i]));
+	}
+
+	Emulator::TraceReader reader;
+	if (!OpenTrace(reader, args[0]))
+		return 1;
+
+	Emulator::TraceRecord record;
+	uint64_t found = 0;
+
+	while (reader.Next(record))
+	{
+		bool matches = true;
+
+		for (const Term& term : terms)
+		{
+			if (!term.Matches(record))
+			{
+				matches = false;
+				break;
+			}
+		}
+
+		if (matches)
+		{
+			PrintRecord(record);
+			found++;
+		}
+	}
+
+	return found > 0 ? 0 : 1;
+}
+
+//What differs between a and b, nullptr if nothing.
+static const char* Difference(const Emulator::TraceRecord& a, const Emulator::TraceRecord& b, bool cycles)
+{
+	if (a.PC != b.PC)
+		return "PC";
+	if (a.Opcode != b.Opcode || a.Length != b.Length || memcmp(a.Operands, b.Operands, a.Length - 1) != 0)
+		return "instruction";
+	if (a.Interrupt != b.Interrupt)
+		return "interrupt";
+	if (a.A != b.A)
+		return "A";
+	if (a.Flags != b.Flags)
+		return "flags";
+	if (a.WriteCount != b.WriteCount)
+		return "memory writes";
+
+	for (int i = 0; i < a.WriteCount; i++)
+	{
+		if (a.Writes[i].Address != b.Writes[i].Address || a.Writes[i].Value != b.Writes[i].Value)
+			return "memory writes";
+	}
+
+	if (cycles && a.Cycle != b.Cycle)
+		return "cycle";
+
+	return nullptr;
+}
+
+static int Diff(const std::vector<std::string>& args)
+{
+	bool cycles = true;
+
+	for (size_t i = 2; i < args.size(); i++)
+	{
+		if (args[i] == "--no-cycles")
+			cycles = false;
+		else
+			throw std::invalid_argument(args[i]);
+	}
+
+	Emulator::TraceReader a, b;
+	if (!OpenTrace(a, args[0]) || !OpenTrace(b, args[1]))
+		return 2;
+
+	Emulator::TraceRecord ra, rb;
+	uint64_t compared = 0;
+
+	while (true)
+	{
+		bool hasA = a.Next(ra);
+		bool hasB = b.Next(rb);
+
+		if (!hasA && !hasB)
+		{
+			printf("Same, %llu instructions.\n", (unsigned long long)compared);
+			return 0;
+		}
+
+		if (hasA != hasB)
+		{
+			printf("%s ends after %llu instructions, the other one goes on:\n", hasA ? args[1].c_str() : args[0].c_str(), (unsigned long long)compared);
+			PrintRecord(hasA ? ra : rb);
+			return 1;
+		}
+
+		const char* difference = Difference(ra, rb, cycles);
+
+		if (difference != nullptr)
+		{
+			printf("The %s differs at instruction %llu of the trace:\n", difference, (unsigned long long)compared);
+			PrintRecord(ra);
+			PrintRecord(rb);
+			return 1;
+		}
+
+		compared++;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	std::string command = argv[1];
+	std::vector<std::string> args(argv + 2, argv + argc);
+
+	try
+	{
+		if (command == "dump")
+			return Dump(args);
+		if (command == "grep")
+			return Grep(args);
+		if (command == "diff" && args.size() >= 2)
+			return Diff(args);
+	}
+	catch (...)
+	{
+		fprintf(stderr, "Bad argument.\n\n");
+		PrintUsage();
+		return 2;
+	}
+
+	PrintUsage();
+	return 2;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <utility>
 #include <cstdint>
@@ -24,6 +25,65 @@ namespace Simulation {
 	void SetClock(int clock_speed, int accuracy);
 	int GetClock();
 	int GetAccuracy();
+
+	void SetCore(Emulator::CPUCores core);
+	Emulator::CPUCores GetCore();
+
+	//Max speed ignores the clock and runs the CPU as fast as the host can.
+	//Pause, stop and interrupts are still checked, every MaxSpeedCyclesPerCheck cycles (a few ms).
+	const int MaxSpeedCyclesPerCheck = 256 * 1024;
+
+	void SetMaxSpeed(bool maxSpeed);
+	bool GetMaxSpeed();
+
+	//Skip delay loops and busy waits in one step (Emulator::CPU::SetIdleSkip()).
+	//At max speed, a program that's only waiting for input doesn't keep the host busy either.
+	void SetIdleSkip(bool idleSkip);
+	bool GetIdleSkip();
+
+	//Run the bootloader routines in C++ (Emulator::CPU::SetBootloaderHle()). Same result, faster.
+	void SetBootloaderHle(bool bootloaderHle);
+	bool GetBootloaderHle();
+
+	//Count the documented T-states of every instruction (Emulator::CPU::SetCycleExact()).
+	void SetCycleExact(bool cycleExact);
+	bool GetCycleExact();
+
+	//Count every opcode in the performance counters (Emulator::CPU::SetOpcodeCounting()). The JIT core runs as the block core.
+	void SetOpcodeCounting(bool opcodeCounting);
+	bool GetOpcodeCounting();
+
+	//Count the cycles of every address and routine (Emulator::CPU::SetProfiler()), from now on. The JIT core runs as the block core,
+	//idle loop skipping and the bootloader HLE are off while it's on. The counts are kept until ResetProfile() or the next run.
+	void SetProfiling(bool profiling);
+	bool GetProfiling();
+	void ResetProfile();
+
+	//Any thread can read it while the simulation runs.
+	Emulator::Profiler& GetProfiler();
+
+	//Reverse debugging (Emulator::Rewind), in MB of memory for it. 0 turns it off. Applies on the next run.
+	void SetRewindBudget(int megabytes);
+	int GetRewindBudget();
+
+	//While paused, halted or stepping. The simulation thread does it, and stays paused (or stepping) there.
+	//Step back to the last line of code before this one, back to the last breakpoint, or to any instruction that was recorded.
+	void StepBack();
+	void ReverseContinue();
+	void SeekInstruction(uint64_t instruction);
+
+	//What can be rewound to, in instructions run (State.TotalInstructions). False if nothing is recorded.
+	bool CanRewind();
+	uint64_t GetRewindFirst();
+	uint64_t GetRewindLast();
+	uint64_t GetRewindPosition();
+
+	//Memory was changed from outside the CPU, e.g. in the Hex Editor. What was recorded can't be replayed, it starts again from here.
+	void RestartRewind();
+
+	//Measured by the simulation thread a few times a second, in any mode. 0 when it's not running.
+	double GetInstructionsPerSecond();
+	double GetEmulatedMHz();
 	
 	void Run(bool stepping = false);
 	void Stop();
@@ -16,6 +16,7 @@ class Controls : public Window
 {
 	//Pretty straight forward.
 	//Assemble, Step, INTR, Run, Stop, Pause buttons.
+	//Step Back, Reverse and the instruction slider when rewinding is on (Simulation::SetRewindBudget()).
 private:
 	ImFont* _Font;
 
@@ -86,7 +87,7 @@ public:
 				Simulation::GetRunning(),
 				ImVec2(width, 40)))
 			{
-				Simulation::cpu->_IPINTR = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::InterruptINTR);
 			}
 
 			ImGui::SameLine();
@@ -113,6 +114,52 @@ public:
 
 			ImGui::Separator();
 
+			if (Simulation::GetRewindBudget() > 0)
+			{
+				bool stopped = Simulation::CanRewind() && (Simulation::GetPaused() || Simulation::cpu->GetHalted() || Simulation::_Stepping);
+				bool back = stopped && Simulation::GetRewindPosition() > Simulation::GetRewindFirst();
+
+				if (Button("Step Back", back, ImVec2(width, 40)))
+				{
+					Simulation::StepBack();
+				}
+
+				ImGui::SameLine();
+
+				//Back to the last breakpoint it passed.
+				if (Button("Reverse", back, ImVec2(width, 40)))
+				{
+					Simulation::ReverseContinue();
+				}
+
+				ImGui::SameLine();
+
+				//Any instruction that was recorded. Follows the CPU while it runs.
+				uint64_t first = Simulation::CanRewind() ? Simulation::GetRewindFirst() : 0;
+				uint64_t last = Simulation::CanRewind() ? Simulation::GetRewindLast() : 0;
+				uint64_t position = Simulation::CanRewind() ? Simulation::GetRewindPosition() : 0;
+
+				if (!stopped)
+				{
+					ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+					ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+				}
+
+				ImGui::SetNextItemWidth(width);
+				if (ImGui::SliderScalar("##Instruction", ImGuiDataType_U64, &position, &first, &last, "%llu"))
+				{
+					Simulation::SeekInstruction(position);
+				}
+
+				if (!stopped)
+				{
+					ImGui::PopItemFlag();
+					ImGui::PopStyleVar();
+				}
+
+				ImGui::Separator();
+			}
+
 			ImGui::PushFont(_Font);
 
 			std::string text = "";
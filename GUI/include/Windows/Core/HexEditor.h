@@ -2,6 +2,9 @@
 
 #include "Windows/Window.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "imgui.h"
 #include "imgui_memory_editor/imgui_memory_editor.h"
 
@@ -14,6 +17,25 @@ private:
 	uint16_t start = 0x0800;
 	uint16_t end = 0xffff;
 
+	//The profile heatmap. The most cycles at any address, the colors are relative to it (on a log scale, most code runs a few times).
+	static inline double _HeatScale = 0;
+	double _HeatTime = 0;
+
+	//How often the scale is worked out again, it looks at the whole memory.
+	static constexpr double HeatInterval = 0.25;
+
+	static ImU32 HeatColor(const ImU8* data, size_t off)
+	{
+		uint16_t addr = (uint16_t)((data - Simulation::program.Memory.get()) + off);
+		uint64_t cycles = Simulation::GetProfiler().GetCycles(addr);
+
+		if (cycles == 0 || _HeatScale <= 0)
+			return 0;
+
+		double heat = std::min(1.0, std::log((double)cycles + 1) / _HeatScale);
+		return IM_COL32(255, (int)(200 * (1 - heat)), 0, 40 + (int)(140 * heat));
+	}
+
 public:
 	bool _Saved = true;
 
@@ -24,6 +46,20 @@ public:
 
 		_HexEditor.HighlightColor = 0xff707000; // IM_COL32(255, 0, 0, 255);
 
+		//Edits go through the CPU's Memory, so the block core sees that the code changed. Rewinding starts again from the edit.
+		_HexEditor.WriteFn = [](ImU8* data, size_t off, ImU8 d)
+		{
+			uint16_t addr = (uint16_t)((data - Simulation::program.Memory.get()) + off);
+
+			if (Simulation::cpu != nullptr && Simulation::cpu->GetMemory()->GetData() == Simulation::program.Memory)
+			{
+				Simulation::cpu->GetMemory()->SetDataAtAddr(addr, d);
+				Simulation::RestartRewind();
+			}
+			else
+				data[off] = d;
+		};
+
 		_Open = ConfigIni::GetInt("HexEditor", "Open", 1);
 		_Saved = _Open;
 	}
@@ -57,13 +93,13 @@ public:
 		{
 			if (Simulation::GetRunning() && (Simulation::_Stepping || Simulation::GetPaused()))
 			{
-				if (prevPC != Simulation::cpu->PC->Get() && Simulation::cpu->PC->Get() >= start)
+				if (prevPC != Simulation::cpu->PC.Get() && Simulation::cpu->PC.Get() >= start)
 				{
-					_HexEditor.HighlightMin = Simulation::cpu->PC->Get() - start;
-					_HexEditor.HighlightMax = Simulation::cpu->PC->Get() + Simulation::cpu->GetInstructionBytes() - start;
-					prevPC = Simulation::cpu->PC->Get();
+					_HexEditor.HighlightMin = Simulation::cpu->PC.Get() - start;
+					_HexEditor.HighlightMax = Simulation::cpu->PC.Get() + Simulation::cpu->GetInstructionBytes() - start;
+					prevPC = Simulation::cpu->PC.Get();
 				}
-				else if (Simulation::cpu->PC->Get() < start)
+				else if (Simulation::cpu->PC.Get() < start)
 				{
 					_HexEditor.HighlightMin = 0;
 					_HexEditor.HighlightMax = 0;
@@ -75,6 +111,24 @@ public:
 				_HexEditor.HighlightMax = 0;
 			}
 
+			//Where the cycles go, while profiling.
+			if (Simulation::GetProfiling())
+			{
+				if (ImGui::GetTime() - _HeatTime >= HeatInterval)
+				{
+					uint64_t most = 0;
+					for (int addr = 0; addr < 0x10000; addr++)
+						most = std::max(most, Simulation::GetProfiler().GetCycles((uint16_t)addr));
+
+					_HeatScale = std::log((double)most + 1);
+					_HeatTime = ImGui::GetTime();
+				}
+
+				_HexEditor.BgColorFn = HeatColor;
+			}
+			else
+				_HexEditor.BgColorFn = nullptr;
+
 			_HexEditor.DrawContents(Simulation::program.Memory.get() + start, end + 1 - start, start);
 		}
 		ImGui::End();
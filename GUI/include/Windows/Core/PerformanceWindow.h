@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Windows/Window.h"
+
+#include <cstdint>
+
+#include "perf_counters.h"
+
+//The CPU's performance counters (Emulator::CPU::GetPerfCounts()), live.
+class PerformanceWindow : public Window
+{
+private:
+	bool _Saved = true;
+
+	//The rates are worked out over the last SampleInterval seconds.
+	static constexpr double SampleInterval = 0.5;
+
+	Emulator::PerfCounts _Counts;
+	Emulator::PerfCounts _Sample;
+	double _SampleTime = 0;
+
+	double _HostNsPerEmulatedMs = 0;
+	double _LoopsPerSecond = 0;
+	double _SleepOvershootUs = 0; // Average, per sleep.
+
+	void UpdateCounts();
+
+public:
+	static PerformanceWindow* Instance;
+
+public:
+	void Init() override;
+	void Open() override;
+	void Close() override;
+	void SimulationStart() override;
+	void Render() override;
+};
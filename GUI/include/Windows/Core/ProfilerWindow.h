@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Windows/Window.h"
+
+#include "profiler.h"
+
+//Where the cycles go (Emulator::Profiler), by label, routine and call. Also puts the cycles of every line next to it in the Code Editor.
+class ProfilerWindow : public Window
+{
+private:
+	bool _Saved = true;
+
+	//The report is made again every ReportInterval seconds, it goes through the whole memory.
+	static constexpr double ReportInterval = 0.5;
+
+	//Rows of each table.
+	static constexpr int MaxRows = 32;
+
+	Emulator::ProfileReport _Report;
+	double _ReportTime = 0;
+
+	void UpdateReport();
+
+public:
+	static ProfilerWindow* Instance;
+
+public:
+	void Init() override;
+	void Open() override;
+	void Close() override;
+	void SimulationStart() override;
+	void Render() override;
+};
@@ -19,6 +19,8 @@
 #include "Windows/Core/RegistersWindow.h"
 #include "Windows/Core/HexEditor.h"
 #include "Windows/Core/Popup.h"
+#include "Windows/Core/PerformanceWindow.h"
+#include "Windows/Core/ProfilerWindow.h"
 
 #include "Windows/Peripherals/Leds.h"
 #include "Windows/Peripherals/Switches.h"
@@ -34,6 +36,8 @@ namespace Application
 		std::make_shared<Popup>(),
 		std::make_shared<HexEditor>(),
 		std::make_shared<RegistersWindow>(),
+		std::make_shared<PerformanceWindow>(),
+		std::make_shared<ProfilerWindow>(),
 		std::make_shared<SegmentDisplay>(),
 		std::make_shared<Beep8085>(),
 		std::make_shared<Keyboard>(),
@@ -117,6 +121,34 @@ namespace Application
 					Simulation::SetClock((int)(cpu_speed*1000000), cpu_accuracy);
 				}
 
+				ImGui::MenuItem("Max speed ignores the clock, as fast as possible.", 0, false, false);
+				bool maxSpeed = Simulation::GetMaxSpeed();
+				if (ImGui::Checkbox("Max speed", &maxSpeed))
+				{
+					Simulation::SetMaxSpeed(maxSpeed);
+				}
+
+				ImGui::MenuItem("Skips DELA/DELB and KIND waits, same timing.", 0, false, false);
+				bool idleSkip = Simulation::GetIdleSkip();
+				if (ImGui::Checkbox("Skip delay loops", &idleSkip))
+				{
+					Simulation::SetIdleSkip(idleSkip);
+				}
+
+				ImGui::MenuItem("Runs STDM, DELA, KIND... natively, same result.", 0, false, false);
+				bool bootloaderHle = Simulation::GetBootloaderHle();
+				if (ImGui::Checkbox("Bootloader HLE", &bootloaderHle))
+				{
+					Simulation::SetBootloaderHle(bootloaderHle);
+				}
+
+				ImGui::MenuItem("Counts real 8085 T-states, e.g. for sizing delays.", 0, false, false);
+				bool cycleExact = Simulation::GetCycleExact();
+				if (ImGui::Checkbox("Exact T-states", &cycleExact))
+				{
+					Simulation::SetCycleExact(cycleExact);
+				}
+
 				ImGui::MenuItem("CPU cycles are divided into steps.", 0, false, false);
 				ImGui::MenuItem("Warning: Too many slows the clock speed.", 0, false, false);
 				if (ImGui::DragInt("Clock Accuracy", &cpu_accuracy, 1, 10, 1000))
@@ -127,11 +159,36 @@ namespace Application
 					Simulation::SetClock((int)(cpu_speed * 1000000), cpu_accuracy);
 				}
 
+				ImGui::MenuItem("Memory for Step Back and Reverse, e.g. 64 MB. 0 (off) by default.", 0, false, false);
+				ImGui::MenuItem("Applies on the next run.", 0, false, false);
+				int rewindBudget = Simulation::GetRewindBudget();
+				if (ImGui::DragInt("Rewind budget", &rewindBudget, 1, 0, 1024, "%d MB"))
+				{
+					if (rewindBudget < 0)
+						rewindBudget = 0;
+
+					Simulation::SetRewindBudget(rewindBudget);
+				}
+
+				ImGui::MenuItem("Reference is slower, only useful for debugging the emulator.", 0, false, false);
+				ImGui::MenuItem("Applies on the next run.", 0, false, false);
+				int core = Simulation::GetCore();
+				if (ImGui::Combo("CPU core", &core, "Reference\0Switch\0Block cache\0JIT (x86-64)\0"))
+				{
+					Simulation::SetCore((Emulator::CPUCores)core);
+				}
+
 				
 
 				ImGui::EndMenu();
 			}
 
+			if (Simulation::GetRunning())
+			{
+				ImGui::Separator();
+				ImGui::Text("%.1f MIPS, %.2f mhz", Simulation::GetInstructionsPerSecond() / 1000000.0, Simulation::GetEmulatedMHz());
+			}
+
 			ImGui::EndMainMenuBar();
 		}
 
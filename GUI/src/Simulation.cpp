@@ -1,5 +1,6 @@
 #include "Simulation.h"
 
+#include <chrono>
 #include <iostream>
 
 #include "Application.h"
@@ -19,6 +20,51 @@ namespace Simulation {
 
 	int CPU_Speed;
 	int CPU_Accuracy;
+	int CPU_Core;
+
+	std::atomic<bool> MaxSpeed = false;
+	std::atomic<bool> IdleSkip = false;
+	std::atomic<bool> BootloaderHle = false;
+	std::atomic<bool> CycleExact = false;
+	std::atomic<bool> OpcodeCounting = false;
+
+	//See SetProfiling(). Like _Rewind, lives as long as the program.
+	std::atomic<bool> Profiling = false;
+	Emulator::Profiler _Profiler;
+	std::atomic<bool> _ProfileReset = false;
+
+	//See SetRewindBudget(). _Rewind lives as long as the program, the GUI reads its position while the simulation thread runs.
+	std::atomic<int> RewindBudget = 0; // Off until it's turned on in Options, recording costs memory and time.
+	Emulator::Rewind _Rewind;
+	std::atomic<bool> _Rewinding = false;
+	std::atomic<bool> _RewindRestart = false;
+
+	//For the simulation thread, see StepBack().
+	enum RewindCommands
+	{
+		RewindNone = 0,
+		RewindStepBack,
+		RewindReverseContinue,
+		RewindSeek
+	};
+
+	std::atomic<int> _RewindCommand = RewindNone;
+	std::atomic<uint64_t> _RewindTarget = 0;
+
+	std::atomic<double> _InstructionsPerSecond = 0;
+	std::atomic<double> _EmulatedMHz = 0;
+
+	//How often the numbers above are updated.
+	const auto TelemetryInterval = std::chrono::milliseconds(250);
+
+	//The clock, or one big slice per Loop() at max speed.
+	void ApplyClock()
+	{
+		if (MaxSpeed)
+			cpu->SetClock(MaxSpeedCyclesPerCheck, 1);
+		else
+			cpu->SetClock(CPU_Speed, CPU_Accuracy);
+	}
 
 	void Assemble(std::string text)
 	{
@@ -42,6 +88,8 @@ namespace Simulation {
 			cpu->SetHalted(false);
 			_Stepping = false;
 			Paused = false;
+
+			cpu->Wake();
 		}
 		else if (cpu == nullptr || !cpu->GetRunning())
 		{
@@ -73,13 +121,153 @@ namespace Simulation {
 
 		if (GetRunning() && cpu != nullptr)
 		{
-			cpu->SetClock(CPU_Speed, CPU_Accuracy);
+			ApplyClock();
 		}
 	}
 
 	int GetClock() { return CPU_Speed; }
 	int GetAccuracy() { return CPU_Accuracy; }
 
+	//Only takes effect the next time the simulation starts.
+	void SetCore(Emulator::CPUCores core)
+	{
+		CPU_Core = core;
+
+		ConfigIni::SetInt("Simulation", "CPU_Core", core);
+	}
+
+	Emulator::CPUCores GetCore() { return (Emulator::CPUCores)CPU_Core; }
+
+	void SetMaxSpeed(bool maxSpeed)
+	{
+		MaxSpeed = maxSpeed;
+
+		ConfigIni::SetInt("Simulation", "MaxSpeed", maxSpeed);
+
+		if (GetRunning() && cpu != nullptr)
+		{
+			ApplyClock();
+		}
+	}
+
+	bool GetMaxSpeed() { return MaxSpeed; }
+
+	void SetIdleSkip(bool idleSkip)
+	{
+		IdleSkip = idleSkip;
+
+		ConfigIni::SetInt("Simulation", "IdleSkip", idleSkip);
+
+		if (GetRunning() && cpu != nullptr)
+		{
+			cpu->SetIdleSkip(idleSkip);
+		}
+	}
+
+	bool GetIdleSkip() { return IdleSkip; }
+
+	void SetBootloaderHle(bool bootloaderHle)
+	{
+		BootloaderHle = bootloaderHle;
+
+		ConfigIni::SetInt("Simulation", "BootloaderHle", bootloaderHle);
+
+		if (GetRunning() && cpu != nullptr)
+		{
+			cpu->SetBootloaderHle(bootloaderHle);
+		}
+	}
+
+	bool GetBootloaderHle() { return BootloaderHle; }
+
+	void SetCycleExact(bool cycleExact)
+	{
+		CycleExact = cycleExact;
+
+		ConfigIni::SetInt("Simulation", "CycleExact", cycleExact);
+
+		if (GetRunning() && cpu != nullptr)
+		{
+			cpu->SetCycleExact(cycleExact);
+
+			//The recorded instructions would take other cycles now.
+			RestartRewind();
+		}
+	}
+
+	bool GetCycleExact() { return CycleExact; }
+
+	void SetOpcodeCounting(bool opcodeCounting)
+	{
+		OpcodeCounting = opcodeCounting;
+
+		ConfigIni::SetInt("Simulation", "OpcodeCounting", opcodeCounting);
+
+		if (GetRunning() && cpu != nullptr)
+		{
+			cpu->SetOpcodeCounting(opcodeCounting);
+		}
+	}
+
+	bool GetOpcodeCounting() { return OpcodeCounting; }
+
+	void SetProfiling(bool profiling)
+	{
+		Profiling = profiling;
+
+		ConfigIni::SetInt("Simulation", "Profiling", profiling);
+	}
+
+	bool GetProfiling() { return Profiling; }
+
+	void ResetProfile()
+	{
+		//The simulation thread clears it, it's the only one writing to it.
+		if (GetRunning())
+			_ProfileReset = true;
+		else
+			_Profiler.Clear();
+	}
+
+	Emulator::Profiler& GetProfiler() { return _Profiler; }
+
+	void SetRewindBudget(int megabytes)
+	{
+		RewindBudget = megabytes;
+
+		ConfigIni::SetInt("Simulation", "RewindBudget", megabytes);
+	}
+
+	int GetRewindBudget() { return RewindBudget; }
+
+	void RewindCommand(RewindCommands command, uint64_t target = 0)
+	{
+		if (cpu == nullptr || !_Rewinding)
+			return;
+
+		_RewindTarget = target;
+		_RewindCommand = command;
+
+		cpu->Wake();
+	}
+
+	void StepBack() { RewindCommand(RewindStepBack); }
+	void ReverseContinue() { RewindCommand(RewindReverseContinue); }
+	void SeekInstruction(uint64_t instruction) { RewindCommand(RewindSeek, instruction); }
+
+	bool CanRewind() { return _Rewinding; }
+	uint64_t GetRewindFirst() { return _Rewind.GetFirst(); }
+	uint64_t GetRewindLast() { return _Rewind.GetLast(); }
+	uint64_t GetRewindPosition() { return _Rewind.GetPosition(); }
+
+	void RestartRewind()
+	{
+		_RewindRestart = true;
+	}
+
+	double GetInstructionsPerSecond() { return _InstructionsPerSecond; }
+	double GetEmulatedMHz() { return _EmulatedMHz; }
+
 	void Stop()
 	{
 		if (cpu != nullptr)
@@ -88,6 +276,8 @@ namespace Simulation {
 			cpu->SetHalted(false);
 			Paused = false;
 			_Stepping = false;
+
+			cpu->Wake();
 		}
 
 		if (t.joinable())
@@ -118,14 +308,23 @@ namespace Simulation {
 		else
 		{
 			_ScheduledStep = true; // Step isn't instant. It's buffered.
+			cpu->Wake();
 		}
 	}
 
 	void Init()
 	{	
-		program.Memory = std::shared_ptr<uint8_t>((uint8_t*)calloc(0xffff, sizeof(uint8_t)), free);
+		program.Memory = std::shared_ptr<uint8_t>((uint8_t*)calloc(0xffff + 1, sizeof(uint8_t)), free);
 		CPU_Speed = ConfigIni::GetInt("Simulation", "CPU_Speed", 3200000);
 		CPU_Accuracy = ConfigIni::GetInt("Simulation", "CPU_Accuracy", 500);
+		CPU_Core = ConfigIni::GetInt("Simulation", "CPU_Core", Emulator::SwitchCore);
+		MaxSpeed = ConfigIni::GetInt("Simulation", "MaxSpeed", 0) != 0;
+		IdleSkip = ConfigIni::GetInt("Simulation", "IdleSkip", 0) != 0;
+		BootloaderHle = ConfigIni::GetInt("Simulation", "BootloaderHle", 0) != 0;
+		CycleExact = ConfigIni::GetInt("Simulation", "CycleExact", 0) != 0;
+		OpcodeCounting = ConfigIni::GetInt("Simulation", "OpcodeCounting", 0) != 0;
+		RewindBudget = ConfigIni::GetInt("Simulation", "RewindBudget", 0);
+		Profiling = ConfigIni::GetInt("Simulation", "Profiling", 0) != 0;
 	}
 
 	bool HasSymbols(Assembler::Assembly program, uint16_t addr)
@@ -141,17 +340,79 @@ namespace Simulation {
 		return false;
 	}
 
+	//On the simulation thread, paused or stepping. See StepBack().
+	void RunRewindCommand(int command)
+	{
+		switch (command)
+		{
+		case RewindStepBack:
+		{
+			std::vector<bool> hasSymbol(0xffff + 1);
+
+			for (auto& symbol : program.Symbols)
+			{
+				hasSymbol[symbol.first] = true;
+			}
+
+			_Rewind.SeekBack(cpu.get(), [](Emulator::CPU* cpu, void* ctx) { return (bool)(*(std::vector<bool>*)ctx)[cpu->PC.Get()]; }, &hasSymbol);
+			break;
+		}
+
+		case RewindReverseContinue:
+			_Rewind.SeekBack(cpu.get(), [](Emulator::CPU* cpu, void* ctx) { return cpu->_BreakpointMap.Check(cpu->PC.Get()); }, nullptr);
+			break;
+
+		case RewindSeek:
+			_Rewind.Seek(cpu.get(), _RewindTarget);
+			break;
+		}
+
+		//Stays where it is until Run or Step.
+		if (!_Stepping)
+		{
+			cpu->SetHalted(true);
+			Paused = true;
+		}
+	}
+
 	void thread()
 	{
 		//Create CPU.
-		cpu = std::make_shared<Emulator::CPU>(program.Memory, 0xffff, CodeEditor::Instance->editor._Breakpoints, program.Symbols);
+		cpu = std::make_shared<Emulator::CPU>(program.Memory, 0xffff + 1, CodeEditor::Instance->editor._Breakpoints, program.Symbols, GetCore());
 
-		cpu->SetClock(CPU_Speed, CPU_Accuracy);
+		ApplyClock();
+		cpu->SetIdleSkip(IdleSkip);
+		cpu->SetBootloaderLabels(program.Labels);
+		cpu->SetBootloaderHle(BootloaderHle);
+		cpu->SetCycleExact(CycleExact);
+		cpu->SetOpcodeCounting(OpcodeCounting);
+
+		//A new run, a new profile.
+		_Profiler.Clear();
+		_ProfileReset = false;
+		cpu->SetProfiler(Profiling ? &_Profiler : nullptr);
 
 		Application::SimulationStart();
 
 		auto _StartOfFrame = std::chrono::system_clock::now();
 
+		//Telemetry
+		auto _LastSample = std::chrono::steady_clock::now();
+		uint64_t _SampleInstructions = 0;
+		uint64_t _SampleCycles = 0;
+
+		//The clock keeps running in HLT, CPU_Speed cycles a second. What's left over from dividing by CPU_Accuracy is kept for the next frames.
+		uint64_t _HaltedRemainder = 0;
+		auto addHaltedFrames = [&](long long frames)
+		{
+			if (_Rewinding)
+				_Rewind.Resume(cpu.get());
+
+			_HaltedRemainder += (uint64_t)frames * CPU_Speed;
+			cpu->AddHaltedCycles(_HaltedRemainder / CPU_Accuracy);
+			_HaltedRemainder %= CPU_Accuracy;
+		};
+
 		//----- Set the INTR_ADDR to the address of the label "INTR_ROUTINE"
 		//maybe find a better way?
 		auto &labels = program.Labels;
@@ -160,7 +421,7 @@ namespace Simulation {
 		{
 			if (labels.at(i).first == "INTR_ROUTINE")
 			{
-				cpu->INTR_ADDR = labels.at(i).second;
+				cpu->State.INTR_ADDR = labels.at(i).second;
 			}
 		}
 		//-----
@@ -169,13 +430,59 @@ namespace Simulation {
 		cpu->SetHalted(false);
 		Paused = false;
 
+		//Reverse debugging, see SetRewindBudget(). The peripherals added their state handlers in SimulationStart().
+		_Rewinding = RewindBudget > 0;
+		_RewindRestart = false;
+		_RewindCommand = RewindNone;
+
+		if (_Rewinding)
+		{
+			_Rewind.SetBudget((size_t)RewindBudget * 1024 * 1024);
+			_Rewind.Start(cpu.get());
+		}
+
 		while (cpu->GetRunning())
 		{
+			//Before looking at anything. A wake up after this doesn't get lost, see the end of the loop.
+			uint64_t wakes = cpu->GetWakes();
+
+			//See SetProfiling(). It can be turned on and off while it runs.
+			if (_ProfileReset.exchange(false))
+			{
+				_Profiler.Clear();
+			}
+
+			if (Profiling != (cpu->GetProfiler() != nullptr))
+			{
+				cpu->SetProfiler(Profiling ? &_Profiler : nullptr);
+			}
+
+			if (_Rewinding)
+			{
+				if (_RewindRestart.exchange(false))
+				{
+					_Rewind.Start(cpu.get());
+				}
+
+				int command = _RewindCommand.exchange(RewindNone);
+
+				if (command != RewindNone && (Paused || cpu->GetHalted() || _Stepping))
+				{
+					RunRewindCommand(command);
+				}
+			}
+
 			if (cpu->GetRunning() && !cpu->GetHalted() && !Paused && !_Stepping)
 			{
 				try // Loop inside try / catch in cases of errors, crashes.
 				{
+					if (_Rewinding)
+						_Rewind.Resume(cpu.get());
+
 					cpu->Loop();
+
+					if (_Rewinding)
+						_Rewind.Record(cpu.get());
 				}
 				catch(...)
 				{
@@ -196,11 +503,17 @@ namespace Simulation {
 					// Probably should add an option to enable/disable that. TODO
 
 					// BUT. If we have symbols on that address, it means it's user code, added using "ORG". So we don't skip it. 
-					while (_ScheduledStep || (_Stepping && GetRunning() && !HasSymbols(program, cpu->PC->Get())))
+					while (_ScheduledStep || (_Stepping && GetRunning() && !HasSymbols(program, cpu->PC.Get())))
 					{
+						if (_Rewinding)
+							_Rewind.Resume(cpu.get());
+
 						cpu->Step(program.Symbols);
 						_ScheduledStep = false;
 
+						if (_Rewinding)
+							_Rewind.Record(cpu.get());
+
 						_StartOfFrame += std::chrono::microseconds(1000000 / CPU_Accuracy);
 						std::this_thread::sleep_until(_StartOfFrame);
 					}
@@ -217,8 +530,16 @@ namespace Simulation {
 
 			
 			// Check for interrupts, even it we're halted but not when paused.
+			// RaiseInterrupt() only makes them pending once the events run, Loop() doesn't run while halted.
+			// Not while stepping back either, until the next step: that would start recording from there.
+			bool rewound = _Rewinding && _Rewind.IsRewound();
+
+			if (!Paused && !rewound)
+			{
+				cpu->RunEvents();
+			}
 
-			if (!Paused && cpu->Interrupts())
+			if (!Paused && !rewound && cpu->Interrupts())
 			{
 				if (!_Stepping)
 				{
@@ -226,16 +547,74 @@ namespace Simulation {
 				}
 			}
 
-			//Sleep until appropriate times has passed since START OF FRAME. 
-			//Not from now. This accounts for the time it takes for the clock/loop to run.
-			_StartOfFrame += std::chrono::microseconds(1000000 / CPU_Accuracy);
-			std::this_thread::sleep_until(_StartOfFrame);
+			auto now = std::chrono::steady_clock::now();
+			if (now - _LastSample >= TelemetryInterval)
+			{
+				double seconds = std::chrono::duration<double>(now - _LastSample).count();
+
+				_InstructionsPerSecond = (cpu->State.TotalInstructions - _SampleInstructions) / seconds;
+				_EmulatedMHz = (cpu->State.TotalCycles - _SampleCycles) / seconds / 1000000.0;
+
+				_LastSample = now;
+				_SampleInstructions = cpu->State.TotalInstructions;
+				_SampleCycles = cpu->State.TotalCycles;
+			}
+
+			//Only waiting for input (KIND): sleep like at the normal clock, nothing changes until a key is pressed.
+			if (MaxSpeed && cpu->GetRunning() && !cpu->GetHalted() && !Paused && !_Stepping && !cpu->IsIdle())
+			{
+				//No sleeping at max speed. If it's switched off, the clock starts again from here.
+				_StartOfFrame = std::chrono::system_clock::now();
+			}
+			else
+			{
+				auto frame = std::chrono::microseconds(1000000 / CPU_Accuracy);
+				bool hlt = cpu->GetWaitingForInterrupt() && !Paused && !_Stepping;
+
+				//Nothing runs until an interrupt, or until Run, Step or Stop: in HLT, on a breakpoint, paused, between steps.
+				//Wait for that instead of waking up every frame. Only the telemetry wakes us up in between.
+				if (cpu->GetRunning() && (cpu->GetHalted() || Paused || (_Stepping && !_ScheduledStep)))
+				{
+					cpu->WaitForWake(wakes, _LastSample + TelemetryInterval);
+
+					//The frames we slept through, so the frames stay where they would have been.
+					long long frames = (std::chrono::system_clock::now() - _StartOfFrame) / frame;
+					if (frames > 0)
+					{
+						_StartOfFrame += frames * frame;
+
+						if (hlt)
+							addHaltedFrames(frames);
+					}
+				}
+
+				if (hlt)
+					addHaltedFrames(1);
+
+				//Sleep until appropriate times has passed since START OF FRAME. 
+				//Not from now. This accounts for the time it takes for the clock/loop to run.
+				_StartOfFrame += frame;
+				std::this_thread::sleep_until(_StartOfFrame);
+
+				//How late the OS woke us up, for the performance counters. Behind already (the frame took too long): 0.
+				auto late = std::chrono::system_clock::now() - _StartOfFrame;
+				cpu->AddSleep(late.count() > 0 ? std::chrono::duration_cast<std::chrono::nanoseconds>(late).count() : 0);
+			}
 		}
 		
 		//Update buffers before deleting CPU.
 		RegistersWindow::Instance->UpdateBuffers(true);
 
+		if (_Rewinding)
+		{
+			_Rewinding = false;
+			_Rewind.Stop(cpu.get());
+		}
+
 		cpu = nullptr;
 		Paused = false;
+
+		_InstructionsPerSecond = 0;
+		_EmulatedMHz = 0;
 	}
 }
\ No newline at end of file
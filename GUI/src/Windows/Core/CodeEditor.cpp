@@ -348,7 +348,7 @@ void CodeEditor::Render()
 
 		for (int i = 0; i < symbols.size(); i++)
 		{
-			if (symbols.at(i).first == Simulation::cpu->PC->Get())
+			if (symbols.at(i).first == Simulation::cpu->PC.Get())
 			{
 				editor.CurrentLine = symbols.at(i).second - 1;
 			}
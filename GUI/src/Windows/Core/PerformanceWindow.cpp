@@ -0,0 +1,166 @@
+#include "Windows/Core/PerformanceWindow.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "imgui.h"
+#include "Simulation.h"
+#include "ConfigIni.h"
+#include "CPUinstructions.h"
+
+PerformanceWindow* PerformanceWindow::Instance;
+
+void PerformanceWindow::Init()
+{
+	Instance = this;
+
+	IncludeInWindows = true;
+	Name = "Performance";
+
+	_Open = ConfigIni::GetInt("Performance", "Open", 0);
+	_Saved = _Open;
+}
+
+void PerformanceWindow::Open()
+{
+	_Open = true;
+	ConfigIni::SetInt("Performance", "Open", 1);
+}
+
+void PerformanceWindow::Close()
+{
+	if (!_Open && _Open == _Saved)
+		return;
+
+	_Open = false;
+	_Saved = false;
+	ConfigIni::SetInt("Performance", "Open", 0);
+}
+
+void PerformanceWindow::SimulationStart()
+{
+	//A new CPU, counting from 0.
+	_Counts = Emulator::PerfCounts();
+	_Sample = Emulator::PerfCounts();
+	_SampleTime = ImGui::GetTime();
+
+	_HostNsPerEmulatedMs = 0;
+	_LoopsPerSecond = 0;
+	_SleepOvershootUs = 0;
+}
+
+void PerformanceWindow::UpdateCounts()
+{
+	std::shared_ptr<Emulator::CPU> cpu = Simulation::cpu;
+
+	if (cpu == nullptr)
+		return;
+
+	_Counts = cpu->GetPerfCounts();
+
+	double now = ImGui::GetTime();
+	double seconds = now - _SampleTime;
+
+	if (seconds < SampleInterval)
+		return;
+
+	Emulator::PerfCounts delta;
+	delta.LoopNs = _Counts.LoopNs - _Sample.LoopNs;
+	delta.LoopCycles = _Counts.LoopCycles - _Sample.LoopCycles;
+
+	_HostNsPerEmulatedMs = delta.HostNsPerEmulatedMs(Simulation::GetClock());
+	_LoopsPerSecond = (_Counts.Loops - _Sample.Loops) / seconds;
+
+	uint64_t sleeps = _Counts.Sleeps - _Sample.Sleeps;
+	_SleepOvershootUs = sleeps == 0 ? 0 : (_Counts.SleepOvershootNs - _Sample.SleepOvershootNs) / 1000.0 / sleeps;
+
+	_Sample = _Counts;
+	_SampleTime = now;
+}
+
+void PerformanceWindow::Render()
+{
+	if (!_Open)
+	{
+		Close();
+		return;
+	}
+
+	if (Simulation::GetRunning())
+	{
+		UpdateCounts();
+	}
+
+	ImGui::Begin("Performance", &_Open);
+	{
+		ImGui::Text("%.2f MIPS, %.3f mhz", Simulation::GetInstructionsPerSecond() / 1000000.0, Simulation::GetEmulatedMHz());
+
+		//How much of the host the emulation takes: 1000000 ns per emulated ms is exactly real time, with no time left to sleep.
+		ImGui::Text("%.0f ns of host time per emulated ms (%.1f%%)", _HostNsPerEmulatedMs, _HostNsPerEmulatedMs / 10000.0);
+		ImGui::Text("%.0f loops/s, sleeps wake up %.1f us late", _LoopsPerSecond, _SleepOvershootUs);
+		ImGui::Text("%llu instructions, %llu cycles", (unsigned long long)_Counts.Instructions, (unsigned long long)_Counts.Cycles);
+
+		bool countOpcodes = Simulation::GetOpcodeCounting();
+		if (ImGui::Checkbox("Count opcodes", &countOpcodes))
+		{
+			Simulation::SetOpcodeCounting(countOpcodes);
+		}
+
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("Needs the interpreter: the JIT core runs as the block core while it's on.");
+		}
+
+		//Most used first.
+		auto table = [](const char* id, const char* name, const uint64_t* counts, int size, int rows, bool opcodes)
+		{
+			int order[256];
+			for (int i = 0; i < size; i++)
+				order[i] = i;
+
+			std::stable_sort(order, order + size, [&](int a, int b) { return counts[a] > counts[b]; });
+
+			if (ImGui::BeginTable(id, 2, ImGuiTableFlags_Borders))
+			{
+				ImGui::TableSetupColumn(name);
+				ImGui::TableSetupColumn("Count");
+				ImGui::TableHeadersRow();
+
+				for (int i = 0; i < size && i < rows && counts[order[i]] != 0; i++)
+				{
+					ImGui::TableNextRow();
+
+					ImGui::TableSetColumnIndex(0);
+					if (opcodes)
+						ImGui::Text("%02XH %s", order[i], InternalEmulator::CPUInstructions[order[i]].OPERAND);
+					else
+						ImGui::Text("%02XH", order[i]);
+
+					ImGui::TableSetColumnIndex(1);
+					ImGui::Text("%llu", (unsigned long long)counts[order[i]]);
+				}
+
+				ImGui::EndTable();
+			}
+		};
+
+		if (ImGui::CollapsingHeader("Interrupts", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGui::Text("RST 7.5: %llu  RST 6.5: %llu  RST 5.5: %llu  INTR: %llu",
+				(unsigned long long)_Counts.Interrupts[Emulator::Interrupt75], (unsigned long long)_Counts.Interrupts[Emulator::Interrupt65],
+				(unsigned long long)_Counts.Interrupts[Emulator::Interrupt55], (unsigned long long)_Counts.Interrupts[Emulator::InterruptINTR]);
+		}
+
+		if (ImGui::CollapsingHeader("Ports"))
+		{
+			table("PerfIn", "IN", _Counts.In, 256, 8, false);
+			table("PerfOut", "OUT", _Counts.Out, 256, 8, false);
+		}
+
+		if (countOpcodes && ImGui::CollapsingHeader("Opcodes", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			table("PerfOpcodes", "Opcode", _Counts.Opcodes, 256, 16, true);
+		}
+	}
+	ImGui::End();
+}
@@ -0,0 +1,209 @@
+#include "Windows/Core/ProfilerWindow.h"
+
+#include <algorithm>
+
+#include "imgui.h"
+#include "Simulation.h"
+#include "ConfigIni.h"
+#include "Windows/Core/CodeEditor.h"
+
+ProfilerWindow* ProfilerWindow::Instance;
+
+void ProfilerWindow::Init()
+{
+	Instance = this;
+
+	IncludeInWindows = true;
+	Name = "Profiler";
+
+	_Open = ConfigIni::GetInt("Profiler", "Open", 0);
+	_Saved = _Open;
+}
+
+void ProfilerWindow::Open()
+{
+	_Open = true;
+	ConfigIni::SetInt("Profiler", "Open", 1);
+}
+
+void ProfilerWindow::Close()
+{
+	if (!_Open && _Open == _Saved)
+		return;
+
+	_Open = false;
+	_Saved = false;
+	ConfigIni::SetInt("Profiler", "Open", 0);
+}
+
+void ProfilerWindow::SimulationStart()
+{
+	//The profile was cleared, show that on the next frame.
+	_ReportTime = 0;
+}
+
+void ProfilerWindow::UpdateReport()
+{
+	_Report = Simulation::GetProfiler().GetReport(Simulation::program.Labels, Simulation::program.Symbols);
+	_ReportTime = ImGui::GetTime();
+
+	//Symbols have the line numbers from 1.
+	TextEditor& editor = CodeEditor::Instance->editor;
+	editor._LineCycles.assign(editor.GetTotalLines(), 0);
+	editor._LineCyclesMost = 0;
+
+	for (auto& line : _Report.Lines)
+	{
+		if (line.first < 1 || line.first > (int)editor._LineCycles.size())
+			continue;
+
+		editor._LineCycles[line.first - 1] = line.second.Cycles;
+		editor._LineCyclesMost = std::max(editor._LineCyclesMost, line.second.Cycles);
+	}
+}
+
+void ProfilerWindow::Render()
+{
+	//Even when the window is closed, for the Code Editor.
+	if (Simulation::GetProfiling())
+	{
+		if (_ReportTime == 0 || ImGui::GetTime() - _ReportTime >= ReportInterval)
+			UpdateReport();
+	}
+	else if (!CodeEditor::Instance->editor._LineCycles.empty())
+	{
+		CodeEditor::Instance->editor._LineCycles.clear();
+		_ReportTime = 0;
+	}
+
+	if (!_Open)
+	{
+		Close();
+		return;
+	}
+
+	ImGui::Begin("Profiler", &_Open);
+	{
+		bool profiling = Simulation::GetProfiling();
+		if (ImGui::Checkbox("Profile", &profiling))
+		{
+			Simulation::SetProfiling(profiling);
+		}
+
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("Needs every instruction: the JIT core runs as the block core, idle loop skipping and the bootloader HLE are off while it's on.");
+		}
+
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+		{
+			Simulation::ResetProfile();
+			_ReportTime = 0;
+		}
+
+		ImGui::Text("%llu instructions, %llu cycles", (unsigned long long)_Report.Total.Instructions, (unsigned long long)_Report.Total.Cycles);
+
+		double total = _Report.Total.Cycles > 0 ? (double)_Report.Total.Cycles : 1.0;
+
+		auto cyclesColumns = [&](uint64_t cycles)
+		{
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", (unsigned long long)cycles);
+
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", cycles * 100.0 / total);
+		};
+
+		//Most cycles first, the report is sorted.
+		if (ImGui::CollapsingHeader("Labels", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (ImGui::BeginTable("ProfileLabels", 4, ImGuiTableFlags_Borders))
+			{
+				ImGui::TableSetupColumn("Label");
+				ImGui::TableSetupColumn("Instructions");
+				ImGui::TableSetupColumn("Cycles");
+				ImGui::TableSetupColumn("%");
+				ImGui::TableHeadersRow();
+
+				for (int i = 0; i < (int)_Report.Labels.size() && i < MaxRows; i++)
+				{
+					auto& label = _Report.Labels[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%s (%04XH)", label.Name.c_str(), label.Address);
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)label.Count.Instructions);
+
+					cyclesColumns(label.Count.Cycles);
+				}
+
+				ImGui::EndTable();
+			}
+		}
+
+		//With everything they called.
+		if (ImGui::CollapsingHeader("Routines", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (ImGui::BeginTable("ProfileRoutines", 4, ImGuiTableFlags_Borders))
+			{
+				ImGui::TableSetupColumn("Routine");
+				ImGui::TableSetupColumn("Calls");
+				ImGui::TableSetupColumn("Cycles");
+				ImGui::TableSetupColumn("%");
+				ImGui::TableHeadersRow();
+
+				for (int i = 0; i < (int)_Report.Routines.size() && i < MaxRows; i++)
+				{
+					auto& routine = _Report.Routines[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::Text("%s (%04XH)", routine.Name.c_str(), routine.Address);
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)routine.Calls);
+
+					cyclesColumns(routine.Cycles);
+				}
+
+				ImGui::EndTable();
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Calls"))
+		{
+			if (ImGui::BeginTable("ProfileCalls", 5, ImGuiTableFlags_Borders))
+			{
+				ImGui::TableSetupColumn("Caller");
+				ImGui::TableSetupColumn("Callee");
+				ImGui::TableSetupColumn("Calls");
+				ImGui::TableSetupColumn("Cycles");
+				ImGui::TableSetupColumn("%");
+				ImGui::TableHeadersRow();
+
+				for (int i = 0; i < (int)_Report.Calls.size() && i < MaxRows; i++)
+				{
+					auto& call = _Report.Calls[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(call.Caller.c_str());
+
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(call.Callee.c_str());
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)call.Calls);
+
+					cyclesColumns(call.Cycles);
+				}
+
+				ImGui::EndTable();
+			}
+		}
+	}
+	ImGui::End();
+}
@@ -25,22 +25,22 @@ void RegistersWindow::UpdateBuffers(bool force)
 		return;
 	}
 
-	A = Simulation::cpu->A->GetUnsigned();
-	B = Simulation::cpu->B->GetUnsigned();
-	C = Simulation::cpu->C->GetUnsigned();
-	D = Simulation::cpu->D->GetUnsigned();
-	E = Simulation::cpu->E->GetUnsigned();
-	H = Simulation::cpu->H->GetUnsigned();
-	L = Simulation::cpu->L->GetUnsigned();
+	A = Simulation::cpu->A.GetUnsigned();
+	B = Simulation::cpu->B.GetUnsigned();
+	C = Simulation::cpu->C.GetUnsigned();
+	D = Simulation::cpu->D.GetUnsigned();
+	E = Simulation::cpu->E.GetUnsigned();
+	H = Simulation::cpu->H.GetUnsigned();
+	L = Simulation::cpu->L.GetUnsigned();
 	M = Simulation::cpu->GetUnsignedM();
 
-	Sign_flag = Simulation::cpu->Flags->GetBit(SIGN_FLAG);
-	Zero_flag = Simulation::cpu->Flags->GetBit(ZERO_FLAG);
-	Parity_flag = Simulation::cpu->Flags->GetBit(PARITY_FLAG);
-	Carry_flag = Simulation::cpu->Flags->GetBit(CARRY_FLAG);
+	Sign_flag = Simulation::cpu->Flags.GetBit(SIGN_FLAG);
+	Zero_flag = Simulation::cpu->Flags.GetBit(ZERO_FLAG);
+	Parity_flag = Simulation::cpu->Flags.GetBit(PARITY_FLAG);
+	Carry_flag = Simulation::cpu->Flags.GetBit(CARRY_FLAG);
 
-	PC = Simulation::cpu->PC->Get();
-	SP = Simulation::cpu->SP->Get();
+	PC = Simulation::cpu->PC.Get();
+	SP = Simulation::cpu->SP.Get();
 
 	updating = false;
 }
@@ -1,5 +1,7 @@
 #include "Windows/Peripherals/7SegmentDisplay.h"
 
+#include <algorithm>
+
 #include "imgui.h"
 
 #include "Backend/GUI_backend.h"
@@ -84,6 +86,20 @@ void SegmentDisplay::SimulationStart()
 	Simulation::cpu->AddIOInterface(0x55, Char6, nullptr);
 	Simulation::cpu->AddIOInterface(0x56, Show, nullptr);
 
+	//Snapshots (Emulator::CPU::SaveState()): the characters and how many of them are shown.
+	Simulation::cpu->AddStateHandler({
+		[](void*, std::vector<uint8_t>& state)
+		{
+			state.insert(state.end(), SegmentDisplay::Instance->chars, SegmentDisplay::Instance->chars + 6);
+			state.push_back((uint8_t)SegmentDisplay::Instance->show);
+		},
+		[](void*, const std::vector<uint8_t>& state)
+		{
+			std::copy(state.begin(), state.begin() + 6, SegmentDisplay::Instance->chars);
+			SegmentDisplay::Instance->show = state.at(6);
+		},
+		nullptr });
+
 	chars[0] = '\0';
 	chars[1] = '\0';
 	chars[2] = '\0';
@@ -143,6 +143,12 @@ void Keyboard::SimulationStart()
 
 	Simulation::cpu->AddIOInterface(0x28, SetScanLine, nullptr);
 	Simulation::cpu->AddIOInterface(0x18, nullptr, GetKeys);
+
+	//Snapshots (Emulator::CPU::SaveState()): the scan line the program selected. The keys pressed are the user's, not saved.
+	Simulation::cpu->AddStateHandler({
+		[](void*, std::vector<uint8_t>& state) { state.push_back(Keyboard::Instance->Scan); },
+		[](void*, const std::vector<uint8_t>& state) { Keyboard::Instance->Scan = state.at(0); },
+		nullptr });
 }
 
 void Keyboard::Render()
@@ -209,7 +215,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 
 		} ImGui::SameLine();
@@ -220,7 +226,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -230,7 +236,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -240,7 +246,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		}
 
@@ -252,7 +258,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -263,7 +269,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -273,7 +279,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -283,7 +289,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		}
 
@@ -295,7 +301,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -305,7 +311,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -315,7 +321,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -325,7 +331,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		}
 
@@ -337,7 +343,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -347,7 +353,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -357,7 +363,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		} ImGui::SameLine();
 
@@ -367,7 +373,7 @@ void Keyboard::Render()
 
 			if (Simulation::GetRunning())
 			{
-				Simulation::cpu->_IP55 = true;
+				Simulation::cpu->RaiseInterrupt(Emulator::Interrupt55);
 			}
 		}
 	}
@@ -38,6 +38,12 @@ void Leds::Close()
 void Leds::SimulationStart()
 {
 	Simulation::cpu->AddIOInterface(0x30, [](uint8_t val) { Leds::Instance->ledValues = val; }, nullptr);
+
+	//Snapshots (Emulator::CPU::SaveState()) light the LEDs that were lit.
+	Simulation::cpu->AddStateHandler({
+		[](void*, std::vector<uint8_t>& state) { state.push_back(Leds::Instance->ledValues); },
+		[](void*, const std::vector<uint8_t>& state) { Leds::Instance->ledValues = state.at(0); },
+		nullptr });
 	ledValues = 0xff;
 }
 
@@ -91,6 +91,7 @@ struct MemoryEditor
     ImU8            (*ReadFn)(const ImU8* data, size_t off);    // = 0      // optional handler to read bytes.
     void            (*WriteFn)(ImU8* data, size_t off, ImU8 d); // = 0      // optional handler to write bytes.
     bool            (*HighlightFn)(const ImU8* data, size_t off);//= 0      // optional handler to return Highlight property (to support non-contiguous highlighting).
+    ImU32           (*BgColorFn)(const ImU8* data, size_t off); // = 0      // optional handler to return custom background color of individual bytes (0 for none).
 
     // [Internal State]
     bool            ContentsWidthChanged;
@@ -123,6 +124,7 @@ struct MemoryEditor
         ReadFn = NULL;
         WriteFn = NULL;
         HighlightFn = NULL;
+        BgColorFn = NULL;
 
         // State/Internals
         ContentsWidthChanged = false;
@@ -282,6 +284,20 @@ struct MemoryEditor
                         byte_pos_x += (float)(n / OptMidColsCount) * s.SpacingBetweenMidCols;
                     ImGui::SameLine(byte_pos_x);
 
+                    // Draw background color
+                    if (BgColorFn)
+                    {
+                        ImU32 bg_color = BgColorFn(mem_data, addr);
+                        if (bg_color != 0)
+                        {
+                            ImVec2 pos = ImGui::GetCursorScreenPos();
+                            float bg_width = s.GlyphWidth * 2;
+                            if (n + 1 < Cols && addr + 1 < mem_size && BgColorFn(mem_data, addr + 1) != 0)
+                                bg_width = s.HexCellWidth;
+                            draw_list->AddRectFilled(pos, ImVec2(pos.x + bg_width, pos.y + s.LineHeight), bg_color);
+                        }
+                    }
+
                     // Draw highlight
                     bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
                     bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr));
@@ -901,6 +901,10 @@ void TextEditor::Render()
 	snprintf(buf, 16, " %d ", globalLineMax);
 	mTextStart = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x + mLeftMargin;
 
+	//The profiler's column, between the line numbers and the text.
+	float cyclesWidth = _LineCycles.empty() ? 0.0f : ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, "999.9M ", nullptr, nullptr).x;
+	mTextStart += cyclesWidth;
+
 	if (!mLines.empty())
 	{
 		float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
@@ -1026,7 +1030,28 @@ void TextEditor::Render()
 			startOfText = finalRect.x;
 
 			auto lineNoWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x;
-			drawList->AddText(ImVec2(lineStartScreenPos.x + mTextStart - lineNoWidth, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], buf);
+			drawList->AddText(ImVec2(lineStartScreenPos.x + mTextStart - cyclesWidth - lineNoWidth, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], buf);
+
+			//Cycles on this line, tinted by how many there are compared to the line with the most (log scale).
+			uint64_t cycles = lineNo < (int)_LineCycles.size() ? _LineCycles[lineNo] : 0;
+
+			if (cycles > 0)
+			{
+				if (cycles < 1000)
+					snprintf(buf, 16, "%llu", (unsigned long long)cycles);
+				else if (cycles < 1000000)
+					snprintf(buf, 16, "%.1fk", cycles / 1000.0);
+				else if (cycles < 1000000000)
+					snprintf(buf, 16, "%.1fM", cycles / 1000000.0);
+				else
+					snprintf(buf, 16, "%.1fG", cycles / 1000000000.0);
+
+				float heat = _LineCyclesMost > 0 ? (float)(log((double)cycles + 1) / log((double)_LineCyclesMost + 1)) : 0.0f;
+				ImVec2 cyclesPos = ImVec2(lineStartScreenPos.x + mTextStart - cyclesWidth, lineStartScreenPos.y);
+
+				drawList->AddRectFilled(cyclesPos, ImVec2(cyclesPos.x + cyclesWidth - spaceSize, cyclesPos.y + mCharAdvance.y), IM_COL32(255, (int)(200 * (1 - heat)), 0, 30 + (int)(120 * heat)));
+				drawList->AddText(cyclesPos, mPalette[(int)PaletteIndex::LineNumber], buf);
+			}
 
 			if (mState.mCursorPosition.mLine == lineNo)
 			{
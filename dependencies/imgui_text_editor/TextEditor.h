@@ -25,6 +25,10 @@ public:
 	std::vector<int> _Breakpoints;
 	bool _BreakpointsChanged = false;
 
+	//Cycles spent on every line (index is line - 1), from the profiler, shown next to the line numbers. Empty for no column.
+	std::vector<uint64_t> _LineCycles;
+	uint64_t _LineCyclesMost = 0;
+
 	enum class PaletteIndex
 	{
 		Default,
@@ -141,7 +141,150 @@ project "8085_emu"
 		symbols "Off"
 
 
-        
+
+project "8085_batch"
+	location "8085_batch"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/include/**.h",
+		"%{prj.name}/src/**.cpp",
+	}
+
+	defines
+	{
+		"_CRT_SECURE_NO_WARNINGS"
+	}
+
+	includedirs
+	{
+		"8085_assembler/include",
+		"8085_emu/include",
+		"8085_batch/include",
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		links
+		{
+			"8085_assembler",
+			"8085_emu",
+		}
+
+		defines
+		{
+			"PLATFORM_WINDOWS",
+		}
+
+	filter "system:linux"
+		linkgroups "On"
+
+		links
+		{
+			"8085_assembler",
+			"8085_emu",
+
+			"pthread",
+		}
+
+		pic "On"
+		systemversion "latest"
+
+	filter "configurations:Debug"
+		defines "_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "_DIST"
+		runtime "Release"
+		optimize "on"
+		symbols "Off"
+
+
+
+project "8085_trace"
+	location "8085_trace"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.cpp",
+	}
+
+	defines
+	{
+		"_CRT_SECURE_NO_WARNINGS"
+	}
+
+	includedirs
+	{
+		"8085_emu/include",
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		links
+		{
+			"8085_emu",
+		}
+
+		defines
+		{
+			"PLATFORM_WINDOWS",
+		}
+
+	filter "system:linux"
+		linkgroups "On"
+
+		links
+		{
+			"8085_emu",
+
+			"pthread",
+		}
+
+		pic "On"
+		systemversion "latest"
+
+	filter "configurations:Debug"
+		defines "_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "_DIST"
+		runtime "Release"
+		optimize "on"
+		symbols "Off"
+
+
+
 project "GUI"
 	location "GUI"
 	kind "ConsoleApp"